@@ -1,6 +1,21 @@
 
 ### Build Configuration Checks
 
+option(RIFT_PROFILER "Compile the --profile hooks into the evaluator" ON)
+if (RIFT_PROFILER)
+    add_definitions(-DRIFT_PROFILER)
+endif ()
+
+option(RIFT_JIT "Compile hot functions to native code with --engine=tiered (x86_64 only)" ON)
+if (RIFT_JIT)
+    add_definitions(-DRIFT_JIT)
+endif ()
+
+option(RIFT_CHECKED_READER "Bounds check every scanner and parser read instead of trusting the sentinel (debugging)" OFF)
+if (RIFT_CHECKED_READER)
+    add_definitions(-DRIFT_CHECKED_READER)
+endif ()
+
 IF (WIN32)
     add_definitions(-DOS_WINDOWS)
 ELSEIF (LINUX)
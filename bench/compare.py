@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+"""Compares two rift-bench JSON outputs (Google Benchmark format).
+
+usage: compare.py <baseline.json> <current.json> [threshold%]
+Exits 1 if any benchmark got slower than the threshold (default 10%).
+"""
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        runs = json.load(f)["benchmarks"]
+    return {r["name"]: r for r in runs if r.get("run_type", "iteration") == "iteration"}
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        return 2
+    base, curr = load(sys.argv[1]), load(sys.argv[2])
+    threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 10.0
+
+    slower = 0
+    print(f"{'benchmark':<40} {'baseline':>12} {'current':>12} {'change':>8}")
+    for name, run in curr.items():
+        if name not in base:
+            print(f"{name:<40} {'-':>12} {run['real_time']:>10.3f}{run['time_unit']:>2} {'new':>8}")
+            continue
+        old, new = base[name]["real_time"], run["real_time"]
+        change = (new - old) / old * 100 if old else 0.0
+        flag = " <<" if change > threshold else ""
+        slower += change > threshold
+        print(f"{name:<40} {old:>10.3f}{run['time_unit']:>2} {new:>10.3f}{run['time_unit']:>2} {change:>+7.1f}%{flag}")
+    return 1 if slower else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
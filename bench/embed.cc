@@ -0,0 +1,109 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <rift/rift.hh>
+#include <rift/rift.h>
+
+namespace rift
+{
+    namespace bench
+    {
+        #pragma mark - Workloads
+
+        /// @brief a policy check as a host would run it on every request
+        static const std::string POLICY =
+            "fun add(a, b) { return a + b; }"
+            "fun allow(user, size) { if (size > limit(user)) { return false; } return true; }"
+            "fun label(user) { return \"user:\" + user; }";
+
+        #pragma mark - Benchmarks
+
+        static void define(embed::Runtime& runtime)
+        {
+            runtime.define("limit", 1, [](std::span<const embed::Value> args) { return embed::Value(args[0].asString().size() * 10.0); });
+        }
+
+        /// @brief calls through a function looked up once
+        static void call(benchmark::State& state)
+        {
+            embed::Runtime runtime;
+            auto script = runtime.compile(POLICY);
+            auto add = script.function("add");
+            double n = 0;
+            for (auto _ : state) n = runtime.call(add, {n, 1.0}).asNumber();
+            benchmark::DoNotOptimize(n);
+            state.SetItemsProcessed(state.iterations());
+        }
+
+        /// @brief looks the function up by name on every call
+        static void named(benchmark::State& state)
+        {
+            embed::Runtime runtime;
+            auto script = runtime.compile(POLICY);
+            double n = 0;
+            for (auto _ : state) n = runtime.call(script, "add", {n, 1.0}).asNumber();
+            benchmark::DoNotOptimize(n);
+            state.SetItemsProcessed(state.iterations());
+        }
+
+        /// @brief a string in, a fresh string out, and a host function called from Rift
+        static void policy(benchmark::State& state)
+        {
+            embed::Runtime runtime;
+            define(runtime);
+            auto script = runtime.compile(POLICY);
+            auto allow = script.function("allow"), label = script.function("label");
+            embed::Value user("alice");
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(runtime.call(allow, {user, 42}));
+                benchmark::DoNotOptimize(runtime.call(label, {user}));
+            }
+            state.SetItemsProcessed(state.iterations() * 2);
+        }
+
+        /// @brief the same call through the C interface
+        static void c(benchmark::State& state)
+        {
+            auto runtime = rift_runtime_new(1);
+            auto script = rift_compile(runtime, POLICY.data(), POLICY.size());
+            rift_value args[2] = {rift_number(0), rift_number(1)}, res;
+            for (auto _ : state) {
+                rift_call(runtime, script, "add", args, 2, &res);
+                args[0] = res;
+            }
+            benchmark::DoNotOptimize(res);
+            rift_script_free(script);
+            rift_runtime_free(runtime);
+            state.SetItemsProcessed(state.iterations());
+        }
+
+        /// @brief what running a source per request costs: scanning, parsing and running it again
+        static void recompile(benchmark::State& state)
+        {
+            const std::string source = "fun add(a, b) { return a + b; } add(1, 2);";
+            for (auto _ : state) {
+                // a fresh runtime is what a standalone run gets, redefining add would fail
+                state.PauseTiming();
+                auto fresh = std::make_unique<embed::Runtime>();
+                state.ResumeTiming();
+                auto script = fresh->compile(source);
+                benchmark::DoNotOptimize(fresh->call(script, "add", {1, 2}));
+                state.PauseTiming();
+                fresh.reset();
+                state.ResumeTiming();
+            }
+            state.SetItemsProcessed(state.iterations());
+        }
+
+        #pragma mark - Registration
+
+        void registerEmbedding()
+        {
+            benchmark::RegisterBenchmark("embed/call", call);
+            benchmark::RegisterBenchmark("embed/named", named);
+            benchmark::RegisterBenchmark("embed/policy", policy);
+            benchmark::RegisterBenchmark("embed/c", c);
+            benchmark::RegisterBenchmark("embed/recompile", recompile);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include <benchmark/benchmark.h>
+
+namespace rift { namespace bench { void registerAll(); void registerEmbedding(); } }
+
+/// @brief per-phase throughput for every workload
+/// @note --benchmark_out=<file> --benchmark_out_format=json writes a baseline (see bench-baseline)
+int main(int argc, char **argv)
+{
+    rift::bench::registerAll();
+    rift::bench::registerEmbedding();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/resolver.hh>
+#include <ast/eval.hh>
+#include <ast/env.hh>
+#include <vm/vm.hh>
+#include "workloads.hh"
+
+using namespace rift::ast;
+using namespace rift::scanner;
+
+namespace rift
+{
+    namespace bench
+    {
+        #pragma mark - Helpers
+
+        /// @brief swallows what the programs print while they're timed
+        struct Silence
+        {
+            std::ostringstream sink;
+            std::streambuf* old;
+            Silence() : old(std::cout.rdbuf(sink.rdbuf())) {}
+            ~Silence() { std::cout.rdbuf(old); }
+        };
+
+        static std::unique_ptr<Program> load(const std::string& source)
+        {
+            Scanner scanner(source);
+            scanner.scan_source();
+            Parser parser(scanner.tokens);
+            return parser.parse();
+        }
+
+        static void resolve(const Program& prgm)
+        {
+            Resolver resolver;
+            resolver.resolve(prgm);
+        }
+
+        /// @brief throughput counters, zero means the phase doesn't see that unit
+        static void rates(benchmark::State& state, size_t bytes, size_t tokens, size_t nodes)
+        {
+            if (bytes) state.SetBytesProcessed(state.iterations() * bytes);
+            if (tokens) state.counters["tokens/s"] = benchmark::Counter(double(state.iterations() * tokens), benchmark::Counter::kIsRate);
+            if (nodes) state.counters["nodes/s"] = benchmark::Counter(double(state.iterations() * nodes), benchmark::Counter::kIsRate);
+        }
+
+        #pragma mark - Phases
+
+        static void scan(benchmark::State& state, const Workload& w)
+        {
+            size_t tokens = 0;
+            for (auto _ : state) {
+                Scanner scanner(w.source);
+                scanner.scan_source();
+                tokens = scanner.tokens->size();
+                benchmark::DoNotOptimize(scanner.tokens->data());
+            }
+            rates(state, w.source.size(), tokens, 0);
+        }
+
+        /// @param lazy defer function bodies (what the driver does for files)
+        static void parse(benchmark::State& state, const Workload& w, bool lazy)
+        {
+            Scanner scanner(w.source);
+            scanner.scan_source();
+            size_t nodes = 0;
+            for (auto _ : state) {
+                Parser parser(scanner.tokens);
+                parser.lazy = lazy;
+                auto prgm = parser.parse();
+                nodes = prgm->nodes().objects();
+                benchmark::DoNotOptimize(prgm.get());
+            }
+            rates(state, 0, scanner.tokens->size(), nodes);
+        }
+
+        /// @note resolving is redone (untimed) each round since globals are cleared between runs,
+        ///       functions are redeclared too so a tiered run compiles them again every round
+        static void tree(benchmark::State& state, const Workload& w, bool tiered)
+        {
+            auto prgm = load(w.source);
+            Silence quiet;
+            for (auto _ : state) {
+                state.PauseTiming();
+                Environment::clear(false);
+                resolve(*prgm);
+                state.ResumeTiming();
+
+                Eval eval;
+                eval.tiered(tiered);
+                DiscardResults results;
+                eval.evaluate(*prgm, results);
+            }
+            rates(state, 0, 0, prgm->nodes().objects());
+        }
+
+        /// @note includes compiling to bytecode
+        static void vm(benchmark::State& state, const Workload& w)
+        {
+            auto prgm = load(w.source);
+            resolve(*prgm);
+            Silence quiet;
+            for (auto _ : state) {
+                rift::vm::VM machine;
+                DiscardResults results;
+                machine.evaluate(*prgm, results);
+            }
+            rates(state, 0, 0, prgm->nodes().objects());
+        }
+
+        #pragma mark - Registration
+
+        void registerAll()
+        {
+            // workloads outlive the run, the benchmarks keep references to them
+            static const auto all = workloads(RIFT_EXAMPLES_DIR);
+            for (const auto& w : all) {
+                benchmark::RegisterBenchmark(("scan/" + w.name).c_str(), scan, w);
+                benchmark::RegisterBenchmark(("parse/" + w.name).c_str(), parse, w, false);
+                benchmark::RegisterBenchmark(("parse.lazy/" + w.name).c_str(), parse, w, true);
+                benchmark::RegisterBenchmark(("eval.tree/" + w.name).c_str(), tree, w, false)->Unit(benchmark::kMillisecond);
+                benchmark::RegisterBenchmark(("eval.tiered/" + w.name).c_str(), tree, w, true)->Unit(benchmark::kMillisecond);
+                benchmark::RegisterBenchmark(("eval.vm/" + w.name).c_str(), vm, w)->Unit(benchmark::kMillisecond);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rift
+{
+    namespace bench
+    {
+        /// @struct Workload
+        /// @brief A named rift program fed to every phase
+        struct Workload
+        {
+            std::string name;
+            std::string source;
+        };
+
+        /// @brief (((1 + 1) * 2) - 3) ... nested depth times
+        inline std::string nesting(int depth)
+        {
+            std::string expr = "1";
+            const char* ops[] = {" + ", " * ", " - "};
+            for (int i = 0; i < depth; i++)
+                expr = "(" + expr + ops[i % 3] + std::to_string(i % 7 + 1) + ")";
+            return "print(" + expr + ");\n";
+        }
+
+        /// @brief a single for loop running n times
+        inline std::string loop(int n)
+        {
+            return "mut sum = 0;\n"
+                   "for (mut i = 0; i < " + std::to_string(n) + "; i = i + 1) {\n"
+                   "    sum = sum + i * 2;\n"
+                   "}\n"
+                   "print(sum);\n";
+        }
+
+        /// @brief n global declarations, each reading the previous one
+        inline std::string decls(int n)
+        {
+            std::ostringstream out;
+            out << "mut v0 = 0;\n";
+            for (int i = 1; i < n; i++)
+                out << "mut v" << i << " = v" << i - 1 << " + " << i << ";\n";
+            return out.str();
+        }
+
+        /// @brief n string literals of len characters each, concatenated pairwise
+        inline std::string strings(int n, int len)
+        {
+            std::ostringstream out;
+            std::string body(len, 'r');
+            for (int i = 0; i < n; i++)
+                out << "mut s" << i << " = \"" << body << "\" + \"" << i << "\";\n";
+            return out.str();
+        }
+
+        /// @brief a text of n lines built by appending to one string in a loop
+        inline std::string append(int n)
+        {
+            return "mut text = \"\";\n"
+                   "for (mut i = 0; i < " + std::to_string(n) + "; i = i + 1) { text = text + \"line \" + i + \"\\n\"; }\n"
+                   "print(text == text + \"\");\n";
+        }
+
+        /// @brief a library of n functions of which only the first is ever called
+        inline std::string library(int n)
+        {
+            std::ostringstream out;
+            for (int i = 0; i < n; i++)
+                out << "fun f" << i << "(a, b) {\n"
+                    << "    mut c = a * " << i << " + b;\n"
+                    << "    if (c > 10) { return c - 1; } elif (c < 0) { return -c; }\n"
+                    << "    return c + a * b;\n"
+                    << "}\n";
+            out << "print(f0(1, 2));\n";
+            return out.str();
+        }
+
+        /// @brief naive recursive fibonacci of n, nothing but calls and arithmetic
+        inline std::string fib(int n)
+        {
+            return "fun fib(n) {\n"
+                   "    if (n < 2) return n;\n"
+                   "    return fib(n - 1) + fib(n - 2);\n"
+                   "}\n"
+                   "print(fib(" + std::to_string(n) + "));\n";
+        }
+
+        /// @brief the synthetic workloads plus every program under examples/
+        inline std::vector<Workload> workloads(const std::string& examples)
+        {
+            std::vector<Workload> ret = {
+                {"nesting/200", nesting(200)},
+                {"loop/10000", loop(10000)},
+                {"decls/5000", decls(5000)},
+                {"strings/1000x1k", strings(1000, 1024)},
+                {"append/10000", append(10000)},
+                {"library/2000", library(2000)},
+                {"fib/22", fib(22)},
+            };
+
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(examples, ec)) {
+                if (entry.path().extension() != ".rf") continue;
+                std::ifstream file(entry.path());
+                std::stringstream src;
+                src << file.rdbuf();
+                ret.push_back({"example/" + entry.path().stem().string(), src.str()});
+            }
+            return ret;
+        }
+    }
+}
\ No newline at end of file
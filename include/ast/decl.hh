@@ -22,11 +22,13 @@ namespace rift
 {
     namespace ast
     {
-        class Decl: public Accept<Tokens>
+        class Decl: public Accept<Values>
         {
             public:
-                virtual Tokens accept(const Visitor &visitor) const = 0;
+                virtual Values accept(const Visitor &visitor) const = 0;
                 virtual ~Decl() = default;
+                /// @brief the line the declaration ends on (starts on, for for/fun)
+                uint32_t line = 0;
                 friend class Visitor;
                 friend class DeclStmt;
                 friend class DeclVar;
@@ -35,8 +37,8 @@ namespace rift
         class DeclStmt: public Decl
         {
             public:
-                DeclStmt(std::unique_ptr<Stmt> stmt) : stmt(std::move(stmt)) {};
-                Tokens accept(const Visitor &visitor) const override { return visitor.visit_decl_stmt(*this); }
+                DeclStmt(Stmt* stmt) : stmt(stmt) {};
+                Values accept(const Visitor &visitor) const override { return visitor.visit_decl_stmt(*this); }
 
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
@@ -44,15 +46,15 @@ namespace rift
                 string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
                 #pragma clang diagnostic pop
 
-                std::unique_ptr<Stmt> stmt;
+                Stmt* stmt = nullptr;
         };
 
         class DeclVar: public Decl
         {
             public:
                 DeclVar(const Token &identifier): identifier(identifier), expr(nullptr) {};
-                DeclVar(const Token &identifier, std::unique_ptr<Expr> expr): identifier(identifier), expr(std::move(expr)) {};
-                Tokens accept(const Visitor &visitor) const override { return visitor.visit_decl_var(*this); }
+                DeclVar(const Token &identifier, Expr* expr): identifier(identifier), expr(expr) {};
+                Values accept(const Visitor &visitor) const override { return visitor.visit_decl_var(*this); }
 
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
@@ -60,8 +62,10 @@ namespace rift
                 string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
                 #pragma clang diagnostic pop
 
-                const Token& identifier;
-                std::unique_ptr<Expr> expr;
+                Token identifier;
+                Expr* expr = nullptr;
+                /// @note filled in by the Resolver
+                mutable Address addr;
         };
 
         class Block : public Decl
@@ -69,9 +73,11 @@ namespace rift
             public:
                 Block(vec_prog decls) : decls(std::move(decls)) {};
                 ~Block() = default;
-                vec_prog decls = nullptr;
+                vec_prog decls;
+                /// @brief number of locals declared directly in this block (filled in by the Resolver)
+                mutable uint32_t slots = 0;
 
-                Tokens accept(const Visitor &visitor) const override { return visitor.visit_block_stmt(*this); };
+                Values accept(const Visitor &visitor) const override { return visitor.visit_block_stmt(*this); };
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 // must uncomment visit_printer in printer.hh
@@ -85,15 +91,56 @@ namespace rift
                 For(): expr(nullptr), stmt_l(nullptr), stmt_r(nullptr), decl(nullptr), blk(nullptr), stmt_o(nullptr) {};
                 ~For() = default;
 
-                std::unique_ptr<Expr> expr;
-                std::unique_ptr<Stmt> stmt_l;
-                std::unique_ptr<Stmt> stmt_r;
-                std::unique_ptr<Decl> decl;
+                Expr* expr = nullptr;
+                Stmt* stmt_l = nullptr;
+                Stmt* stmt_r = nullptr;
+                Decl* decl = nullptr;
+
+                Block* blk = nullptr;
+                Stmt* stmt_o = nullptr;
+                /// @brief number of locals declared by the initializer (filled in by the Resolver)
+                mutable uint32_t slots = 0;
+                /// @brief `parallel for`, the iterations may run at once (see Visitor::parallel)
+                bool parallel = false;
+
+                /// @struct Counted
+                /// @brief the parts of `for (mut i = start; i < bound; i = i + step)`
+                struct Counted {
+                    const DeclVar* var = nullptr;
+                    /// @brief LESS, LESS_EQUAL, GREATER or GREATER_EQUAL
+                    TokenType compare = TokenType::LESS;
+                    const Expr* bound = nullptr;
+                    const Expr* step = nullptr;
+                    /// @brief true when the step is subtracted
+                    bool down = false;
+                };
+                /// @brief true when the loop only counts a variable it declares towards a bound
+                bool counted(Counted& loop) const;
+
+                Values accept(const Visitor &visitor) const override { return visitor.visit_for(*this); };
+                #pragma clang diagnostic push
+                #pragma clang diagnostic ignored "-Wunused-parameter"
+                // must uncomment visit_printer in printer.hh
+                string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
+                #pragma clang diagnostic pop
+        };
+
+        /// @class Import
+        /// @brief `import "path";`, the module at path (relative to the importing file) runs
+        ///        once, before the program that first imports it (see driver::Modules)
+        /// @note only allowed at the top level, nothing happens when the import itself runs
+        class Import : public Decl
+        {
+            public:
+                Import(Token path) : path(path) {};
+                ~Import() = default;
 
-                std::unique_ptr<Block> blk;
-                std::unique_ptr<Stmt> stmt_o;
+                /// @brief the string literal naming the module
+                Token path;
+                /// @brief set once the module was loaded, the Resolver reports imports that weren't
+                mutable bool linked = false;
 
-                Tokens accept(const Visitor &visitor) const override { return visitor.visit_for(*this); };
+                Values accept(const Visitor &visitor) const override { return visitor.visit_import(*this); };
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 // must uncomment visit_printer in printer.hh
@@ -104,19 +151,37 @@ namespace rift
         class DeclFunc : public Decl
         {
             public:
-                typedef struct {
+                /// @note a lazy Parser defers the bodies of top level functions, body() parses
+                ///       (resolves and optimizes) one the first time an engine needs it
+                struct Func {
                     Token name;
                     Tokens params;
-                    std::unique_ptr<Block> blk;
-                } Func;
+                    mutable Block* blk = nullptr;
+                    /// @brief first token of a deferred body (past its '{'), 0 if it wasn't deferred
+                    uint32_t begin = 0;
+                    /// @brief the program a deferred body is parsed from
+                    const Program* owner = nullptr;
+                    /// @brief top level names declared before the function (Resolver)
+                    mutable uint32_t globals = 0;
+
+                    /// @brief true until a deferred body is parsed
+                    inline bool deferred() const { return blk == nullptr && begin != 0; }
+                    /// @brief the body, nullptr for a declaration without one
+                    inline const Block* body() const { return deferred() ? parse() : blk; }
+
+                    private:
+                        const Block* parse() const;
+                };
 
                 DeclFunc(): func(nullptr) {};
-                DeclFunc(std::unique_ptr<Func> func): func(std::move(func)) {};
+                DeclFunc(Func* func): func(func) {};
                 ~DeclFunc() = default;
 
-                std::unique_ptr<Func> func;
+                Func* func = nullptr;
+                /// @note filled in by the Resolver
+                mutable Address addr;
 
-                Tokens accept(const Visitor &visitor) const override { return visitor.visit_decl_func(*this); };
+                Values accept(const Visitor &visitor) const override { return visitor.visit_decl_func(*this); };
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 // must uncomment visit_printer in printer.hh
@@ -13,11 +13,11 @@
 /////////////////////////////////////////////////////////////
 
 #pragma once
-// #include "../../external/abseil/absl/container/flat_hash_map.h"
-// #include <absl/container/flat_hash_map.h>
 #include <scanner/tokens.hh>
-#include <unordered_map>
-#include <unordered_set>
+#include <utils/flat_map.hh>
+#include <utils/symbols.hh>
+#include <utils/value.hh>
+#include <vector>
 #include <iostream>
 
 using Token = rift::scanner::Token;
@@ -28,59 +28,68 @@ namespace rift
 {
     namespace ast
     {
+        /// @class Environment
+        /// @brief The global variables, each name is bound to a slot once and every
+        ///        later access (resolved by the Resolver) is an index into that slot
+        /// @note locals never live here, they live in the Visitor's frames
         class Environment
         {
             public:
-                /// @note top level
-                static Environment& getInstance(bool parser) {
-                    static Environment eval_instance;
-                    static Environment parser_instance;
-                    return parser ? parser_instance : eval_instance;
-                }
-                /// @brief add a child to the current environment (recursive-checks)
-                static void addChild(bool parser) {
-                    Environment curr = getInstance(parser);
-                    while(curr.child) {
-                        std::cout << curr.child << std::endl;
-                        curr = curr.child;
-                    }
-                    curr.child = new Environment();
-                }
-                /// @brief remove the child from the current environment
-                static void removeChild(bool parser) {
-                    Environment prev;
-                    Environment curr = getInstance(parser);
-                    while(curr.child != nullptr) {
-                        prev = curr;
-                        curr = *curr.child;
-                    }
-                    prev.child = nullptr; // remove the child
-                }
+                /// @brief the environments of the current isolate (see Isolate::current)
+                static Environment& getInstance(bool parser);
 
-                /// @brief clear all enviroments
-                /// @note usefull for switching from compile-time to runtime
+                /// @brief clear all globals
+                /// @note invalidates every address resolved against this environment
                 static void clear(bool parser) {
                     Environment &curr = getInstance(parser);
-                    while(curr.child != nullptr) {
-                        Environment *tmp = curr.child;
-                        curr.child = curr.child->child;
-                        delete tmp;
-                    }
-                    getInstance(parser).values.clear();
-                    getInstance(parser).const_keys.clear();
+                    curr.globals.clear();
+                    curr.names.clear();
+                    curr.index.clear();
                 }
 
-                Environment() : child(nullptr) {}
-                Environment(Environment *child) : child(child) {}
+                /// @param symbols the table names are interned in (the owning isolate's)
+                explicit Environment(Symbols& symbols) : symbols(symbols) {}
                 ~Environment() = default;
-                Token getEnv(const str_t& name) const;
-                void setEnv(const str_t& name, const Token& value, bool is_const);
+
+                /// @brief the slot bound to a symbol, binding a new (undefined) one if needed
+                uint32_t slot(SymbolId name);
+                /// @brief the slot bound to name (interned first)
+                inline uint32_t slot(const str_t& name) { return slot(symbols.intern(name)); }
+                /// @brief the value in a slot
+                inline const rift::Value& get(uint32_t slot) const { return globals[slot].value; }
+                /// @brief changes every time the slot is assigned, never 0 once it was
+                /// @note what inline caches check their value against (see Call::Site)
+                inline uint64_t version(uint32_t slot) const { return globals[slot].version; }
+                /// @brief the last version given to any slot, unchanged until one is assigned
+                inline uint64_t stamp() const { return versions; }
+                /// @brief slots bound so far
+                inline uint32_t size() const { return static_cast<uint32_t>(globals.size()); }
+                /// @brief assigns a slot, constants can only be assigned while undefined
+                void set(uint32_t slot, const rift::Value& value, bool is_const);
+
+                /// @brief the value bound to name, undefined if it was never declared
+                rift::Value getEnv(const str_t& name) const;
+                /// @brief true if name is bound to a defined value
+                bool contains(const str_t& name) const;
+                void setEnv(const str_t& name, const rift::Value& value, bool is_const);
                 void printState();
-                Environment *child;
+                /// @brief marks the value of every global (see Heap::Roots)
+                void trace(Heap& heap) const;
+
             protected:
-                // absl::flat_hash_map<str_t, rift::scanner::Token> values;
-                std::unordered_map<str_t, rift::scanner::Token> values = {};
-                std::unordered_set<str_t> const_keys = {};
+                struct Global {
+                    rift::Value value = rift::Value::undefined();
+                    bool is_const = false;
+                    uint64_t version = 0;
+                };
+
+                Symbols& symbols;
+                std::vector<Global> globals = {};
+                std::vector<SymbolId> names = {};
+                FlatMap<SymbolId, uint32_t> index = {};
+                /// @brief the last version given to a slot, kept through clear so a slot bound
+                ///        again never matches what was cached of the one before
+                uint64_t versions = 0;
         };
     }
 }
\ No newline at end of file
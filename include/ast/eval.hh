@@ -22,6 +22,9 @@
 #include <ast/prgm.hh>
 #include <utils/arithmetic.hh>
 #include <utils/literals.hh>
+#include <utils/results.hh>
+#include <jit/jit.hh>
+#include <utils/scheduler.hh>
 
 using any = std::any;
 using string = std::string;
@@ -33,14 +36,34 @@ namespace rift
         class Eval
         {
             public:
-                Eval();
+                /// @param isolate whose globals and heap the program runs against
+                Eval(Isolate& isolate = Isolate::current());
                 ~Eval() = default;
 
-                /// @brief Evaluates the given *expr/stmt/decl*
-                std::vector<string> evaluate(const Program& expr, bool interactive);
+                /// @brief Evaluates the program, handing each top level result to sink
+                void evaluate(const Program& prgm, ResultSink& sink);
+                /// @brief Evaluates the program and collects every top level result
+                std::vector<string> evaluate(const Program& prgm, bool interactive);
+                /// @brief Calls a function value from outside of any program (see embed::Runtime)
+                /// @note the result is only rooted until the next safepoint of the heap
+                Value call(const Value& fn, std::span<const Value> args);
+
+                /// @brief the most scopes that were open at once
+                inline size_t peakDepth() const { return visitor->peakDepth(); }
+                /// @brief reports statements and calls to profiler while evaluating (nullptr stops)
+                inline void profile(Profiler* profiler) { visitor->profiler = profiler; }
+                /// @brief compiles functions to native code once they are hot (not while profiling)
+                inline void tiered(bool on) { visitor->tiering = on; }
 
             private:
                 std::unique_ptr<Visitor> visitor;
+
+                /// @brief the visitor's frames are roots of the isolate's heap
+                struct Frames : public Heap::Roots {
+                    Frames(Heap& heap, const Visitor& visitor) : Heap::Roots(heap), visitor(visitor) {}
+                    inline void trace(Heap& heap) const override { visitor.trace(heap); }
+                    const Visitor& visitor;
+                } frames;
         };
 
         /// @class EvaluatorException
@@ -57,12 +80,75 @@ namespace rift
                 std::string message;
         };
 
-        class StmtReturnException: public std::exception
+        /// @class ObjCallable
+        /// @brief A function declared while evaluating
+        /// @note the function lives in the declaring Program's arena, which must outlive the callable
+        class ObjCallable : public rift::Obj
         {
             public:
-                StmtReturnException(Token tok): tok(tok) {};
-                ~StmtReturnException() = default;
-                Token tok;
+                ObjCallable(std::string name, const DeclFunc::Func* func, uint32_t arity) : rift::Obj(rift::ObjType::CALLABLE), name(std::move(name)), func(func), arity(arity) {}
+                std::string name;
+                /// @note its body may still be deferred until the first call
+                const DeclFunc::Func* func;
+                /// @brief number of parameters, bound to the first slots of the body's scope
+                uint32_t arity;
+                /// @brief counters and native code of the tiered engine
+                jit::Tier tier;
+        };
+
+        /// @class ObjTask
+        /// @brief A spawned call, running on the scheduler until the await (or the end of the
+        ///        program) that joins it (see Visitor::join)
+        class ObjTask : public rift::Obj
+        {
+            public:
+                enum class State : uint8_t
+                {
+                    RUNNING,
+                    DONE,
+                    FAILED
+                };
+
+                ObjTask(Value fn, Values args) : rift::Obj(rift::ObjType::TASK), fn(fn), args(std::move(args)) {}
+                Value fn;
+                /// @brief evaluated when spawned, dropped once the call ran
+                Values args;
+                State state = State::RUNNING;
+                /// @brief what the call returned, on the heap of the isolate that awaits it
+                Value result = Value::nil();
+                /// @brief the runtime error the call ended with (FAILED)
+                std::string error;
+
+                void trace(Heap& heap) const override
+                {
+                    heap.mark(fn);
+                    for (const auto& arg : args) heap.mark(arg);
+                    heap.mark(result);
+                }
+        };
+
+        /// @struct Job
+        /// @brief The run of a spawned task on the scheduler, on a visitor of its own reading
+        ///        the globals of when it was spawned
+        struct Job : public Scheduler::Task
+        {
+            Job(Isolate& isolate, ObjTask& task, std::shared_ptr<const Snapshot> globals)
+                : isolate(isolate), task(task), globals(std::move(globals)) {}
+
+            Isolate& isolate;
+            ObjTask& task;
+            std::shared_ptr<const Snapshot> globals;
+            /// @brief waited on by whoever joins the task
+            Scheduler::Group group;
+            Worker worker;
+            Value result;
+            bool failed = false;
+            std::string error;
+
+            void run() override;
         };
     }
+
+    inline ast::ObjCallable* Value::asCallable() const { return static_cast<ast::ObjCallable*>(as.obj); }
+    inline ast::ObjTask* Value::asTask() const { return static_cast<ast::ObjTask*>(as.obj); }
 }
\ No newline at end of file
@@ -16,6 +16,9 @@
 #pragma once
 #include <scanner/tokens.hh>
 #include <utils/macros.hh>
+#include <utils/literals.hh>
+#include <utils/arithmetic.hh>
+#include <utils/builtins.hh>
 
 #include <any>
 #include <iostream>
@@ -48,26 +51,124 @@ namespace rift
         ///            - Example: 1
         ///          - Unary: An expression with a single operator and a single operand
         ///            - Example: -1
-        class Expr : public Accept<Token>
+        class Expr : public Accept<Value>
         {
             public:
-                virtual Token accept(const Visitor& visitor) const override = 0;
+                virtual Value accept(const Visitor& visitor) const override = 0;
                 virtual string accept_printer(const Visitor& visitor) const override = 0;
                 virtual ~Expr() = default;
         };
 
         #pragma mark - Concrete Expressions
 
-        using Exprs = std::vector<std::unique_ptr<Expr>>;
+        using Exprs = std::vector<Expr*>;
         class Call : public Expr
         {
             public:
-                Call(std::unique_ptr<Expr> name, Exprs&& args): name(std::move(name)), args(std::move(args)) {};
+                Call(Expr* name, Exprs&& args): name(name), args(std::move(args)) {};
 
-                std::unique_ptr<Expr> name; // expr -> Literal::Identifier
+                Expr* name = nullptr; // expr -> Literal::Identifier
                 Exprs args;
+                /// @brief the builtin of the callee's name, when it is a global (see builtins::Builtin)
+                /// @note filled in by the Resolver
+                mutable builtins::Builtin builtin = builtins::Builtin::NONE;
 
-                inline Token accept(const Visitor& visitor) const override { return visitor.visit_call(*this); }
+                /// @struct Site
+                /// @brief Inline cache of a call through a global: the callee it was last checked
+                ///        to take this many arguments, valid while the global keeps that version
+                struct Site {
+                    uint64_t version = 0;
+                    uint32_t slot = 0;
+                    Obj* callee = nullptr;
+                };
+                /// @note only filled by a visitor of the isolate, workers just read it
+                mutable Site site;
+
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_call(*this); }
+                #pragma clang diagnostic push
+                #pragma clang diagnostic ignored "-Wunused-parameter"
+                inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
+                #pragma clang diagnostic pop
+        };
+
+        /// @class Spawn
+        /// @brief `spawn f(args)`, the call as a task that runs on a worker
+        /// @note evaluates to the task, the arguments are evaluated right away
+        class Spawn : public Expr
+        {
+            public:
+                Spawn(Token keyword, Call* call): keyword(keyword), call(call) {};
+                Token keyword;
+                Call* call = nullptr;
+
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_spawn(*this); }
+                #pragma clang diagnostic push
+                #pragma clang diagnostic ignored "-Wunused-parameter"
+                inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
+                #pragma clang diagnostic pop
+        };
+
+        /// @class Await
+        /// @brief `await task`, what the spawned call returned
+        class Await : public Expr
+        {
+            public:
+                Await(Token keyword, Expr* task): keyword(keyword), task(task) {};
+                Token keyword;
+                Expr* task = nullptr;
+
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_await(*this); }
+                #pragma clang diagnostic push
+                #pragma clang diagnostic ignored "-Wunused-parameter"
+                inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
+                #pragma clang diagnostic pop
+        };
+
+        /// @class Array
+        /// @brief `[1, 2, 3]`, a new array of the elements
+        class Array : public Expr
+        {
+            public:
+                Array(Token bracket, Exprs&& elements): bracket(bracket), elements(std::move(elements)) {};
+                Token bracket;
+                Exprs elements;
+
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_array(*this); }
+                #pragma clang diagnostic push
+                #pragma clang diagnostic ignored "-Wunused-parameter"
+                inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
+                #pragma clang diagnostic pop
+        };
+
+        /// @class Index
+        /// @brief `target[index]`, an element of an array
+        class Index : public Expr
+        {
+            public:
+                Index(Expr* target, Token bracket, Expr* index): target(target), bracket(bracket), index(index) {};
+                Expr* target = nullptr;
+                Token bracket;
+                Expr* index = nullptr;
+
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_index(*this); }
+                #pragma clang diagnostic push
+                #pragma clang diagnostic ignored "-Wunused-parameter"
+                inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
+                #pragma clang diagnostic pop
+        };
+
+        /// @class SetIndex
+        /// @brief `target[index] = value`, evaluates to the value
+        class SetIndex : public Expr
+        {
+            public:
+                SetIndex(Expr* target, Token bracket, Expr* index, Expr* value): target(target), bracket(bracket), index(index), value(value) {};
+                Expr* target = nullptr;
+                Token bracket;
+                Expr* index = nullptr;
+                Expr* value = nullptr;
+
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_set_index(*this); }
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
@@ -77,12 +178,12 @@ namespace rift
         class Ternary : public Expr
         {
             public:
-                Ternary(std::unique_ptr<Expr> condition, std::unique_ptr<Expr> left, std::unique_ptr<Expr> right): condition(std::move(condition)), left(std::move(left)), right(std::move(right)) {};
-                std::unique_ptr<Expr> condition;
-                std::unique_ptr<Expr> left;
-                std::unique_ptr<Expr> right;
+                Ternary(Expr* condition, Expr* left, Expr* right): condition(condition), left(left), right(right) {};
+                Expr* condition = nullptr;
+                Expr* left = nullptr;
+                Expr* right = nullptr;
 
-                inline Token accept(const Visitor& visitor) const override { return visitor.visit_ternary(*this); }
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_ternary(*this); }
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
@@ -92,11 +193,13 @@ namespace rift
         class Assign : public Expr
         {
             public:
-                Assign(Token name, std::unique_ptr<Expr> value): name(name), value(std::move(value)) {};
+                Assign(Token name, Expr* value): name(name), value(value) {};
                 Token name;
-                std::unique_ptr<Expr> value;
+                Expr* value = nullptr;
+                /// @note filled in by the Resolver
+                mutable Address addr;
 
-                inline Token accept(const Visitor& visitor) const override { return visitor.visit_assign(*this); }
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_assign(*this); }
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 inline string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
@@ -111,12 +214,14 @@ namespace rift
         class Binary : public Expr
         {
             public:
-                Binary(std::unique_ptr<Expr> left, Token op, std::unique_ptr<Expr> right): op(op), left(std::move(left)), right(std::move(right)) {};
+                Binary(Expr* left, Token op, Expr* right): op(op), arith(rift::arith::op(op.type)), left(left), right(right) {};
                 Token op;
-                std::unique_ptr<Expr> left;
-                std::unique_ptr<Expr> right;
+                /// @brief the operator's dispatch table row, looked up once
+                rift::arith::Op arith;
+                Expr* left = nullptr;
+                Expr* right = nullptr;
 
-                inline Token accept(const Visitor& visitor) const override { return visitor.visit_binary(*this); }
+                inline Value accept(const Visitor& visitor) const override { return visitor.visit_binary(*this); }
                 inline string accept_printer(const Visitor& visitor) const override { return visitor.print_binary(*this); }
         };
 
@@ -125,22 +230,28 @@ namespace rift
         class Grouping : public Expr
         {
             public:
-                Grouping(std::unique_ptr<Expr> expr): expr(std::move(expr)) {};
-                std::unique_ptr<Expr> expr;
+                Grouping(Expr* expr): expr(expr) {};
+                Expr* expr = nullptr;
 
-                inline Token accept(const Visitor& visitor) const override {return visitor.visit_grouping(*this);}
+                inline Value accept(const Visitor& visitor) const override {return visitor.visit_grouping(*this);}
                 inline string accept_printer(const Visitor& visitor) const override {return visitor.print_grouping(*this);}
         };
 
         /// @class Literal
         /// @param value The value of the literal
+        /// @note constant is converted once at parse time (undefined for identifiers)
         class Literal: public Expr
         {
             public:
-                Literal(Token value): value(value) {};
+                Literal(Token value): value(value), constant(rift::literalValue(value)) {};
+                /// @note for values computed ahead of time (folding), value is only kept for printing
+                Literal(Token value, Value constant): value(value), constant(constant) {};
                 Token value;
+                Value constant;
+                /// @note filled in by the Resolver (identifiers only)
+                mutable Address addr;
 
-                inline Token accept(const Visitor &visitor) const override {return visitor.visit_literal(*this);}
+                inline Value accept(const Visitor &visitor) const override {return visitor.visit_literal(*this);}
                 inline string accept_printer(const Visitor& visitor) const override {return visitor.print_literal(*this);}
         };
 
@@ -150,11 +261,11 @@ namespace rift
         class Unary : public Expr
         {
             public:
-                Unary(Token op, std::unique_ptr<Expr> expr): op(op), expr(std::move(expr)) {};
+                Unary(Token op, Expr* expr): op(op), expr(expr) {};
                 Token op;
-                std::unique_ptr<Expr> expr;
+                Expr* expr = nullptr;
 
-                inline Token accept(const Visitor& visitor) const override {return visitor.visit_unary(*this);}
+                inline Value accept(const Visitor& visitor) const override {return visitor.visit_unary(*this);}
                 inline string accept_printer(const Visitor& visitor) const override {return visitor.print_unary(*this);}
         };
     }
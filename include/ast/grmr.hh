@@ -16,10 +16,17 @@
 
 #include <scanner/tokens.hh>
 #include <utils/macros.hh>
+#include <utils/value.hh>
 #include <ast/env.hh>
+#include <utils/isolate.hh>
+#include <utils/results.hh>
+#include <deque>
+#include <memory>
 
 using Token = rift::scanner::Token;
 using Tokens = std::vector<Token>;
+using Value = rift::Value;
+using Values = rift::Values;
 using string = std::string;
 
 namespace rift
@@ -42,18 +49,22 @@ namespace rift
         /// exprStmt       → expression ";"
         /// ifStmt         → "if" "(" expression ")" stmt|blk ( "elif" statment|blk )* ( "else" stmt|blk )?
         /// returnStmt     → "return" expression ";"
-        /// ternary        → expression "?" expression ":" expression ";"
-        /// expression     → equality ";"
-        /// assignment     → IDENTIFIER "=" assignment | equality
+        /// ternary        → logic_or "?" logic_or ":" logic_or ";"
+        /// expression     → assignment ";"
+        /// assignment     → ( IDENTIFIER | call "[" expression "]" ) "=" assignment | ternary
+        /// logic_or       → logic_and ( ( "||" | "??" ) logic_and )* ";"
+        /// logic_and      → equality ( "&&" equality )* ";"
         /// equality       → comparison ( ( "!=" | "==" ) comparison )* ";"
         /// comparison     → term ( ( ">" | ">=" | "<" | "<=" ) term )* ";"
         /// term           → factor ( ( "-" | "+" ) factor )* ";"
         /// factor         → unary ( ( "/" | "*" ) unary )* ";"
         /// unary          → ( "!" | "-" ) unary | primary ";"
-        /// call           → primary ( "(" arguments? ")" )* ";"
-        /// primary        → NUMBER | STRING | "true" | "false" | "nil" | "(" expression ")" ";"
+        /// call           → primary ( "(" arguments? ")" )? ( "[" expression "]" )* ";"
+        /// arguments      → expression ( "," expression )*
+        /// primary        → NUMBER | STRING | "true" | "false" | "nil" | "(" expression ")" | "[" arguments? "]" ";"
 
         __DEFAULT_FORWARD_NONE_VA(
+            Expr,
             Assign,
             Binary,
             Grouping,
@@ -63,11 +74,25 @@ namespace rift
 
         __DEFAULT_FORWARD_NONE_VA(
             Printer,
+            Profiler,
+            ObjCallable,
             Ternary,
             For,
             Call
         )
 
+        __DEFAULT_FORWARD_NONE_VA(
+            Spawn,
+            Await,
+            ObjTask
+        )
+
+        __DEFAULT_FORWARD_NONE_VA(
+            Array,
+            Index,
+            SetIndex
+        )
+
         __DEFAULT_FORWARD_NONE_VA(
             Stmt, 
             StmtPrint, 
@@ -80,7 +105,8 @@ namespace rift
             Decl, 
             DeclStmt, 
             DeclVar,
-            DeclFunc
+            DeclFunc,
+            Import
         )
 
         __DEFAULT_FORWARD_NONE_VA(
@@ -88,7 +114,46 @@ namespace rift
             Block
         )
 
-        using vec_prog = std::unique_ptr<std::vector<std::unique_ptr<Decl>>>;
+        /// @note nodes are owned by the Program's arena, the vector only references them
+        using vec_prog = std::vector<Decl*>;
+
+        /// @struct Address
+        /// @brief The lexical address of a variable, filled in by the Resolver
+        /// @note depth is the number of scopes between the use and the declaration,
+        ///       a GLOBAL address indexes the global Environment with slot instead
+        struct Address
+        {
+            static constexpr uint32_t GLOBAL = UINT32_MAX;
+            uint32_t depth = GLOBAL;
+            uint32_t slot = 0;
+
+            inline bool global() const { return depth == GLOBAL; }
+        };
+
+        /// @struct Worker
+        /// @brief What a visitor running on a worker thread has of its own instead of sharing
+        ///        its isolate's (see parallel.cc): a heap, freed once the work is done, and the
+        ///        text it printed, written to the isolate's output once every worker is done
+        /// @note the visitor only reads globals, and doesn't call the host's functions
+        struct Worker
+        {
+            Heap heap;
+            std::string printed;
+        };
+
+        /// @struct Snapshot
+        /// @brief The globals as they were when a task was spawned, what the task reads instead
+        ///        of the isolate's while its spawner keeps running (and assigning them)
+        /// @note shared by every task spawned until a global is assigned again (see Environment::stamp)
+        struct Snapshot
+        {
+            uint64_t stamp = 0;
+            Values values;
+            std::vector<uint64_t> versions;
+        };
+
+        struct Job;
+
         /// @class Visitor 
         /// @brief implementation of the statements and expressions
         class Visitor
@@ -96,31 +161,36 @@ namespace rift
             public:
                 /* Evaluator */
                     /* expr */
-                    virtual Token visit_assign(const Assign& expr) const;
-                    virtual Token visit_binary(const Binary& expr) const;
-                    virtual Token visit_grouping(const Grouping& expr) const;
-                    virtual Token visit_literal(const Literal& expr) const;
-                    virtual Token visit_unary(const Unary& expr) const;
-                    virtual Token visit_ternary(const Ternary& expr) const;
-                    virtual Token visit_call(const Call& expr) const;
+                    virtual Value visit_assign(const Assign& expr) const;
+                    virtual Value visit_binary(const Binary& expr) const;
+                    virtual Value visit_grouping(const Grouping& expr) const;
+                    virtual Value visit_literal(const Literal& expr) const;
+                    virtual Value visit_unary(const Unary& expr) const;
+                    virtual Value visit_ternary(const Ternary& expr) const;
+                    virtual Value visit_call(const Call& expr) const;
+                    virtual Value visit_spawn(const Spawn& expr) const;
+                    virtual Value visit_await(const Await& expr) const;
+                    virtual Value visit_array(const Array& expr) const;
+                    virtual Value visit_index(const Index& expr) const;
+                    virtual Value visit_set_index(const SetIndex& expr) const;
 
                     /* stmt */
-                    /// @note TokenType::IGNORE is used to ignore statements returning void
-                    virtual Token visit_expr_stmt(const StmtExpr& stmt) const;
-                    virtual Token visit_print_stmt(const StmtPrint& stmt) const;
-                    virtual Token visit_if_stmt(const StmtIf& stmt) const;
-                    [[noreturn]] virtual Token visit_return_stmt(const StmtReturn& stmt) const;
+                                        virtual Value visit_expr_stmt(const StmtExpr& stmt) const;
+                    virtual Value visit_print_stmt(const StmtPrint& stmt) const;
+                    virtual Value visit_if_stmt(const StmtIf& stmt) const;
+                    virtual Value visit_return_stmt(const StmtReturn& stmt) const;
 
                     /* decl */
-                    virtual Tokens visit_decl_stmt(const DeclStmt& decl) const;
-                    virtual Tokens visit_decl_var(const DeclVar& decl) const;
-                    virtual Tokens visit_decl_func(const DeclFunc& decl) const;
+                    virtual Values visit_decl_stmt(const DeclStmt& decl) const;
+                    virtual Values visit_decl_var(const DeclVar& decl) const;
+                    virtual Values visit_decl_func(const DeclFunc& decl) const;
+                    virtual Values visit_import(const Import& decl) const;
                     /* c-flow */
-                    virtual Tokens visit_for(const For& decl) const;
+                    virtual Values visit_for(const For& decl) const;
                     /* block */
-                    virtual Tokens visit_block_stmt(const Block& block) const;
+                    virtual Values visit_block_stmt(const Block& block) const;
                     /* prgm */
-                    virtual Tokens visit_program(const Program& prgm) const;
+                    virtual Values visit_program(const Program& prgm) const;
 
 
                 /* Printer */
@@ -139,7 +209,117 @@ namespace rift
 
                 
 
+                Visitor() = default;
+                explicit Visitor(Isolate& isolate) : isolate(&isolate) {}
                 virtual ~Visitor() = default;
+
+                /// @brief the most scopes that were open at once
+                inline size_t peakDepth() const { return peak; }
+                /// @brief where visit_program sends the value of each top level declaration
+                ResultSink* sink = nullptr;
+                /// @brief whose globals and heap the visit works on
+                Isolate* isolate = &Isolate::current();
+                /// @brief preallocates frame storage for n slots and scopes
+                inline void reserve(size_t n) { slots.reserve(n); scopes.reserve(n / 8); }
+                /// @brief marks the values the open frames hold (see Eval)
+                void trace(Heap& heap) const;
+                /// @brief calls fn (a callable or native) with args, as a call expression would
+                Value call(const Value& fn, std::span<const Value> args) const;
+                /// @brief drops every frame, after an error left them half open
+                void unwind() const;
+                /// @brief waits for the spawned tasks in order up to until (all of them when null),
+                ///        writes what each printed and keeps its result on its ObjTask
+                void join(const ObjTask* until = nullptr) const;
+
+                /// @brief when set, statements and calls are reported to it (--profile)
+                Profiler* profiler = nullptr;
+                /// @brief compile hot functions to native code (--engine=tiered, see jit::Tier)
+                bool tiering = false;
+                /// @brief set when the visitor runs on a worker thread (see Worker)
+                Worker* worker = nullptr;
+                /// @brief set when the visitor runs a task, the globals it reads
+                const Snapshot* view = nullptr;
+                /// @brief where the values the visit makes are allocated
+                inline Heap& heap() const { return worker != nullptr ? worker->heap : Heap::current(isolate->heap); }
+
+                /// @brief calls that may be in progress at once
+                static constexpr size_t MAX_CALLS = 1024;
+
+            protected:
+                #pragma mark - Completion
+                /// @brief how the last statement completed, anything but NORMAL skips the rest of
+                ///        every enclosing block until a construct that handles it (a call for RETURN)
+                enum class Signal : uint8_t
+                {
+                    NORMAL,
+                    RETURN
+                };
+                mutable Signal signal = Signal::NORMAL;
+                /// @brief the value carried by a RETURN
+                mutable Value returned;
+                /// @brief calls in progress
+                mutable size_t calls = 0;
+                /// @brief the function whose body is running, its loops count towards its hotness (tiering only)
+                mutable ObjCallable* running = nullptr;
+                /// @brief set while a top level declaration runs, only those have their values
+                ///        collected (in blocks they would be dropped right away)
+                mutable bool top = false;
+
+                /// @brief counts a call made with the frame's arguments from base on, and runs it
+                ///        natively if the callee is compiled (or just became hot) and the guards hold
+                /// @return false when the call has to be interpreted
+                bool native(ObjCallable& callee, const Expr* through, size_t base, Value& res) const;
+                /// @brief reports fn if it can't be called with that many arguments right now
+                void callable(const Value& fn, size_t args) const;
+                /// @brief calls fn with the arguments in slots from base on
+                /// @param through the expression fn was reached by, if any (see native)
+                Value invoke(const Value& fn, const Expr* through, size_t base) const;
+                /// @brief calls the builtin of a call whose name isn't a defined global
+                Value builtin(const Call& expr) const;
+
+                #pragma mark - Parallel
+                /// @brief tasks running on the scheduler, in the order they were spawned
+                mutable std::deque<std::shared_ptr<Job>> spawned;
+                /// @brief what the tasks spawned since the globals were last assigned read
+                mutable std::shared_ptr<const Snapshot> snapshot;
+                /// @brief runs the iterations of a counted loop on the scheduler, in chunks
+                Values parallel(const For& decl) const;
+                /// @brief joins while tasks run, before something they may be reading changes under them
+                inline void settle() const { if (!spawned.empty()) join(); }
+                /// @brief a global, as the task reads it when the visitor runs one
+                inline const Value& global(uint32_t slot) const {
+                    static const Value undefined = Value::undefined();
+                    if (view == nullptr) return isolate->globals.get(slot);
+                    return slot < view->values.size() ? view->values[slot] : undefined;
+                }
+                inline uint64_t version(uint32_t slot) const {
+                    if (view == nullptr) return isolate->globals.version(slot);
+                    return slot < view->versions.size() ? view->versions[slot] : 0;
+                }
+                /// @brief gets what workers will read ready to be shared: deferred bodies are
+                ///        parsed and ropes flattened, neither is safe to do from two threads
+                void share(std::span<const Value> also = {}) const;
+
+                #pragma mark - Frames
+                /// @brief every open scope's slots laid out back to back
+                /// @note also the call frame pool, a call's frame is carved out of the end and given
+                ///       back on return, so the storage is only grown by the deepest call chain
+                mutable Values slots;
+                /// @brief index into slots where each open scope begins
+                mutable std::vector<size_t> scopes;
+                /// @brief high water mark of scopes
+                mutable size_t peak = 0;
+
+                /// @brief the local at the given address
+                inline Value& local(const Address& addr) const { return slots[scopes[scopes.size() - 1 - addr.depth] + addr.slot]; }
+                /// @brief opens a scope of n undefined slots
+                inline void pushScope(size_t n) const {
+                    scopes.push_back(slots.size());
+                    slots.resize(slots.size() + n, Value::undefined());
+                    if (scopes.size() > peak) peak = scopes.size();
+                }
+                /// @brief closes the innermost scope
+                inline void popScope() const { slots.resize(scopes.back()); scopes.pop_back(); }
         };
 
         /// @class Accept
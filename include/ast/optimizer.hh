@@ -0,0 +1,109 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/grmr.hh>
+#include <ast/expr.hh>
+#include <ast/stmt.hh>
+#include <ast/decl.hh>
+#include <ast/prgm.hh>
+#include <utils/arena.hh>
+#include <unordered_map>
+#include <vector>
+
+namespace rift
+{
+    namespace ast
+    {
+        /// @class Optimizer
+        /// @brief Static pass run after the Resolver, it rewrites the program in place so
+        ///        every engine runs the simplified tree
+        /// @details - expressions whose operands are all constants are folded into a Literal
+        ///            (arithmetic, comparisons, string '+', '!', '-', short circuits, ternaries)
+        ///          - `mut!` variables initialized with a constant are replaced by that constant
+        ///            at every use that follows the declaration
+        ///          - if/elif arms with a constant condition are kept or dropped, as is the else
+        ///            they make unreachable
+        /// @note nothing that would be a runtime error is folded, it is left to fail at runtime
+        class Optimizer : public Visitor
+        {
+            public:
+                Optimizer() = default;
+                ~Optimizer() = default;
+
+                /// @brief optimizes the program in place, new nodes go to its arena
+                void optimize(const Program& prgm);
+                /// @brief optimizes a deferred function body once it is resolved
+                /// @note only what the body itself declares is propagated, not global constants
+                void optimize(const Program& prgm, const DeclFunc::Func& func);
+
+                /* expr */
+                Value visit_assign(const Assign& expr) const override;
+                Value visit_binary(const Binary& expr) const override;
+                Value visit_grouping(const Grouping& expr) const override;
+                Value visit_literal(const Literal& expr) const override;
+                Value visit_unary(const Unary& expr) const override;
+                Value visit_ternary(const Ternary& expr) const override;
+                Value visit_call(const Call& expr) const override;
+                Value visit_spawn(const Spawn& expr) const override;
+                Value visit_await(const Await& expr) const override;
+                Value visit_array(const Array& expr) const override;
+                Value visit_index(const Index& expr) const override;
+                Value visit_set_index(const SetIndex& expr) const override;
+
+                /* stmt */
+                Value visit_expr_stmt(const StmtExpr& stmt) const override;
+                Value visit_print_stmt(const StmtPrint& stmt) const override;
+                Value visit_if_stmt(const StmtIf& stmt) const override;
+                Value visit_return_stmt(const StmtReturn& stmt) const override;
+
+                /* decl */
+                Values visit_decl_stmt(const DeclStmt& decl) const override;
+                Values visit_decl_var(const DeclVar& decl) const override;
+                Values visit_decl_func(const DeclFunc& decl) const override;
+                Values visit_for(const For& decl) const override;
+                Values visit_block_stmt(const Block& block) const override;
+                Values visit_program(const Program& prgm) const override;
+
+            private:
+                /// @brief the program's arena, folded literals are allocated in it
+                mutable Arena* arena = nullptr;
+                /// @brief set by a visit when the node should be replaced by another expression
+                mutable Expr* replacement = nullptr;
+                /// @brief line of the last token seen, given to folded literals
+                mutable int line = 0;
+
+                using Constants = std::unordered_map<uint32_t, Value>;
+                /// @brief constants by slot, mirrors the scopes the Resolver opened
+                mutable Constants globals;
+                mutable std::vector<Constants> open;
+
+                /// @brief optimizes expr, returning the node that should take its place
+                Expr* fold(Expr* expr) const;
+                /// @brief the value of a literal (nullptr or non literal nodes are undefined)
+                static Value constant(const Expr* expr);
+                /// @brief a literal node holding val
+                Literal* literal(const Value& val) const;
+                /// @brief optimizes the statement or block of an if arm
+                void branch(StmtIf::Stmt* arm) const;
+                /// @brief optimizes the decls of a block in the innermost scope
+                void declarations(const Block& block) const;
+                /// @brief optimizes a function body in a scope of its own
+                void body(const DeclFunc::Func& func) const;
+                /// @brief the constant bound to an address, undefined if there is none
+                Value lookup(const Address& addr) const;
+        };
+    }
+}
\ No newline at end of file
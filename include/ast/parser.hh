@@ -15,7 +15,11 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <typeindex>
 #include <vector>
 #include <exception>
 #include <scanner/tokens.hh>
@@ -24,6 +28,7 @@
 #include <ast/expr.hh>
 #include <ast/stmt.hh>
 #include <ast/decl.hh>
+#include <utils/arena.hh>
 
 using namespace rift::scanner;
 using namespace rift::reader;
@@ -34,19 +39,92 @@ namespace rift
     {
         class Stmt;
 
+        /// @enum Precedence
+        /// @brief How tightly a binary operator binds, NONE for tokens that aren't one
+        enum class Precedence : uint8_t { NONE, OR, AND, EQUALITY, COMPARISON, TERM, FACTOR };
+
+        /// @brief the binary precedence of every token type, what the expression parser climbs
+        inline constexpr auto precedences = [] {
+            std::array<Precedence, TokenType::EOFF + 1> table{};
+            table[TokenType::LOG_OR] = table[TokenType::NULLISH_COAL] = Precedence::OR;
+            table[TokenType::LOG_AND] = Precedence::AND;
+            table[TokenType::BANG_EQUAL] = table[TokenType::EQUAL_EQUAL] = Precedence::EQUALITY;
+            table[TokenType::GREATER] = table[TokenType::GREATER_EQUAL] = Precedence::COMPARISON;
+            table[TokenType::LESS] = table[TokenType::LESS_EQUAL] = Precedence::COMPARISON;
+            table[TokenType::MINUS] = table[TokenType::PLUS] = Precedence::TERM;
+            table[TokenType::STAR] = table[TokenType::SLASH] = Precedence::FACTOR;
+            return table;
+        }();
+
         /// @class Parser
         /// @brief The parser class is responsible for parsing the tokens generated by the scanner.
-        class Parser : public Reader<Token>
+        /// @note consumes the scanner's compact tokens in place, Tokens are only materialized for the AST
+        class Parser : public Reader<CompactToken>
         {
             public:
-                Parser(std::shared_ptr<std::vector<Token>> &tokens) : Reader<Token>(tokens), tokens(tokens)  {};
+                /// @param isolate where the literals and names of the program live (the scanner's)
+                Parser(std::shared_ptr<TokenBuffer> tokens, Isolate& isolate = Isolate::current()) : Reader<CompactToken>(*tokens), tokens(tokens), isolate(isolate)  {};
                 ~Parser() = default;
 
                 /// @brief Parses the tokens and returns an expression
                 std::unique_ptr<Program> parse();
+                /// @brief Parses a body deferred by a lazy parse, from its first token
+                /// @param into the arena of the program the body belongs to
+                Block* body(uint32_t begin, Arena& into);
+
+                /// @brief defers top level function bodies, only their brackets are matched
+                ///        until the body is first needed (see DeclFunc::Func::body)
+                /// @note any other syntax error in a deferred body is reported once it is
+                ///       parsed: when the tree engine first calls the function, or when the vm
+                ///       compiles the program, before any of it runs
+                bool lazy = false;
+
+                /// @brief when set, every node made is tallied by its type (--stats)
+                std::map<std::type_index, size_t>* kinds = nullptr;
             protected:
-                std::shared_ptr<std::vector<Token>> tokens;
+                std::shared_ptr<TokenBuffer> tokens;
+                Isolate& isolate;
                 std::exception exception;
+                /// @brief arena of the program being parsed, handed over to it once parsing is done
+                std::unique_ptr<Arena> arena;
+                /// @brief where nodes are made, the arena above or the program's for a deferred body
+                Arena* nodes = nullptr;
+                /// @brief blocks open around the current token
+                unsigned depth = 0;
+                /// @brief functions whose bodies were deferred, tied to the program once it is made
+                std::vector<DeclFunc::Func*> deferred;
+                /// @brief the closing brackets skip is waiting for, innermost last
+                std::vector<TokenType> closers;
+                /// @brief the top level imports, handed over to the program
+                std::vector<Import*> imports;
+
+                /// @brief allocates a node in the current arena
+                template <typename T, typename... Args>
+                inline T* make(Args&&... args) {
+                    if (kinds) (*kinds)[typeid(T)]++;
+                    T* node = nodes->make<T>(std::forward<Args>(args)...);
+                    // statements are made right after their last (or, for if/for/fun, first) token
+                    if constexpr (std::is_base_of_v<Stmt, T> || std::is_base_of_v<Decl, T>)
+                        node->line = curr ? source[curr - 1].line : 0;
+                    return node;
+                }
+
+                /// @brief materializes a token for the AST
+                inline Token token(const CompactToken& tok) const { return tokens->token(tok); }
+
+                using Reader<CompactToken>::peek;
+                /// @brief Peeks at the type of the current token
+                /// @note past the end is the EOFF sentinel, which nothing is matched against
+                inline bool peek(TokenType type) { return current().type == type; }
+                /// @brief matches a token by type alone and advances the cursor
+                inline bool match(TokenType type) {
+                    if (!peek(type)) return false;
+                    curr++;
+                    return true;
+                }
+                /// @brief consumes a token of type, reports message if it isn't there
+                /// @note unlike Reader::consume, the exception is only made to be reported
+                CompactToken expect(TokenType type, const char* message);
 
             private:
                 #pragma mark - Grammar Evaluators
@@ -54,64 +132,66 @@ namespace rift
                 /// @note rules in order of precedence <Expr>
 
                 /// @example 1 + 2 * 3
-                std::unique_ptr<Expr> expression();
+                Expr* expression();
                 /// @example 1==1 ? print("hi") : print("else")
-                std::unique_ptr<Expr> ternary();
+                Expr* ternary();
                 /// @example identifier = 1 + 3
-                std::unique_ptr<Expr> assignment();
-                /// @example 1 == 1, 1 != 2
-                std::unique_ptr<Expr> equality();
-                /// @example 1 > 2, 1 <= 2
-                std::unique_ptr<Expr> comparison();
-                /// @example 1 + 2, 1 - 2
-                std::unique_ptr<Expr> term();
-                /// @example 1 * 2, 1 / 2
-                std::unique_ptr<Expr> factor();
+                Expr* assignment();
+                /// @example a || b && c == 1 + 2 * 3
+                /// @brief the binary operators binding at least as tightly as min (see precedences)
+                Expr* binary(Precedence min);
                 /// @example -1, !1
-                std::unique_ptr<Expr> unary();
-                /// @example method();
-                std::unique_ptr<Expr> call();
-                /// @example 1, "string", true, false, nil
-                std::unique_ptr<Expr> primary();
+                Expr* unary();
+                /// @example method(); or a[i]
+                Expr* call();
+                /// @example 1, "string", true, false, nil, [1, 2]
+                Expr* primary();
 
                 /// @note rules in order of precedence <Stmt>
 
                 /// @example function();
-                std::unique_ptr<StmtExpr> statement_expression();
+                StmtExpr* statement_expression();
                 /// @example print(1 + 2);
-                std::unique_ptr<StmtPrint> statement_print();
+                StmtPrint* statement_print();
                 /// @example if (1+2) print(3);
-                std::unique_ptr<StmtIf> statement_if();
+                StmtIf* statement_if();
                 /// @example return 1;
-                std::unique_ptr<StmtReturn> statement_return();
+                StmtReturn* statement_return();
             
 
                 /// @note rules in order of precedence <Decl>
                 /// @example var x = 1;
-                std::unique_ptr<DeclStmt> declaration_statement();
+                DeclStmt* declaration_statement();
                 /// @example mut x = 1; mut! x = 5;
-                std::unique_ptr<DeclVar> declaration_variable(bool mut);
+                DeclVar* declaration_variable(bool mut);
                 /// @example func test() {}
-                std::unique_ptr<DeclFunc> declaration_func();
+                DeclFunc* declaration_func();
+                /// @example import "lib/util.rf";
+                Import* declaration_import();
 
                 /// @example while(true) print("hi");
-                std::unique_ptr<For> for_();
+                For* for_();
 
                 /// @example { var x = 1; }
-                std::unique_ptr<Block> block();
+                Block* block();
                 /// @example func test() {}  or member.method()
-                std::unique_ptr<DeclFunc::Func> function(); 
+                DeclFunc::Func* function(); 
+                /// @brief pre-parses a body, matching its braces, parentheses and brackets up
+                ///        to (and past) its '}'
+                /// @return the body's first token
+                uint32_t skip();
                 /// @example 1, 2, 3
                 Tokens params();
                 /// @example 1+1, "str", a
-                Exprs args();
+                /// @param close the token after the last one, none are parsed if it comes first
+                Exprs args(TokenType close = TokenType::RIGHT_PAREN);
                 /// @note program
                 std::unique_ptr<Program> program();
                 
                 /// @brief Syncronizes the parser to avoid error-cascading
                 void synchronize();
                 /// @brief returns any statements that might be executed 
-                std::unique_ptr<Stmt> ret_stmt();
+                Stmt* ret_stmt();
                 /// @brief returns any declarations that might be executed
                 vec_prog ret_decl();
         };
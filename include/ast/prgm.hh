@@ -17,30 +17,67 @@
 #include <memory>
 #include <scanner/tokens.hh>
 #include <ast/grmr.hh>
+#include <ast/decl.hh>
+#include <utils/arena.hh>
+#include <utils/flat_map.hh>
+#include <utils/isolate.hh>
 
 using Tokens = std::vector<rift::scanner::Token>;
 namespace rift
 {
+    namespace vm
+    {
+        class Compiler;
+    }
+
+    namespace ir
+    {
+        class Builder;
+    }
+
     namespace ast
     {
         class Stmt;
 
-        class Program : public Accept<Tokens>
+        class Program : public Accept<Values>
         {
             public:
-                Program(vec_prog decls) : decls(std::move(decls)) {}
+                /// @param arena owns every node reachable from decls
+                Program(vec_prog decls, std::unique_ptr<Arena> arena) : decls(std::move(decls)), arena(std::move(arena)) {}
                 virtual ~Program() = default;
                 friend class Visitor;
+                friend class Parser;
+                friend class Resolver;
+                friend class Optimizer;
+                friend class rift::vm::Compiler;
+                friend class rift::ir::Builder;
 
-                Tokens accept(const Visitor &visitor) const override { return visitor.visit_program(*this); }
+                Values accept(const Visitor &visitor) const override { return visitor.visit_program(*this); }
 
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 std::string accept_printer(const Visitor& visitor) const override { return "unimplemented"; }
                 #pragma clang diagnostic pop
 
+                /// @brief arena the nodes of this program were allocated from
+                inline Arena& nodes() const { return *arena; }
+
+                /// @brief the imports at its top level, in the order they appear
+                inline const std::vector<Import*>& imports() const { return imported; }
+
+                /// @brief parses, resolves and optimizes a body the parser deferred
+                /// @note the source the program was scanned from must still be alive
+                Block* body(const DeclFunc::Func& func) const;
+
             protected:
-                vec_prog decls = nullptr;
+                vec_prog decls;
+                std::unique_ptr<Arena> arena;
+                /// @brief kept while a function body is deferred, with the isolate it is parsed in
+                std::shared_ptr<scanner::TokenBuffer> tokens;
+                Isolate* isolate = nullptr;
+                std::vector<Import*> imported;
+                /// @brief top level names by declaration order (Resolver)
+                mutable FlatMap<SymbolId, uint32_t> declared;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief marks the line a node starts on as the one currently executing (--profile)
+/// @note compiled out entirely without RIFT_PROFILER, otherwise a not-taken branch while idle
+#ifdef RIFT_PROFILER
+#define RIFT_PROFILE_LINE(node) do { if (profiler) [[unlikely]] profiler->at((node).line); } while (0)
+#else
+#define RIFT_PROFILE_LINE(node) do {} while (0)
+#endif
+
+namespace rift
+{
+    namespace ast
+    {
+        /// @class Profiler
+        /// @brief Sampling profiler for the tree evaluator
+        /// @details the evaluator keeps a shadow stack of (function, line) frames up to date,
+        ///          a SIGPROF timer copies that stack into a preallocated buffer on every tick
+        ///          and the samples are only aggregated once profiling stops
+        /// @note one profiler can be running at a time (the timer is process wide)
+        class Profiler
+        {
+            public:
+                static constexpr uint32_t MAX_DEPTH = 256;
+
+                explicit Profiler(std::chrono::microseconds interval = std::chrono::microseconds(1000));
+                ~Profiler();
+                Profiler(const Profiler&) = delete;
+                Profiler& operator=(const Profiler&) = delete;
+
+                /// @brief arms the timer, samples accumulate across start/stop pairs
+                void start();
+                /// @brief disarms the timer
+                void stop();
+
+                /// @brief the innermost frame is now executing line
+                inline void at(uint32_t line) {
+                    steps++;
+                    if (depth <= MAX_DEPTH) lines[depth - 1] = line;
+                }
+                /// @brief a call into the named function
+                void enter(const std::string& name);
+                /// @brief the innermost call returned
+                inline void leave() { if (depth > 1) depth = depth - 1; }
+
+                /// @brief samples taken so far
+                size_t samples() const { return count; }
+                /// @brief statements executed while profiling, timer or not (what tests budget work by)
+                size_t steps = 0;
+
+                /// @brief per-function and per-line tables, source is used to quote the hot lines
+                void report(std::ostream& out, std::span<const char> source = {}) const;
+                /// @brief one "fn:line;fn:line count" row per distinct stack, for flamegraph.pl & co.
+                void collapsed(std::ostream& out) const;
+
+            private:
+                /// @brief SIGPROF handler, copies the active profiler's stack out
+                static void sample(int);
+                static Profiler* active;
+
+                std::chrono::microseconds interval;
+                struct sigaction previous = {};
+
+                #pragma mark - Shadow Stack
+                // written by the evaluator, read by the signal handler
+                volatile uint32_t depth = 1;
+                volatile uint32_t fns[MAX_DEPTH] = {};
+                volatile uint32_t lines[MAX_DEPTH] = {};
+                /// @brief function names by id, 0 is the top level
+                std::vector<std::string> names = {"<main>"};
+                std::unordered_map<std::string, uint32_t> ids;
+
+                #pragma mark - Samples
+                // laid out as [depth, fn, line, fn, line, ...] per sample
+                std::unique_ptr<uint32_t[]> buffer;
+                size_t capacity = 0;
+                volatile size_t used = 0;
+                volatile size_t count = 0;
+                volatile size_t dropped = 0;
+
+                /// @brief calls fn(frames, depth) for every sample
+                template <typename F>
+                void each(F&& fn) const;
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/grmr.hh>
+#include <ast/expr.hh>
+#include <ast/stmt.hh>
+#include <ast/decl.hh>
+#include <ast/prgm.hh>
+#include <utils/flat_map.hh>
+#include <utils/symbols.hh>
+#include <string>
+#include <vector>
+
+namespace rift
+{
+    namespace ast
+    {
+        /// @class Resolver
+        /// @brief Static pass run between the parser and an engine, it gives every
+        ///        variable a lexical Address so lookups are indexed loads at runtime
+        /// @details - blocks, for loops and function bodies open a scope, the program itself doesn't
+        ///          - names not declared in an enclosing scope of the same function are globals
+        ///          - a declaration can't shadow anything visible from it
+        ///          - the programs one resolver resolves run in the same globals (a file and its
+        ///            imports), a top level variable is declared by only one of them
+        ///          - functions can't read the locals of an enclosing function (no closures yet)
+        ///          - a parallel for counts, and its body doesn't assign anything declared outside
+        ///            of it, return, spawn or await (see Visitor::parallel)
+        class Resolver : public Visitor
+        {
+            public:
+                /// @param isolate whose globals are bound to the program's top level names
+                Resolver(Isolate& isolate = Isolate::current()) { this->isolate = &isolate; }
+                ~Resolver() = default;
+
+                /// @brief resolves every variable of the program in place
+                void resolve(const Program& prgm);
+                /// @brief resolves a deferred function body once it is parsed, as if it had been
+                ///        resolved along with the rest of its program
+                void resolve(const Program& prgm, const DeclFunc::Func& func);
+
+                /* expr */
+                Value visit_assign(const Assign& expr) const override;
+                Value visit_binary(const Binary& expr) const override;
+                Value visit_grouping(const Grouping& expr) const override;
+                Value visit_literal(const Literal& expr) const override;
+                Value visit_unary(const Unary& expr) const override;
+                Value visit_ternary(const Ternary& expr) const override;
+                Value visit_call(const Call& expr) const override;
+                Value visit_spawn(const Spawn& expr) const override;
+                Value visit_await(const Await& expr) const override;
+                Value visit_array(const Array& expr) const override;
+                Value visit_index(const Index& expr) const override;
+                Value visit_set_index(const SetIndex& expr) const override;
+
+                /* stmt */
+                Value visit_expr_stmt(const StmtExpr& stmt) const override;
+                Value visit_print_stmt(const StmtPrint& stmt) const override;
+                Value visit_if_stmt(const StmtIf& stmt) const override;
+                Value visit_return_stmt(const StmtReturn& stmt) const override;
+
+                /* decl */
+                Values visit_decl_stmt(const DeclStmt& decl) const override;
+                Values visit_decl_var(const DeclVar& decl) const override;
+                Values visit_decl_func(const DeclFunc& decl) const override;
+                Values visit_import(const Import& decl) const override;
+                Values visit_for(const For& decl) const override;
+                Values visit_block_stmt(const Block& block) const override;
+                Values visit_program(const Program& prgm) const override;
+
+            private:
+                struct Local {
+                    uint32_t slot;
+                    bool is_const;
+                };
+
+                struct Scope {
+                    FlatMap<SymbolId, Local> locals;
+                    uint32_t slots = 0;
+                };
+
+                mutable std::vector<Scope> open;
+                /// @brief index of the outermost scope of the innermost function
+                mutable size_t function = 0;
+                /// @brief variables declared at the top level of this program, by declaration order
+                mutable FlatMap<SymbolId, uint32_t>* globals = nullptr;
+                /// @brief how many of them are visible, all but while resolving a deferred body
+                mutable uint32_t visible = UINT32_MAX;
+                /// @brief the programs resolved so far, this one included
+                mutable uint32_t programs = 0;
+                /// @brief which of them declared each top level variable first
+                mutable FlatMap<SymbolId, uint32_t> linked;
+                /// @brief index of the outermost scope inside the innermost parallel for's body,
+                ///        NONE outside of one
+                static constexpr size_t NONE = SIZE_MAX;
+                mutable size_t parallel = NONE;
+
+                /// @brief resolves the decls of a block into the innermost scope
+                void declarations(const Block& block) const;
+                /// @brief resolves a function's parameters and body in a scope of their own
+                void body(const DeclFunc::Func& func) const;
+                /// @brief declares a variable in the innermost scope (or as a global)
+                Address declare(const Token& name, bool is_const) const;
+                /// @brief declares a function in the innermost scope (or as a global)
+                Address declareFunc(const Token& name) const;
+                /// @brief the address of a variable visible from the innermost scope
+                Address lookup(const Token& name, bool assign) const;
+                /// @brief reports what can't be done inside a parallel for
+                void sequential(uint32_t line, const std::string& what) const;
+        };
+
+        /// @class ResolverException
+        /// @brief The base exception for the resolver
+        class ResolverException : public std::exception
+        {
+            public:
+                ResolverException(const std::string &message) : message(message) {}
+                ~ResolverException() = default;
+
+                const char *what() const noexcept override { return message.c_str(); }
+
+            private:
+                std::string message;
+        };
+    }
+}
\ No newline at end of file
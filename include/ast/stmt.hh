@@ -35,12 +35,14 @@ namespace rift
         );
 
     
-        class Stmt: public rift::ast::Accept<Token>
+        class Stmt: public rift::ast::Accept<Value>
         {
             public:
-                virtual Token accept(const Visitor &visitor) const = 0;
+                virtual Value accept(const Visitor &visitor) const = 0;
                 virtual string accept_printer(const Visitor& visitor) const = 0;
                 virtual ~Stmt() = default;
+                /// @brief the line the statement ends on (starts on, for if)
+                uint32_t line = 0;
         };
         
         /// @class StmtExpr
@@ -61,12 +63,12 @@ namespace rift
         class StmtExpr: public Stmt
         {
             public:
-                StmtExpr(std::unique_ptr<Expr> expr) : expr(std::move(expr)) {};
+                StmtExpr(Expr* expr) : expr(expr) {};
                 ~StmtExpr() = default;
-                std::unique_ptr<Expr> expr;
+                Expr* expr = nullptr;
 
 
-                Token accept(const Visitor &visitor) const override { return visitor.visit_expr_stmt(*this); };
+                Value accept(const Visitor &visitor) const override { return visitor.visit_expr_stmt(*this); };
                 
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
@@ -78,11 +80,11 @@ namespace rift
         class StmtPrint : public Stmt
         {
             public:
-                StmtPrint(std::unique_ptr<Expr>& expr) : expr(std::move(expr)) {};
+                StmtPrint(Expr* expr) : expr(expr) {};
                 ~StmtPrint() = default;
-                std::unique_ptr<Expr> expr;
+                Expr* expr = nullptr;
 
-                Token accept(const Visitor &visitor) const override { return visitor.visit_print_stmt(*this); };
+                Value accept(const Visitor &visitor) const override { return visitor.visit_print_stmt(*this); };
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 // must uncomment visit_printer in printer.hh
@@ -96,13 +98,13 @@ namespace rift
                 struct Stmt {
                     public:
                         Stmt() : expr(nullptr), stmt(nullptr), blk(nullptr) {};
-                        Stmt(std::unique_ptr<Expr> expr): expr(std::move(expr)), stmt(nullptr), blk(nullptr) {}
-                        Stmt(std::unique_ptr<Expr> expr, std::unique_ptr<rift::ast::Stmt> stmt): expr(std::move(expr)), stmt(std::move(stmt)) {}
-                        Stmt(std::unique_ptr<Expr> expr, std::unique_ptr<Block> blk): expr(std::move(expr)), blk(std::move(blk)) {}
+                        Stmt(Expr* expr): expr(expr), stmt(nullptr), blk(nullptr) {}
+                        Stmt(Expr* expr, rift::ast::Stmt* stmt): expr(expr), stmt(stmt) {}
+                        Stmt(Expr* expr, Block* blk): expr(expr), blk(blk) {}
 
-                        std::unique_ptr<Expr> expr;
-                        std::unique_ptr<rift::ast::Stmt> stmt;
-                        std::unique_ptr<Block> blk;
+                        Expr* expr = nullptr;
+                        rift::ast::Stmt* stmt = nullptr;
+                        Block* blk = nullptr;
                 };
 
             public:
@@ -111,11 +113,11 @@ namespace rift
                 StmtIf(Stmt* if_stmt, Stmt* else_stmt): if_stmt(if_stmt), else_stmt(else_stmt) {};
                 StmtIf(Stmt* if_stmt, Stmt* else_stmt, std::vector<Stmt*> elif_stmts): if_stmt(if_stmt), else_stmt(else_stmt), elif_stmts(elif_stmts) {};
 
-                Stmt* if_stmt;
-                Stmt* else_stmt;
+                Stmt* if_stmt = nullptr;
+                Stmt* else_stmt = nullptr;
                 std::vector<Stmt*> elif_stmts;
 
-                Token accept(const Visitor &visitor) const override { return visitor.visit_if_stmt(*this); };
+                Value accept(const Visitor &visitor) const override { return visitor.visit_if_stmt(*this); };
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 // must uncomment visit_printer in printer.hh
@@ -126,11 +128,11 @@ namespace rift
         class StmtReturn : public Stmt
         {
             public:
-                StmtReturn(std::unique_ptr<Expr> expr): expr(std::move(expr)) {};
+                StmtReturn(Expr* expr): expr(expr) {};
                 ~StmtReturn() = default;
-                std::unique_ptr<Expr> expr;
+                Expr* expr = nullptr;
 
-                Token accept(const Visitor &visitor) const override { return visitor.visit_return_stmt(*this); };
+                Value accept(const Visitor &visitor) const override { return visitor.visit_return_stmt(*this); };
                 #pragma clang diagnostic push
                 #pragma clang diagnostic ignored "-Wunused-parameter"
                 // must uncomment visit_printer in printer.hh
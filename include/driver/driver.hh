@@ -20,10 +20,24 @@
 #include <readline/readline.h>
 #include <readline/history.h>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <deque>
+#include <vector>
+#include <driver/stats.hh>
+#include <driver/modules.hh>
+#include <ast/profiler.hh>
+#include <utils/isolate.hh>
 
 namespace rift
 {
+    class MappedFile;
+    namespace ast { class Program; class Eval; }
+    namespace vm { class VM; }
+    namespace ir { class Module; class PassManager; }
+
     namespace driver
     {
         
@@ -31,14 +45,40 @@ namespace rift
             {"help",        no_argument,       0,  'h' },
             {"version",     no_argument,       0,  'v' },
             {"interactive", no_argument,       0,  'i' },
+            {"engine",      required_argument, 0,  'e' },
+            {"stats",       optional_argument, 0,  's' },
+            {"profile",     optional_argument, 0,  'p' },
+            {"no-cache",    no_argument,       0,  'n' },
+            {"dump-ir",     optional_argument, 0,  'd' },
+            {"workers",     required_argument, 0,  'w' },
+            {"emit",        required_argument, 0,  'x' },
+            {"output",      required_argument, 0,  'o' },
             {nullptr, 0, nullptr, 0}
         };
 
+        /// @brief The execution engine used to run a program
+        enum class Engine
+        {
+            TREE,  // reference tree-walking evaluator
+            VM,    // bytecode compiler + stack vm
+            TIERED // tree-walking evaluator compiling hot numeric functions to native code
+        };
+
+        /// @brief What --emit compiles a file to, instead of running it (see vm::Image)
+        enum class Emit
+        {
+            NONE, // run the file
+            OBJ,  // an image riftlang runs without the source (foo.rfo)
+            EXE   // a copy of this executable running the image at startup (foo)
+        };
+
         class Driver
         {
             public:
-                Driver() = default;
-                ~Driver() = default;
+                Driver();
+                /// @param emit what files are compiled to unless --emit says otherwise (riftc)
+                explicit Driver(Emit emit);
+                ~Driver();
 
                 /// @brief Parses the command line arguments.
                 /// @param argc The number of arguments.
@@ -58,8 +98,71 @@ namespace rift
                 /// @brief Runs the compiler
                 void runFile(std::string path);
 
+                /// @brief Runs the image appended to this executable, if it has one
+                /// @return false when it has none, the command line is parsed then
+                bool runEmbedded();
+                /// @brief Runs the scripts of an image on the vm
+                /// @param from where the image was read, named when it can't be run
+                void runImage(std::span<const char> image, const std::string& from);
+
                 /// @brief Runs the interpreter
                 void runPrompt();
+                /// @brief Loads a file into the prompt session before the first line is read
+                void runPrelude(std::string path);
+
+                /// @brief Scans, parses, resolves and evaluates one program (or prompt line)
+                /// @param source must outlive the program, which is dropped after the run unless interactive
+                /// @param interactive keep the program, later prompt lines may call its functions
+                /// @param file the path source was read from, its compiled script is cached (vm only)
+                void run(std::span<const char> source, bool interactive, const std::string& file = {});
+
+                /// @brief Writes the image compiled from file as --emit asked
+                void write(std::string_view image, const std::string& file);
+
+                /// @brief Prints (or writes) the collected stats and profile, if any
+                /// @param source the program that ran, quoted next to its hot lines
+                void report(std::span<const char> source);
+
+                /// @brief Prints (or appends) the optimized IR of a program for --dump-ir
+                void dump(const rift::ir::Module& module, const rift::ir::PassManager& passes);
+
+                /// @brief The engine selected with --engine
+                Engine engine = Engine::TREE;
+                /// @brief Whether files run on the vm use the script cache, off with --no-cache
+                bool caching = true;
+                /// @brief Set by --emit, files are compiled and written instead of run
+                Emit emit = Emit::NONE;
+                /// @brief Where --output has --emit write, next to the file otherwise
+                std::string output;
+                /// @brief Collected when --stats is given
+                std::unique_ptr<Stats> stats;
+                /// @brief Where --stats=<file> writes JSON, stderr gets a summary otherwise
+                std::string stats_path;
+                /// @brief Sampling the tree evaluator when --profile is given
+                std::unique_ptr<rift::ast::Profiler> profiler;
+                /// @brief Where --profile=<file> writes collapsed stacks
+                std::string profile_path;
+                /// @brief Whether every program is lowered to IR and printed, set by --dump-ir
+                bool dumping = false;
+                /// @brief Where --dump-ir=<file> appends the IR, stderr gets it otherwise
+                std::string ir_path;
+
+                /// @brief Everything the programs run by this driver share, nothing outlives it
+                Isolate isolate;
+                /// @brief Imported files, compiled once unless they change (prompt lines import too)
+                Modules modules{isolate};
+                /// @brief Created on first use, globals persist across prompt lines
+                std::unique_ptr<rift::vm::VM> vm;
+                /// @brief Created on first use, its frame pool is reused by every prompt line
+                std::unique_ptr<rift::ast::Eval> eval;
+                /// @brief Functions declared on a prompt line point into that line's arena
+                std::vector<std::unique_ptr<rift::ast::Program>> session;
+                /// @brief The text of every prompt line and prelude, deferred bodies are parsed from it
+                std::deque<std::string> lines;
+                /// @brief Preludes stay mapped for the same reason
+                std::vector<std::unique_ptr<MappedFile>> files;
+                /// @brief --profile was given for the vm engine and said so
+                bool warned = false;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+#include <utils/isolate.hh>
+#include <utils/scheduler.hh>
+
+namespace rift
+{
+    class MappedFile;
+    namespace ast { class Program; }
+
+    namespace driver
+    {
+        class Modules;
+
+        /// @class Module
+        /// @brief A file brought in by an import, scanned and parsed on its own (on a worker)
+        /// @note a module has a heap of its own for its literals, the isolate's heap is only
+        ///       touched by the thread running the programs
+        class Module : public Scheduler::Task
+        {
+            public:
+                Module(Modules& modules, std::filesystem::path path, std::filesystem::file_time_type mtime);
+                ~Module() override;
+
+                /// @brief absolute, what the module is cached by (with mtime)
+                const std::filesystem::path path;
+                /// @brief when the file was last written as of the compile
+                const std::filesystem::file_time_type mtime;
+
+                /// @brief where its literals and folded constants live, as long as the module
+                Heap heap;
+                std::unique_ptr<MappedFile> file;
+                std::unique_ptr<ast::Program> program;
+                /// @brief the modules its imports name, in the order they appear
+                std::vector<Module*> imports;
+
+                /// @brief tokens scanned and nodes made, for --stats
+                size_t tokens = 0;
+                std::map<std::type_index, size_t> kinds;
+                /// @brief what compiling it raised, empty if it compiled
+                std::string error;
+
+                /// @brief scans and parses the file, then requests its imports
+                void run() override;
+
+            private:
+                friend class Modules;
+                Modules& modules;
+                /// @brief the load that last reached the module
+                uint64_t seen = 0;
+                /// @brief whether the program already ran in the isolate
+                bool ran = false;
+        };
+
+        /// @class Modules
+        /// @brief The files programs import, cached by absolute path and modification time
+        /// @details loading a program requests its imports: a module that isn't cached, or
+        ///          whose file changed since, is compiled on Scheduler::shared() and requests
+        ///          its own imports from there, so every file of the tree is scanned and parsed
+        ///          at once. Only then, back on the calling thread, the imports are checked for
+        ///          cycles and errors and linked: the modules still to run are returned in the
+        ///          order they have to run in, each after everything it imports
+        /// @note every module shares the isolate's globals, an import doesn't open a namespace
+        class Modules
+        {
+            public:
+                explicit Modules(Isolate& isolate) : isolate(isolate) {}
+                ~Modules();
+                Modules(const Modules&) = delete;
+                Modules& operator=(const Modules&) = delete;
+
+                /// @brief compiles everything program imports, directly or not
+                /// @param from the directory imports of program are relative to
+                /// @param self the file program was read from, empty for a prompt line
+                /// @return the modules to resolve and run before program, dependencies first,
+                ///         those that already ran and didn't change since are left out
+                std::vector<Module*> load(const ast::Program& program, const std::filesystem::path& from, const std::filesystem::path& self = {});
+                /// @brief optimizes the (resolved) programs of modules and program at once
+                void optimize(const std::vector<Module*>& modules, const ast::Program& program);
+
+                /// @brief tally the nodes each module parses into Module::kinds (--stats)
+                bool counting = false;
+                /// @brief modules in the cache
+                inline size_t size() const { return cache.size(); }
+
+            private:
+                friend class Module;
+                Isolate& isolate;
+                std::mutex lock;
+                std::map<std::filesystem::path, std::unique_ptr<Module>> cache;
+                /// @brief modules whose file changed, the values they made may still be around
+                std::vector<std::unique_ptr<Module>> retired;
+                /// @brief counts loads, a module is expanded once per load (see Module::seen)
+                uint64_t generation = 0;
+                /// @brief the group of the load in progress
+                Scheduler::Group* group = nullptr;
+
+                /// @brief the module at path, compiling it (on the scheduler) unless it is cached
+                Module* request(const std::filesystem::path& path);
+                /// @brief links the imports of program, relative to from, to their modules
+                void expand(const ast::Program& program, const std::filesystem::path& from, std::vector<Module*>& into);
+                /// @brief the absolute path an import names
+                static std::filesystem::path resolve(const std::filesystem::path& from, const std::string& name);
+        };
+    }
+}
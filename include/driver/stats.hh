@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <vector>
+#include <utils/alloc.hh>
+#include <utils/value.hh>
+
+namespace rift
+{
+    namespace driver
+    {
+        /// @class Stats
+        /// @brief What a run cost, collected by the driver for --stats
+        /// @note allocations are counted through the alloc hook, which is only switched
+        ///       on while a phase is being timed
+        class Stats
+        {
+            public:
+                struct Phase
+                {
+                    std::string name;
+                    double seconds = 0;
+                    alloc::Counts heap = {};
+                };
+
+                /// @brief the phases in the order they ran
+                std::vector<Phase> phases;
+                /// @brief tokens scanned, including the trailing EOF
+                size_t tokens = 0;
+                /// @brief AST nodes built, by node type
+                std::map<std::type_index, size_t> kinds;
+                /// @brief deepest the scopes (tree) or call frames (vm) got
+                size_t depth = 0;
+                /// @brief the runtime heap once the run is over
+                Heap::Stats gc = {};
+
+                /// @brief runs fn as the named phase, recording its wall time and heap traffic
+                template <typename F>
+                decltype(auto) time(const std::string& name, F&& fn)
+                {
+                    Timer timer(*this, name);
+                    return fn();
+                }
+
+                /// @brief total number of AST nodes
+                size_t nodes() const;
+
+                /// @brief human readable summary
+                void print(std::ostream& out) const;
+                /// @brief the same summary as a JSON object
+                void json(std::ostream& out) const;
+
+                /// @brief readable node type name (Binary, DeclVar, ...)
+                static std::string kind(const std::type_index& type);
+
+            private:
+                /// @brief records a phase when it goes out of scope, even if fn throws
+                struct Timer
+                {
+                    Timer(Stats& stats, const std::string& name);
+                    ~Timer();
+
+                    Stats& stats;
+                    Phase phase;
+                    bool tracked;
+                    alloc::Counts heap;
+                    std::chrono::steady_clock::time_point start;
+                };
+        };
+    }
+}
\ No newline at end of file
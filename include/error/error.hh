@@ -15,6 +15,7 @@
 #pragma once
 
 // #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <scanner/tokens.hh>
 
@@ -22,9 +23,32 @@ namespace rift
 {
     namespace error
     {
-        [[maybe_unused]] static bool errorOccured = false;
-        [[maybe_unused]] static bool runtimeErrorOccured = false;
+        /// @class Error
+        /// @brief What report and runTimeError throw instead of exiting, when the current
+        ///        isolate raises its errors (see Isolate::Errors::raise)
+        class Error : public std::runtime_error
+        {
+            public:
+                Error(const std::string& message, bool runtime) : std::runtime_error(message), runtime(runtime) {}
+                /// @brief false for errors found while compiling
+                bool runtime;
+        };
 
+        /// @class Raise
+        /// @brief While one is alive, errors on its thread are thrown as Error without
+        ///        touching any isolate (a worker's, see ast::Worker)
+        class Raise
+        {
+            public:
+                Raise();
+                ~Raise();
+                Raise(const Raise&) = delete;
+                Raise& operator=(const Raise&) = delete;
+            private:
+                bool previous;
+        };
+
+        // errors are marked on the current isolate (see Isolate::errors)
         /// @brief Used to report an error.
         void report(int line, std::string_view where, std::string msg, const rift::scanner::Token& token, std::exception e);
         /// @brief Used to report an runtime error.
@@ -0,0 +1,130 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/grmr.hh>
+#include <ast/expr.hh>
+#include <ast/stmt.hh>
+#include <ast/decl.hh>
+#include <ast/prgm.hh>
+#include <ir/ir.hh>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace rift
+{
+    namespace ir
+    {
+        using namespace rift::ast;
+
+        /// @class Builder
+        /// @brief Lowers a resolved Program into SSA form by visiting the AST once
+        /// @details Locals become SSA values as they are assigned, phis are placed on the fly
+        ///          (Braun et al., "Simple and Efficient Construction of Static Single
+        ///          Assignment Form"), globals stay loads and stores. Every function the
+        ///          program declares is lowered too, deferred bodies are parsed for it.
+        class Builder : public Visitor
+        {
+            public:
+                Builder() = default;
+                ~Builder() = default;
+
+                /// @brief lowers the program and every function it declares
+                std::unique_ptr<Module> build(const Program& prgm);
+
+                /* expr */
+                Value visit_assign(const Assign& expr) const override;
+                Value visit_binary(const Binary& expr) const override;
+                Value visit_grouping(const Grouping& expr) const override;
+                Value visit_literal(const Literal& expr) const override;
+                Value visit_unary(const Unary& expr) const override;
+                Value visit_ternary(const Ternary& expr) const override;
+                Value visit_call(const Call& expr) const override;
+                Value visit_spawn(const Spawn& expr) const override;
+                Value visit_await(const Await& expr) const override;
+                Value visit_array(const Array& expr) const override;
+                Value visit_index(const Index& expr) const override;
+                Value visit_set_index(const SetIndex& expr) const override;
+
+                /* stmt */
+                Value visit_expr_stmt(const StmtExpr& stmt) const override;
+                Value visit_print_stmt(const StmtPrint& stmt) const override;
+                Value visit_if_stmt(const StmtIf& stmt) const override;
+                Value visit_return_stmt(const StmtReturn& stmt) const override;
+
+                /* decl */
+                Values visit_decl_stmt(const DeclStmt& decl) const override;
+                Values visit_decl_var(const DeclVar& decl) const override;
+                Values visit_decl_func(const DeclFunc& decl) const override;
+                Values visit_for(const For& decl) const override;
+                Values visit_block_stmt(const ast::Block& block) const override;
+                Values visit_program(const Program& prgm) const override;
+
+            private:
+                mutable Module* module = nullptr;
+                mutable Function* fn = nullptr;
+                /// @brief where the next instruction goes
+                mutable ir::Block* current = nullptr;
+                /// @brief the value of the last visited expression
+                mutable Inst* result = nullptr;
+                /// @brief first variable of each open scope of the current function
+                mutable std::vector<uint32_t> scopes;
+                /// @brief variables taken by the open scopes of the current function
+                mutable uint32_t locals = 0;
+
+                #pragma mark - SSA construction
+
+                /// @brief the definition of each variable at the end of a block
+                mutable std::unordered_map<const ir::Block*, std::unordered_map<uint32_t, Inst*>> defs;
+                /// @brief phis of blocks whose predecessors aren't all known yet
+                mutable std::unordered_map<const ir::Block*, std::vector<std::pair<uint32_t, Inst*>>> incomplete;
+                mutable std::unordered_set<const ir::Block*> sealed;
+                /// @brief trivial phis that were removed, and what replaced them
+                mutable std::unordered_map<const Inst*, Inst*> forwarded;
+
+                void write(uint32_t var, ir::Block* block, Inst* val) const;
+                Inst* read(uint32_t var, ir::Block* block) const;
+                Inst* readRecursive(uint32_t var, ir::Block* block) const;
+                Inst* addPhiOperands(uint32_t var, Inst* phi) const;
+                Inst* tryRemoveTrivialPhi(Inst* phi) const;
+                /// @brief no more predecessors will be added to block
+                void seal(ir::Block* block) const;
+
+                #pragma mark - Emitters
+
+                /// @brief lowers expr and returns its value
+                Inst* value(const Expr& expr) const;
+                Inst* constant(Value val) const;
+                inline Inst* emit(Op op, Type type, std::vector<Inst*> operands = {}) const { return fn->append(current, op, type, std::move(operands)); }
+                /// @brief true when the current block already ended (code after a return)
+                inline bool terminated() const { return current->terminator() != nullptr; }
+                /// @brief continues in a new block nothing jumps to, pruned once the function is done
+                void unreachable() const;
+                /// @brief a phi joining one value per predecessor of the current block
+                Inst* join(std::vector<Inst*> vals, Type type) const;
+                /// @brief lowers a branch of an if/elif/else (either a stmt or a block)
+                void branch(const StmtIf::Stmt& branch) const;
+                /// @brief lowers a declared function into its own ir::Function
+                void function(const DeclFunc::Func& func) const;
+
+                #pragma mark - Locals
+
+                void beginScope(uint32_t n) const;
+                inline void endScope() const { locals = scopes.back(); scopes.pop_back(); }
+                /// @brief the variable of a resolved local, unique among the open scopes
+                inline uint32_t variable(const Address& addr) const { return scopes[scopes.size() - 1 - addr.depth] + addr.slot; }
+        };
+    }
+}
\ No newline at end of file
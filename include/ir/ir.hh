@@ -0,0 +1,218 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/decl.hh>
+#include <utils/value.hh>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// @note every instruction is listed once here, the enum and the names used by
+///       the printer are both generated from this list
+#define RIFT_IR_OPS(X)          \
+    /* values */                \
+    X(CONST)                    \
+    X(PARAM)                    \
+    X(PHI)                      \
+    X(FUNC)                     \
+    /* generic arithmetic */    \
+    X(ADD)                      \
+    X(SUB)                      \
+    X(MUL)                      \
+    X(DIV)                      \
+    X(LT)                       \
+    X(LE)                       \
+    X(GT)                       \
+    X(GE)                       \
+    X(EQ)                       \
+    X(NE)                       \
+    X(NEG)                      \
+    X(NOT)                      \
+    X(BOOL)                     \
+    /* numbers only */          \
+    X(NADD)                     \
+    X(NSUB)                     \
+    X(NMUL)                     \
+    X(NDIV)                     \
+    X(NLT)                      \
+    X(NLE)                      \
+    X(NGT)                      \
+    X(NGE)                      \
+    X(NEQ)                      \
+    X(NNE)                      \
+    /* effects */               \
+    X(LOAD_GLOBAL)              \
+    X(STORE_GLOBAL)             \
+    X(CALL)                     \
+    X(SPAWN)                    \
+    X(AWAIT)                    \
+    X(ARRAY)                    \
+    X(INDEX)                    \
+    X(SET_INDEX)                \
+    X(PRINT)                    \
+    /* terminators */           \
+    X(JUMP)                     \
+    X(BRANCH)                   \
+    X(RETURN)
+
+namespace rift
+{
+    namespace ir
+    {
+        /// @enum Op
+        /// @brief What an instruction computes
+        /// @details operands are always other instructions, anything else is a field
+        ///          - CONST: constant, PARAM: index, FUNC: func
+        ///          - LOAD_GLOBAL: index, STORE_GLOBAL: index, constant is a bool for a declaration (true
+        ///            for a constant) and undefined for an assignment
+        ///          - CALL, SPAWN: callee followed by the arguments, AWAIT: the task
+        ///          - ARRAY: the elements, INDEX: array and index, SET_INDEX: array, index and value
+        ///          - JUMP, BRANCH: the targets are the successors of the block
+        enum class Op : uint8_t
+        {
+            #define __RIFT_IR_ENUM(name) name,
+            RIFT_IR_OPS(__RIFT_IR_ENUM)
+            #undef __RIFT_IR_ENUM
+        };
+
+        /// @brief lowercase name of an op, as printed
+        extern const char* name(Op op);
+
+        /// @enum Type
+        /// @brief What is known about a value, NONE is nothing yet (while inferring)
+        enum class Type : uint8_t
+        {
+            NONE,
+            NUMBER,
+            BOOL,
+            STRING,
+            NIL,
+            FUNCTION,
+            ANY
+        };
+
+        /// @brief the type of a value that is either a or b
+        inline Type join(Type a, Type b) { return a == Type::NONE ? b : b == Type::NONE || a == b ? a : Type::ANY; }
+        extern const char* name(Type type);
+
+        class Block;
+
+        /// @class Inst
+        /// @brief An instruction, which is also the SSA value it defines
+        class Inst
+        {
+            public:
+                Inst(Op op, Type type, uint32_t id) : op(op), type(type), id(id) {}
+
+                Op op;
+                Type type;
+                /// @brief unique within the function, printed as %id
+                uint32_t id;
+                Block* block = nullptr;
+                std::vector<Inst*> operands;
+                /// @brief every instruction with this one as an operand (once per use)
+                std::vector<Inst*> users;
+
+                Value constant = Value::undefined();
+                uint32_t index = 0;
+                const ast::DeclFunc::Func* func = nullptr;
+                /// @brief the global or parameter name, only for printing
+                std::string label;
+
+                /// @brief true for an instruction the block has to end with
+                inline bool terminator() const { return op == Op::JUMP || op == Op::BRANCH || op == Op::RETURN; }
+        };
+
+        /// @class Block
+        /// @brief A basic block, phis first and exactly one terminator last
+        class Block
+        {
+            public:
+                Block(uint32_t id) : id(id) {}
+
+                uint32_t id;
+                std::vector<Inst*> insts;
+                /// @note phi operands are in the order of preds
+                std::vector<Block*> preds;
+                std::vector<Block*> succs;
+                /// @brief immediate dominator, filled in by Function::dominators (nullptr for the entry)
+                Block* idom = nullptr;
+
+                inline Inst* terminator() const { return insts.empty() || !insts.back()->terminator() ? nullptr : insts.back(); }
+        };
+
+        /// @class Function
+        /// @brief The blocks of one function, or of the top level code
+        class Function
+        {
+            public:
+                Function(std::string name, uint32_t arity) : name(std::move(name)), arity(arity) {}
+
+                std::string name;
+                uint32_t arity;
+                /// @note blocks[0] is the entry
+                std::vector<std::unique_ptr<Block>> blocks;
+
+                /// @brief a new empty block
+                Block* block();
+                /// @brief a new instruction at the end of block (or before its terminator)
+                Inst* append(Block* block, Op op, Type type, std::vector<Inst*> operands = {});
+                /// @brief a new phi at the start of block, without operands
+                Inst* phi(Block* block);
+                void addOperand(Inst* inst, Inst* operand);
+                /// @brief ends from with a jump to to
+                Inst* jump(Block* from, Block* to);
+                /// @brief ends from with a branch to then when cond is truthy, to other otherwise
+                Inst* branch(Block* from, Inst* cond, Block* then, Block* other);
+                /// @brief points every use of from at to, from is left without users
+                void replace(Inst* from, Inst* to);
+                /// @brief takes inst out of its block, it must have no users
+                void remove(Inst* inst);
+                /// @brief moves inst to the end of block, before its terminator
+                void move(Inst* inst, Block* block);
+                /// @brief drops the blocks that can't be reached from the entry
+                void prune();
+
+                /// @brief the blocks in reverse post order from the entry
+                std::vector<Block*> rpo() const;
+                /// @brief fills in Block::idom
+                void dominators();
+                /// @brief true when a dominates b (after dominators)
+                bool dominates(const Block* a, const Block* b) const;
+
+                std::string print() const;
+
+            private:
+                /// @note a deque, instructions are referenced by pointer
+                std::deque<Inst> insts;
+                uint32_t next_block = 0;
+        };
+
+        /// @class Module
+        /// @brief The top level code of a program and every function it declares
+        class Module
+        {
+            public:
+                /// @note functions[0] is the top level code
+                std::vector<std::unique_ptr<Function>> functions;
+
+                /// @brief the textual form, as shown by --dump-ir
+                std::string print() const;
+        };
+    }
+}
\ No newline at end of file
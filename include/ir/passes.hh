@@ -0,0 +1,104 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ir/ir.hh>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rift
+{
+    namespace ir
+    {
+        /// @class Pass
+        /// @brief A transformation of one function, run by the PassManager
+        class Pass
+        {
+            public:
+                virtual ~Pass() = default;
+                virtual const char* name() const = 0;
+                /// @brief transforms fn in place
+                /// @return how many instructions were rewritten, moved or removed
+                virtual size_t run(Function& fn) = 0;
+        };
+
+        /// @class PassManager
+        /// @brief Runs its passes in order over every function of a module
+        class PassManager
+        {
+            public:
+                /// @brief type specialization, global value numbering, loop invariant code
+                ///        motion and dead store elimination, in that order
+                static PassManager standard();
+
+                inline PassManager& add(std::unique_ptr<Pass> pass) { passes.push_back(std::move(pass)); return *this; }
+                void run(Module& module);
+
+                /// @brief what each pass changed in the last run, summed over the functions
+                std::vector<std::pair<std::string, size_t>> changes;
+
+            private:
+                std::vector<std::unique_ptr<Pass>> passes;
+        };
+
+        #pragma mark - Passes
+
+        /// @class TypeSpecialization
+        /// @brief Infers the types of values and rewrites the arithmetic whose operands are
+        ///        always numbers to the number only instructions
+        /// @note optimistic, phis start out as NONE so a loop carried number stays a number
+        class TypeSpecialization : public Pass
+        {
+            public:
+                inline const char* name() const override { return "types"; }
+                size_t run(Function& fn) override;
+        };
+
+        /// @class GlobalValueNumbering
+        /// @brief Replaces a pure instruction by an identical one that dominates it
+        class GlobalValueNumbering : public Pass
+        {
+            public:
+                inline const char* name() const override { return "gvn"; }
+                size_t run(Function& fn) override;
+        };
+
+        /// @class LoopInvariantCodeMotion
+        /// @brief Moves what a loop computes the same way on every iteration into the block
+        ///        the loop is entered from
+        /// @note only instructions that can't fail are moved, a loop that never runs its
+        ///       body must not report an error it wouldn't have
+        class LoopInvariantCodeMotion : public Pass
+        {
+            public:
+                inline const char* name() const override { return "licm"; }
+                size_t run(Function& fn) override;
+        };
+
+        /// @class DeadStoreElimination
+        /// @brief Drops assignments to a global that are overwritten before anything could
+        ///        read them, then the local definitions nothing uses
+        class DeadStoreElimination : public Pass
+        {
+            public:
+                inline const char* name() const override { return "dse"; }
+                size_t run(Function& fn) override;
+        };
+
+        /// @brief true for an instruction with no effects that can't fail
+        extern bool safe(const Inst* inst);
+    }
+}
\ No newline at end of file
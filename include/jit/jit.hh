@@ -0,0 +1,229 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/grmr.hh>
+#include <ast/expr.hh>
+#include <ast/stmt.hh>
+#include <ast/decl.hh>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rift
+{
+    namespace jit
+    {
+        using namespace rift::ast;
+
+        /// @brief calls plus loop iterations after which an interpreted function is compiled
+        static constexpr uint32_t HOT = 1000;
+        /// @brief failed entry guards after which a function goes back to the interpreter for good
+        static constexpr uint16_t MAX_DEOPTS = 16;
+        /// @brief most parameters a compiled function can take
+        static constexpr uint32_t MAX_ARGS = 32;
+
+        /// @brief what compiled code returns, value in xmm0 and overflowed in rax
+        /// @note the code never calls back into C++ (nor throws through its frames, which
+        ///       have no unwind info), an overflow just returns through every native frame
+        struct Result
+        {
+            double value;
+            uint64_t overflowed;
+        };
+
+        /// @brief compiled code, args holds the unboxed parameters and budget the
+        ///        calls that may still be made before the stack overflows
+        using Entry = Result (*)(const double* args, size_t budget);
+
+        /// @class Code
+        /// @brief Machine code for one function, in its own executable mapping
+        /// @note nothing inside the code is guarded, everything it reads is a number
+        ///       once the entry guards passed (see Visitor::native)
+        class Code
+        {
+            public:
+                ~Code();
+                Code(const Code&) = delete;
+                Code& operator=(const Code&) = delete;
+
+                /// @brief compiles the body of fn, nullptr if it does anything but arithmetic,
+                ///        comparisons, locals, control flow and calls to itself
+                /// @param self the global fn is bound to, calls through it jump straight back in
+                static std::unique_ptr<Code> compile(const ObjCallable& fn, uint32_t self);
+                /// @brief true when this build has a backend for the host
+                static bool supported();
+
+                inline Entry entry() const { return reinterpret_cast<Entry>(mem); }
+                /// @brief bytes of code and constants
+                inline size_t size() const { return len; }
+
+            private:
+                Code(void* mem, size_t len) : mem(mem), len(len) {}
+                void* mem;
+                size_t len;
+        };
+
+        /// @struct Tier
+        /// @brief How a function is run by the tiered engine, kept on the function itself
+        struct Tier
+        {
+            enum class State : uint8_t
+            {
+                INTERPRETED, // counting calls and back edges
+                NATIVE,      // compiled, entered whenever the guards hold
+                GENERIC      // not compilable (or deoptimized too often), interpreted from now on
+            };
+
+            State state = State::INTERPRETED;
+            /// @brief calls and loop back edges seen so far
+            uint32_t hotness = 0;
+            /// @brief type feedback, cleared once any call passed something other than numbers
+            bool numeric = true;
+            /// @brief entry guards that failed since the function was compiled
+            uint16_t deopts = 0;
+            /// @brief the global the function was called through when compiled
+            uint32_t self = Address::GLOBAL;
+            std::unique_ptr<Code> code;
+        };
+
+        /// @class Compiler
+        /// @brief Lowers a function body into x86-64 by visiting the AST once
+        /// @details Numbers are kept unboxed in xmm0 and booleans as 0/1 in eax, every visit
+        ///          returns a Value of the kind it left behind (only used for type checking).
+        ///          Locals live in the native frame, temporaries are spilled to the stack.
+        class Compiler : public Visitor
+        {
+            public:
+                Compiler(uint32_t self) : self(self) {}
+                ~Compiler() = default;
+
+                /// @brief the code for fn followed by its constants, throws JitException if unsupported
+                std::vector<uint8_t> compile(const ObjCallable& fn);
+
+                /* expr */
+                Value visit_assign(const Assign& expr) const override;
+                Value visit_binary(const Binary& expr) const override;
+                Value visit_grouping(const Grouping& expr) const override;
+                Value visit_literal(const Literal& expr) const override;
+                Value visit_unary(const Unary& expr) const override;
+                Value visit_ternary(const Ternary& expr) const override;
+                Value visit_call(const Call& expr) const override;
+                Value visit_spawn(const Spawn& expr) const override;
+                Value visit_await(const Await& expr) const override;
+                Value visit_array(const Array& expr) const override;
+                Value visit_index(const Index& expr) const override;
+                Value visit_set_index(const SetIndex& expr) const override;
+
+                /* stmt */
+                Value visit_expr_stmt(const StmtExpr& stmt) const override;
+                Value visit_print_stmt(const StmtPrint& stmt) const override;
+                Value visit_if_stmt(const StmtIf& stmt) const override;
+                Value visit_return_stmt(const StmtReturn& stmt) const override;
+
+                /* decl */
+                Values visit_decl_stmt(const DeclStmt& decl) const override;
+                Values visit_decl_var(const DeclVar& decl) const override;
+                Values visit_decl_func(const DeclFunc& decl) const override;
+                Values visit_for(const For& decl) const override;
+                Values visit_block_stmt(const Block& block) const override;
+                Values visit_program(const Program& prgm) const override;
+
+            private:
+                /// @brief a jump target, bound once its position is known
+                struct Label {
+                    size_t pos = SIZE_MAX;
+                    std::vector<size_t> fixups;
+                };
+                /// @brief where an xmm operand lives
+                struct Mem {
+                    enum Kind : uint8_t { FRAME, ARGS, STACK, CONST } kind;
+                    int32_t disp;
+                };
+
+                uint32_t self;
+                /// @brief parameters of the function being compiled
+                uint32_t arity = 0;
+                mutable std::vector<uint8_t> code;
+                mutable std::vector<double> constants;
+                /// @brief rip relative operands, (end of the displacement, constant)
+                mutable std::vector<std::pair<size_t, size_t>> pool;
+                /// @brief the epilogue, every return jumps there
+                mutable Label exit;
+                /// @brief the epilogue past clearing rax, an overflow returns through it
+                mutable Label unwind;
+                /// @brief first frame slot of each open scope
+                mutable std::vector<uint32_t> scopes;
+                /// @brief frame slots taken by the open scopes, and the most ever taken (reserved by the prologue)
+                mutable uint32_t locals = 0, reserved = 0;
+
+                #pragma mark - Emitters
+
+                inline void emit(std::initializer_list<uint8_t> bytes) const { code.insert(code.end(), bytes); }
+                void emit32(uint32_t val) const;
+                /// @brief an sse instruction on two registers
+                void sse(uint8_t prefix, uint8_t op, int reg, int rm) const;
+                /// @brief an sse instruction with a memory operand
+                void sse(uint8_t prefix, uint8_t op, int reg, Mem mem) const;
+                /// @brief jmp (or jcc when cc is set) to label
+                void jump(Label& label, uint8_t cc = 0) const;
+                void bind(Label& label) const;
+                /// @brief a deduplicated constant
+                Mem constant(double val) const;
+                /// @brief the memory holding expr if it needs no code to evaluate
+                bool operand(const Expr& expr, Mem& mem) const;
+                /// @brief pushes xmm0, and pops it into xmm reg
+                void spill() const;
+                void unspill(int reg) const;
+                /// @brief evaluates expr, which has to leave a number in xmm0
+                void number(const Expr& expr) const;
+                /// @brief left into xmm0 and right into xmm1
+                void operands(const Binary& expr) const;
+                /// @brief compares the operands into the flags, false (emitting nothing) for other operators
+                bool compare(const Binary& expr) const;
+                /// @brief evaluates a condition and jumps to label when it is false
+                void branch(const Expr& cond, Label& label) const;
+                /// @brief compiles a branch of an if/elif/else (either a stmt or a block)
+                void branch(const StmtIf::Stmt& branch) const;
+
+                #pragma mark - Locals
+
+                void beginScope(uint32_t n) const;
+                inline void endScope() const { locals = scopes.back(); scopes.pop_back(); }
+                /// @brief the frame memory of a resolved local
+                inline Mem local(const Address& addr) const {
+                    auto slot = scopes[scopes.size() - 1 - addr.depth] + addr.slot;
+                    return {Mem::FRAME, -24 - 8 * static_cast<int32_t>(slot)};
+                }
+        };
+
+        /// @class JitException
+        /// @brief Raised while compiling a function the backend can't handle
+        class JitException : public std::exception
+        {
+            public:
+                JitException(const std::string &message) : message(message) {}
+                ~JitException() = default;
+
+                const char *what() const noexcept override { return message.c_str(); }
+
+            private:
+                std::string message;
+        };
+    }
+}
\ No newline at end of file
@@ -17,6 +17,8 @@
 
 #include <error/error.hh>
 #include <exception>
+#include <span>
+#include <stdexcept>
 #include <string>
 
 namespace rift
@@ -26,53 +28,81 @@ namespace rift
 
         class ReaderException;
 
+        /// @brief readers bound check every access when set (-DRIFT_CHECKED_READER=ON), for
+        ///        debugging a source that breaks the sentinel contract below
+        #ifdef RIFT_CHECKED_READER
+        inline constexpr bool checked = true;
+        #else
+        inline constexpr bool checked = false;
+        #endif
+
         /// @class Reader
         /// @tparam T The type of the reader <Token(Parser), Char(Scanner)>
         /// @brief The base class for reading through lines with utilities
+        /// @details the source is terminated by a sentinel: source[source.size()] is readable and
+        ///          holds T() (a NUL for chars, an EOFF token for tokens), which no reader ever looks
+        ///          for. Peeking at the current element then needs no bounds check, it simply never
+        ///          matches past the end. Lookahead further than that (peekNext, peek_off) is checked
         template <typename T>
         class Reader
         {
             public:
-                Reader(std::shared_ptr<std::vector<T>> &source): source(source) {start=0;curr=0;line=1;};
+                /// @note non-owning, whoever constructs the reader keeps the source (and its
+                ///       sentinel) alive: std::string, MappedFile and TokenBuffer all have one
+                Reader(std::span<const T> source): source(source.data() ? source : std::span<const T>(&none, 0)) {
+                    start=0;curr=0;line=1;
+                    if constexpr (checked)
+                        if (!(this->source.data()[this->source.size()] == T())) throw std::logic_error("Reader source isn't terminated by a sentinel");
+                };
                 ~Reader() = default;
 
             protected:
-                std::shared_ptr<std::vector<T>> source;
+                std::span<const T> source;
                 unsigned start, curr, line;
                 unsigned long long match_length;
 
                 #pragma mark - Reader Methods
 
-                inline bool atEnd() { return this->curr >= source->size(); }
-                inline T advance() { return (!atEnd()) ? source->at(curr++) : T(); }
+                inline bool atEnd() { return this->curr >= source.size(); }
+                /// @note callers check atEnd (or peek) first, only checked readers stop at the end
+                inline T advance() {
+                    if constexpr (checked) return (!atEnd()) ? source[curr++] : T();
+                    return source.data()[curr++];
+                }
                 inline void prevance() { if (curr>0) curr--; }
-                // inline typename std::enable_if<std::is_same<T, char>::value, T>::type advance() { return (!atEnd()) ? source->at(curr++) : '\0'; }
-                // inline typename std::enable_if<!std::is_same<T, char>::value, T>::type advance() { return (!atEnd()) ? source->at(curr++) : nullptr; }
+
+                /// @brief the current element, the sentinel at the end
+                inline const T& current() const {
+                    if constexpr (checked) return curr < source.size() ? source[curr] : none;
+                    return source.data()[curr];
+                }
 
                 /// @brief Peeks at the current character 
-                inline bool peek(T expected) {
-                    return !atEnd() && source->at(curr) == expected; 
-                };
+                inline bool peek(T expected) { return current() == expected; };
                 /// @brief Peeks at the current character with an offset
-                inline bool peek_off(T expected, int offset) { return curr+offset<source->size() && source->at(curr+offset) == expected; };
+                inline bool peek_off(T expected, int offset) { return curr+offset<source.size() && source[curr+offset] == expected; };
                 /// @brief Peeks at the current character
-                inline T peek() { return !atEnd() ? source->at(curr) : T(); };
+                inline T peek() { return current(); };
                 /// @brief Peeks at the current character with an offset
-                inline T peek(int offset) { return curr+offset<source->size() ? source->at(curr+offset) : T(); };
+                inline T peek(int offset) { return curr+offset<source.size() ? source[curr+offset] : T(); };
                 /// @brief Peeks at the next character 
-                inline T peekNext() { return curr+1<source->size() ? source->at(curr+1) : T(); };
+                inline T peekNext() { return curr+1<source.size() ? source[curr+1] : T(); };
                 /// @brief Peeks at the next 2 characters
                 inline bool peek3(T expected) { return peek_off(expected, 0) && peek_off(expected, 1) && peek_off(expected, 2); }
                 /// @brief Peeks the previous character
-                inline T peekPrev() { return curr-1>=0 ? source->at(curr-1) : T(); };
+                inline T peekPrev() { return curr>=1 ? source[curr-1] : T(); };
                 /// @brief Peeks previous with offset
-                inline T peekPrev(int offset) { return curr-offset>=0 ? source->at(curr-offset) : T(); };
+                inline T peekPrev(int offset) { return curr>=(unsigned)offset ? source[curr-offset] : T(); };
                 /// @brief matches a single character and advances the cursor 
-                inline bool match_one(T expected) { return peek(expected) ? advance() : false; }
+                inline bool match_one(T expected) {
+                    if (!peek(expected)) return false;
+                    curr++;
+                    return true;
+                }
 
 
                 /// @brief Scans a comment and advances the cursor
-                inline void scanComment() { while (peek('\n')) advance();};
+                inline void scanComment() { while (!atEnd() && !peek('\n')) advance();};
                 /// @brief Consumes a T and advances the cursor (Error if not found)
                 inline T consume (T expected, std::unique_ptr<ReaderException> error) { 
                     if (peek(expected)) return advance();
@@ -127,6 +157,10 @@ namespace rift
                     }
                     return true;
                 }
+
+            private:
+                /// @brief the source of readers made from an empty span, a lone sentinel
+                static inline const T none = T();
         };
 
         /// @class ReaderException
@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+/// @brief C interface to rift::embed (see rift/rift.hh), for hosts that can't take C++
+/// @note every function but rift_runtime_new takes a runtime created by it, and none of
+///       them may be called on the same runtime from two threads at once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rift_runtime rift_runtime;
+typedef struct rift_script rift_script;
+
+typedef enum rift_type
+{
+    RIFT_NIL,
+    RIFT_BOOL,
+    RIFT_NUMBER,
+    RIFT_STRING,
+    RIFT_FUNCTION
+} rift_type;
+
+/// @brief a value passed to or returned by Rift
+/// @note strings returned by the runtime are not NUL terminated, and only valid until
+///       the next call on the same runtime. A FUNCTION holds the function's name
+typedef struct rift_value
+{
+    rift_type type;
+    union {
+        int boolean;
+        double number;
+        struct {
+            const char* data;
+            size_t size;
+        } string;
+    } as;
+} rift_value;
+
+/// @brief a function of the host, returns 0 and sets *result, or anything else to fail
+typedef int (*rift_host_fn)(void* data, const rift_value* args, size_t argc, rift_value* result);
+
+rift_runtime* rift_runtime_new(int tiered);
+void rift_runtime_free(rift_runtime* runtime);
+
+/// @brief compiles source and runs its top level, NULL if that failed (see rift_error)
+rift_script* rift_compile(rift_runtime* runtime, const char* source, size_t size);
+void rift_script_free(rift_script* script);
+
+/// @brief calls the function name with args, 0 on success with *result set
+int rift_call(rift_runtime* runtime, rift_script* script, const char* name, const rift_value* args, size_t argc, rift_value* result);
+/// @brief binds name to fn, called with data as its first argument
+void rift_define(rift_runtime* runtime, const char* name, uint32_t arity, rift_host_fn fn, void* data);
+
+/// @brief the message of the last error, valid until the next call on the runtime
+const char* rift_error(const rift_runtime* runtime);
+
+static inline rift_value rift_nil(void) { rift_value v; v.type = RIFT_NIL; v.as.number = 0; return v; }
+static inline rift_value rift_bool(int b) { rift_value v; v.type = RIFT_BOOL; v.as.boolean = b; return v; }
+static inline rift_value rift_number(double n) { rift_value v; v.type = RIFT_NUMBER; v.as.number = n; return v; }
+static inline rift_value rift_string(const char* data, size_t size) { rift_value v; v.type = RIFT_STRING; v.as.string.data = data; v.as.string.size = size; return v; }
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,181 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/eval.hh>
+#include <error/error.hh>
+#include <utils/isolate.hh>
+#include <utils/string.hh>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace rift
+{
+    namespace ast { class Program; }
+
+    /// @brief Running Rift inside another program: compile a source once, then call its
+    ///        functions with host values as often as needed
+    /// @details everything runs in the Runtime's own isolate, errors are thrown as
+    ///          rift::embed::Error instead of exiting (see Isolate::Errors::raise)
+    namespace embed
+    {
+        using Error = rift::error::Error;
+
+        /// @class Value
+        /// @brief A value as the host sees it, numbers and bools are stored inline and
+        ///        strings share their text with the runtime (see String), so none of them
+        ///        are ever converted through text
+        /// @note a FUNCTION only carries the function's name, look it up to call it
+        class Value
+        {
+            public:
+                enum class Type : uint8_t
+                {
+                    NIL,
+                    BOOL,
+                    NUMBER,
+                    STRING,
+                    FUNCTION
+                };
+
+                Value() : kind(Type::NIL) { as.number = 0; }
+                Value(bool b) : kind(Type::BOOL) { as.boolean = b; }
+                Value(double n) : kind(Type::NUMBER) { as.number = n; }
+                Value(int n) : Value(static_cast<double>(n)) {}
+                Value(String str) : kind(Type::STRING), str(std::move(str)) { as.number = 0; }
+                Value(const char* str) : Value(String(str)) {}
+                Value(std::string_view str) : Value(String(str)) {}
+                Value(const std::string& str) : Value(String(std::string_view(str))) {}
+
+                static inline Value function(std::string name) { Value v(String(std::move(name))); v.kind = Type::FUNCTION; return v; }
+
+                inline Type type() const { return kind; }
+                inline bool isNil() const { return kind == Type::NIL; }
+                inline bool isBool() const { return kind == Type::BOOL; }
+                inline bool isNumber() const { return kind == Type::NUMBER; }
+                inline bool isString() const { return kind == Type::STRING; }
+                inline bool isFunction() const { return kind == Type::FUNCTION; }
+
+                inline bool asBool() const { return as.boolean; }
+                inline double asNumber() const { return as.number; }
+                /// @brief the text of a STRING, the name of a FUNCTION
+                inline const String& asString() const { return str; }
+
+                bool operator==(const Value& other) const;
+
+            private:
+                Type kind;
+                union {
+                    bool boolean;
+                    double number;
+                } as;
+                String str;
+        };
+
+        class Runtime;
+
+        /// @class Function
+        /// @brief A global looked up once, calling through it skips the lookup by name
+        /// @note it names a slot, whatever the global holds when called is what runs
+        class Function
+        {
+            public:
+                inline const std::string& name() const { return label; }
+
+            private:
+                friend class Runtime;
+                friend class Script;
+                Function(Runtime* runtime, uint32_t slot, std::string name) : runtime(runtime), slot(slot), label(std::move(name)) {}
+
+                Runtime* runtime;
+                uint32_t slot;
+                std::string label;
+        };
+
+        /// @class Script
+        /// @brief A compiled source, its top level ran once and its functions stay defined
+        /// @note copies share the program, which lives as long as one of them does
+        class Script
+        {
+            public:
+                /// @brief the global named name, to be called through the runtime
+                Function function(std::string_view name) const;
+
+            private:
+                friend class Runtime;
+                struct State;
+                Script(Runtime* runtime, std::shared_ptr<State> state) : runtime(runtime), state(std::move(state)) {}
+
+                Runtime* runtime;
+                std::shared_ptr<State> state;
+        };
+
+        /// @class Runtime
+        /// @brief Owns an isolate and the evaluator running in it
+        /// @note like the isolate, a runtime is used from one thread at a time
+        class Runtime
+        {
+            public:
+                /// @brief a function of the host, called with the values Rift passed
+                using Host = std::function<Value(std::span<const Value> args)>;
+                /// @brief most arguments a call converts without allocating
+                static constexpr size_t INLINE_ARGS = 8;
+
+                /// @param tiered compile hot numeric functions to native code (see jit::Tier),
+                ///        off unless the host asks for it
+                explicit Runtime(bool tiered = false);
+                ~Runtime();
+                Runtime(const Runtime&) = delete;
+                Runtime& operator=(const Runtime&) = delete;
+
+                /// @brief scans, parses, resolves and optimizes source, then runs its top level
+                /// @throws Error when it doesn't compile, or its top level fails
+                Script compile(std::string source);
+
+                /// @brief calls fn with args
+                /// @throws Error when fn isn't a function taking that many arguments, or fails
+                Value call(const Function& fn, std::span<const Value> args);
+                inline Value call(const Function& fn, std::initializer_list<Value> args) { return call(fn, std::span<const Value>(args.begin(), args.size())); }
+                /// @brief calls the function script (or any script before it) defined as name
+                inline Value call(const Script& script, std::string_view name, std::span<const Value> args) { return call(script.function(name), args); }
+                inline Value call(const Script& script, std::string_view name, std::initializer_list<Value> args) { return call(script.function(name), args); }
+
+                /// @brief binds name to a function of the host taking arity arguments, scripts
+                ///        compiled before or after call it like any other function
+                void define(std::string_view name, uint32_t arity, Host fn);
+                /// @brief the value of a global, nil if it was never defined
+                Value get(std::string_view name);
+
+                /// @brief where the runtime's state lives, print goes to isolate().output
+                inline Isolate& isolate() { return context; }
+
+            private:
+                friend class Script;
+
+                /// @brief the runtime's view of a host value, allocated on its heap if needed
+                rift::Value fromHost(const Value& val);
+                /// @brief the host's view of a runtime value
+                static Value toHost(const rift::Value& val);
+
+                Isolate context;
+                ast::Eval eval;
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <scanner/tokens.hh>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace rift
+{
+    namespace scanner
+    {
+        namespace keywords
+        {
+            /// @struct Keyword
+            /// @brief A reserved word and the token it scans to
+            struct Keyword
+            {
+                std::string_view word;
+                TokenType type = TokenType::IDENTIFIER;
+            };
+
+            /// @note `mut!` isn't in here, the scanner turns `mut` followed by '!' into CONST
+            inline constexpr Keyword LIST[] = {
+                {"and", TokenType::LOG_AND},
+                {"await", TokenType::AWAIT},
+                {"class", TokenType::CLASS},
+                {"else", TokenType::ELSE},
+                {"elif", TokenType::ELIF},
+                {"false", TokenType::FALSE},
+                {"for", TokenType::FOR},
+                {"fun", TokenType::FUN},
+                {"if", TokenType::IF},
+                {"import", TokenType::IMPORT},
+                {"mut", TokenType::VAR},
+                {"nil", TokenType::NIL},
+                {"or", TokenType::LOG_OR},
+                {"parallel", TokenType::PARALLEL},
+                {"print", TokenType::PRINT},
+                {"return", TokenType::RETURN},
+                {"spawn", TokenType::SPAWN},
+                {"super", TokenType::SUPER},
+                {"this", TokenType::THIS},
+                {"true", TokenType::TRUE},
+                {"while", TokenType::WHILE},
+            };
+
+            inline constexpr size_t MIN_LENGTH = 2;
+            inline constexpr size_t MAX_LENGTH = 8;
+            inline constexpr size_t SLOTS = 64;
+
+            /// @brief hashes a word by its first and last characters and its length
+            constexpr uint32_t hash(std::string_view word, uint32_t seed)
+            {
+                uint32_t h = static_cast<unsigned char>(word.front()) * seed;
+                h ^= static_cast<unsigned char>(word.back()) * (seed >> 5 | 1);
+                h += static_cast<uint32_t>(word.size()) * 0x9e37u;
+                return (h >> 7) % SLOTS;
+            }
+
+            /// @struct Table
+            /// @brief Perfect hash over LIST, every keyword has a slot of its own
+            struct Table
+            {
+                uint32_t seed = 0;
+                std::array<Keyword, SLOTS> slots = {};
+            };
+
+            /// @brief searches for the first seed without collisions (evaluated by the compiler)
+            constexpr Table build()
+            {
+                for (uint32_t seed = 1; seed < 100000; seed++) {
+                    Table table{seed, {}};
+                    bool perfect = true;
+                    for (const auto& kw : LIST) {
+                        auto& slot = table.slots[hash(kw.word, seed)];
+                        if (!slot.word.empty()) { perfect = false; break; }
+                        slot = kw;
+                    }
+                    if (perfect) return table;
+                }
+                return Table{};
+            }
+
+            inline constexpr Table TABLE = build();
+            static_assert(TABLE.seed != 0, "no perfect hash seed found for the keyword list");
+
+            /// @brief the keyword type of a whole word, IDENTIFIER if it isn't one
+            /// @note one hash and at most one comparison
+            constexpr TokenType lookup(std::string_view word)
+            {
+                if (word.size() < MIN_LENGTH || word.size() > MAX_LENGTH) return TokenType::IDENTIFIER;
+                const auto& slot = TABLE.slots[hash(word, TABLE.seed)];
+                return slot.word == word ? slot.type : TokenType::IDENTIFIER;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -15,8 +15,11 @@
 #pragma once
 
 #include <scanner/tokens.hh>
+#include <scanner/keywords.hh>
+#include <scanner/simd.hh>
 #include <error/error.hh>
 #include <reader/reader.hh>
+#include <utils/isolate.hh>
 #include <string>
 #include <stdlib.h>
 // #include <map>
@@ -35,11 +38,13 @@ namespace rift
     {
         struct Scanner : public Reader<char>
         {
-            std::shared_ptr<std::vector<char>> source;
-            std::vector<Token> tokens;
-            std::map<str_t, Type, std::greater<str_t> > keywords;
+            /// @brief scanned tokens, spans into source
+            std::shared_ptr<TokenBuffer> tokens;
 
-            Scanner(std::shared_ptr<std::vector<char>> source);
+            /// @param source borrowed (e.g. a mapped file), must outlive the tokens and be followed
+            ///        by a NUL (as std::string and MappedFile are, see Reader)
+            /// @param isolate where identifiers are interned
+            Scanner(std::span<const char> source, Isolate& isolate = Isolate::current());
             ~Scanner(){}
 
             /// @fn scan_token
@@ -53,18 +58,42 @@ namespace rift
 
             /// @fn scan_source
             /// @brief Scans the source code and returns a list of tokens
+            /// @details a source of at least `parallel` bytes is split into chunks scanned
+            ///          concurrently on the shared scheduler (see scan_chunks)
             void scan_source();
+
+            /// @brief sources shorter than this are scanned on one thread
+            static constexpr size_t PARALLEL = 1 << 20;
+            /// @brief the smallest chunk a source is split into
+            static constexpr size_t CHUNK = 256 << 10;
+            /// @brief where scan_source starts splitting, SIZE_MAX never does
+            size_t parallel = PARALLEL;
         private:
+            Isolate& isolate;
+            Symbols& symbols;
+
+            /// @brief Scans the source in chunks concurrently, then stitches their tokens
+            /// @details a pre-pass skipping strings and comments splits the source at whitespace,
+            ///          each chunk is scanned by a scanner of its own that ends there (whitespace
+            ///          is as good a sentinel as the NUL, no token reads past it) and counts its
+            ///          lines from 1, the chunks are then appended in order, their lines offset
+            ///          by the newlines of the chunks before them
+            /// @return false if it didn't split the source, or a chunk had an error, which the
+            ///         serial scan then reports at the right line
+            bool scan_chunks(size_t chunks);
 
             #pragma mark - Token Management
 
-            void addToken(Type type) { addToken(type, ""); };
-            void addToken(Type type, std::string literal) {
-                tokens.push_back(Token(type, literal, literal, line));
-            }
+            /// @brief adds a token spanning [start, curr)
+            inline void addToken(Type type) { tokens->emplace_back(type, start, curr - start, line); }
 
             #pragma mark - Helper Functions (Inline)
 
+            /// @brief run finders for this cpu (see simd::kernels)
+            const simd::Kernels& simd = simd::kernels();
+            inline const char* here() const { return source.data() + curr; }
+            inline size_t left() const { return source.size() - curr; }
+
             inline bool isDigit(char c) { return c>='0' && c<='9'; }
             inline bool isAlpha(char c) { return (c!=' ') && ( (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_'); }
             inline bool isAlphaNumeric(char c) { return std::isalnum(c); }
@@ -72,8 +101,8 @@ namespace rift
 
             void twoChar(Type t1, Type t2, char c) {
                 if (peek(c)) {
-                    addToken(t2); 
-                    advance(); 
+                    advance();
+                    addToken(t2);
                 } else {
                     addToken(t1);
                 }
@@ -85,11 +114,12 @@ namespace rift
             void string();
             /// @brief Scans a numeric literal
             void num();
-            /// @brief Scans an identifier
+            /// @brief Scans an identifier or keyword (see keywords::lookup)
             void identifier();
-            /// @brief Scans a keyword
-            /// @return true if keyword, false otherwise
-            bool keyword();
+            /// @brief Skips a whitespace run, counting its newlines
+            void spaces();
+            /// @brief Skips a `//` comment up to (not including) its newline
+            void comment();
         };
     };
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+namespace rift
+{
+    namespace scanner
+    {
+        namespace simd
+        {
+            /// @enum Level
+            /// @brief Instruction sets the scanner kernels are built for
+            enum class Level
+            {
+                SCALAR,
+                SSE2,
+                AVX2,
+                NEON
+            };
+
+            /// @struct Kernels
+            /// @brief Run finders used by the Scanner, all of them take the bytes left in the source
+            ///        and return how many of them the run covers (n if it reaches the end)
+            struct Kernels
+            {
+                Level level;
+                const char* name;
+
+                /// @brief length of the leading ' ', '\t', '\r', '\n' run, adds its newlines to lines
+                size_t (*skipWhitespace)(const char* p, size_t n, size_t& lines);
+                /// @brief length of the leading [A-Za-z0-9_] run
+                size_t (*identifierEnd)(const char* p, size_t n);
+                /// @brief length of the leading [0-9] run
+                size_t (*digitsEnd)(const char* p, size_t n);
+                /// @brief offset of the first '\n'
+                size_t (*lineEnd)(const char* p, size_t n);
+                /// @brief offset of the first '"', adds the newlines before it to lines
+                size_t (*findQuote)(const char* p, size_t n, size_t& lines);
+            };
+
+            /// @brief the best kernels for this cpu, picked once on first use
+            /// @note RIFT_SIMD=scalar|sse2|avx2|neon forces a level (if supported)
+            const Kernels& kernels();
+            /// @brief the kernels of a given level, nullptr if this build/cpu can't run them
+            const Kernels* kernels(Level level);
+        }
+    }
+}
\ No newline at end of file
@@ -15,7 +15,13 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <any>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+#include <utils/symbols.hh>
 
 namespace rift
 {
@@ -30,6 +36,8 @@ namespace rift
             RIGHT_PAREN,
             LEFT_BRACE,
             RIGHT_BRACE,
+            LEFT_BRACKET,
+            RIGHT_BRACKET,
             COMMA,
             DOT,
             MINUS,
@@ -83,11 +91,41 @@ namespace rift
             VAR,
             CONST,
             WHILE,
+            PARALLEL,
+            SPAWN,
+            AWAIT,
+            IMPORT,
             
             IGNORE,
             EOFF
         };
 
+        /// @struct CompactToken
+        /// @brief What the scanner produces: a type and the span of the lexeme inside the source buffer
+        /// @note trivially copyable and allocation free, materialize a Token through TokenBuffer::token
+        struct CompactToken
+        {
+            TokenType type;
+            uint32_t offset;
+            /// @note identifiers are interned while scanning, their length is the symbol's
+            union {
+                uint32_t length;
+                SymbolId symbol;
+            };
+            uint32_t line;
+
+            CompactToken() : type(TokenType::EOFF), offset(0), length(0), line(0) {}
+            CompactToken(TokenType type) : type(type), offset(0), length(0), line(0) {}
+            CompactToken(TokenType type, uint32_t offset, uint32_t length, uint32_t line) : type(type), offset(offset), length(length), line(line) {}
+
+            /// @brief true for the token types that carry a symbol instead of a length
+            static inline bool named(TokenType type) { return type == TokenType::IDENTIFIER || type == TokenType::C_IDENTIFIER; }
+
+            /// @note like Token, tokens compare by type only
+            inline bool operator==(const CompactToken& other) const { return type == other.type; }
+        };
+        static_assert(sizeof(CompactToken) == 16, "CompactToken should stay 16 bytes");
+
         /// @struct Token
         /// @brief Represents a token in the source code (a lexeme with a type and a literal value)
         struct Token
@@ -98,17 +136,25 @@ namespace rift
             const std::type_info* l_type;
 
             int line;
+            /// @brief the interned lexeme of identifiers, Symbols::NONE for everything else
+            SymbolId symbol = Symbols::NONE;
 
             Token() : type(TokenType::NIL), lexeme(""), literal(0), l_type(&typeid(void)), line(0) {}
             Token(TokenType type) : type(type), lexeme(""), literal(0), l_type(&typeid(void)), line(0) {}
+            /// @note keeps the type and line only, the lexeme lives in the source (see TokenBuffer::token)
+            Token(const CompactToken& tok) : type(tok.type), lexeme(""), literal(0), l_type(&typeid(void)), line(tok.line) {}
 
-            Token(TokenType type, std::string lexeme, std::any literal, int line)
+            /// @note identifiers are interned here unless a symbol is given (see TokenBuffer::token)
+            Token(TokenType type, std::string lexeme, std::any literal, int line, SymbolId symbol = Symbols::NONE)
             {
                 this->type = type;
                 this->lexeme = lexeme;
                 this->literal = literal;
                 this->line = line;
                 this->l_type = &typeid(literal);
+                this->symbol = symbol;
+                if (symbol == Symbols::NONE && CompactToken::named(type))
+                    this->symbol = Symbols::getInstance().intern(this->lexeme);
             }
 
             Token(const Token& other) {
@@ -117,6 +163,7 @@ namespace rift
                 this->literal = other.literal;
                 this->line = other.line;
                 this->l_type = other.l_type;
+                this->symbol = other.symbol;
             }
 
             ~Token() { }
@@ -138,5 +185,48 @@ namespace rift
             std::any getLiteral() const;
         };
 
+        /// @struct TokenBuffer
+        /// @brief Contiguous compact tokens, together with the source buffer they point into
+        /// @note always followed by an EOFF token, the sentinel readers stop at (see Reader)
+        struct TokenBuffer : private std::vector<CompactToken>
+        {
+            using base = std::vector<CompactToken>;
+            TokenBuffer(std::string_view source, const Symbols& symbols) : base(1), source(source), symbols(&symbols) {}
+
+            using base::operator[];
+            using base::data;
+            inline size_t size() const { return base::size() - 1; }
+            inline bool empty() const { return size() == 0; }
+            inline const CompactToken* begin() const { return data(); }
+            inline const CompactToken* end() const { return data() + size(); }
+            inline CompactToken& back() { return base::operator[](size() - 1); }
+            inline void reserve(size_t n) { base::reserve(n + 1); }
+            /// @brief n tokens, the ones added are EOFF until written (the sentinel stays last)
+            inline void resize(size_t n) { base::resize(n + 1); base::back() = CompactToken(); }
+
+            /// @brief appends tok in place of the sentinel, which moves one further
+            inline void push_back(const CompactToken& tok) {
+                base::back() = tok;
+                base::emplace_back();
+            }
+            template <typename... Args>
+            inline void emplace_back(Args&&... args) { push_back(CompactToken(std::forward<Args>(args)...)); }
+
+            /// @brief the tokens, without the sentinel that follows them
+            inline operator std::span<const CompactToken>() const { return {data(), size()}; }
+
+            /// @note non-owning, same lifetime as the scanner's source
+            std::string_view source;
+            /// @brief the table the identifiers were interned in (the scanner's isolate)
+            const Symbols* symbols;
+
+            /// @brief the text of a token (a view into the source, no copy)
+            inline std::string_view lexeme(const CompactToken& tok) const {
+                if (CompactToken::named(tok.type)) return symbols->name(tok.symbol);
+                return source.substr(tok.offset, tok.length);
+            }
+            /// @brief materializes a full Token, only needed for tokens kept by the AST
+            Token token(const CompactToken& tok) const;
+        };
     }
 }
\ No newline at end of file
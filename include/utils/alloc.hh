@@ -0,0 +1,44 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+namespace rift
+{
+    namespace alloc
+    {
+        /// @brief heap traffic since tracking was turned on
+        struct Counts
+        {
+            size_t allocations = 0;
+            size_t bytes = 0;
+
+            inline Counts operator-(const Counts& rhs) const { return {allocations - rhs.allocations, bytes - rhs.bytes}; }
+        };
+
+        /// @brief turns the counting hook on/off
+        /// @note the hook replaces the global operator new in riftlang and the tests (see
+        ///       alloc_hook.cc), riftlib leaves it alone and counts nothing on its own. While
+        ///       tracking is off it only costs a relaxed load per allocation
+        void track(bool enabled);
+        /// @brief true while the hook is counting
+        bool tracking();
+        /// @brief allocations (and bytes requested) seen so far
+        Counts counts();
+        /// @brief counts an allocation of size bytes while tracking, what the hook calls
+        void count(size_t size);
+    }
+}
\ No newline at end of file
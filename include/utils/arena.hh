@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rift
+{
+    /// @class Arena
+    /// @brief Bump allocator, objects are laid out back to back in allocation order
+    ///        and all of them are freed at once when the arena is released
+    /// @note objects that aren't trivially destructible get their destructor run on
+    ///       release (in reverse allocation order), nothing is ever freed individually
+    class Arena
+    {
+        public:
+            static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+            Arena() = default;
+            ~Arena() { release(); }
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            /// @brief raw storage for size bytes aligned to align
+            void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+            /// @brief constructs a T inside the arena
+            template <typename T, typename... Args>
+            T* make(Args&&... args) {
+                T* obj = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+                count++;
+                if constexpr (!std::is_trivially_destructible_v<T>)
+                    finalizers.push_back({obj, [](void* ptr) { static_cast<T*>(ptr)->~T(); }});
+                return obj;
+            }
+
+            /// @brief destroys every object and frees every block
+            void release();
+
+            /// @brief bytes handed out so far
+            inline size_t used() const { return bytes; }
+            /// @brief bytes reserved from the system
+            inline size_t reserved() const { return capacity; }
+            /// @brief objects constructed through make
+            inline size_t objects() const { return count; }
+
+        private:
+            struct Finalizer {
+                void* obj;
+                void (*destroy)(void*);
+            };
+
+            std::vector<std::unique_ptr<std::byte[]>> blocks;
+            std::vector<Finalizer> finalizers;
+            std::byte* cursor = nullptr;
+            std::byte* end = nullptr;
+            size_t bytes = 0;
+            size_t capacity = 0;
+            size_t count = 0;
+    };
+}
\ No newline at end of file
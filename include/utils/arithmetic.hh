@@ -16,9 +16,13 @@
 #pragma once
 
 #include <any>
+#include <array>
+#include <cstdint>
+#include <utility>
 #include <string>
 #include <scanner/tokens.hh>
 #include <utils/macros.hh>
+#include <utils/value.hh>
 
 
 using any = std::any;
@@ -28,6 +32,97 @@ using TokenType = rift::scanner::TokenType;
 
 namespace rift
 {
-    /// @brief evaluates the given values with operation
-    extern any any_arithmetic(any left, any right, const Token& op);
+    namespace arith
+    {
+        /// @brief the operators with a dispatch table row
+        enum class Op : uint8_t
+        {
+            ADD, SUB, MUL, DIV,
+            LESS, LESS_EQUAL, GREATER, GREATER_EQUAL,
+            EQUAL, NOT_EQUAL,
+            NONE // everything else, its row is empty
+        };
+
+        constexpr size_t OPS = static_cast<size_t>(Op::NONE) + 1;
+        /// @note one column per ValueType tag
+        constexpr size_t KINDS = static_cast<size_t>(ValueType::OBJ) + 1;
+
+        /// @brief the row of a binary operator token
+        constexpr Op op(TokenType type)
+        {
+            switch (type) {
+                case TokenType::PLUS: return Op::ADD;
+                case TokenType::MINUS: return Op::SUB;
+                case TokenType::STAR: return Op::MUL;
+                case TokenType::SLASH: return Op::DIV;
+                case TokenType::LESS: return Op::LESS;
+                case TokenType::LESS_EQUAL: return Op::LESS_EQUAL;
+                case TokenType::GREATER: return Op::GREATER;
+                case TokenType::GREATER_EQUAL: return Op::GREATER_EQUAL;
+                case TokenType::EQUAL_EQUAL: return Op::EQUAL;
+                case TokenType::BANG_EQUAL: return Op::NOT_EQUAL;
+                default: return Op::NONE;
+            }
+        }
+
+        using Fn = Value (*)(const Value&, const Value&);
+
+        #pragma mark - Kernels
+
+        template <Op O>
+        inline Value numeric(const Value& l, const Value& r)
+        {
+            const double a = l.as.number, b = r.as.number;
+            if constexpr (O == Op::ADD) return Value::number(a + b);
+            else if constexpr (O == Op::SUB) return Value::number(a - b);
+            else if constexpr (O == Op::MUL) return Value::number(a * b);
+            else if constexpr (O == Op::DIV) return Value::number(a / b);
+            else if constexpr (O == Op::LESS) return Value::boolean(a < b);
+            else if constexpr (O == Op::LESS_EQUAL) return Value::boolean(a <= b);
+            else if constexpr (O == Op::GREATER) return Value::boolean(a > b);
+            else if constexpr (O == Op::GREATER_EQUAL) return Value::boolean(a >= b);
+            else if constexpr (O == Op::EQUAL) return Value::boolean(a == b);
+            else return Value::boolean(a != b);
+        }
+
+        template <Op O>
+        inline Value structural(const Value& l, const Value& r)
+        {
+            if constexpr (O == Op::EQUAL) return Value::boolean(equal(l, r));
+            else return Value::boolean(!equal(l, r));
+        }
+
+        #pragma mark - Table
+
+        /// @brief the kernel for (op, lhs, rhs), nullptr where the caller has to decide
+        ///        (strings, mixed operands and errors stay on the caller's slow path)
+        template <Op O, ValueType L, ValueType R>
+        constexpr Fn entry()
+        {
+            constexpr bool defined = L != ValueType::UNDEFINED && R != ValueType::UNDEFINED;
+            if constexpr (O == Op::NONE || !defined) return nullptr;
+            else if constexpr (L == ValueType::NUMBER && R == ValueType::NUMBER) return &numeric<O>;
+            else if constexpr (O == Op::EQUAL || O == Op::NOT_EQUAL) return &structural<O>;
+            else return nullptr;
+        }
+
+        template <size_t... I>
+        constexpr std::array<Fn, sizeof...(I)> build(std::index_sequence<I...>)
+        {
+            return {entry<static_cast<Op>(I / (KINDS * KINDS)), static_cast<ValueType>(I / KINDS % KINDS), static_cast<ValueType>(I % KINDS)>()...};
+        }
+
+        /// @brief every (op, lhs, rhs) combination, laid out row major
+        inline constexpr auto TABLE = build(std::make_index_sequence<OPS * KINDS * KINDS>());
+
+        /// @brief the kernel for op applied to these operand tags, nullptr if there is none
+        inline Fn lookup(Op op, ValueType l, ValueType r)
+        {
+            return TABLE[(static_cast<size_t>(op) * KINDS + static_cast<size_t>(l)) * KINDS + static_cast<size_t>(r)];
+        }
+    }
+
+    /// @brief evaluates the given numeric values with operation
+    /// @note reports an error for anything without a kernel
+    extern Value any_arithmetic(const Value& left, const Value& right, const Token& op);
 }
\ No newline at end of file
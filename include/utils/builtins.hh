@@ -0,0 +1,63 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <utils/value.hh>
+
+namespace rift
+{
+    namespace builtins
+    {
+        /// @enum Builtin
+        /// @brief Functions every engine provides, on arrays mostly (see ObjArray)
+        /// @details - array(n): n zeros
+        ///          - len(a): the elements of an array, or the bytes of a string
+        ///          - sum(a), min(a), max(a), dot(a, b): reductions (see numeric::Kernels)
+        ///          - map(a, f): a new array of f applied to every element
+        /// @note a builtin is only called where the global of its name isn't defined, so
+        ///       programs declaring a function of the same name keep calling theirs
+        enum class Builtin : uint8_t
+        {
+            NONE,
+            ARRAY,
+            LEN,
+            SUM,
+            MIN,
+            MAX,
+            DOT,
+            MAP
+        };
+
+        /// @brief the builtin called name, NONE if there is none
+        Builtin lookup(std::string_view name);
+        extern const char* name(Builtin fn);
+        extern uint32_t arity(Builtin fn);
+
+        /// @brief the element of target an index points at, reported unless it is one
+        double& element(const Value& target, const Value& index);
+
+        /// @brief calls f with one argument, how map reaches the engine's functions
+        using Apply = std::function<Value(const Value& f, const Value& arg)>;
+
+        /// @brief calls a builtin, reporting a runtime error for arguments it can't take
+        /// @param heap where the arrays it makes are allocated
+        /// @note the arguments must stay reachable during the call, apply may collect
+        Value call(Builtin fn, std::span<const Value> args, Heap& heap, const Apply& apply);
+    }
+}
@@ -0,0 +1,85 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rift
+{
+    /// @class FlatMap
+    /// @brief Open addressing map for small integer keys (symbols, slots): keys and
+    ///        values live in one flat array and lookups probe linearly from a multiplicative hash
+    /// @note the largest key is reserved to mark empty buckets, nothing is ever erased
+    template <typename K, typename V>
+    class FlatMap
+    {
+        static_assert(std::is_unsigned_v<K>, "FlatMap keys are unsigned integers");
+
+        public:
+            static constexpr K EMPTY = std::numeric_limits<K>::max();
+
+            FlatMap() = default;
+
+            /// @brief the value bound to key, nullptr if there is none
+            inline V* find(K key) {
+                if (buckets.empty()) return nullptr;
+                for (size_t i = hash(key);; i = (i + 1) & mask()) {
+                    if (buckets[i].first == key) return &buckets[i].second;
+                    if (buckets[i].first == EMPTY) return nullptr;
+                }
+            }
+            inline const V* find(K key) const { return const_cast<FlatMap*>(this)->find(key); }
+            inline bool contains(K key) const { return find(key) != nullptr; }
+
+            /// @brief binds key to val unless it is already bound
+            /// @return the bound value and whether it was inserted
+            std::pair<V*, bool> emplace(K key, V val) {
+                if ((count + 1) * 4 > buckets.size() * 3) grow();
+                size_t i = hash(key);
+                for (; buckets[i].first != EMPTY; i = (i + 1) & mask())
+                    if (buckets[i].first == key) return {&buckets[i].second, false};
+                buckets[i] = {key, std::move(val)};
+                count++;
+                return {&buckets[i].second, true};
+            }
+
+            /// @brief the value bound to key, default constructed if there is none
+            inline V& operator[](K key) { return *emplace(key, V{}).first; }
+
+            inline size_t size() const { return count; }
+            inline bool empty() const { return count == 0; }
+            inline void clear() { buckets.clear(); count = 0; }
+
+        private:
+            inline size_t mask() const { return buckets.size() - 1; }
+            /// @note fibonacci hashing, spreads dense ids across the table
+            inline size_t hash(K key) const { return (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull >> 32) & mask(); }
+
+            void grow() {
+                auto old = std::move(buckets);
+                buckets.assign(old.empty() ? 16 : old.size() * 2, {EMPTY, V{}});
+                count = 0;
+                for (auto& [key, val] : old)
+                    if (key != EMPTY) emplace(key, std::move(val));
+            }
+
+            std::vector<std::pair<K, V>> buckets = {};
+            size_t count = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/env.hh>
+#include <utils/symbols.hh>
+#include <utils/value.hh>
+#include <utils/output.hh>
+
+namespace rift
+{
+    /// @class Isolate
+    /// @brief One interpreter context: the symbol table, heap, environments and error state
+    ///        of every program run in it. Isolates share no mutable state, so each one can
+    ///        run on its own thread (one thread per isolate at a time)
+    /// @details the scanner, parser, resolver and engines take the isolate they run in (the
+    ///          current one by default), and enter it while running so helpers reached from
+    ///          them (literals, errors, Symbols/Heap/Environment::getInstance) see it too
+    /// @note symbols, heap objects and global slots only mean something inside the isolate
+    ///       that produced them, a Program must be evaluated in the isolate it was parsed in
+    class Isolate
+    {
+        public:
+            Isolate() : globals(symbols), parser_globals(symbols), roots(*this) {}
+            ~Isolate() = default;
+            Isolate(const Isolate&) = delete;
+            Isolate& operator=(const Isolate&) = delete;
+
+            /// @brief the isolate entered on this thread, the process wide default one otherwise
+            static Isolate& current();
+
+            /// @class Scope
+            /// @brief Enters an isolate on this thread for its lifetime (scopes nest)
+            class Scope
+            {
+                public:
+                    explicit Scope(Isolate& isolate);
+                    ~Scope();
+                    Scope(const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+
+                private:
+                    Isolate* previous;
+            };
+
+            /// @brief the globals seen by the parser or by the engines
+            inline ast::Environment& environment(bool parser) { return parser ? parser_globals : globals; }
+
+            Symbols symbols;
+            Heap heap;
+            /// @brief what print writes to, stdout unless the host redirects it
+            Output output;
+            ast::Environment globals;
+            ast::Environment parser_globals;
+
+            /// @brief whether an error was reported while running in this isolate
+            struct Errors {
+                bool compile = false;
+                bool runtime = false;
+                /// @brief throw an error::Error instead of printing it and exiting (embedding)
+                bool raise = false;
+            } errors;
+
+        private:
+            /// @brief the values of both environments are live as long as the isolate
+            struct Globals : public Heap::Roots {
+                explicit Globals(Isolate& isolate) : Heap::Roots(isolate.heap), isolate(isolate) {}
+                void trace(Heap& heap) const override;
+                Isolate& isolate;
+            } roots;
+    };
+}
\ No newline at end of file
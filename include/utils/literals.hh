@@ -19,6 +19,7 @@
 #include <any>
 #include <string>
 #include "arithmetic.hh"
+#include "value.hh"
 
 
 using any = std::any;
@@ -28,20 +29,12 @@ using TokenType = rift::scanner::TokenType;
 
 namespace rift
 {
-    /// @brief evaluates token for truthiness
-    extern bool truthy(const Token& tok);
-    /// @brief evaluates tokens for equality
-    extern bool equal(const Token& tl, const Token& tr);
-    /// @brief parses token's literal to check if its a number
-    extern bool isNumber(const Token& tok);
-    /// @brief parses token's literal to check if its a string
-    extern bool isString(const Token& tok);
-    /// @brief casts token to a number
-    extern any castNumber(const Token& tok);
+    /// @brief converts a literal token to its runtime value (undefined for identifiers)
+    extern Value literalValue(const Token& tok);
+    /// @brief formats a number with the shortest round-trip representation
+    extern std::string formatNumber(double num);
     /// @brief casts token to a number then to a string for printing
     extern std::string castNumberString(const any& val, bool err = true);
     /// @brief casts token to a string
     extern std::string castString(const Token& tok, bool err = true);
-    /// @brief casts token to a string for printing
-    extern std::string castAnyString(const Token& token);
 }
\ No newline at end of file
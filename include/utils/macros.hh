@@ -74,47 +74,24 @@
 
 #pragma mark - Arithmetic
 
-#define _ANY_ARITHMETIC(left, right, op, op_tok) \
-    if (left.type() == typeid(double)) \
-        return std::any_cast<double>(left) op std::any_cast<double>(right); \
-    else if (left.type() == typeid(int)) \
-        return std::any_cast<int>(left) op std::any_cast<int>(right); \
-    else if (left.type() == typeid(unsigned)) \
-        return std::any_cast<unsigned>(left) op std::any_cast<unsigned>(right); \
-    else if (left.type() == typeid(short)) \
-        return std::any_cast<short>(left) op std::any_cast<short>(right); \
-    else if (left.type() == typeid(unsigned long)) \
-        return std::any_cast<unsigned long>(left) op std::any_cast<unsigned long>(right); \
-    else if (left.type() == typeid(unsigned short)) \
-        return std::any_cast<unsigned short>(left) op std::any_cast<unsigned short>(right); \
-    else if (left.type() == typeid(unsigned long long)) \
-        return std::any_cast<unsigned long long>(left) op std::any_cast<unsigned long long>(right); \
-    else if (left.type() == typeid(long long)) \
-        return std::any_cast<long long>(left) op std::any_cast<long long>(right); \
-    else if (left.type() == typeid(Token))\
-        return any_arithmetic(std::any_cast<Token>(left).getLiteral(), std::any_cast<Token>(right).getLiteral(), op_tok);\
-    else \
-        rift::error::report(op_tok.line, "Arithmetic Error", "Invalid operands for arithmetic operation", Token(), std::exception());
-
 #define _STRING_ARITHMETIC() \
         if (expr.op.type == TokenType::GREATER) \
-            return (strcmp(castString(left).c_str(),castString(right).c_str())>0) ? Token(TokenType::TRUE, "true", "true", expr.op.line) : Token(TokenType::FALSE, "false", "false", expr.op.line); \
+            return Value::boolean(left.asString().compare(right.asString()) > 0); \
         else if (expr.op.type == TokenType::LESS) \
-            return (strcmp(castString(left).c_str(),castString(right).c_str())<0) ? Token(TokenType::TRUE, "true", "true", expr.op.line) : Token(TokenType::FALSE, "false", "false", expr.op.line); \
+            return Value::boolean(left.asString().compare(right.asString()) < 0); \
         else if (expr.op.type == TokenType::GREATER_EQUAL) \
-            return (strcmp(castString(left).c_str(),castString(right).c_str())>=0) ? Token(TokenType::TRUE, "true", "true", expr.op.line) : Token(TokenType::FALSE, "false", "false", expr.op.line); \
+            return Value::boolean(left.asString().compare(right.asString()) >= 0); \
         else if (expr.op.type == TokenType::LESS_EQUAL) \
-            return (strcmp(castString(left).c_str(),castString(right).c_str())<=0) ? Token(TokenType::TRUE, "true", "true", expr.op.line) : Token(TokenType::FALSE, "false", "false", expr.op.line); \
+            return Value::boolean(left.asString().compare(right.asString()) <= 0); \
         else if (expr.op.type == TokenType::EQUAL_EQUAL) \
-            return (strcmp(castString(left).c_str(),castString(right).c_str())==0) ? Token(TokenType::TRUE, "true", "true", expr.op.line) : Token(TokenType::FALSE, "false", "false", expr.op.line); \
+            return Value::boolean(left.asString() == right.asString()); \
         else if (expr.op.type == TokenType::BANG_EQUAL) \
-            return (strcmp(castString(left).c_str(),castString(right).c_str())!=0) ? Token(TokenType::TRUE, "true", "true", expr.op.line) : Token(TokenType::FALSE, "false", "false", expr.op.line); \
+            return Value::boolean(left.asString() != right.asString()); \
 
 #pragma mark  - Specific Codebase
 
-#define _BOOL_LOGIC(op) if (isNumber(left) && isNumber(right)) {\
-            resBool = std::any_cast<bool>(any_arithmetic(left, right, op));\
-            return Token(resBool?TokenType::TRUE:TokenType::FALSE, resBool?"true":"false", resBool, op.line);\
-        } else if (isString(left) && isString(right)) {\
+#define _BOOL_LOGIC(op) if (left.isNumber() && right.isNumber()) {\
+            return any_arithmetic(left, right, op);\
+        } else if (left.isString() && right.isString()) {\
             _STRING_ARITHMETIC()\
-        }\
+        }
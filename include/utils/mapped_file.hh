@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace rift
+{
+    /// @class MappedFile
+    /// @brief A read-only view of a whole file, mmapped when possible
+    /// @details regular files are mapped straight from the page cache (no copy),
+    ///          stdin, pipes and other unmappable files are read into an owned buffer
+    /// @note either way the contents are followed by a NUL, the sentinel the scanner stops at
+    class MappedFile
+    {
+        public:
+            /// @brief opens path ("-" reads stdin)
+            /// @return nullptr if the file can't be opened
+            static std::unique_ptr<MappedFile> open(const std::string& path);
+
+            ~MappedFile();
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            /// @brief the contents, valid for the lifetime of the MappedFile
+            inline std::span<const char> span() const { return {data, size}; }
+            /// @brief false when the contents were copied (fallback path)
+            inline bool mapped() const { return is_mapped; }
+
+        private:
+            MappedFile() = default;
+            /// @brief fallback, reads fd to EOF
+            bool slurp(int fd);
+
+            const char* data = nullptr;
+            size_t size = 0;
+            /// @brief of the mapping, the contents and the page(s) of zeros after them
+            size_t length = 0;
+            bool is_mapped = false;
+            std::vector<char> buffer;
+    };
+}
\ No newline at end of file
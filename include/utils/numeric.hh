@@ -0,0 +1,49 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <scanner/simd.hh>
+
+namespace rift
+{
+    namespace numeric
+    {
+        using Level = scanner::simd::Level;
+
+        /// @struct Kernels
+        /// @brief Reductions over the elements of an array (see ObjArray), all of them take
+        ///        the elements and how many there are
+        /// @note every level adds in the same order, so sums agree to the last bit whatever
+        ///       the cpu. min and max need n > 0, with a NaN among the elements they are the
+        ///       first NaN
+        struct Kernels
+        {
+            Level level;
+            const char* name;
+
+            double (*sum)(const double* p, size_t n);
+            double (*min)(const double* p, size_t n);
+            double (*max)(const double* p, size_t n);
+            /// @brief sum of the products of a and b, both n long
+            double (*dot)(const double* a, const double* b, size_t n);
+        };
+
+        /// @brief the kernels of the level the scanner runs at (RIFT_SIMD forces it too)
+        const Kernels& kernels();
+        /// @brief the kernels of a given level, nullptr if this build/cpu can't run them
+        const Kernels* kernels(Level level);
+    }
+}
@@ -0,0 +1,113 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utils/string.hh>
+#include <utils/value.hh>
+
+namespace rift
+{
+    /// @class Output
+    /// @brief Where print writes, one per isolate
+    /// @details text is gathered in a userspace buffer and handed to the sink in one
+    ///          batch (one writev for a file descriptor) when
+    ///          - the buffer holds CAPACITY bytes
+    ///          - a line ends and the policy is LINE (the default when stdout is a TTY)
+    ///          - a program or prompt line finishes, an error is reported or the process exits
+    ///          long strings aren't copied into the buffer, the batch points at their text
+    class Output
+    {
+        public:
+            /// @brief bytes buffered before a flush is forced
+            static constexpr size_t CAPACITY = 64 * 1024;
+            /// @brief strings at least this long are written from their own storage
+            static constexpr size_t PIN_MIN = 512;
+
+            /// @enum Policy
+            /// @brief When a finished line is flushed
+            enum class Policy
+            {
+                FULL, // only once the buffer is full (or the program ends)
+                LINE  // after every line
+            };
+
+            /// @class Sink
+            /// @brief Receives the flushed text, in order
+            class Sink
+            {
+                public:
+                    virtual ~Sink() = default;
+                    /// @brief the parts of one batch, only valid during the call
+                    virtual void write(std::span<const std::string_view> parts) = 0;
+                    /// @brief true when a person is reading along (a terminal)
+                    virtual bool interactive() const { return false; }
+            };
+
+            /// @brief writes to fd with writev, retrying short writes
+            static std::unique_ptr<Sink> fd(int fd);
+            /// @brief appends to out, which must outlive the sink
+            static std::unique_ptr<Sink> memory(std::string& out);
+            /// @brief calls fn once per part
+            static std::unique_ptr<Sink> callback(std::function<void(std::string_view)> fn);
+
+            /// @brief stdout, line buffered when it is a terminal
+            Output();
+            ~Output();
+            Output(const Output&) = delete;
+            Output& operator=(const Output&) = delete;
+
+            /// @brief flushes what the old sink was given, then writes to sink
+            /// @note the policy follows the sink, LINE if it is interactive
+            void redirect(std::unique_ptr<Sink> sink);
+            inline void policy(Policy policy) { flushing = policy; }
+            inline Policy policy() const { return flushing; }
+
+            /// @brief the printed form of val followed by a newline
+            void print(const Value& val);
+            void write(std::string_view text);
+            /// @brief hands everything buffered to the sink
+            void flush();
+
+            /// @brief bytes waiting for the next flush
+            inline size_t pending() const { return size; }
+            /// @brief flushes made so far
+            inline size_t flushes() const { return batches; }
+
+            /// @brief flushes every live Output, also run at exit
+            static void flushAll();
+
+        private:
+            /// @brief a range of the buffer, or a string kept alive until the flush
+            struct Segment {
+                size_t offset;
+                size_t size;
+                String pinned;
+            };
+
+            std::unique_ptr<Sink> sink;
+            Policy flushing;
+            std::string buffer;
+            std::vector<Segment> segments;
+            size_t size = 0;
+            size_t batches = 0;
+    };
+}
\ No newline at end of file
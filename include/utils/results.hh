@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utils/value.hh>
+
+namespace rift
+{
+    /// @class ResultSink
+    /// @brief Receives the value of every top level declaration as an engine runs it
+    /// @note results are consumed as they are produced, an engine never keeps them
+    class ResultSink
+    {
+        public:
+            virtual ~ResultSink() = default;
+            virtual void result(const Value& val) = 0;
+    };
+
+    /// @class DiscardResults
+    /// @brief For batch runs, nothing is kept however long the program runs
+    class DiscardResults : public ResultSink
+    {
+        public:
+            #pragma clang diagnostic push
+            #pragma clang diagnostic ignored "-Wunused-parameter"
+            inline void result(const Value& val) override {}
+            #pragma clang diagnostic pop
+    };
+
+    /// @class CollectResults
+    /// @brief Keeps every result, formatted as the REPL would show it
+    class CollectResults : public ResultSink
+    {
+        public:
+            inline void result(const Value& val) override { results.push_back(resultValue(val)); }
+            std::vector<std::string> results;
+    };
+}
\ No newline at end of file
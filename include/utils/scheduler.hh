@@ -0,0 +1,217 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rift
+{
+    /// @class Deque
+    /// @brief Chase-Lev work stealing deque of T*, one owner and any number of thieves
+    /// @details - the owner pushes and pops at the bottom (LIFO, what it just made is still hot)
+    ///          - thieves take from the top (FIFO, the oldest and usually largest work)
+    ///          - only the last item is contended, owner and thief race for it with one CAS
+    ///          the ring doubles when full, the smaller ones are kept until the deque is
+    ///          destroyed since a thief may still be reading one
+    template <typename T>
+    class Deque
+    {
+        public:
+            explicit Deque(size_t capacity = 64) : ring(new Ring(capacity)) { rings.emplace_back(ring.load(std::memory_order_relaxed)); }
+            Deque(const Deque&) = delete;
+            Deque& operator=(const Deque&) = delete;
+
+            /// @note owner only
+            void push(T* item)
+            {
+                auto b = bottom.load(std::memory_order_relaxed);
+                auto t = top.load(std::memory_order_acquire);
+                auto r = ring.load(std::memory_order_relaxed);
+                if (b - t > static_cast<int64_t>(r->mask)) r = grow(r, t, b);
+                r->put(b, item);
+                std::atomic_thread_fence(std::memory_order_release);
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+
+            /// @return the newest item, nullptr when empty (or a thief took the last one)
+            /// @note owner only
+            T* pop()
+            {
+                auto b = bottom.load(std::memory_order_relaxed) - 1;
+                auto r = ring.load(std::memory_order_relaxed);
+                bottom.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto t = top.load(std::memory_order_relaxed);
+                if (t > b) {
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                T* item = r->get(b);
+                if (t == b) {
+                    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) item = nullptr;
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                }
+                return item;
+            }
+
+            /// @return the oldest item, nullptr when empty or another thread won it
+            T* steal()
+            {
+                auto t = top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto b = bottom.load(std::memory_order_acquire);
+                if (t >= b) return nullptr;
+                T* item = ring.load(std::memory_order_acquire)->get(t);
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+                return item;
+            }
+
+            /// @brief items left, only exact while no one else uses the deque
+            inline size_t size() const
+            {
+                auto b = bottom.load(std::memory_order_relaxed), t = top.load(std::memory_order_relaxed);
+                return b > t ? static_cast<size_t>(b - t) : 0;
+            }
+            inline bool empty() const { return size() == 0; }
+
+        private:
+            struct Ring {
+                size_t mask;
+                std::unique_ptr<std::atomic<T*>[]> items;
+                /// @param capacity rounded up to a power of two
+                explicit Ring(size_t capacity) : mask(std::bit_ceil(capacity < 2 ? 2 : capacity) - 1), items(new std::atomic<T*>[mask + 1]) {}
+                inline T* get(int64_t i) const { return items[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed); }
+                inline void put(int64_t i, T* item) { items[static_cast<size_t>(i) & mask].store(item, std::memory_order_relaxed); }
+            };
+
+            Ring* grow(Ring* old, int64_t t, int64_t b)
+            {
+                auto next = new Ring(2 * (old->mask + 1));
+                for (auto i = t; i < b; i++) next->put(i, old->get(i));
+                rings.emplace_back(next);
+                ring.store(next, std::memory_order_release);
+                return next;
+            }
+
+            alignas(64) std::atomic<int64_t> top{0};
+            alignas(64) std::atomic<int64_t> bottom{0};
+            std::atomic<Ring*> ring;
+            /// @brief every ring the deque used, owned (and only grown) by the owner
+            std::vector<std::unique_ptr<Ring>> rings;
+    };
+
+    /// @class Scheduler
+    /// @brief Pool of worker threads running tasks, each worker with a Deque of its own
+    /// @details a task spawned on a worker goes to the bottom of its deque, one spawned from
+    ///          any other thread to a shared queue. An idle worker tries its own deque, then the
+    ///          shared queue, then steals from the others starting at a random one, and sleeps
+    ///          once nothing is left anywhere. wait helps: the waiting thread runs tasks (its
+    ///          own group's or anyone's) until the group is done
+    /// @note tasks must not throw, whatever can fail is caught inside run
+    class Scheduler
+    {
+        public:
+            class Group;
+
+            /// @class Task
+            /// @brief A unit of work, owned by whoever spawned it until its group is done
+            class Task
+            {
+                public:
+                    virtual ~Task() = default;
+                    virtual void run() = 0;
+                private:
+                    friend class Scheduler;
+                    Group* group = nullptr;
+            };
+
+            /// @class Group
+            /// @brief The tasks a wait waits for
+            class Group
+            {
+                public:
+                    inline bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+                private:
+                    friend class Scheduler;
+                    std::atomic<size_t> pending{0};
+            };
+
+            struct Stats {
+                /// @brief tasks run, by anyone
+                uint64_t executed = 0;
+                /// @brief tasks taken from another worker's deque
+                uint64_t stolen = 0;
+            };
+
+            /// @param workers threads started, 0 runs every task on the thread that waits for it
+            explicit Scheduler(size_t workers);
+            ~Scheduler();
+            Scheduler(const Scheduler&) = delete;
+            Scheduler& operator=(const Scheduler&) = delete;
+
+            /// @brief queues task as part of group, it may start right away
+            void spawn(Group& group, Task& task);
+            /// @brief runs tasks until every task of group is done
+            void wait(Group& group);
+
+            inline size_t workers() const { return queues.size(); }
+            Stats stats() const;
+
+            /// @brief the process wide scheduler, started on first use
+            static Scheduler& shared();
+            /// @brief how many workers shared starts with, only until it is first used
+            /// @note defaults to one less than the hardware threads, the waiting thread helps
+            static void configure(size_t workers);
+
+        private:
+            /// @brief a worker's deque and thread
+            struct Queue {
+                Deque<Task> tasks;
+                std::thread thread;
+            };
+
+            std::vector<std::unique_ptr<Queue>> queues;
+            /// @brief tasks spawned from outside the pool, and what sleeping workers wait on
+            std::mutex lock;
+            std::deque<Task*> injected;
+            std::condition_variable wake;
+            std::condition_variable finished;
+            /// @brief spawned tasks nobody has taken yet
+            std::atomic<size_t> queued{0};
+            /// @brief size of injected, read without the lock
+            std::atomic<size_t> incoming{0};
+            std::atomic<size_t> sleeping{0};
+            std::atomic<size_t> waiting{0};
+            std::atomic<uint64_t> executed{0};
+            std::atomic<uint64_t> stolen{0};
+            bool stopping = false;
+
+            /// @brief the loop of worker index
+            void work(size_t index);
+            /// @brief a task for the calling thread (worker index, or SIZE_MAX), nullptr if none
+            Task* find(size_t index);
+            /// @brief runs task and completes it in its group
+            void execute(Task* task);
+    };
+}
\ No newline at end of file
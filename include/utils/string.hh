@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace rift
+{
+    /// @class String
+    /// @brief The immutable string of a runtime value, two words wide
+    /// @details - up to INLINE characters are stored inline, without allocating
+    ///          - longer ones share a refcounted buffer, copying a String never copies text
+    ///          - concatenating long strings makes a rope node pointing at both sides,
+    ///            the text is only laid out flat once something needs it (view)
+    /// @note the counts are atomic, workers share text with their isolate (see ast::Worker),
+    ///       flattening isn't: a rope is flattened before it is shared
+    class String
+    {
+        public:
+            /// @brief longest string stored inline
+            static constexpr size_t INLINE = 15;
+            /// @brief concatenations shorter than this are copied flat instead of becoming a rope
+            static constexpr size_t ROPE_MIN = 64;
+
+            String() { small(0); }
+            String(std::string_view str);
+            String(const char* str) : String(std::string_view(str)) {}
+            String(const std::string& str) : String(std::string_view(str)) {}
+
+            String(const String& other) { std::memcpy(bytes, other.bytes, sizeof(bytes)); if (heap()) rep()->refs.fetch_add(1, std::memory_order_relaxed); }
+            String(String&& other) noexcept { std::memcpy(bytes, other.bytes, sizeof(bytes)); other.small(0); }
+            String& operator=(String other) noexcept { std::swap(bytes, other.bytes); return *this; }
+            ~String() { if (heap()) release(rep()); }
+
+            /// @brief left followed by right, O(1) once the result is long enough to be a rope
+            friend String operator+(const String& left, const String& right);
+
+            inline size_t size() const { return heap() ? rep()->size : INLINE - static_cast<uint8_t>(bytes[INLINE]); }
+            inline bool empty() const { return size() == 0; }
+            /// @brief the characters, a rope is flattened (once, for every String sharing it)
+            std::string_view view() const;
+            inline std::string str() const { return std::string(view()); }
+
+            /// @note both compare their contents, ropes are flattened
+            int compare(const String& other) const;
+            friend bool operator==(const String& left, const String& right);
+            friend std::ostream& operator<<(std::ostream& out, const String& str) { return out << str.view(); }
+
+            #pragma mark - Representation
+
+            /// @brief true when the characters are stored inline
+            inline bool inlined() const { return !heap(); }
+            /// @brief true for a concatenation that wasn't flattened yet
+            bool rope() const;
+            /// @brief how many Strings share the heap representation, 0 when inlined
+            inline uint32_t refs() const { return heap() ? rep()->refs.load(std::memory_order_relaxed) : 0; }
+            /// @brief the longest chain of rope nodes below this one, 0 when flat
+            inline uint32_t depth() const { return heap() ? rep()->depth : 0; }
+
+        private:
+            struct Rep {
+                std::atomic<uint32_t> refs;
+                /// @brief 0 for a buffer, a rope keeps its depth once flattened
+                uint32_t depth;
+                size_t size;
+            };
+            struct Buffer;
+            struct Rope;
+
+            /// @brief bytes[INLINE] is INLINE - size when inlined (the terminator of a full
+            ///        string), HEAP otherwise with the Rep pointer in front
+            static constexpr char HEAP = static_cast<char>(0xFF);
+            alignas(8) char bytes[INLINE + 1];
+
+            inline bool heap() const { return bytes[INLINE] == HEAP; }
+            inline Rep* rep() const { Rep* ret; std::memcpy(&ret, bytes, sizeof(ret)); return ret; }
+            inline void small(size_t size) { bytes[size] = '\0'; bytes[INLINE] = static_cast<char>(INLINE - size); }
+            inline void point(Rep* rep) { std::memcpy(bytes, &rep, sizeof(rep)); bytes[INLINE] = HEAP; }
+
+            /// @brief makes room for size characters, inline or in a new buffer
+            /// @return where the caller writes them
+            char* reserve(size_t size);
+            /// @brief drops a reference, frees what is no longer used (ropes without recursing)
+            static void release(Rep* rep);
+    };
+
+    static_assert(sizeof(String) == 16, "String must stay two words wide");
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rift
+{
+    /// @brief an interned identifier, equal names always get equal ids
+    using SymbolId = uint32_t;
+
+    /// @class Symbols
+    /// @brief Interns every identifier once (at scan time), the resolver, environment and
+    ///        engines then compare and hash 32 bit ids instead of strings
+    /// @note id 0 is the empty name, a default constructed Token has no symbol
+    class Symbols
+    {
+        public:
+            static constexpr SymbolId NONE = 0;
+            /// @brief names per chunk, and chunks at most
+            static constexpr size_t CHUNK = 1024;
+            static constexpr size_t CHUNKS = 4096;
+
+            /// @brief the table of the current isolate (see Isolate::current)
+            static Symbols& getInstance();
+
+            Symbols();
+            Symbols(const Symbols&) = delete;
+            Symbols& operator=(const Symbols&) = delete;
+
+            /// @class Sharing
+            /// @brief While one is alive intern may be called from several threads at once,
+            ///        it takes a lock then (modules compiled in parallel, see driver::Modules)
+            class Sharing
+            {
+                public:
+                    explicit Sharing(Symbols& symbols) : symbols(symbols) { symbols.sharing.fetch_add(1); }
+                    ~Sharing() { symbols.sharing.fetch_sub(1); }
+                    Sharing(const Sharing&) = delete;
+                    Sharing& operator=(const Sharing&) = delete;
+
+                private:
+                    Symbols& symbols;
+            };
+
+            /// @brief the id of name, interning it the first time it is seen
+            inline SymbolId intern(std::string_view name) {
+                if (sharing.load(std::memory_order_relaxed) == 0) return insert(name);
+                std::lock_guard guard(lock);
+                return insert(name);
+            }
+            /// @brief the text of an interned symbol, valid for the lifetime of the table
+            /// @note never locks, a name doesn't move once interned
+            inline std::string_view name(SymbolId id) const { return chunks[id / CHUNK][id % CHUNK]; }
+            /// @brief number of interned symbols (including the empty name)
+            inline size_t size() const { return count.load(std::memory_order_acquire); }
+
+        private:
+            static uint64_t hash(std::string_view name);
+            SymbolId insert(std::string_view name);
+            void grow();
+
+            /// @brief names in chunks that are only ever added, so views handed out by name()
+            ///        stay valid and can be read while another thread interns
+            std::unique_ptr<std::unique_ptr<std::string[]>[]> chunks;
+            std::atomic<size_t> count = 0;
+            std::vector<uint64_t> hashes;
+            /// @brief open addressing table of ids, UINT32_MAX marks an empty bucket
+            std::vector<SymbolId> buckets;
+            std::atomic<uint32_t> sharing = 0;
+            std::mutex lock;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,362 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+#include <utils/string.hh>
+
+namespace rift
+{
+    namespace vm { class ObjFunction; }
+    namespace ast { class ObjCallable; class ObjTask; }
+    class Heap;
+    class ObjNative;
+
+    /// @enum ObjType
+    /// @brief Kinds of heap allocated objects a Value may point to
+    enum class ObjType : uint8_t
+    {
+        STRING,
+        FUNCTION, // bytecode function (vm)
+        CALLABLE, // function body (tree-walking evaluator)
+        NATIVE,   // function of the host (see embed::Runtime::define)
+        TASK,     // spawned call (tree-walking evaluator)
+        ARRAY     // numbers stored unboxed
+    };
+
+    /// @class Obj
+    /// @brief Base of every heap object referenced by a Value
+    /// @note objects not made by a Heap (a script's constants) are unmanaged, whoever made
+    ///       them frees them and they must not point to managed objects
+    class Obj
+    {
+        public:
+            static constexpr uint8_t UNMANAGED = 0xFF;
+
+            Obj(ObjType type) : type(type) {}
+            virtual ~Obj() = default;
+            /// @brief marks the objects this one points to (see Heap::mark)
+            virtual void trace(Heap& heap) const { (void)heap; }
+
+            ObjType type;
+            /// @brief the pool the object was allocated from (set by the Heap)
+            uint8_t cls = UNMANAGED;
+            /// @brief reached during the current collection
+            bool marked = false;
+            /// @brief id of the Heap that allocated it, a heap only marks its own objects
+            uint32_t owner = 0;
+    };
+
+    /// @class ObjString
+    /// @brief An immutable heap string
+    /// @note objects are per value, the text itself is shared between them (see String)
+    class ObjString : public Obj
+    {
+        public:
+            ObjString(String str) : Obj(ObjType::STRING), str(std::move(str)) {}
+            String str;
+    };
+
+    /// @class ObjArray
+    /// @brief A fixed length array of numbers, kept as plain doubles so elements are read
+    ///        and written without boxing and the numeric kernels run over them in place
+    /// @note every number of the language is a double, so there is no integer storage
+    class ObjArray : public Obj
+    {
+        public:
+            ObjArray(std::vector<double> items) : Obj(ObjType::ARRAY), items(std::move(items)) {}
+            std::vector<double> items;
+    };
+
+    /// @enum ValueType
+    /// @brief The tag of a Value
+    /// @note UNDEFINED is never produced by the language, it marks unset slots
+    enum class ValueType : uint8_t
+    {
+        UNDEFINED,
+        NIL,
+        BOOL,
+        NUMBER,
+        OBJ
+    };
+
+    /// @struct Value
+    /// @brief A runtime value, numbers/bools/nil are stored inline and everything
+    ///        else is a pointer to an Obj, so copying a Value never allocates
+    struct Value
+    {
+        ValueType type;
+        union {
+            bool boolean;
+            double number;
+            Obj* obj;
+        } as;
+
+        Value() : type(ValueType::NIL) { as.number = 0; }
+
+        static inline Value undefined() { Value v; v.type = ValueType::UNDEFINED; return v; }
+        static inline Value nil() { return Value(); }
+        static inline Value boolean(bool b) { Value v; v.type = ValueType::BOOL; v.as.boolean = b; return v; }
+        static inline Value number(double n) { Value v; v.type = ValueType::NUMBER; v.as.number = n; return v; }
+        static inline Value object(Obj* o) { Value v; v.type = ValueType::OBJ; v.as.obj = o; return v; }
+
+        inline bool isUndefined() const { return type == ValueType::UNDEFINED; }
+        inline bool isNil() const { return type == ValueType::NIL; }
+        inline bool isBool() const { return type == ValueType::BOOL; }
+        inline bool isNumber() const { return type == ValueType::NUMBER; }
+        inline bool isObj(ObjType t) const { return type == ValueType::OBJ && as.obj->type == t; }
+        inline bool isString() const { return isObj(ObjType::STRING); }
+        inline bool isFunction() const { return isObj(ObjType::FUNCTION); }
+        inline bool isCallable() const { return isObj(ObjType::CALLABLE); }
+        inline bool isNative() const { return isObj(ObjType::NATIVE); }
+        inline bool isTask() const { return isObj(ObjType::TASK); }
+        inline bool isArray() const { return isObj(ObjType::ARRAY); }
+
+        inline const String& asString() const { return static_cast<ObjString*>(as.obj)->str; }
+        inline ObjArray* asArray() const { return static_cast<ObjArray*>(as.obj); }
+        /// @note defined in vm/chunk.hh
+        inline vm::ObjFunction* asFunction() const;
+        /// @note defined in ast/eval.hh
+        inline ast::ObjCallable* asCallable() const;
+        inline ObjNative* asNative() const;
+        /// @note defined in ast/eval.hh
+        inline ast::ObjTask* asTask() const;
+    };
+
+    static_assert(sizeof(Value) == 16, "Value must stay two words wide");
+
+    using Values = std::vector<Value>;
+
+    /// @class ObjNative
+    /// @brief A function implemented by the host, called with its arguments in place
+    /// @note the arguments are only valid during the call, the result must be a value of
+    ///       the heap the function was called from (or inline)
+    class ObjNative : public Obj
+    {
+        public:
+            using Fn = std::function<Value(std::span<const Value> args)>;
+            ObjNative(std::string name, uint32_t arity, Fn fn) : Obj(ObjType::NATIVE), name(std::move(name)), arity(arity), fn(std::move(fn)) {}
+            std::string name;
+            uint32_t arity;
+            Fn fn;
+    };
+
+    inline ObjNative* Value::asNative() const { return static_cast<ObjNative*>(as.obj); }
+
+    /// @class Heap
+    /// @brief Owns the objects created while evaluating, and frees the ones no root reaches
+    /// @details objects are carved out of pools of fixed size classes (larger ones go to
+    ///          operator new) and collected by marking from every registered Roots, then
+    ///          sweeping what wasn't marked. A collection only happens at a safepoint, where
+    ///          the engine knows every live value is somewhere its roots trace
+    /// @note a Value that isn't reachable from a root, a pin or another object is only
+    ///       valid until the next safepoint. Objects of another heap are never marked, they
+    ///       must be kept alive by that heap's roots (a worker's heap, see ast::Worker)
+    class Heap
+    {
+        public:
+            /// @brief object sizes of the pools, anything larger is allocated on its own
+            static constexpr std::array<size_t, 7> CLASSES = {32, 48, 64, 96, 128, 192, 256};
+            static constexpr uint8_t LARGE = CLASSES.size();
+            /// @brief bytes reserved at a time by a pool
+            static constexpr size_t SLAB_SIZE = 64 * 1024;
+            /// @brief bytes to allocate before the first collection, and at least between two
+            static constexpr size_t PRESSURE_MIN = 1024 * 1024;
+
+            Heap();
+            ~Heap();
+            Heap(const Heap&) = delete;
+            Heap& operator=(const Heap&) = delete;
+
+            /// @brief the heap entered on this thread, the current isolate's otherwise
+            static Heap& getInstance();
+            /// @brief the heap entered on this thread, fallback otherwise
+            static Heap& current(Heap& fallback);
+
+            /// @class Scope
+            /// @brief Makes this thread allocate on another heap than its isolate's for its
+            ///        lifetime (scopes nest): literals, folded constants and the values of
+            ///        visitors without a Worker (a module compiled on a worker, see driver::Modules)
+            class Scope
+            {
+                public:
+                    explicit Scope(Heap& heap);
+                    ~Scope();
+                    Scope(const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+
+                private:
+                    Heap* previous;
+            };
+
+            /// @class Roots
+            /// @brief Where live values are kept outside of the heap (globals, frames, stacks),
+            ///        registered with the heap for as long as it exists
+            class Roots
+            {
+                public:
+                    explicit Roots(Heap& heap);
+                    virtual ~Roots();
+                    Roots(const Roots&) = delete;
+                    Roots& operator=(const Roots&) = delete;
+
+                    /// @brief marks every value held (see Heap::mark)
+                    virtual void trace(Heap& heap) const = 0;
+
+                private:
+                    friend class Heap;
+                    Heap* heap;
+            };
+
+            /// @class Pins
+            /// @brief Objects kept alive as long as the pins are, the constants of a program
+            ///        live in pins made in its arena
+            class Pins : public Roots
+            {
+                public:
+                    using Roots::Roots;
+                    void trace(Heap& heap) const override;
+                    std::vector<Obj*> objects;
+            };
+
+            /// @class Pinning
+            /// @brief Pins every object allocated on the heap for its lifetime (scopes nest)
+            class Pinning
+            {
+                public:
+                    Pinning(Heap& heap, Pins& pins) : heap(heap), previous(heap.pinning) { heap.pinning = &pins; }
+                    ~Pinning() { heap.pinning = previous; }
+                    Pinning(const Pinning&) = delete;
+                    Pinning& operator=(const Pinning&) = delete;
+
+                private:
+                    Heap& heap;
+                    Pins* previous;
+            };
+
+            /// @struct Stats
+            /// @brief What the heap holds, as of the last allocation or collection
+            struct Stats {
+                /// @brief live objects, and the bytes of the slots they take
+                size_t objects = 0;
+                size_t bytes = 0;
+                /// @brief bytes taken from the system by the pools and large objects
+                size_t reserved = 0;
+                size_t collections = 0;
+                /// @brief objects freed by every collection so far
+                size_t freed = 0;
+                /// @brief live objects per size class, large ones last
+                std::array<size_t, CLASSES.size() + 1> classes = {};
+            };
+
+            /// @brief allocates an object owned by the heap
+            template <typename T, typename... Args>
+            T* allocate(Args&&... args) {
+                constexpr uint8_t cls = sizeClass(sizeof(T));
+                static_assert(alignof(T) <= alignof(std::max_align_t), "heap objects can't be over aligned");
+                T* obj = new (slot(cls, sizeof(T))) T(std::forward<Args>(args)...);
+                track(obj, cls);
+                return obj;
+            }
+
+            /// @brief allocates a string owned by the heap
+            inline Value string(String str);
+            /// @brief allocates an array owned by the heap
+            inline Value array(std::vector<double> items);
+
+            /// @brief collects if enough was allocated since the last collection
+            inline void safepoint() { if (pending()) collect(); }
+            /// @brief true once enough was allocated to make a collection worthwhile
+            inline bool pending() const { return pressure >= threshold; }
+            /// @brief frees every object no root reaches
+            void collect();
+            /// @brief marks a value and what it points to as reachable
+            inline void mark(const Value& val);
+            void mark(Obj* obj);
+
+            inline const Stats& stats() const { return counts; }
+            /// @brief what the objects it allocates are owned by (see Obj::owner)
+            inline uint32_t identity() const { return id; }
+
+            /// @brief the size class of an object of size bytes, LARGE if none fits
+            static constexpr uint8_t sizeClass(size_t size) {
+                for (uint8_t i = 0; i < CLASSES.size(); i++)
+                    if (size <= CLASSES[i]) return i;
+                return LARGE;
+            }
+
+        private:
+            struct Pool {
+                std::vector<std::unique_ptr<std::byte[]>> slabs;
+                /// @brief freed slots, each one holding the next
+                void* free = nullptr;
+                std::byte* next = nullptr;
+                std::byte* end = nullptr;
+            };
+
+            /// @brief storage for an object of the class
+            void* slot(uint8_t cls, size_t size);
+            /// @brief registers a constructed object
+            void track(Obj* obj, uint8_t cls);
+            /// @brief destroys an object and gives its storage back
+            void release(Obj* obj);
+
+            const uint32_t id;
+            std::array<Pool, CLASSES.size()> pools;
+            std::vector<Obj*> objects;
+            std::vector<Roots*> roots;
+            /// @brief marked objects whose own references weren't marked yet
+            std::vector<Obj*> gray;
+            Pins* pinning = nullptr;
+            Stats counts;
+            /// @brief bytes allocated since the last collection, string and array contents included
+            size_t pressure = 0;
+            size_t threshold = PRESSURE_MIN;
+    };
+
+    /// @brief only false is falsy
+    inline bool truthy(const Value& val) { return !val.isBool() || val.as.boolean; }
+    /// @brief structural equality, strings and arrays compare by contents
+    extern bool equal(const Value& left, const Value& right);
+    /// @brief the string form of a value as shown by print
+    extern std::string printValue(const Value& val);
+    /// @brief the string form of a value as reported back by evaluate
+    extern std::string resultValue(const Value& val);
+
+    inline Value Heap::string(String str)
+    {
+        if (!str.inlined()) pressure += str.size();
+        return Value::object(allocate<ObjString>(std::move(str)));
+    }
+
+    inline Value Heap::array(std::vector<double> items)
+    {
+        pressure += items.size() * sizeof(double);
+        return Value::object(allocate<ObjArray>(std::move(items)));
+    }
+
+    inline void Heap::mark(const Value& val)
+    {
+        if (val.type == ValueType::OBJ) mark(val.as.obj);
+    }
+}
\ No newline at end of file
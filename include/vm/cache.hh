@@ -0,0 +1,60 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vm/chunk.hh>
+#include <utils/symbols.hh>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace rift
+{
+    namespace vm
+    {
+        /// @class ScriptCache
+        /// @brief Compiled scripts saved on disk (.rfc), so an unchanged file runs without
+        ///        being scanned, parsed or compiled again
+        /// @details a cache file is keyed by a hash of the source and of this build's bytecode
+        ///          (format and opcode set), and lives in $XDG_CACHE_HOME/rift when that is set
+        ///          or next to the source otherwise (foo.rf caches to foo.rfc). Any file that
+        ///          doesn't match its key or checksum, is cut short, or holds code that doesn't
+        ///          verify is treated as a miss
+        class ScriptCache
+        {
+            public:
+                /// @brief bump whenever the compiler's output or this layout changes
+                static constexpr uint32_t FORMAT = 2;
+
+                /// @brief the key of source for this build
+                static uint64_t key(std::span<const char> source);
+                /// @brief where the script compiled from file (with the given key) is cached
+                static std::string path(const std::string& file, uint64_t key);
+
+                /// @brief the bytes of a cache file holding script
+                static std::string encode(uint64_t key, const Script& script, const Symbols& symbols);
+                /// @brief a script back from what encode wrote, nullptr unless bytes are exactly that with key
+                static std::unique_ptr<Script> decode(std::span<const char> bytes, uint64_t key, Symbols& symbols);
+
+                /// @brief maps a cache file back into a script, nullptr on a miss
+                /// @param symbols where the names of the script's globals are interned
+                static std::unique_ptr<Script> load(const std::string& path, uint64_t key, Symbols& symbols);
+                /// @brief writes script to path (atomically, concurrent runs may race to store it)
+                /// @return false if the file couldn't be written, which only costs a recompile
+                static bool store(const std::string& path, uint64_t key, const Script& script, const Symbols& symbols);
+        };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vm/opcodes.hh>
+#include <utils/value.hh>
+#include <utils/flat_map.hh>
+#include <utils/symbols.hh>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rift
+{
+    namespace vm
+    {
+        /// @struct Chunk
+        /// @brief A sequence of bytecode with its constant pool and line table
+        struct Chunk
+        {
+            std::vector<uint8_t> code;
+            std::vector<int> lines;
+            std::vector<Value> constants;
+
+            /// @brief appends a byte to the chunk
+            inline void write(uint8_t byte, int line) { code.push_back(byte); lines.push_back(line); }
+            /// @brief appends a u16 operand (big endian)
+            inline void write16(uint16_t val, int line) { write((val >> 8) & 0xff, line); write(val & 0xff, line); }
+            /// @brief adds a constant and returns its index
+            uint16_t addConstant(Value val);
+
+            /// @brief human readable listing of the chunk
+            std::string disassemble(const std::string& name) const;
+        };
+
+        /// @class ObjFunction
+        /// @brief A compiled function body
+        class Script;
+
+        class ObjFunction : public Obj
+        {
+            public:
+                ObjFunction(std::string name) : Obj(ObjType::FUNCTION), name(std::move(name)), arity(0) {}
+                std::string name;
+                unsigned arity;
+                Chunk chunk;
+                /// @brief the script whose globals the *_GLOBAL operands index
+                const Script* script = nullptr;
+        };
+
+        /// @class Script
+        /// @brief The output of the compiler, owns every constant object it refers to
+        ///        and can be run any number of times by a VM
+        class Script
+        {
+            public:
+                Script() = default;
+                ~Script() = default;
+
+                /// @brief the top level code of the program
+                ObjFunction* main = nullptr;
+                /// @brief names of the globals, indexed by the *_GLOBAL operands
+                std::vector<SymbolId> globals;
+
+                /// @brief allocates a constant string owned by the script
+                ObjString* newString(String str);
+                /// @brief allocates a function owned by the script
+                ObjFunction* newFunction(std::string name);
+                /// @brief returns the index of a global, adding it if needed
+                uint16_t global(SymbolId name);
+
+                /// @brief listing of every function in the script
+                std::string disassemble() const;
+
+            private:
+                std::vector<std::unique_ptr<Obj>> objects;
+                FlatMap<SymbolId, uint16_t> global_index;
+        };
+    }
+
+    inline vm::ObjFunction* Value::asFunction() const { return static_cast<vm::ObjFunction*>(as.obj); }
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/grmr.hh>
+#include <ast/expr.hh>
+#include <ast/stmt.hh>
+#include <ast/decl.hh>
+#include <ast/prgm.hh>
+#include <vm/chunk.hh>
+#include <unordered_map>
+
+namespace rift
+{
+    namespace vm
+    {
+        using namespace rift::ast;
+
+        /// @class Compiler
+        /// @brief Lowers a Program into bytecode by visiting the AST once
+        /// @details Every expression leaves exactly one value on the stack, every
+        ///          stmt/decl reports how many values it left through the size of
+        ///          the returned Values (0 or 1) so the enclosing block can pop it
+        ///          (or record it as a result at the top level).
+        class Compiler : public Visitor
+        {
+            public:
+                Compiler() = default;
+                ~Compiler() = default;
+
+                /// @brief compiles a program into a runnable script
+                std::unique_ptr<Script> compile(const Program& prgm);
+
+                /* expr */
+                Value visit_assign(const Assign& expr) const override;
+                Value visit_binary(const Binary& expr) const override;
+                Value visit_grouping(const Grouping& expr) const override;
+                Value visit_literal(const Literal& expr) const override;
+                Value visit_unary(const Unary& expr) const override;
+                Value visit_ternary(const Ternary& expr) const override;
+                Value visit_call(const Call& expr) const override;
+                Value visit_spawn(const Spawn& expr) const override;
+                Value visit_await(const Await& expr) const override;
+                Value visit_array(const Array& expr) const override;
+                Value visit_index(const Index& expr) const override;
+                Value visit_set_index(const SetIndex& expr) const override;
+
+                /* stmt */
+                Value visit_expr_stmt(const StmtExpr& stmt) const override;
+                Value visit_print_stmt(const StmtPrint& stmt) const override;
+                Value visit_if_stmt(const StmtIf& stmt) const override;
+                Value visit_return_stmt(const StmtReturn& stmt) const override;
+
+                /* decl */
+                Values visit_decl_stmt(const DeclStmt& decl) const override;
+                Values visit_decl_var(const DeclVar& decl) const override;
+                Values visit_decl_func(const DeclFunc& decl) const override;
+                Values visit_for(const For& decl) const override;
+                Values visit_block_stmt(const Block& block) const override;
+                Values visit_program(const Program& prgm) const override;
+
+            private:
+                mutable Script* script = nullptr;
+                mutable ObjFunction* function = nullptr;
+                mutable int line = 0;
+                /// @brief deduplicated constant strings of the script
+                mutable std::unordered_map<std::string, ObjString*> strings;
+                /// @brief first frame slot of each open scope of the current function
+                mutable std::vector<uint16_t> scopes;
+                /// @brief frame slots taken by the open scopes of the current function
+                mutable uint16_t locals = 0;
+
+                #pragma mark - Emitters
+
+                inline Chunk& chunk() const { return function->chunk; }
+                inline void emit(uint8_t byte) const { chunk().write(byte, line); }
+                inline void emit(OpCode op, uint16_t operand) const { emit(op); chunk().write16(operand, line); }
+                void emitConstant(Value val) const;
+                /// @brief emits a forward jump and returns the offset to patch
+                size_t emitJump(OpCode op) const;
+                /// @brief points a forward jump at the current end of the chunk
+                void patchJump(size_t offset) const;
+                /// @brief emits a backward jump to loop_start
+                void emitLoop(size_t loop_start) const;
+
+                /// @brief compiles a branch of an if/elif/else (either a stmt or a block)
+                void branch(const StmtIf::Stmt& branch) const;
+                /// @brief compiles a decl and pops whatever value it left behind
+                void discard(const Decl& decl) const;
+
+                #pragma mark - Locals
+
+                /// @brief reserves the slots of a scope on the stack
+                void beginScope(uint32_t slots) const;
+                /// @brief pops the slots of the innermost scope
+                void endScope() const;
+                /// @brief the frame slot of a resolved local (slot 0 holds the callee)
+                inline uint16_t local(const Address& addr) const { return scopes[scopes.size() - 1 - addr.depth] + addr.slot + 1; }
+        };
+
+        /// @class CompilerException
+        /// @brief The base exception for the compiler
+        class CompilerException : public std::exception
+        {
+            public:
+                CompilerException(const std::string &message) : message(message) {}
+                ~CompilerException() = default;
+
+                const char *what() const noexcept override { return message.c_str(); }
+
+            private:
+                std::string message;
+        };
+    }
+}
\ No newline at end of file
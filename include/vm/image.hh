@@ -0,0 +1,63 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vm/chunk.hh>
+#include <utils/symbols.hh>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rift
+{
+    namespace vm
+    {
+        /// @class Image
+        /// @brief A program compiled ahead of time (--emit), which runs without its source
+        /// @details an image is a header and the scripts of the program's imports then its own,
+        ///          each laid out like a cache file (see ScriptCache) keyed by this build only.
+        ///          --emit=obj writes one to foo.rfo, which riftlang runs like a source file, and
+        ///          --emit=exe appends it to a copy of the running executable, followed by a
+        ///          trailer that copy finds at startup (only the program runs then, on the vm)
+        class Image
+        {
+            public:
+                /// @brief bump whenever this layout changes (the scripts follow ScriptCache::FORMAT)
+                static constexpr uint32_t FORMAT = 1;
+
+                /// @brief whether bytes start like an image (from any build)
+                static bool is(std::span<const char> bytes);
+
+                /// @brief the image of scripts, in the order they run
+                static std::string encode(std::span<const std::unique_ptr<Script>> scripts, const Symbols& symbols);
+                /// @brief the scripts of an image, in the order they run
+                /// @param symbols where the names of the scripts' globals are interned
+                /// @return empty if the image is cut short or was written by another build
+                static std::vector<std::unique_ptr<Script>> decode(std::span<const char> bytes, Symbols& symbols);
+
+                /// @brief the image appended to an executable, empty if there is none
+                static std::span<const char> embedded(std::span<const char> executable);
+                /// @brief the path of the running executable, empty where it can't be found
+                static std::string self();
+
+                /// @brief writes image to path, as an executable running it when executable is set
+                /// @return false if the file (or the running executable) couldn't be written (read)
+                static bool write(const std::string& path, std::string_view image, bool executable);
+        };
+    }
+}
@@ -0,0 +1,96 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+/// @note every opcode is listed once here, the enum, the disassembler names and
+///       the computed-goto dispatch table are all generated from this list
+#define RIFT_OPCODES(X) \
+    /* constants */            \
+    X(CONSTANT)                \
+    X(NIL)                     \
+    X(TRUE)                    \
+    X(FALSE)                   \
+    X(POP)                     \
+    /* globals */              \
+    X(GET_GLOBAL)              \
+    X(SET_GLOBAL)              \
+    X(DEFINE_GLOBAL)           \
+    X(DEFINE_CONST)            \
+    X(DEFINE_FUNC)             \
+    /* locals */               \
+    X(GET_LOCAL)               \
+    X(SET_LOCAL)               \
+    X(RESERVE)                 \
+    X(POPN)                    \
+    /* arithmetic */           \
+    X(ADD)                     \
+    X(SUBTRACT)                \
+    X(MULTIPLY)                \
+    X(DIVIDE)                  \
+    X(NEGATE)                  \
+    X(NOT)                     \
+    X(TO_BOOL)                 \
+    /* comparison */           \
+    X(EQUAL)                   \
+    X(NOT_EQUAL)               \
+    X(GREATER)                 \
+    X(GREATER_EQUAL)           \
+    X(LESS)                    \
+    X(LESS_EQUAL)              \
+    /* control flow */         \
+    X(JUMP)                    \
+    X(JUMP_IF_FALSE)           \
+    X(JUMP_IF_NOT_NIL)         \
+    X(LOOP)                    \
+    X(CALL)                    \
+    X(RETURN)                  \
+    /* arrays */               \
+    X(ARRAY)                   \
+    X(GET_INDEX)               \
+    X(SET_INDEX)               \
+    X(GET_BUILTIN)             \
+    X(CALL_BUILTIN)            \
+    /* statements */           \
+    X(PRINT)                   \
+    X(RESULT)                  \
+    X(HALT)
+
+namespace rift
+{
+    namespace vm
+    {
+        /// @enum OpCode
+        /// @brief Single byte instructions of the rift bytecode
+        /// @details operands follow the opcode inline in the code stream
+        ///          - CONSTANT, *_GLOBAL, DEFINE_*: u16 index
+        ///          - *_LOCAL: u16 slot (relative to the frame), RESERVE, POPN: u16 count
+        ///          - JUMP, JUMP_IF_*, LOOP: u16 offset
+        ///          - CALL: u8 argument count
+        ///          - ARRAY: u16 element count, GET_BUILTIN: u16 index (of the global the builtin's name is)
+        ///          - CALL_BUILTIN: u8 builtin, u8 argument count
+        enum OpCode : uint8_t
+        {
+            #define __RIFT_OPCODE_ENUM(name) OP_##name,
+            RIFT_OPCODES(__RIFT_OPCODE_ENUM)
+            #undef __RIFT_OPCODE_ENUM
+            OP_COUNT
+        };
+
+        /// @brief Name of the opcode (used by the disassembler)
+        const char* opcodeName(OpCode op);
+    }
+}
\ No newline at end of file
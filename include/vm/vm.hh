@@ -0,0 +1,119 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ast/prgm.hh>
+#include <vm/chunk.hh>
+#include <utils/isolate.hh>
+#include <utils/results.hh>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// computed goto (labels as values) is a GNU extension, fall back to a switch
+#if !defined(RIFT_COMPUTED_GOTO)
+    #if defined(__GNUC__) || defined(__clang__)
+        #define RIFT_COMPUTED_GOTO 1
+    #else
+        #define RIFT_COMPUTED_GOTO 0
+    #endif
+#endif
+
+namespace rift
+{
+    namespace vm
+    {
+        /// @class VM
+        /// @brief Stack based virtual machine running scripts produced by the Compiler
+        /// @note selected with `--engine=vm`, the tree walking Visitor stays the reference engine
+        class VM
+        {
+            public:
+                /// @param isolate whose error state and symbols the scripts run with
+                VM(Isolate& isolate = Isolate::current());
+                ~VM() = default;
+
+                /// @brief Compiles and runs the given program (drop-in for Eval::evaluate)
+                /// @note results are reported for top level declarations only
+                void evaluate(const rift::ast::Program& prgm, ResultSink& sink);
+                /// @brief Compiles and runs the given program, collecting every top level result
+                std::vector<std::string> evaluate(const rift::ast::Program& prgm, bool interactive);
+
+                /// @brief Runs an already compiled script, globals persist between runs
+                void run(const Script& script, ResultSink& sink);
+                /// @brief Runs a script and keeps it alive as long as the VM (see evaluate)
+                void run(std::unique_ptr<Script> script, ResultSink& sink);
+
+                /// @brief the most call frames that were live at once
+                inline size_t peakDepth() const { return peak; }
+
+                static constexpr size_t FRAMES_MAX = 1024;
+                static constexpr size_t STACK_MAX = FRAMES_MAX * 64;
+
+            private:
+                struct Global;
+                struct CallFrame {
+                    ObjFunction* function;
+                    const uint8_t* ip;
+                    Value* slots;
+                    Global* const* linked;
+                };
+
+                struct Global {
+                    Value value = Value::undefined();
+                    bool is_const = false;
+                };
+
+                /// @brief globals, shared by every script run on this VM (REPL lines)
+                /// @note a deque so linked scripts keep pointing at the same globals as it grows
+                std::deque<Global> globals;
+                /// @brief index of each global's symbol in globals
+                FlatMap<SymbolId, uint32_t> global_index;
+                /// @brief each script's global indices resolved against globals, so functions
+                ///        defined by one script can be called from another
+                std::unordered_map<const Script*, std::vector<Global*>> links;
+                /// @brief scripts compiled by evaluate, kept alive since globals may hold their functions
+                std::vector<std::unique_ptr<Script>> scripts;
+
+                Isolate& isolate;
+                std::unique_ptr<Value[]> stack;
+                /// @brief the top of the stack as of the last safepoint, the bottom when not running
+                Value* top;
+                CallFrame frames[FRAMES_MAX];
+                size_t peak = 0;
+
+                /// @brief the stack and globals are roots of the isolate's heap
+                struct Roots : public Heap::Roots {
+                    explicit Roots(VM& vm) : Heap::Roots(vm.isolate.heap), vm(vm) {}
+                    void trace(Heap& heap) const override;
+                    VM& vm;
+                } roots;
+
+                /// @brief allocates a runtime string on the isolate's heap
+                ObjString* newString(String str);
+                /// @brief runs a script's main from the bottom of the stack
+                void execute(const Script& script, ResultSink& sink);
+                /// @brief the dispatch loop, runs frames[base] (and what it calls) until it returns
+                /// @param sp the top of the stack, above the frame's function and arguments
+                Value dispatch(size_t base, Value* sp, ResultSink& sink);
+                /// @brief calls fn with arg above sp as frames[depth], how map reaches the script's functions
+                Value apply(const Value& fn, const Value& arg, size_t depth, Value* sp, ResultSink& sink);
+                /// @brief resolves the globals of a script, the first time it is seen
+                Global* const* link(const Script* script);
+        };
+    }
+}
\ No newline at end of file
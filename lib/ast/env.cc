@@ -20,40 +20,55 @@ namespace rift
 {
     namespace ast
     {
-        Token Environment::getEnv(const str_t& name) const
+        uint32_t Environment::slot(SymbolId name)
         {
-            if (!values.contains(name)) {
-                
-                if(child != nullptr)
-                    return child->getEnv(name);
-
-                return Token(rift::scanner::TokenType::NIL, "nil", "nil", -1);
+            auto [slot, bound] = index.emplace(name, static_cast<uint32_t>(globals.size()));
+            if (bound) {
+                globals.emplace_back();
+                names.push_back(name);
             }
-            return values.at(name);
+            return *slot;
         }
 
-        void Environment::setEnv(const str_t& name, const Token& value, bool is_const)
+        void Environment::set(uint32_t slot, const rift::Value& value, bool is_const)
         {
-            if (!values.contains(name) && child != nullptr) {
-                child->setEnv(name, value, is_const);
+            auto& global = globals[slot];
+            if (global.is_const && !global.value.isUndefined()) {
+                error::report(0, "Environment", "Cannot reassign a constant variable", rift::scanner::Token(), std::exception());
             } else {
-                if (values.contains(name) && const_keys.contains(name)) {
-                    error::report(0, "Environment", "Cannot reassign a constant variable", values.at(name), std::exception());
-                } else {
-                    values[name] = value;
-                    if (is_const) const_keys.insert(name);
-                }
+                global.value = value;
+                global.version = ++versions;
+                if (is_const) global.is_const = true;
             }
         }
 
+        rift::Value Environment::getEnv(const str_t& name) const
+        {
+            auto slot = index.find(symbols.intern(name));
+            if (!slot) return rift::Value::undefined();
+            return globals[*slot].value;
+        }
+
+        bool Environment::contains(const str_t& name) const
+        {
+            return !getEnv(name).isUndefined();
+        }
+
+        void Environment::setEnv(const str_t& name, const rift::Value& value, bool is_const)
+        {
+            set(slot(name), value, is_const);
+        }
+
+        void Environment::trace(Heap& heap) const
+        {
+            for (const auto& global : globals) heap.mark(global.value);
+        }
+
         void Environment::printState()
         {
-            Environment *curr = this;
-            while (curr != nullptr) {
-                for (const auto& [key, value] : curr->values) {
-                    std::cout << key << " => " << value.to_string() << std::endl;
-                }
-                curr = curr->child;
+            for (size_t i = 0; i < globals.size(); i++) {
+                if (globals[i].value.isUndefined()) continue;
+                std::cout << symbols.name(names[i]) << " => " << rift::resultValue(globals[i].value) << std::endl;
             }
         }
     }
@@ -17,8 +17,10 @@
 #include <error/error.hh>
 #include <utils/macros.hh>
 #include <ast/env.hh>
+#include <ast/profiler.hh>
+#include <algorithm>
+#include <utility>
 
-using env = rift::ast::Environment;
 
 namespace rift
 {
@@ -26,175 +28,159 @@ namespace rift
     {
         #pragma mark - Eval
 
-        Eval::Eval()
+        /// @brief slots preallocated for frames, enough for most call chains to never grow it
+        static constexpr size_t FRAME_POOL = 4096;
+
+        Eval::Eval(Isolate& isolate) : visitor(new Visitor()), frames(isolate.heap, *visitor)
         {
-            this->visitor = std::unique_ptr<Visitor>(new Visitor());
+            this->visitor->isolate = &isolate;
+            this->visitor->reserve(FRAME_POOL);
         }
 
-        std::vector<std::string> Eval::evaluate(const Program& expr, bool interactive)
+        void Eval::evaluate(const Program& prgm, ResultSink& sink)
         {
-            std::vector<std::string> res;
-
+            Isolate::Scope enter(*visitor->isolate);
+            visitor->sink = &sink;
             try {
-                auto toks = expr.accept(*visitor.get());
-                for (const auto& tok : toks) {
-                    any val = tok.getLiteral();
-                    if (isNumber(tok)) {
-                        res.push_back(castNumberString(tok));
-                    } else if (isString(tok)) {
-                        res.push_back(castString(tok));
-                    } else if (val.type() == typeid(bool)) {
-                        res.push_back(std::any_cast<bool>(val) ? "true" : "false");
-                    } else if (val.type() == typeid(std::nullptr_t)) {
-                        res.push_back("null");
-                    } else {
-                        res.push_back("undefined");
-                    }
-                }
+                prgm.accept(*visitor.get());
+            } catch (const error::Error&) {
+                visitor->sink = nullptr;
+                visitor->unwind();
+                throw;
             } catch (const std::runtime_error& e) {
+                visitor->sink = nullptr;
+                visitor->unwind();
                 error::runTimeError(e.what());
             }
+            visitor->sink = nullptr;
+            // a program (or prompt line) is done, what it printed shows up
+            visitor->isolate->output.flush();
+            visitor->isolate->heap.safepoint();
+        }
 
-            return res;
+        Value Eval::call(const Value& fn, std::span<const Value> args)
+        {
+            Isolate::Scope enter(*visitor->isolate);
+            try {
+                auto res = visitor->call(fn, args);
+                visitor->join();
+                visitor->isolate->output.flush();
+                return res;
+            } catch (...) {
+                // errors and whatever the host's functions threw leave the frames open
+                visitor->unwind();
+                throw;
+            }
+        }
+
+        std::vector<std::string> Eval::evaluate(const Program& prgm, bool interactive)
+        {
+            (void)interactive;
+            CollectResults collect;
+            evaluate(prgm, collect);
+            return std::move(collect.results);
         }
 
         #pragma mark - Eval Visitor
 
-        Token Visitor::visit_literal(const Literal& expr) const
+        void Visitor::trace(Heap& heap) const
         {
-            Token val = expr.value;
-            any literal;
-            Token res = env::getInstance(false).getEnv(castString(val));
-            
-            if (val.type == TokenType::NIL) 
-                return Token(TokenType::NIL, "nil", nullptr, expr.value.line);
-            else if (val.type == TokenType::IDENTIFIER || val.type == TokenType::C_IDENTIFIER) {
-                if (res.type == TokenType::NIL) rift::error::runTimeError("Undefined variable '" + castString(val) + "'");
-                literal = res.getLiteral();
-            } else {
-                literal = val.getLiteral();
-            }
+            for (const auto& val : slots) heap.mark(val);
+            heap.mark(returned);
+            for (const auto& job : spawned) heap.mark(&job->task);
+            if (snapshot != nullptr)
+                for (const auto& val : snapshot->values) heap.mark(val);
+        }
 
-            if (literal.type() == typeid(std::string)) 
-                return Token(TokenType::STRINGLITERAL, std::any_cast<std::string>(literal), 0, expr.value.line);
-
-            /* Numeric Literals */
-            else if (literal.type() == typeid(double))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<double>(literal)), std::any_cast<double>(literal), expr.value.line);
-            else if (literal.type() == typeid(int))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<int>(literal)), std::any_cast<int>(literal), expr.value.line);
-            else if (literal.type() == typeid(unsigned))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<unsigned>(literal)), std::any_cast<unsigned>(literal), expr.value.line);
-            else if (literal.type() == typeid(short))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<short>(literal)), std::any_cast<short>(literal), expr.value.line);
-            else if (literal.type() == typeid(unsigned long))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<unsigned long>(literal)), std::any_cast<unsigned long>(literal), expr.value.line);
-            else if (literal.type() == typeid(unsigned short))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<unsigned short>(literal)), std::any_cast<unsigned short>(literal), expr.value.line);
-            else if (literal.type() == typeid(unsigned long long))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<unsigned long long>(literal)), std::any_cast<unsigned long long>(literal), expr.value.line);
-            else if (literal.type() == typeid(long long))
-                return Token(TokenType::NUMERICLITERAL, std::to_string(std::any_cast<long long>(literal)), std::any_cast<long long>(literal), expr.value.line);
-            
-            /* Other Literals */
-            else if (literal.type() == typeid(std::nullptr_t))
-                return Token(TokenType::NIL, "nil", nullptr, expr.value.line);
-            else if (literal.type() == typeid(bool))
-                return Token(std::any_cast<bool>(literal)?TokenType::TRUE:TokenType::FALSE, std::to_string(std::any_cast<bool>(literal)), std::any_cast<bool>(literal), expr.value.line);
-            else if (literal.type() == typeid(std::nullptr_t))
-                return Token(TokenType::NIL, "nil", nullptr, expr.value.line);
-
-            /* Function */
-            else if (res.type == TokenType::FUN)
+        void Visitor::unwind() const
+        {
+            slots.clear();
+            scopes.clear();
+            signal = Signal::NORMAL;
+            returned = Value::nil();
+            calls = 0;
+            running = nullptr;
+            top = false;
+            // the tasks still read the frames' isolate, whatever they printed is dropped
+            for (const auto& job : spawned) Scheduler::shared().wait(job->group);
+            spawned.clear();
+            snapshot.reset();
+        }
+
+        Value Visitor::visit_literal(const Literal& expr) const
+        {
+            if (expr.value.type == TokenType::IDENTIFIER || expr.value.type == TokenType::C_IDENTIFIER) {
+                const auto& res = expr.addr.global() ? global(expr.addr.slot) : local(expr.addr);
+                if (res.isUndefined()) rift::error::runTimeError("Undefined variable '" + expr.value.lexeme + "'");
                 return res;
-            else
+            }
+
+            if (expr.constant.isUndefined())
                 rift::error::runTimeError("Unknown literal type");
-            return Token();
+            return expr.constant;
         }
 
-        Token Visitor::visit_binary(const Binary& expr) const
+        Value Visitor::visit_binary(const Binary& expr) const
         {
-            Token left;
-            Token right;
-
-            string l_s, r_s;
-            any resAny;
-            bool resBool;
+            Value left;
+            Value right;
 
             // Operators that can't evaulate yet
             switch (expr.op.type) {
                 case NULLISH_COAL:
-                    left = expr.left.get()->accept(*this);
-                    if (left.type == TokenType::NIL) {
-                        right = expr.right.get()->accept(*this);
-                        return right;
-                    }
+                    left = expr.left->accept(*this);
+                    if (left.isNil())
+                        return expr.right->accept(*this);
                     return left;
                 case LOG_AND:
-                    left = expr.left.get()->accept(*this);
-                    if(truthy(left)) {
-                        if(truthy(expr.right.get()->accept(*this)))
-                            return Token(TokenType::TRUE, "true", "true", expr.op.line);
-                        return Token(TokenType::FALSE, "false", "false", expr.op.line);
-                    }
-                    return Token();
+                    left = expr.left->accept(*this);
+                    if (truthy(left))
+                        return Value::boolean(truthy(expr.right->accept(*this)));
+                    return Value::boolean(false);
                 case LOG_OR:
-                    left = expr.left.get()->accept(*this);
-                    if (truthy(left)) {
-                        right = expr.right.get()->accept(*this);
-                        return Token(TokenType::TRUE, "true", "true", expr.op.line);
-                    } else {
-                        right = expr.left.get()->accept(*this);
-                        if (truthy(right)) return Token(TokenType::TRUE, "true", "true", expr.op.line);
-                        return Token(TokenType::FALSE, "false", "false", expr.op.line);
-                    }
+                    left = expr.left->accept(*this);
+                    if (truthy(left))
+                        return Value::boolean(true);
+                    return Value::boolean(truthy(expr.right->accept(*this)));
                 default:
                     break;
             }
 
-            left = expr.left.get()->accept(*this);
-            right = expr.right.get()->accept(*this);
+            left = expr.left->accept(*this);
+            right = expr.right->accept(*this);
+
+            // numbers (and equality) go straight through the dispatch table
+            if (auto fn = arith::lookup(expr.arith, left.type, right.type))
+                return fn(left, right);
 
             // Operators which depend on evaluation of both
             switch (expr.op.type) {
                 /* arthimetic ops */
                 case TokenType::MINUS:
-                    if (!isNumber(left) && !isNumber(right))
+                    if (!left.isNumber() || !right.isNumber())
                         rift::error::runTimeError("Expected a number for '-' operator");
-                    resAny = any_arithmetic(left, right, expr.op);
-                    return Token(TokenType::NUMERICLITERAL, castNumberString(resAny), resAny, expr.op.line);
+                    return any_arithmetic(left, right, expr.op);
                 case TokenType::PLUS:
-                    if ((!isNumber(left) && !isNumber(right)) && (!isString(left) && !isString(right)))
-                        rift::error::runTimeError("Expected a number or string for '+' operator");
-                    if (isNumber(left) && isNumber(right)) {
-                        resAny = any_arithmetic(left, right, expr.op);
-                        return Token(TokenType::NUMERICLITERAL, castNumberString(resAny), resAny, expr.op.line);
-                    } else if (isString(left) && isString(right)) {
-                        l_s = castString(left), r_s = castString(right);
-                        if (l_s[0] == '"' && l_s[l_s.size()-1] == '"') l_s = l_s.substr(1, l_s.size()-2);
-                        if (r_s[0] == '"' && r_s[r_s.size()-1] == '"') r_s = r_s.substr(1, r_s.size()-2);
-                        return Token(TokenType::STRINGLITERAL, l_s + r_s, 0, expr.op.line);
-                    } else if (isString(left) && isNumber(right)) {
-                        return Token(TokenType::STRINGLITERAL, castString(left) + castNumberString(right), 0, expr.op.line);
-                    } else if (isNumber(left) && isString(right)) {
-                        return Token(TokenType::STRINGLITERAL, castNumberString(left) + castString(right), 0, expr.op.line);
-                    }
+                    if (left.isNumber() && right.isNumber())
+                        return any_arithmetic(left, right, expr.op);
+                    else if (left.isString() && right.isString())
+                        return heap().string(left.asString() + right.asString());
+                    else if (left.isString() && right.isNumber())
+                        return heap().string(left.asString() + formatNumber(right.as.number));
+                    else if (left.isNumber() && right.isString())
+                        return heap().string(formatNumber(left.as.number) + right.asString());
                     rift::error::runTimeError("Expected a number or string for '+' operator");
                 case TokenType::SLASH:
-                    if (!isNumber(left) && !isNumber(right))
-                        rift::error::runTimeError("Expected a number for '-' operator");
-                    resAny = any_arithmetic(left, right, expr.op);
-                    return Token(TokenType::NUMERICLITERAL, castNumberString(resAny), resAny, expr.op.line);
+                    if (!left.isNumber() || !right.isNumber())
+                        rift::error::runTimeError("Expected a number for '/' operator");
+                    return any_arithmetic(left, right, expr.op);
                 case TokenType::STAR:
-                    if (!isNumber(left) && !isNumber(right))
+                    if (!left.isNumber() || !right.isNumber())
                         rift::error::runTimeError("Expected a number for '*' operator");
-                    resAny = any_arithmetic(left, right, expr.op);
-                    return Token(TokenType::NUMERICLITERAL, castNumberString(resAny), resAny, expr.op.line);
+                    return any_arithmetic(left, right, expr.op);
                 /* comparison ops */
                 case TokenType::GREATER:
-                    if(strcmp(castString(left).c_str(),castString(right).c_str())>0)
-                        return Token(TokenType::TRUE, "true", "true", expr.op.line);
-                    return Token(TokenType::FALSE, "false", "false", expr.op.line);
+                    _BOOL_LOGIC(expr.op);
                     rift::error::runTimeError("Expected a number or string for '>' operator");
                 case TokenType::GREATER_EQUAL:
                     _BOOL_LOGIC(expr.op);
@@ -206,133 +192,298 @@ namespace rift
                     _BOOL_LOGIC(expr.op);
                     rift::error::runTimeError("Expected a number or string for '<=' operator");
                 case TokenType::BANG_EQUAL:
-                    _BOOL_LOGIC(expr.op);
-                    rift::error::runTimeError("Expected a number or string for '!=' operator");
+                    return Value::boolean(!equal(left, right));
                 case TokenType::EQUAL_EQUAL:
-                    _BOOL_LOGIC(expr.op);
-                    rift::error::runTimeError("Expected a number or string for '==' operator");
+                    return Value::boolean(equal(left, right));
                 default:
                     rift::error::runTimeError("Unknown operator for a binary expression");
             }
 
-            return Token();
+            return Value();
         }
 
-        Token Visitor::visit_assign(const Assign& expr) const
+        Value Visitor::visit_assign(const Assign& expr) const
         {
-            auto name = castString(expr.name);
-            env::getInstance(false).setEnv(name, expr.value->accept(*this), expr.name.type == TokenType::C_IDENTIFIER);
-            return env::getInstance(false).getEnv(name);
+            auto val = expr.value->accept(*this);
+            // the Resolver catches it in a parallel for's body, a function it calls only now
+            if (expr.addr.global() && worker != nullptr)
+                rift::error::runTimeError("Cannot assign the global '" + expr.name.lexeme + "' inside a parallel for or a task");
+            if (expr.addr.global()) isolate->globals.set(expr.addr.slot, val, false);
+            else local(expr.addr) = val;
+            return val;
         }
 
-        Token Visitor::visit_grouping(const Grouping& expr) const
+        Value Visitor::visit_grouping(const Grouping& expr) const
         {
-            return expr.expr.get()->accept(*this);
+            return expr.expr->accept(*this);
         }
 
-        Token Visitor::visit_unary(const Unary& expr) const
+        Value Visitor::visit_unary(const Unary& expr) const
         {
-            Token right = expr.expr.get()->accept(*this);
-            bool res = false;
-            any resAny;
+            Value right = expr.expr->accept(*this);
  
             switch (expr.op.type) {
                 case TokenType::MINUS:
-                    if (!isNumber(right))
+                    if (!right.isNumber())
                         rift::error::runTimeError("Expected a number after '-' operator");
-
-                resAny = any_arithmetic(right, Token(TokenType::NUMERICLITERAL, "-1", -1, expr.op.line), Token(TokenType::STAR, "-", "", expr.op.line));
-                return Token(TokenType::NUMERICLITERAL, castNumberString(resAny), resAny, expr.op.line);
+                    return Value::number(-right.as.number);
 
                 case TokenType::BANG:
-                    if (right.type == TokenType::TRUE || right.type == TokenType::FALSE)
-                        res = truthy(right);
-                    else if (isNumber(right))
-                        res = std::any_cast<bool>(any_arithmetic(right, Token(TokenType::NUMERICLITERAL, "0", 0, expr.op.line), Token(TokenType::EQUAL_EQUAL, "==", "", expr.op.line)));
-                    else if (isString(right))
-                        res = castString(right).empty();
-                    else
-                        rift::error::runTimeError("Expected a number or string after '!' operator");
-                    return Token(res?TokenType::TRUE:TokenType::FALSE, std::to_string(!res), !res, expr.op.line);
+                    if (right.isBool())
+                        return Value::boolean(!right.as.boolean);
+                    else if (right.isNumber())
+                        return Value::boolean(right.as.number == 0);
+                    else if (right.isString())
+                        return Value::boolean(right.asString().empty());
+                    rift::error::runTimeError("Expected a number or string after '!' operator");
                 default:
                     rift::error::runTimeError("Unknown operator for a unary expression");
             }
-            return Token();
+            return Value();
         }
 
-        Token Visitor::visit_ternary(const Ternary& expr) const
+        Value Visitor::visit_ternary(const Ternary& expr) const
         {
-            Token cond = expr.condition->accept(*this);
+            if(truthy(expr.condition->accept(*this))) 
+                return expr.left->accept(*this);
+            return expr.right->accept(*this);
+        }
 
-            if(truthy(cond)) 
-                return Token(expr.left->accept(*this));
-            return Token(expr.right->accept(*this));
+        Value Visitor::visit_array(const Array& expr) const
+        {
+            std::vector<double> items;
+            items.reserve(expr.elements.size());
+            for (const auto& element : expr.elements) {
+                auto val = element->accept(*this);
+                if (!val.isNumber()) rift::error::runTimeError("Expected a number for an array element");
+                items.push_back(val.as.number);
+            }
+            return heap().array(std::move(items));
         }
 
-        Token Visitor::visit_call(const Call& expr) const
+        Value Visitor::visit_index(const Index& expr) const
         {
-            auto name = expr.name->accept(*this);
-            if (name.type == TokenType::NIL)
-                rift::error::runTimeError("Undefined function '" + name.lexeme + "'");
-            
-            std::vector<Token> args;
-            for (const auto& arg: expr.args) {
-                args.push_back(arg->accept(*this));
+            auto target = expr.target->accept(*this);
+            auto index = expr.index->accept(*this);
+            return Value::number(builtins::element(target, index));
+        }
+
+        Value Visitor::visit_set_index(const SetIndex& expr) const
+        {
+            auto target = expr.target->accept(*this);
+            auto index = expr.index->accept(*this);
+            auto val = expr.value->accept(*this);
+            auto& slot = builtins::element(target, index);
+            if (!val.isNumber()) rift::error::runTimeError("Expected a number for an array element");
+            // the iterations (or tasks) would all write the array at once
+            if (worker != nullptr && target.as.obj->owner != worker->heap.identity())
+                rift::error::runTimeError("Cannot assign an element of an array made outside of a parallel for or a task");
+            // a running task may have been given the array
+            settle();
+            slot = val.as.number;
+            return val;
+        }
+
+        Value Visitor::visit_call(const Call& expr) const
+        {
+            // the Resolver only marks calls through a global
+            if (expr.builtin != builtins::Builtin::NONE && global(static_cast<const Literal*>(expr.name)->addr.slot).isUndefined())
+                return builtin(expr);
+
+            Value name;
+            if (expr.site.version != 0 && expr.site.version == version(expr.site.slot)) {
+                // the global wasn't assigned since, so it still holds the function checked then
+                name = Value::object(expr.site.callee);
+                if (calls == MAX_CALLS) rift::error::runTimeError("Stack overflow");
+            } else {
+                name = expr.name->accept(*this);
+                callable(name, expr.args.size());
+                auto global = dynamic_cast<const Literal*>(expr.name);
+                // running tasks read the sites too
+                if (worker == nullptr && spawned.empty() && global != nullptr && global->addr.global())
+                    expr.site = {version(global->addr.slot), global->addr.slot, name.as.obj};
             }
 
-            // exception for return stmt, then return that
-            // if no exception occurs return nil
-            auto blk = std::any_cast<Block*>(name.literal);
+            // arguments are evaluated straight into the new frame, calls made while
+            // evaluating them open (and close) their own frames above it
+            auto base = slots.size();
+            for (const auto& arg : expr.args) {
+                auto val = arg->accept(*this);
+                slots.push_back(val);
+            }
+            return invoke(name, expr.name, base);
+        }
 
-            try {
-                auto res = blk->accept(*this);
-                return Token();
-            } catch (const StmtReturnException& e) {
-                return e.tok;    
+        Value Visitor::builtin(const Call& expr) const
+        {
+            // the arguments stay in the frame while it runs, so they are roots
+            auto base = slots.size();
+            for (const auto& arg : expr.args) {
+                auto val = arg->accept(*this);
+                slots.push_back(val);
+            }
+            auto res = builtins::call(expr.builtin, std::span<const Value>(slots.data() + base, slots.size() - base), heap(),
+                [this](const Value& fn, const Value& arg) { return call(fn, std::span<const Value>(&arg, 1)); });
+            slots.resize(base);
+            return res;
+        }
+
+        Value Visitor::call(const Value& fn, std::span<const Value> args) const
+        {
+            callable(fn, args.size());
+            auto base = slots.size();
+            slots.insert(slots.end(), args.begin(), args.end());
+            return invoke(fn, nullptr, base);
+        }
+
+        void Visitor::callable(const Value& fn, size_t args) const
+        {
+            if (!fn.isCallable() && !fn.isNative())
+                rift::error::runTimeError("Can only call functions");
+
+            auto arity = fn.isCallable() ? fn.asCallable()->arity : fn.asNative()->arity;
+            if (args != arity)
+                rift::error::runTimeError("Expected " + std::to_string(arity) + " arguments but got " + std::to_string(args));
+            if (calls == MAX_CALLS)
+                rift::error::runTimeError("Stack overflow");
+        }
+
+        Value Visitor::invoke(const Value& fn, const Expr* through, size_t base) const
+        {
+            if (fn.isNative()) {
+                if (worker != nullptr)
+                    rift::error::runTimeError("Cannot call the host's function '" + fn.asNative()->name + "' inside a parallel for or a task");
+                // the host reads the arguments where they were evaluated
+                auto res = fn.asNative()->fn(std::span<const Value>(slots.data() + base, slots.size() - base));
+                slots.resize(base);
+                return res;
+            }
+
+            auto callee = fn.asCallable();
+            Value res = Value::nil();
+            if (tiering && profiler == nullptr && native(*callee, through, base, res))
+                return res;
+            auto caller = running;
+            if (tiering) running = callee;
+
+#ifdef RIFT_PROFILER
+            // leaves the callee's frame however the call ends
+            struct Frame {
+                Profiler* prof;
+                Frame(Profiler* prof, const std::string& name) : prof(prof) { if (prof) prof->enter(name); }
+                ~Frame() { if (prof) prof->leave(); }
+            } frame(profiler, callee->name);
+#endif
+
+            // parameters and the body's locals share one scope (see Resolver::visit_decl_func)
+            const Block& body = *callee->func->body();
+            scopes.push_back(base);
+            slots.resize(base + body.slots, Value::undefined());
+            if (scopes.size() > peak) peak = scopes.size();
+            calls++;
+
+            // a body's declarations aren't top level, whoever called it
+            auto outer = std::exchange(top, false);
+            for (const auto& decl : body.decls) {
+                decl->accept(*this);
+                if (signal != Signal::NORMAL) break;
+            }
+            top = outer;
+
+            if (signal == Signal::RETURN) {
+                res = returned;
+                signal = Signal::NORMAL;
             }
+            calls--;
+            popScope();
+            running = caller;
+            return res;
+        }
+
+        bool Visitor::native(ObjCallable& callee, const Expr* through, size_t base, Value& res) const
+        {
+            auto& tier = callee.tier;
+            bool numbers = std::all_of(slots.begin() + base, slots.end(), [](const Value& v) { return v.isNumber(); });
+
+            if (tier.state == jit::Tier::State::INTERPRETED) {
+                tier.numeric &= numbers;
+                if (++tier.hotness < jit::HOT) return false;
+                // calls through the global the function was reached by can be direct
+                auto name = dynamic_cast<const Literal*>(through);
+                tier.self = name != nullptr && name->addr.global() ? name->addr.slot : Address::GLOBAL;
+                if (tier.numeric) tier.code = jit::Code::compile(callee, tier.self);
+                tier.state = tier.code ? jit::Tier::State::NATIVE : jit::Tier::State::GENERIC;
+            }
+            if (tier.state != jit::Tier::State::NATIVE) return false;
+
+            // the code only handles numbers, and its calls to itself assume the global still holds it
+            bool bound = tier.self == Address::GLOBAL || [&] {
+                const auto& val = isolate->globals.get(tier.self);
+                return val.isCallable() && val.asCallable() == &callee;
+            }();
+            if (!numbers || !bound) {
+                if (++tier.deopts == jit::MAX_DEOPTS) {
+                    tier.code.reset();
+                    tier.state = jit::Tier::State::GENERIC;
+                }
+                return false;
+            }
+
+            double args[jit::MAX_ARGS];
+            for (size_t i = base; i < slots.size(); i++) args[i - base] = slots[i].as.number;
+            slots.resize(base);
+            auto out = tier.code->entry()(args, MAX_CALLS - calls);
+            // raised back in C++, nothing can unwind through the native frames
+            if (out.overflowed) rift::error::runTimeError("Stack overflow");
+            res = Value::number(out.value);
+            return true;
         }
 
         #pragma mark - Stmt Visitors
 
-        Token Visitor::visit_expr_stmt(const StmtExpr& stmt) const
+        Value Visitor::visit_expr_stmt(const StmtExpr& stmt) const
         {
+            RIFT_PROFILE_LINE(stmt);
             return stmt.expr->accept(*this);
         }
 
-        Token Visitor::visit_print_stmt(const StmtPrint& stmt) const
+        Value Visitor::visit_print_stmt(const StmtPrint& stmt) const
         {
-            Token val = stmt.expr->accept(*this);
-            std::string res = castAnyString(val);
-            if (res.at(0) == '"' && res.at(res.size()-1) == '"') 
-                res = res.substr(1, res.size()-2);
-            std::cout << res << std::endl;
+            RIFT_PROFILE_LINE(stmt);
+            Value val = stmt.expr->accept(*this);
+            if (worker != nullptr) {
+                // as Output::print would have
+                worker->printed += val.isString() ? std::string(val.asString().view()) : printValue(val);
+                worker->printed += '\n';
+                return val;
+            }
+            isolate->output.print(val);
             return val;
         }
 
-        Token Visitor::visit_if_stmt(const StmtIf& stmt) const
+        Value Visitor::visit_if_stmt(const StmtIf& stmt) const
         {
+            RIFT_PROFILE_LINE(stmt);
             auto if_stmt = stmt.if_stmt;
             // if stmt
-            auto expr = std::move(if_stmt->expr);
+            auto expr = if_stmt->expr;
             if (expr == nullptr) rift::error::runTimeError("If statement expression should not be null");
-            auto expr_tok = expr->accept(*this);
 
-            if (truthy(expr_tok)) {
+            if (truthy(expr->accept(*this))) {
                 if (if_stmt->blk != nullptr) if_stmt->blk->accept(*this);
                 else if (if_stmt->stmt != nullptr) if_stmt->stmt->accept(*this);
                 else rift::error::runTimeError("If statement should have a statement or block");
-                return Token();
+                return Value();
             }
 
             // elif stmt
-            auto elif_stmts = stmt.elif_stmts;
-            for (const auto& elif_stmt : elif_stmts) {
+            for (const auto& elif_stmt : stmt.elif_stmts) {
                 if(elif_stmt->expr == nullptr) rift::error::runTimeError("Elif statement expression should not be null");
                 if(truthy(elif_stmt->expr->accept(*this))) {
                     if (elif_stmt->blk != nullptr) elif_stmt->blk->accept(*this);
                     else if (elif_stmt->stmt != nullptr) elif_stmt->stmt->accept(*this);
                     else rift::error::runTimeError("Elif statement should have a statement or block");
-                    return Token();
+                    return Value();
                 }
             }
 
@@ -343,99 +494,124 @@ namespace rift
                 else if (else_stmt->stmt != nullptr) else_stmt->stmt->accept(*this);
                 else rift::error::runTimeError("Else statement should have a statement or block");
             }
-            return Token();
+            return Value();
         }
 
-        [[noreturn]] Token Visitor::visit_return_stmt(const StmtReturn& stmt) const
+        Value Visitor::visit_return_stmt(const StmtReturn& stmt) const
         {
-            auto val = stmt.expr->accept(*this);
-            // must throw exception to return the value
-            throw StmtReturnException(val);
+            RIFT_PROFILE_LINE(stmt);
+            returned = stmt.expr != nullptr ? stmt.expr->accept(*this) : Value::nil();
+            signal = Signal::RETURN;
+            return returned;
         }
 
         #pragma mark - Program / Block Visitor
 
-        Tokens Visitor::visit_block_stmt(const Block& block) const
+        Values Visitor::visit_block_stmt(const Block& block) const
         {
-            Tokens toks = {};
-
-            env::addChild(false); // add scope
-            for (auto it=block.decls->begin(); it!=block.decls->end(); it++) {
-                auto its = (*it)->accept(*this);
-                toks.insert(toks.end(), its.begin(), its.end());
+            auto outer = std::exchange(top, false);
+            pushScope(block.slots); // add scope
+            for (const auto& decl : block.decls) {
+                decl->accept(*this);
+                if (signal != Signal::NORMAL) break;
             }
-            env::removeChild(false); // remove scope
-
-            return toks;
+            popScope(); // remove scope
+            top = outer;
+            return {};
         }
 
-        Tokens Visitor::visit_program(const Program& prgm) const
+        Values Visitor::visit_program(const Program& prgm) const
         {
-            Tokens toks = {};
-            for (auto it=prgm.decls->begin(); it!=prgm.decls->end(); it++) {
-                auto its = (*it)->accept(*this);
-                toks.insert(toks.end(), its.begin(), its.end());
+            // only top level results are reported, and only if someone is listening
+            for (const auto& decl : prgm.decls) {
+                top = true;
+                auto vals = decl->accept(*this);
+                if (signal == Signal::RETURN)
+                    rift::error::runTimeError("Cannot return from top level code");
+                if (sink != nullptr)
+                    for (const auto& val : vals) sink->result(val);
+                // between top level declarations, every live value is in a global
+                if (isolate->heap.pending()) settle();
+                isolate->heap.safepoint();
             }
-            return toks;
+            join();
+            top = false;
+            return {};
         }
 
         #pragma mark - Decl Visitors
 
-        Tokens Visitor::visit_decl_stmt(const DeclStmt& decl) const
+        Values Visitor::visit_decl_stmt(const DeclStmt& decl) const
         {
-            std::vector<Token> toks;
-            toks.push_back(decl.stmt->accept(*this));
-            return toks;
+            auto val = decl.stmt->accept(*this);
+            if (!top) return {};
+            return {val};
         }
 
-        Tokens Visitor::visit_decl_var(const DeclVar& decl) const
+        Values Visitor::visit_decl_var(const DeclVar& decl) const
         {
+            RIFT_PROFILE_LINE(decl);
             // check performed in parser, undefined variables are CT errors
-            Tokens toks;
-            if (decl.expr != nullptr) {
-                toks.push_back(decl.expr->accept(*this));
-            } else {
-                auto niltok = Token(TokenType::NIL, "null", nullptr, decl.identifier.line);
-                env::getInstance(false).setEnv(decl.identifier.lexeme, niltok, decl.identifier.type == TokenType::C_IDENTIFIER);
-                toks.push_back(niltok);
-            }
-            return toks;
+            auto val = decl.expr != nullptr ? decl.expr->accept(*this) : Value::nil();
+            if (decl.addr.global()) isolate->globals.set(decl.addr.slot, val, decl.identifier.type == TokenType::C_IDENTIFIER);
+            else local(decl.addr) = val;
+            if (!top) return {};
+            return {val};
         }
 
-        Tokens Visitor::visit_decl_func(const DeclFunc& decl) const
+        Values Visitor::visit_decl_func(const DeclFunc& decl) const
         {
-            auto name = decl.func->name;
-            auto params = decl.func->params;
+            RIFT_PROFILE_LINE(decl);
+            const auto& name = decl.func->name.lexeme;
 
-            if (env::getInstance(false).getEnv(castString(name)).type != TokenType::NIL)
-                rift::error::runTimeError("Function '" + name.lexeme + "' already defined");
+            const auto& prev = decl.addr.global() ? isolate->globals.get(decl.addr.slot) : local(decl.addr);
+            if (!prev.isUndefined() && !prev.isNil())
+                rift::error::runTimeError("Function '" + name + "' already defined");
             
-            if (decl.func->blk != nullptr) {
-                auto blk = std::move(decl.func->blk).release();
-                env::getInstance(false).setEnv(castString(name), Token(TokenType::FUN, "function", std::make_any<Block*>(blk), name.line), false);
-            } else {
-                env::getInstance(false).setEnv(castString(name), Token(TokenType::NIL, "null", nullptr, name.line), false);
-            }
-            return {name};
+            Value fn = Value::nil();
+            if (decl.func->blk != nullptr || decl.func->deferred())
+                fn = Value::object(heap().allocate<ObjCallable>(name, decl.func, static_cast<uint32_t>(decl.func->params.size())));
+
+            if (decl.addr.global()) isolate->globals.set(decl.addr.slot, fn, false);
+            else local(decl.addr) = fn;
+            if (!top) return {};
+            return {heap().string(name)};
         }
 
-        Tokens Visitor::visit_for(const For& decl) const
+        Values Visitor::visit_import(const Import& decl) const
         {
-            Tokens toks = {};
+            // the module ran before the program that imports it
+            (void)decl;
+            return {};
+        }
+
+        Values Visitor::visit_for(const For& decl) const
+        {
+            // a worker runs the loops it reaches as they are written
+            if (decl.parallel && worker == nullptr) return parallel(decl);
+            pushScope(decl.slots);
             if (decl.decl != nullptr) decl.decl->accept(*this);
             else if (decl.stmt_l != nullptr) decl.stmt_l->accept(*this);
 
-            while(truthy(decl.expr->accept(*this))) {
-                if(decl.stmt_o != nullptr) toks.push_back(decl.stmt_o->accept(*this));
-                else if (decl.blk != nullptr) {
-                    auto bk = decl.blk->accept(*this);
-                    toks.insert(toks.begin(), bk.begin(), bk.end());
-                }
+            while(true) {
+                RIFT_PROFILE_LINE(decl);
+                if (!truthy(decl.expr->accept(*this))) break;
+                if (decl.stmt_o != nullptr) decl.stmt_o->accept(*this);
+                else if (decl.blk != nullptr) decl.blk->accept(*this);
                 else rift::error::runTimeError("For statement should have a statement or block");
+                if (signal != Signal::NORMAL) break;
 
                 if (decl.stmt_r != nullptr) decl.stmt_r->accept(*this);
+                if (running != nullptr) running->tier.hotness++;
+                // outside of a call no expression is half evaluated, every live value is in a
+                // slot or a global (inside one, temporaries of the caller aren't rooted)
+                if (calls == 0 && heap().pending()) {
+                    settle();
+                    heap().safepoint();
+                }
             }
-            return toks;
+            popScope();
+            return {};
         }
     }
 }
\ No newline at end of file
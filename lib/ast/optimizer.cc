@@ -0,0 +1,395 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ast/optimizer.hh>
+#include <utils/literals.hh>
+
+namespace rift
+{
+    namespace ast
+    {
+        /// @brief nodes are only handed out as const, but every one of them lives (mutable) in the arena
+        template <typename T>
+        static inline T& edit(const T& node) { return const_cast<T&>(node); }
+
+        #pragma mark - Public API
+
+        void Optimizer::optimize(const Program& prgm)
+        {
+            arena = &prgm.nodes();
+            // folded constants end up in the program like literals do
+            auto& heap = Heap::current(isolate->heap);
+            Heap::Pinning pin(heap, *arena->make<Heap::Pins>(heap));
+            replacement = nullptr;
+            globals.clear();
+            open.clear();
+            prgm.accept(*this);
+            arena = nullptr;
+        }
+
+        void Optimizer::optimize(const Program& prgm, const DeclFunc::Func& func)
+        {
+            arena = &prgm.nodes();
+            auto& heap = Heap::current(isolate->heap);
+            Heap::Pinning pin(heap, *arena->make<Heap::Pins>(heap));
+            replacement = nullptr;
+            globals.clear();
+            open.clear();
+            body(func);
+            arena = nullptr;
+        }
+
+        #pragma mark - Helpers
+
+        Expr* Optimizer::fold(Expr* expr) const
+        {
+            if (expr == nullptr) return nullptr;
+
+            replacement = nullptr;
+            Value val = expr->accept(*this);
+            if (replacement != nullptr) {
+                auto res = replacement;
+                replacement = nullptr;
+                return res;
+            }
+            if (val.isUndefined() || !constant(expr).isUndefined()) return expr;
+            return literal(val);
+        }
+
+        Value Optimizer::constant(const Expr* expr)
+        {
+            auto lit = dynamic_cast<const Literal*>(expr);
+            if (lit == nullptr || lit->value.type == TokenType::IDENTIFIER || lit->value.type == TokenType::C_IDENTIFIER)
+                return Value::undefined();
+            return lit->constant;
+        }
+
+        Literal* Optimizer::literal(const Value& val) const
+        {
+            switch (val.type) {
+                case ValueType::NUMBER: return arena->make<Literal>(Token(TokenType::NUMERICLITERAL, formatNumber(val.as.number), "", line), val);
+                case ValueType::BOOL: return arena->make<Literal>(Token(val.as.boolean ? TokenType::TRUE : TokenType::FALSE, val.as.boolean ? "true" : "false", "", line), val);
+                case ValueType::NIL: return arena->make<Literal>(Token(TokenType::NIL, "nil", "", line), val);
+                default: return arena->make<Literal>(Token(TokenType::STRINGLITERAL, val.asString().str(), "", line), val);
+            }
+        }
+
+        Value Optimizer::lookup(const Address& addr) const
+        {
+            if (addr.global()) {
+                auto it = globals.find(addr.slot);
+                return it == globals.end() ? Value::undefined() : it->second;
+            }
+            if (addr.depth >= open.size()) return Value::undefined();
+            const auto& scope = open[open.size() - 1 - addr.depth];
+            auto it = scope.find(addr.slot);
+            return it == scope.end() ? Value::undefined() : it->second;
+        }
+
+        void Optimizer::declarations(const Block& block) const
+        {
+            for (const auto& decl : block.decls)
+                decl->accept(*this);
+        }
+
+        /// @brief true if evaluating op on these constants can't raise a runtime error
+        static bool foldable(TokenType op, const Value& left, const Value& right)
+        {
+            bool numbers = left.isNumber() && right.isNumber();
+            bool strings = left.isString() && right.isString();
+            switch (op) {
+                case TokenType::PLUS:
+                    return numbers || (left.isString() && (right.isString() || right.isNumber())) || (left.isNumber() && right.isString());
+                case TokenType::MINUS:
+                case TokenType::STAR:
+                case TokenType::SLASH:
+                    return numbers;
+                case TokenType::GREATER:
+                case TokenType::GREATER_EQUAL:
+                case TokenType::LESS:
+                case TokenType::LESS_EQUAL:
+                    return numbers || strings;
+                case TokenType::BANG_EQUAL:
+                case TokenType::EQUAL_EQUAL:
+                case TokenType::LOG_AND:
+                case TokenType::LOG_OR:
+                case TokenType::NULLISH_COAL:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        #pragma mark - Expressions
+
+        Value Optimizer::visit_literal(const Literal& expr) const
+        {
+            line = expr.value.line;
+            if (expr.value.type == TokenType::IDENTIFIER || expr.value.type == TokenType::C_IDENTIFIER)
+                return lookup(expr.addr);
+            return expr.constant;
+        }
+
+        Value Optimizer::visit_binary(const Binary& expr) const
+        {
+            auto& node = edit(expr);
+            node.left = fold(node.left);
+            Value left = constant(node.left);
+            line = expr.op.line;
+
+            // short circuits decided by their left operand alone
+            if (!left.isUndefined()) {
+                switch (expr.op.type) {
+                    case TokenType::NULLISH_COAL:
+                        if (!left.isNil()) return left;
+                        replacement = fold(node.right);
+                        return Value::undefined();
+                    case TokenType::LOG_AND:
+                        if (!truthy(left)) return Value::boolean(false);
+                        break;
+                    case TokenType::LOG_OR:
+                        if (truthy(left)) return Value::boolean(true);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            node.right = fold(node.right);
+            Value right = constant(node.right);
+            line = expr.op.line;
+            if (left.isUndefined() || right.isUndefined() || !foldable(expr.op.type, left, right))
+                return Value::undefined();
+
+            // both operands are literals now, so the evaluator's own rules apply
+            return Visitor::visit_binary(expr);
+        }
+
+        Value Optimizer::visit_assign(const Assign& expr) const
+        {
+            edit(expr).value = fold(expr.value);
+            return Value::undefined();
+        }
+
+        Value Optimizer::visit_grouping(const Grouping& expr) const
+        {
+            auto inner = fold(expr.expr);
+            Value val = constant(inner);
+            if (val.isUndefined()) replacement = inner;
+            return val;
+        }
+
+        Value Optimizer::visit_unary(const Unary& expr) const
+        {
+            auto& node = edit(expr);
+            node.expr = fold(node.expr);
+            Value right = constant(node.expr);
+            line = expr.op.line;
+
+            bool safe = (expr.op.type == TokenType::MINUS && right.isNumber())
+                     || (expr.op.type == TokenType::BANG && (right.isBool() || right.isNumber() || right.isString()));
+            if (!safe) return Value::undefined();
+            return Visitor::visit_unary(expr);
+        }
+
+        Value Optimizer::visit_ternary(const Ternary& expr) const
+        {
+            auto& node = edit(expr);
+            node.condition = fold(node.condition);
+            Value cond = constant(node.condition);
+            if (!cond.isUndefined()) {
+                auto taken = fold(truthy(cond) ? node.left : node.right);
+                Value val = constant(taken);
+                if (val.isUndefined()) replacement = taken;
+                return val;
+            }
+
+            node.left = fold(node.left);
+            node.right = fold(node.right);
+            return Value::undefined();
+        }
+
+        Value Optimizer::visit_call(const Call& expr) const
+        {
+            for (auto& arg : edit(expr).args)
+                arg = fold(arg);
+            return Value::undefined();
+        }
+
+        Value Optimizer::visit_spawn(const Spawn& expr) const
+        {
+            expr.call->accept(*this);
+            return Value::undefined();
+        }
+
+        Value Optimizer::visit_await(const Await& expr) const
+        {
+            edit(expr).task = fold(expr.task);
+            return Value::undefined();
+        }
+
+        Value Optimizer::visit_array(const Array& expr) const
+        {
+            for (auto& element : edit(expr).elements)
+                element = fold(element);
+            return Value::undefined();
+        }
+
+        Value Optimizer::visit_index(const Index& expr) const
+        {
+            auto& node = edit(expr);
+            node.target = fold(node.target);
+            node.index = fold(node.index);
+            return Value::undefined();
+        }
+
+        Value Optimizer::visit_set_index(const SetIndex& expr) const
+        {
+            auto& node = edit(expr);
+            node.target = fold(node.target);
+            node.index = fold(node.index);
+            node.value = fold(node.value);
+            return Value::undefined();
+        }
+
+        #pragma mark - Statements
+
+        Value Optimizer::visit_expr_stmt(const StmtExpr& stmt) const
+        {
+            edit(stmt).expr = fold(stmt.expr);
+            return Value();
+        }
+
+        Value Optimizer::visit_print_stmt(const StmtPrint& stmt) const
+        {
+            edit(stmt).expr = fold(stmt.expr);
+            return Value();
+        }
+
+        void Optimizer::branch(StmtIf::Stmt* arm) const
+        {
+            if (arm->blk != nullptr) arm->blk->accept(*this);
+            else if (arm->stmt != nullptr) arm->stmt->accept(*this);
+        }
+
+        Value Optimizer::visit_if_stmt(const StmtIf& stmt) const
+        {
+            auto& node = edit(stmt);
+            std::vector<StmtIf::Stmt*> arms = {node.if_stmt};
+            arms.insert(arms.end(), node.elif_stmts.begin(), node.elif_stmts.end());
+
+            // arms that may run, the first constant-true arm ends the chain as its else
+            std::vector<StmtIf::Stmt*> live;
+            StmtIf::Stmt* otherwise = node.else_stmt;
+            for (auto arm : arms) {
+                arm->expr = fold(arm->expr);
+                Value cond = constant(arm->expr);
+                if (cond.isUndefined()) {
+                    live.push_back(arm);
+                } else if (truthy(cond)) {
+                    otherwise = arm;
+                    break;
+                }
+            }
+
+            if (live.empty()) {
+                // nothing is left to test, the taken arm (if any) becomes an if on a literal
+                auto arm = otherwise != nullptr ? otherwise : node.if_stmt;
+                if (otherwise != nullptr && constant(arm->expr).isUndefined()) arm->expr = literal(Value::boolean(true));
+                live.push_back(arm);
+                otherwise = nullptr;
+            }
+
+            node.if_stmt = live.front();
+            node.elif_stmts.assign(live.begin() + 1, live.end());
+            node.else_stmt = otherwise;
+
+            for (auto arm : live) branch(arm);
+            if (otherwise != nullptr) branch(otherwise);
+            return Value();
+        }
+
+        Value Optimizer::visit_return_stmt(const StmtReturn& stmt) const
+        {
+            edit(stmt).expr = fold(stmt.expr);
+            return Value();
+        }
+
+        #pragma mark - Declarations
+
+        Values Optimizer::visit_decl_stmt(const DeclStmt& decl) const
+        {
+            decl.stmt->accept(*this);
+            return {};
+        }
+
+        Values Optimizer::visit_decl_var(const DeclVar& decl) const
+        {
+            auto& node = edit(decl);
+            node.expr = fold(node.expr);
+
+            // only a constant initialized with a constant is known at every later use
+            Value val = constant(node.expr);
+            if (decl.identifier.type != TokenType::C_IDENTIFIER || val.isUndefined()) return {};
+            if (decl.addr.global()) globals[decl.addr.slot] = val;
+            else if (!open.empty()) open.back()[decl.addr.slot] = val;
+            return {};
+        }
+
+        Values Optimizer::visit_decl_func(const DeclFunc& decl) const
+        {
+            if (decl.func->blk != nullptr) body(*decl.func);
+            return {};
+        }
+
+        void Optimizer::body(const DeclFunc::Func& func) const
+        {
+            // parameters and the body share one scope, like the Resolver
+            open.emplace_back();
+            declarations(*func.blk);
+            open.pop_back();
+        }
+
+        Values Optimizer::visit_for(const For& decl) const
+        {
+            auto& node = edit(decl);
+            open.emplace_back();
+            if (node.decl != nullptr) node.decl->accept(*this);
+            else if (node.stmt_l != nullptr) node.stmt_l->accept(*this);
+
+            node.expr = fold(node.expr);
+            if (node.stmt_o != nullptr) node.stmt_o->accept(*this);
+            else if (node.blk != nullptr) node.blk->accept(*this);
+            if (node.stmt_r != nullptr) node.stmt_r->accept(*this);
+
+            open.pop_back();
+            return {};
+        }
+
+        Values Optimizer::visit_block_stmt(const Block& block) const
+        {
+            open.emplace_back();
+            declarations(block);
+            open.pop_back();
+            return {};
+        }
+
+        Values Optimizer::visit_program(const Program& prgm) const
+        {
+            for (const auto& decl : prgm.decls)
+                decl->accept(*this);
+            return {};
+        }
+    }
+}
\ No newline at end of file
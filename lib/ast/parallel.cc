@@ -0,0 +1,318 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ast/grmr.hh>
+#include <ast/eval.hh>
+#include <error/error.hh>
+#include <utils/scheduler.hh>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+/// @file parallel.cc
+/// @brief parallel for and spawn/await on Scheduler::shared()
+/// @details the work runs on visitors of its own, one per chunk of iterations or per task,
+///          each with a Worker: it allocates on the worker's heap, prints into the worker's
+///          buffer and only reads what the isolate's visitor shares (globals and frames).
+///          Nothing a worker made outlives it but a task's result, which is copied over.
+///          A parallel for waits for its chunks, then writes their output in order and raises
+///          the first error as if the iterations had run one after the other.
+///          A task starts when it is spawned and runs while its spawner goes on: it reads the
+///          globals as they were then (see Snapshot), and the spawner joins it at the await
+///          that waits for it, at the end of the program (or of a host's call), and before a
+///          collection or an array write could change what it reads. Joined tasks have their
+///          output written in spawn order, a task's error is raised by the await of it
+
+namespace rift
+{
+    namespace ast
+    {
+        /// @brief chunks per thread, so a thread that finishes early has some to steal
+        static constexpr size_t SPLIT = 4;
+        /// @brief iterations of a chunk at most, a chunk's heap only goes away with it
+        static constexpr size_t GRAIN_MAX = 4096;
+
+        namespace
+        {
+            /// @brief a worker's frames are the roots of its heap
+            struct Frames : public Heap::Roots {
+                Frames(Heap& heap, const Visitor& visitor) : Heap::Roots(heap), visitor(visitor) {}
+                inline void trace(Heap& heap) const override { visitor.trace(heap); }
+                const Visitor& visitor;
+            };
+
+            /// @brief appends what a worker printed to the isolate's output
+            void replay(Output& output, const std::string& printed)
+            {
+                if (printed.empty()) return;
+                output.write(printed);
+                if (output.policy() == Output::Policy::LINE || output.pending() >= Output::CAPACITY) output.flush();
+            }
+
+            /// @brief true while i still runs an iteration
+            bool holds(double i, double bound, TokenType compare)
+            {
+                switch (compare) {
+                    case TokenType::LESS: return i < bound;
+                    case TokenType::LESS_EQUAL: return i <= bound;
+                    case TokenType::GREATER: return i > bound;
+                    default: return i >= bound;
+                }
+            }
+        }
+
+        #pragma mark - Counted Loops
+
+        bool For::counted(Counted& loop) const
+        {
+            auto var = dynamic_cast<const DeclVar*>(decl);
+            auto cond = dynamic_cast<const Binary*>(expr);
+            auto next = dynamic_cast<const StmtExpr*>(stmt_r);
+            if (var == nullptr || var->expr == nullptr || var->identifier.type != TokenType::IDENTIFIER || cond == nullptr || next == nullptr)
+                return false;
+
+            auto symbol = var->identifier.symbol;
+            auto counter = [symbol](const Expr* expr) {
+                auto name = dynamic_cast<const Literal*>(expr);
+                return name != nullptr && name->value.type == TokenType::IDENTIFIER && name->value.symbol == symbol;
+            };
+            switch (cond->op.type) {
+                case TokenType::LESS:
+                case TokenType::LESS_EQUAL:
+                case TokenType::GREATER:
+                case TokenType::GREATER_EQUAL:
+                    break;
+                default:
+                    return false;
+            }
+            if (!counter(cond->left)) return false;
+
+            auto assign = dynamic_cast<const Assign*>(next->expr);
+            if (assign == nullptr || assign->name.symbol != symbol) return false;
+            auto step = dynamic_cast<const Binary*>(assign->value);
+            if (step == nullptr || !counter(step->left) || (step->op.type != TokenType::PLUS && step->op.type != TokenType::MINUS))
+                return false;
+
+            loop = {var, cond->op.type, cond->right, step->right, step->op.type == TokenType::MINUS};
+            return true;
+        }
+
+        #pragma mark - Sharing
+
+        /// @brief parses a deferred body, or flattens a rope, before a worker reads it
+        static void ready(const Value& val)
+        {
+            if (val.isString()) val.asString().view();
+            else if (val.isCallable()) val.asCallable()->func->body();
+        }
+
+        void Visitor::share(std::span<const Value> also) const
+        {
+            // a body parsed now may bind new globals, so the size is read every time
+            for (uint32_t i = 0; i < isolate->globals.size(); i++) ready(isolate->globals.get(i));
+            for (const auto& val : slots) ready(val);
+            for (const auto& val : also) ready(val);
+        }
+
+        #pragma mark - Parallel For
+
+        Values Visitor::parallel(const For& decl) const
+        {
+            For::Counted loop;
+            if (!decl.counted(loop)) rift::error::runTimeError("A parallel for must count");
+
+            pushScope(decl.slots);
+            decl.decl->accept(*this);
+            const auto start = local(loop.var->addr);
+            // only evaluated once, the body can't change what they read
+            const auto bound = loop.bound->accept(*this);
+            const auto step = loop.step->accept(*this);
+            if (!start.isNumber() || !bound.isNumber() || !step.isNumber())
+                rift::error::runTimeError("A parallel for counts with numbers");
+
+            // iteration k sees start + k * step, as many as the condition would let run
+            double first = start.as.number, limit = bound.as.number, delta = loop.down ? -step.as.number : step.as.number;
+            double count = 0;
+            if (holds(first, limit, loop.compare)) {
+                bool up = loop.compare == TokenType::LESS || loop.compare == TokenType::LESS_EQUAL;
+                if (delta == 0 || (delta > 0) != up || std::isnan(delta))
+                    rift::error::runTimeError("The step of a parallel for must move towards its bound");
+                count = std::ceil((limit - first) / delta);
+                if (!(count < 9007199254740992.0))
+                    rift::error::runTimeError("Too many iterations for a parallel for");
+                while (count > 0 && !holds(first + (count - 1) * delta, limit, loop.compare)) count--;
+                while (holds(first + count * delta, limit, loop.compare)) count++;
+            }
+            auto n = static_cast<size_t>(count);
+            if (n == 0) {
+                popScope();
+                return {};
+            }
+
+            struct Chunk : public Scheduler::Task {
+                const Visitor& parent;
+                const For& decl;
+                size_t slot;
+                double first, delta;
+                size_t begin, end;
+                Worker worker;
+                bool failed = false;
+                std::string error;
+
+                Chunk(const Visitor& parent, const For& decl, size_t slot, double first, double delta, size_t begin, size_t end)
+                    : parent(parent), decl(decl), slot(slot), first(first), delta(delta), begin(begin), end(end) {}
+
+                void run() override
+                {
+                    rift::error::Raise raise;
+                    Visitor visitor(*parent.isolate);
+                    visitor.worker = &worker;
+                    // without closures only the running function's frames are read, all are copied
+                    visitor.slots = parent.slots;
+                    visitor.scopes = parent.scopes;
+                    Frames frames(worker.heap, visitor);
+                    try {
+                        for (size_t k = begin; k < end; k++) {
+                            visitor.slots[slot] = Value::number(first + static_cast<double>(k) * delta);
+                            if (decl.stmt_o != nullptr) decl.stmt_o->accept(visitor);
+                            else decl.blk->accept(visitor);
+                            worker.heap.safepoint();
+                        }
+                    } catch (const std::exception& e) {
+                        failed = true;
+                        error = e.what();
+                    }
+                }
+            };
+
+            share();
+            auto& pool = Scheduler::shared();
+            auto grain = std::clamp<size_t>((n + (pool.workers() + 1) * SPLIT - 1) / ((pool.workers() + 1) * SPLIT), 1, GRAIN_MAX);
+            auto slot = scopes.back() + loop.var->addr.slot;
+
+            std::vector<std::unique_ptr<Chunk>> chunks;
+            chunks.reserve((n + grain - 1) / grain);
+            Scheduler::Group group;
+            for (size_t begin = 0; begin < n; begin += grain) {
+                chunks.push_back(std::make_unique<Chunk>(*this, decl, slot, first, delta, begin, std::min(n, begin + grain)));
+                pool.spawn(group, *chunks.back());
+            }
+            pool.wait(group);
+
+            popScope();
+            for (const auto& chunk : chunks) {
+                replay(isolate->output, chunk->worker.printed);
+                if (chunk->failed) rift::error::runTimeError(chunk->error);
+            }
+            return {};
+        }
+
+        #pragma mark - Tasks
+
+        void Job::run()
+        {
+            rift::error::Raise raise;
+            Visitor visitor(isolate);
+            visitor.worker = &worker;
+            visitor.view = globals.get();
+            Frames frames(worker.heap, visitor);
+            try {
+                result = visitor.call(task.fn, task.args);
+            } catch (const std::exception& e) {
+                failed = true;
+                error = e.what();
+            }
+        }
+
+        Value Visitor::visit_spawn(const Spawn& expr) const
+        {
+            if (worker != nullptr) rift::error::runTimeError("Cannot spawn a task inside a parallel for or a task");
+            auto fn = expr.call->name->accept(*this);
+            callable(fn, expr.call->args.size());
+            if (fn.isNative()) rift::error::runTimeError("Cannot spawn the host's function '" + fn.asNative()->name + "'");
+
+            Values args;
+            args.reserve(expr.call->args.size());
+            for (const auto& arg : expr.call->args) args.push_back(arg->accept(*this));
+
+            // taken again only once a global was assigned since, whatever is in it made ready first
+            const auto& env = isolate->globals;
+            if (snapshot == nullptr || snapshot->stamp != env.stamp()) {
+                share();
+                auto globals = std::make_shared<Snapshot>();
+                globals->stamp = env.stamp();
+                globals->values.reserve(env.size());
+                globals->versions.reserve(env.size());
+                for (uint32_t i = 0; i < env.size(); i++) {
+                    globals->values.push_back(env.get(i));
+                    globals->versions.push_back(env.version(i));
+                }
+                snapshot = std::move(globals);
+            }
+            ready(fn);
+            for (const auto& arg : args) ready(arg);
+
+            auto task = heap().allocate<ObjTask>(fn, std::move(args));
+            auto job = std::make_shared<Job>(*isolate, *task, snapshot);
+            spawned.push_back(job);
+            Scheduler::shared().spawn(job->group, *job);
+            return Value::object(task);
+        }
+
+        Value Visitor::visit_await(const Await& expr) const
+        {
+            if (worker != nullptr) rift::error::runTimeError("Cannot await a task inside a parallel for or a task");
+            auto val = expr.task->accept(*this);
+            if (!val.isTask()) rift::error::runTimeError("Can only await tasks");
+
+            auto task = val.asTask();
+            if (task->state == ObjTask::State::RUNNING) join(task);
+            if (task->state == ObjTask::State::FAILED) rift::error::runTimeError(task->error);
+            return task->result;
+        }
+
+        void Visitor::join(const ObjTask* until) const
+        {
+            auto& pool = Scheduler::shared();
+            while (!spawned.empty()) {
+                auto job = std::move(spawned.front());
+                spawned.pop_front();
+                pool.wait(job->group);
+
+                auto& task = job->task;
+                replay(isolate->output, job->worker.printed);
+                task.args.clear();
+                if (job->failed) {
+                    task.state = ObjTask::State::FAILED;
+                    task.error = std::move(job->error);
+                } else {
+                    // the worker's heap goes away with the job, what was made on it is copied
+                    task.state = ObjTask::State::DONE;
+                    const auto& res = job->result;
+                    if (res.isString()) task.result = isolate->heap.string(res.asString());
+                    else if (res.isCallable()) {
+                        auto fn = res.asCallable();
+                        task.result = Value::object(isolate->heap.allocate<ObjCallable>(fn->name, fn->func, fn->arity));
+                    } else if (res.isArray() && res.as.obj->owner == job->worker.heap.identity()) {
+                        // one it was given is the awaiter's already, and stays the same array
+                        task.result = isolate->heap.array(res.asArray()->items);
+                    } else task.result = res;
+                }
+                if (&task == until) break;
+            }
+            // only rooted while a task reads it, the next collection may free what it holds
+            if (spawned.empty()) snapshot.reset();
+        }
+    }
+}
@@ -17,12 +17,10 @@
 #include <error/error.hh>
 #include <memory>
 #include <ast/prgm.hh>
-#include <ast/env.hh>
 #include <utils/literals.hh>
 
 using namespace rift::scanner;
 
-using env = rift::ast::Environment;
 
 namespace rift
 {
@@ -33,6 +31,12 @@ namespace rift
 
         std::unique_ptr<Program> Parser::parse()
         {
+            Isolate::Scope enter(isolate);
+            arena = std::make_unique<Arena>();
+            nodes = arena.get();
+            // literals live as long as the program's nodes do
+            auto& heap = Heap::current(isolate.heap);
+            Heap::Pinning pin(heap, *arena->make<Heap::Pins>(heap));
             try {
                 return program();
             } catch (const ParserException &e) {
@@ -40,155 +44,194 @@ namespace rift
             }
         }
 
+        Block* Parser::body(uint32_t begin, Arena& into)
+        {
+            Isolate::Scope enter(isolate);
+            nodes = &into;
+            curr = begin;
+            auto& heap = Heap::current(isolate.heap);
+            Heap::Pinning pin(heap, *into.make<Heap::Pins>(heap));
+            try {
+                // block() opens a scope, so functions nested in the body are parsed right away
+                return block();
+            } catch (const ParserException &e) {
+                return make<Block>(vec_prog{});
+            }
+        }
+
+        #pragma mark - Matching
+
+        CompactToken Parser::expect(TokenType type, const char* message)
+        {
+            if (peek(type)) return source[curr++];
+            rift::error::report(line, "consume", "expected token not found", CompactToken(type), ParserException(message));
+            return CompactToken();
+        }
+
         #pragma mark - Expressions Parsing
 
-        std::unique_ptr<Expr> Parser::primary()
+        Expr* Parser::primary()
         {
-            if (match({Token(TokenType::FALSE, "false", "", line)}))
-                return std::unique_ptr<Literal>(new Literal(Token(TokenType::FALSE, "false", "", line)));
-            if (match({Token(TokenType::TRUE, "true", "", line)}))
-                return std::unique_ptr<Literal>(new Literal(Token(TokenType::TRUE, "true", "", line)));
-            if (match({Token(TokenType::NIL, "nil", "", line)}))
-                return std::unique_ptr<Literal>(new Literal(Token(TokenType::NIL, "nil", "", line)));
-
-            if (match({Token(TokenType::NUMERICLITERAL, "", "", line)}))
-                return std::unique_ptr<Literal>(new Literal(peekPrev(1)));
-            if (match({Token(TokenType::STRINGLITERAL, "", "", line)}))
-                return std::unique_ptr<Literal>(new Literal(Token(peekPrev(1))));
-            if (match({Token(TokenType::IDENTIFIER, "", "", line)}))
-                return std::unique_ptr<Literal>(new Literal(Token(peekPrev(1))));
-            if (match({Token(TokenType::C_IDENTIFIER, "", "", line)}))
-                return std::unique_ptr<Literal>(new Literal(Token(peekPrev(1))));
+            if (match(TokenType::FALSE))
+                return make<Literal>(Token(TokenType::FALSE, "false", "", line));
+            if (match(TokenType::TRUE))
+                return make<Literal>(Token(TokenType::TRUE, "true", "", line));
+            if (match(TokenType::NIL))
+                return make<Literal>(Token(TokenType::NIL, "nil", "", line));
+
+            if (match(TokenType::NUMERICLITERAL))
+                return make<Literal>(token(peekPrev(1)));
+            if (match(TokenType::STRINGLITERAL))
+                return make<Literal>(token(peekPrev(1)));
+            if (match(TokenType::IDENTIFIER))
+                return make<Literal>(token(peekPrev(1)));
+            if (match(TokenType::C_IDENTIFIER))
+                return make<Literal>(token(peekPrev(1)));
+
+            if (match(TokenType::LEFT_PAREN)) {
+                auto expr = expression();
+                if (expr == nullptr) rift::error::report(line, "primary", "Expected expression after '('", token(peek()), ParserException("Expected expression after '('"));
+                expect(TokenType::RIGHT_PAREN, "Expected ')' after expression");
+                return make<Grouping>(expr);
+            }
+
+            if (match(TokenType::LEFT_BRACKET)) {
+                auto bracket = token(peekPrev());
+                auto elements = args(TokenType::RIGHT_BRACKET);
+                expect(TokenType::RIGHT_BRACKET, "Expected ']' after array elements");
+                return make<Array>(bracket, std::move(elements));
+            }
             return nullptr;
         }
 
-        std::unique_ptr<Expr> Parser::call()
+        Expr* Parser::call()
         {
             auto expr = primary();
 
-            // TODO: i have to somehow get the right paren, and then check if there is a semicolon
-            // since that's the only way to verify between func test() {} and test(); 
-            // note the "test()""
-            if (peekPrev().type == TokenType::IDENTIFIER && peek() == Token(TokenType::LEFT_PAREN)) {
-                consume(Token(TokenType::LEFT_PAREN));
+            // the trailing ';' belongs to the enclosing statement, so `test();`
+            // and `print(test());` both parse through here
+            if (expr != nullptr && peekPrev().type == TokenType::IDENTIFIER && peek(TokenType::LEFT_PAREN)) {
+                consume(TokenType::LEFT_PAREN);
                 auto arg = args();
-                consume(Token(TokenType::RIGHT_PAREN));
-                consume(Token(TokenType::SEMICOLON));
-                return std::unique_ptr<Call>(new Call(std::move(expr), std::move(arg)));
+                expect(TokenType::RIGHT_PAREN, "Expected ')' after call arguments");
+                expr = make<Call>(expr, std::move(arg));
+            }
+
+            while (expr != nullptr && match(TokenType::LEFT_BRACKET)) {
+                auto bracket = token(peekPrev());
+                auto index = expression();
+                if (index == nullptr) rift::error::report(line, "call", "Expected expression after '['", bracket, ParserException("Expected expression after '['"));
+                expect(TokenType::RIGHT_BRACKET, "Expected ']' after index");
+                expr = make<Index>(expr, bracket, index);
             }
 
             return expr;
         }
 
-        std::unique_ptr<Expr> Parser::unary()
+        Expr* Parser::unary()
         {
-            if (match({Token(TokenType::BANG, "!", "", line)})) {
-                auto op = peekPrev();
+            if (match(TokenType::BANG)) {
+                auto op = token(peekPrev());
                 auto right = unary();
                 if (right == nullptr) rift::error::report(line, "unary", "Expected expression after unary operator", op, ParserException("Expected expression after unary operator"));
-                return std::unique_ptr<Unary>(new Unary(op, std::move(right)));
+                return make<Unary>(op, right);
             }
 
-            if (match({Token(TokenType::MINUS, "-", "", line)})) {
-                auto op = peekPrev();
+            if (match(TokenType::MINUS)) {
+                auto op = token(peekPrev());
                 auto right = unary();
                 if (right == nullptr) rift::error::report(line, "unary", "Expected expression after unary operator", op, ParserException("Expected expression after unary operator"));
-                return std::unique_ptr<Unary>(new Unary(op, std::move(right)));
+                return make<Unary>(op, right);
+            }
+
+            if (match(TokenType::SPAWN)) {
+                auto op = token(peekPrev());
+                auto call = dynamic_cast<Call*>(unary());
+                if (call == nullptr) rift::error::report(line, "unary", "Expected a call after 'spawn'", op, ParserException("Expected a call after 'spawn'"));
+                return make<Spawn>(op, call);
+            }
+
+            if (match(TokenType::AWAIT)) {
+                auto op = token(peekPrev());
+                auto task = unary();
+                if (task == nullptr) rift::error::report(line, "unary", "Expected expression after 'await'", op, ParserException("Expected expression after 'await'"));
+                return make<Await>(op, task);
             }
 
             return call();
         }
 
-        std::unique_ptr<Expr> Parser::factor()
+        /// @brief what a missing operand of each precedence is reported as
+        static constexpr struct { const char *where, *before, *after; } operands[] = {
+            {"binary", "", ""},
+            {"logic_or", "Expected expression before logical operator", "Expected expression after logical operator"},
+            {"logic_and", "Expected expression before logical operator", "Expected expression after logical operator"},
+            {"equality", "Expected expression before equality operator", "Expected expression after equality operator"},
+            {"comparison", "Expected expression before comparison operator", "Expected expression after comparison operator"},
+            {"term", "Expected number before term operator", "Expected number after term operator"},
+            {"factor", "Expected number before factor operator", "Expected number after factor operator"},
+        };
+
+        Expr* Parser::binary(Precedence min)
         {
             auto expr = unary();
 
-            while (match({Token(TokenType::STAR, "*", "", line)}) || match({Token(TokenType::SLASH, "/", "", line)})) {
-                auto op = peekPrev();
-                auto right = unary();
-                if (expr == nullptr) rift::error::report(line, "factor", "Expected number before factor operator", op, ParserException("Expected number before factor operator"));
-                if (right == nullptr) rift::error::report(line, "factor", "Expected number after factor operator", op, ParserException("Expected number after factor operator"));
-                expr = std::unique_ptr<Binary>(new Binary(std::move(expr), op, std::move(right)));
+            while (true) {
+                // NONE sorts below every operator, so anything but one ends the expression
+                // (the EOFF sentinel too)
+                auto prec = precedences[current().type];
+                if (prec < min) break;
+
+                // every operator is left associative, its right operand only takes tighter ones
+                auto op = token(advance());
+                auto right = binary(Precedence(uint8_t(prec) + 1));
+                auto& operand = operands[uint8_t(prec)];
+                if (expr == nullptr) rift::error::report(line, operand.where, operand.before, op, ParserException(operand.before));
+                if (right == nullptr) rift::error::report(line, operand.where, operand.after, op, ParserException(operand.after));
+                expr = make<Binary>(expr, op, right);
             }
 
             return expr;
         }
 
-        std::unique_ptr<Expr> Parser::term()
+        Expr* Parser::ternary()
         {
-            auto expr = factor();
-
-            while (match({Token(TokenType::MINUS, "-", "", line)}) || match({Token(TokenType::PLUS, "+", "", line)})) {
-                auto op = peekPrev();
-                auto right = factor();
-                if (expr == nullptr) rift::error::report(line, "term", "Expected number before term operator", op, ParserException("Expected number before term operator"));
-                if (right == nullptr) rift::error::report(line, "term", "Expected number after term operator", op, ParserException("Expected number after term operator"));
-                expr = std::unique_ptr<Binary>(new Binary(std::move(expr), op, std::move(right)));
-            }
-
-            return expr;
-        }
+            auto expr = binary(Precedence::OR);
 
-        std::unique_ptr<Expr> Parser::comparison()
-        {
-            auto expr = term();
-
-            while (match({Token(TokenType::GREATER, ">", "", line)}) || match({Token(TokenType::GREATER_EQUAL, ">=", "", line)}) || match({Token(TokenType::LESS, "<", "", line)}) || match({Token(TokenType::LESS_EQUAL, "<=", "", line)}) ) {
-                auto op = peekPrev();
-                auto right = term();
-                if (expr == nullptr) rift::error::report(line, "comparison", "Expected expression before comparison operator", op, ParserException("Expected expression before comparison operator"));
-                if (right == nullptr) rift::error::report(line, "comparison", "Expected expression after comparison operator", op, ParserException("Expected expression after comparison operator"));
-                expr = std::unique_ptr<Binary>(new Binary(std::move(expr), op, std::move(right)));
+            if (match(TokenType::QUESTION)) {
+                auto left = binary(Precedence::OR);
+                expect(TokenType::COLON, "Expected a colon while expecting a ternary operator");
+                auto right = binary(Precedence::OR);
+                return make<Ternary>(expr,left,right);
             }
 
             return expr;
         }
 
-        std::unique_ptr<Expr> Parser::equality()
+        Expr* Parser::assignment()
         {
-            auto expr = comparison();
-
-            if (match({Token(TokenType::BANG_EQUAL, "!=", "", line)}) || match({Token(TokenType::EQUAL_EQUAL, "==", "", line)}) || 
-                match({Token(TokenType::NULLISH_COAL, "??", "", line)}) || match({Token(TokenType::LOG_AND, "&&", "", line)}) ) {
-                auto op = peekPrev();
-                auto right = comparison();
-                if (expr == nullptr) rift::error::report(line, "equality", "Expected expression before equality operator", op, ParserException("Expected expression before equality operator"));
-                if (right == nullptr) rift::error::report(line, "equality", "Expected expression after equality operator", op, ParserException("Expected expression after equality operator"));
-                expr = std::unique_ptr<Binary>(new Binary(std::move(expr), op, std::move(right)));
-            }
-
-            return expr;
-        };
+            auto expr = ternary();
 
-        std::unique_ptr<Expr> Parser::ternary()
-        {
-            auto expr = equality();
-
-            if (match({Token(TokenType::QUESTION, "?", "", line)})) {
-                auto left = equality();
-                consume(Token(TokenType::COLON, ":", "", line), std::unique_ptr<ParserException>(new ParserException("Expected a colon while expecting a ternary operator")));
-                auto right = equality();
-                return std::unique_ptr<Ternary>(new Ternary(std::move(expr),std::move(left),std::move(right)));
-            }
+            if(match(TokenType::EQUAL)) {
+                auto op = token(peekPrev());
+                auto value = assignment();
+                if (value == nullptr) 
+                    rift::error::report(line, "assignment", "Expected expression after assignment operator", op, ParserException("Expected expression after assignment operator"));
 
-            return expr;
-        }
+                if (auto element = dynamic_cast<Index*>(expr))
+                    return make<SetIndex>(element->target, element->bracket, element->index, value);
 
-        std::unique_ptr<Expr> Parser::assignment()
-        {
-            if(match({Token(TokenType::EQUAL)})) {
-                auto idt = peekPrev(2);
-                auto expr = ternary();
-                if (expr == nullptr) 
-                    rift::error::report(line, "assignment", "Expected expression after assignment operator", peekPrev(), ParserException("Expected expression after assignment operator"));
+                auto target = dynamic_cast<Literal*>(expr);
+                if (target == nullptr || (target->value.type != TokenType::IDENTIFIER && target->value.type != TokenType::C_IDENTIFIER))
+                    rift::error::report(line, "assignment", "Invalid assignment target", op, ParserException("Invalid assignment target"));
 
-                return std::unique_ptr<Assign>(new Assign(idt, std::move(expr)));
+                return make<Assign>(target->value, value);
             }
 
-            return ternary();
+            return expr;
         }
 
-        std::unique_ptr<Expr> Parser::expression()
+        Expr* Parser::expression()
         {
             auto ret = assignment();
             return ret;
@@ -196,14 +239,14 @@ namespace rift
 
         #pragma mark - Statements Parsing
 
-        std::unique_ptr<Stmt> Parser::ret_stmt()
+        Stmt* Parser::ret_stmt()
         {
-            std::unique_ptr<Stmt> stmt;
-            if (consume (Token(TokenType::PRINT, "", "", line))) {
+            Stmt* stmt;
+            if (consume (TokenType::PRINT)) {
                 stmt = statement_print();
-            } else if (consume(Token(TokenType::IF, "if", "if", line))) {
+            } else if (consume(TokenType::IF)) {
                 stmt = statement_if();
-            } else if (consume(Token(TokenType::RETURN))) {
+            } else if (consume(TokenType::RETURN)) {
                 stmt = statement_return();
             } else {
                 stmt = statement_expression();
@@ -211,57 +254,60 @@ namespace rift
             return stmt;
         }
 
-        std::unique_ptr<StmtExpr> Parser::statement_expression()
+        StmtExpr* Parser::statement_expression()
         {
             auto expr = expression();
-            return std::unique_ptr<StmtExpr>(new StmtExpr(std::move(expr)));
+            if (expr == nullptr)
+                rift::error::report(line, "statement_expression", "Expected expression", token(peek()), ParserException("Expected expression"));
+            expect(TokenType::SEMICOLON, "Expected ';' after expression");
+            return make<StmtExpr>(expr);
         }
 
-        std::unique_ptr<StmtPrint> Parser::statement_print()
+        StmtPrint* Parser::statement_print()
         {
-            consume(Token(TokenType::LEFT_PAREN, "(", "", line), std::unique_ptr<ParserException>(new ParserException("Expected '(' after print")));
+            expect(TokenType::LEFT_PAREN, "Expected '(' after print");
             auto expr = expression();
-            consume(Token(TokenType::RIGHT_PAREN, ")", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ')' after print")));
-            consume(Token(TokenType::SEMICOLON, ";", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ';' after print statement")));
-            return std::unique_ptr<StmtPrint>(new StmtPrint(expr));
+            expect(TokenType::RIGHT_PAREN, "Expected ')' after print");
+            expect(TokenType::SEMICOLON, "Expected ';' after print statement");
+            return make<StmtPrint>(expr);
         }
 
-        std::unique_ptr<StmtIf> Parser::statement_if()
+        StmtIf* Parser::statement_if()
         {
-            std::unique_ptr<StmtIf> ret = std::make_unique<StmtIf>();
-            consume(Token(TokenType::LEFT_PAREN, "(", "", line), std::unique_ptr<ParserException>(new ParserException("Expected '(' after if")));
+            StmtIf* ret = make<StmtIf>();
+            expect(TokenType::LEFT_PAREN, "Expected '(' after if");
             auto expr = expression();
-            consume(Token(TokenType::RIGHT_PAREN, ")", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ')' after if")));
+            expect(TokenType::RIGHT_PAREN, "Expected ')' after if");
             
             /// if stmt
-            StmtIf::Stmt* if_stmt= new StmtIf::Stmt(std::move(expr));
+            StmtIf::Stmt* if_stmt= make<StmtIf::Stmt>(expr);
 
             // block vs stmt
-            if (peek() == Token(TokenType::LEFT_BRACE, "{", "", line)) {
-                consume(Token(TokenType::LEFT_BRACE, "{", "", line), std::unique_ptr<ParserException>(new ParserException("Expected '{' after if block")));
+            if (peek(TokenType::LEFT_BRACE)) {
+                expect(TokenType::LEFT_BRACE, "Expected '{' after if block");
                 auto blk = block();
-                if_stmt->blk = std::move(blk);
+                if_stmt->blk = blk;
             } else {
-                std::unique_ptr<Stmt> stmt = ret_stmt();
-                if_stmt->stmt = std::move(stmt);
+                Stmt* stmt = ret_stmt();
+                if_stmt->stmt = stmt;
             }
             ret->if_stmt = if_stmt;
 
             /// elif stmts
-            if (peek() == Token(TokenType::ELIF, "elif", "elif", line)) {
+            if (peek(TokenType::ELIF)) {
                 std::vector<StmtIf::Stmt*> elif_stmts = {};
 
-                while (consume(Token(TokenType::ELIF, "elif", "elif", line))) {
+                while (consume(TokenType::ELIF)) {
                     auto expr = expression();
-                    StmtIf::Stmt* curr = new StmtIf::Stmt(std::move(expr));
+                    StmtIf::Stmt* curr = make<StmtIf::Stmt>(expr);
                      // block vs stmt
-                    if (peek() == Token(TokenType::LEFT_BRACE, "{", "", line)) {
-                        consume(Token(TokenType::LEFT_BRACE, "{", "", line), std::unique_ptr<ParserException>(new ParserException("Expected '{' after elif block")));
+                    if (peek(TokenType::LEFT_BRACE)) {
+                        expect(TokenType::LEFT_BRACE, "Expected '{' after elif block");
                         auto blk = block();
-                        curr->blk = std::move(blk);
+                        curr->blk = blk;
                     } else {
-                        std::unique_ptr<Stmt> stmt = ret_stmt();
-                        curr->stmt = std::move(stmt);
+                        Stmt* stmt = ret_stmt();
+                        curr->stmt = stmt;
                     }
                     elif_stmts.push_back(curr);
                 }
@@ -270,16 +316,16 @@ namespace rift
 
 
             /// else stmt
-            if (consume(Token(TokenType::ELSE, "else", "else", line))) {
-                StmtIf::Stmt* else_stmt = new StmtIf::Stmt();
+            if (consume(TokenType::ELSE)) {
+                StmtIf::Stmt* else_stmt = make<StmtIf::Stmt>();
                 // block vs stmt
-                if (peek() == Token(TokenType::LEFT_BRACE, "{", "", line)) {
-                    consume(Token(TokenType::LEFT_BRACE, "{", "", line), std::unique_ptr<ParserException>(new ParserException("Expected '{' after else block")));
+                if (peek(TokenType::LEFT_BRACE)) {
+                    expect(TokenType::LEFT_BRACE, "Expected '{' after else block");
                     auto blk = block();
-                    else_stmt->blk = std::move(blk);
+                    else_stmt->blk = blk;
                 } else {
-                    std::unique_ptr<Stmt> stmt = ret_stmt();
-                    else_stmt->stmt = std::move(stmt);
+                    Stmt* stmt = ret_stmt();
+                    else_stmt->stmt = stmt;
                 }
                 ret->else_stmt = else_stmt;
             }
@@ -287,179 +333,227 @@ namespace rift
             return ret;
         }
 
-        std::unique_ptr<StmtReturn> Parser::statement_return()
+        StmtReturn* Parser::statement_return()
         {
-            auto expr = expression();
-            consume(Token(TokenType::SEMICOLON, ";", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ';' after return statement")));
-            return std::unique_ptr<StmtReturn>(new StmtReturn(std::move(expr)));
+            // `return;` yields nil
+            auto expr = peek(TokenType::SEMICOLON) ? nullptr : expression();
+            expect(TokenType::SEMICOLON, "Expected ';' after return statement");
+            return make<StmtReturn>(expr);
         }
 
         #pragma mark - Declarations Parsing
 
-        std::unique_ptr<DeclStmt> Parser::declaration_statement()
+        DeclStmt* Parser::declaration_statement()
         {
-            std::unique_ptr<Stmt> stmt = ret_stmt();
-            return std::make_unique<DeclStmt>(std::move(stmt));
+            Stmt* stmt = ret_stmt();
+            return make<DeclStmt>(stmt);
         }
 
-        std::unique_ptr<DeclVar> Parser::declaration_variable(bool mut)
+        DeclVar* Parser::declaration_variable(bool mut)
         {
             // make sure there is an identifier
             auto tok_t = mut ? TokenType::IDENTIFIER : TokenType::C_IDENTIFIER;
-            if (!consume(Token(TokenType::IDENTIFIER, "", "", line)) && !consume(Token(TokenType::C_IDENTIFIER, "", "", line)))
-                rift::error::report(line, "declaration_variable", "Expected variable name", peek(), ParserException("Expected variable name"));
-            auto idt = peekPrev();
-
-            // make sure the identifier is not already declared
-            /// @note this is just a check, the actual declaration is done in the evaluator
-            ///       this also checks if any outer block has already declared this variable
-            if (env::getInstance(true).getEnv(castString(idt)).type != TokenType::NIL)
-                rift::error::report(line, "declaration_variable", "🛑 Variable '" + castString(idt) + "' already declared at line: " + castNumberString(idt.line), idt, ParserException("Variable '" + castString(idt) + "' already declared"));
-            env::getInstance(true).setEnv(castString(idt), idt, idt.type == TokenType::C_IDENTIFIER);
-
-            if(peek() == Token(TokenType::EQUAL, "=", "", line)) {
-                auto expr = assignment();
-                consume(Token(TokenType::SEMICOLON, ";", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ';' after variable assignment")));
+            if (!consume(TokenType::IDENTIFIER) && !consume(TokenType::C_IDENTIFIER))
+                rift::error::report(line, "declaration_variable", "Expected variable name", token(peek()), ParserException("Expected variable name"));
+            auto idt = token(peekPrev());
+            /// @note redeclarations are reported by the Resolver
+
+            if(consume(TokenType::EQUAL)) {
+                auto expr = expression();
+                if (expr == nullptr)
+                    rift::error::report(line, "declaration_variable", "Expected expression after '='", token(peek()), ParserException("Expected expression after '='"));
+                expect(TokenType::SEMICOLON, "Expected ';' after variable assignment");
                 idt.type = tok_t;
-                return std::make_unique<DeclVar>(idt, std::move(expr));
+                return make<DeclVar>(idt, expr);
             } else if (!mut) {
                 rift::error::report(line, "declaration_variable", "🛑 Constants must be defined", idt, ParserException("Constants must be defined"));
             }
 
-            if (!consume(Token(TokenType::IDENTIFIER, "", "", line)) && !consume(Token(TokenType::C_IDENTIFIER, "", "", line)))
-                rift::error::report(line, "declaration_variable", "Expected variable name", peek(), ParserException("Expected variable name"));
-            idt = peekPrev();
-
-            consume(Token(TokenType::SEMICOLON, ";", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ';' after variable declaration")));
-            return std::unique_ptr<DeclVar>(new DeclVar(Token(tok_t, idt.lexeme, idt.literal, idt.line)));
+            expect(TokenType::SEMICOLON, "Expected ';' after variable declaration");
+            return make<DeclVar>(Token(tok_t, idt.lexeme, idt.literal, idt.line, idt.symbol));
         }
 
-        std::unique_ptr<For> Parser::for_()
+        For* Parser::for_()
         {
-            std::unique_ptr<For> _for = std::make_unique<For>();
-            consume(Token(TokenType::LEFT_PAREN, "(", "", line), std::unique_ptr<ParserException>(new ParserException("Expected '(' after for")));
+            For* _for = make<For>();
+            expect(TokenType::LEFT_PAREN, "Expected '(' after for");
 
             // first ;
-            if (match({Token(TokenType::VAR, "", "", line)})) {
-                _for->decl = std::move(declaration_variable(true));
-            } else if (match({Token(TokenType::CONST, "", "", line)}))  {
-                _for->decl = std::move(declaration_variable(false));
-            } else if(peek(Token(TokenType::IDENTIFIER, "", "", line))) {
-                _for->stmt_l = std::move(ret_stmt());
+            if (match(TokenType::VAR)) {
+                _for->decl = declaration_variable(true);
+            } else if (match(TokenType::CONST))  {
+                _for->decl = declaration_variable(false);
+            } else if(peek(TokenType::IDENTIFIER)) {
+                _for->stmt_l = ret_stmt();
+            } else {
+                expect(TokenType::SEMICOLON, "Expected ';' after for first statement");
             }
             // taken by var_decl();
-            // consume(Token(TokenType::SEMICOLON, ";", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ';' after for first statement")));
+            // expect(TokenType::SEMICOLON, "Expected ';' after for first statement");
 
             // second ;
             auto expr = expression();
-            _for->expr = std::move(expr);
-            consume(Token(TokenType::SEMICOLON, ";", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ';' after for second statement")));
+            _for->expr = expr;
+            expect(TokenType::SEMICOLON, "Expected ';' after for second statement");
 
-            // third ;
-            if(match({Token(TokenType::IDENTIFIER, "", "", line)}))
-                _for->stmt_r = std::move(ret_stmt());
-            consume(Token(TokenType::RIGHT_PAREN, ")", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ')' after for")));
+            // third ; (no trailing ';' before the closing paren)
+            if(!peek(TokenType::RIGHT_PAREN))
+                _for->stmt_r = make<StmtExpr>(expression());
+            expect(TokenType::RIGHT_PAREN, "Expected ')' after for");
 
-            if (match({Token(TokenType::LEFT_BRACE, "{", "", line)})) {
-                _for->blk = std::move(block());
+            if (match(TokenType::LEFT_BRACE)) {
+                _for->blk = block();
             } else {
-                _for->stmt_o = std::move(ret_stmt());
+                _for->stmt_o = ret_stmt();
             }
 
             return _for;
         }
 
-        std::unique_ptr<DeclFunc> Parser::declaration_func() 
+        DeclFunc* Parser::declaration_func() 
         {
-            std::unique_ptr<DeclFunc> _func = std::make_unique<DeclFunc>();
+            DeclFunc* _func = make<DeclFunc>();
             _func->func = function();
-            if (_func->func->blk == nullptr) {
-                consume(Token(TokenType::SEMICOLON, ";", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ';' after function declaration")));
+            if (_func->func->blk == nullptr && !_func->func->deferred()) {
+                expect(TokenType::SEMICOLON, "Expected ';' after function declaration");
             }
             return _func;
         }
 
+        Import* Parser::declaration_import()
+        {
+            auto keyword = token(peekPrev());
+            // the modules a program needs are known before any of it runs
+            if (depth > 0)
+                rift::error::report(line, "declaration_import", "Imports are only allowed at the top level", keyword, ParserException("Imports are only allowed at the top level"));
+            auto path = token(expect(TokenType::STRINGLITERAL, "Expected a module path after 'import'"));
+            expect(TokenType::SEMICOLON, "Expected ';' after import");
+            auto import = make<Import>(path);
+            imports.push_back(import);
+            return import;
+        }
+
         #pragma mark - Program / Block Parsing
 
         vec_prog Parser::ret_decl()
         {
-            vec_prog decls = std::make_unique<std::vector<std::unique_ptr<Decl>>>();
-            if (consume (Token(TokenType::VAR, "", "", line))) {
+            vec_prog decls;
+            if (consume (TokenType::VAR)) {
                 auto test = declaration_variable(true);
-                decls->emplace_back(std::move(test));
-            } else if (consume (Token(TokenType::CONST, "", "", line))) {
+                decls.emplace_back(test);
+            } else if (consume (TokenType::CONST)) {
                 auto test = declaration_variable(false);
-                decls->emplace_back(std::move(test));
-            } else if (consume (Token(TokenType::FOR, "", "", line)))  {
-                decls->emplace_back(for_());
-            } else if(match({Token(TokenType::LEFT_BRACE, "{", "", line)})) {
-                auto inner_decls = std::move(block()->decls);
-                decls->insert(decls->end(), std::make_move_iterator(inner_decls->begin()), std::make_move_iterator(inner_decls->end()));
-            } else if (match({Token(TokenType::FUN)})) {
-                decls->emplace_back(declaration_func());
+                decls.emplace_back(test);
+            } else if (consume (TokenType::FOR))  {
+                decls.emplace_back(for_());
+            } else if (consume (TokenType::PARALLEL))  {
+                expect(TokenType::FOR, "Expected 'for' after 'parallel'");
+                auto loop = for_();
+                loop->parallel = true;
+                decls.emplace_back(loop);
+            } else if(match(TokenType::LEFT_BRACE)) {
+                decls = std::move(block()->decls);
+            } else if (match(TokenType::FUN)) {
+                decls.emplace_back(declaration_func());
+            } else if (consume (TokenType::IMPORT)) {
+                decls.emplace_back(declaration_import());
             } else {
-                decls->emplace_back(declaration_statement());
+                decls.emplace_back(declaration_statement());
             }
             return decls;
         }
 
-        std::unique_ptr<Block> Parser::block()
+        Block* Parser::block()
         {
-            vec_prog decls = std::make_unique<std::vector<std::unique_ptr<Decl>>>();
+            vec_prog decls;
 
-            env::addChild(true);
-            while (!atEnd() && !peek(Token(TokenType::RIGHT_BRACE, "}", "", line))) {
+            depth++;
+            while (!atEnd() && !peek(TokenType::RIGHT_BRACE)) {
                 auto inner = ret_decl();
-                decls->insert(decls->end(), std::make_move_iterator(inner->begin()), std::make_move_iterator(inner->end()));
+                decls.insert(decls.end(), inner.begin(), inner.end());
             }
-            env::removeChild(true);
+            depth--;
 
-            if (!match({Token(TokenType::RIGHT_BRACE, "}", "", line)})) 
-                rift::error::report(line, "statement_block", "Expected '}' after block", peek(), ParserException("Expected '}' after block"));
+            if (!match(TokenType::RIGHT_BRACE)) 
+                rift::error::report(line, "statement_block", "Expected '}' after block", token(peek()), ParserException("Expected '}' after block"));
 
-            return std::unique_ptr<Block>(new Block(std::move(decls)));
+            return make<Block>(std::move(decls));
         }
 
         #pragma mark - Functions / Methods
 
-        std::unique_ptr<DeclFunc::Func> Parser::function()
+        DeclFunc::Func* Parser::function()
         {
-            std::unique_ptr<DeclFunc::Func> ret = std::make_unique<DeclFunc::Func>();
-            auto idt = consume_va({Token(TokenType::IDENTIFIER), Token(TokenType::C_IDENTIFIER)}, std::unique_ptr<ParserException>(new ParserException("Expected function name")));
+            DeclFunc::Func* ret = make<DeclFunc::Func>();
+            auto idt = token(match(TokenType::C_IDENTIFIER) ? peekPrev() : expect(TokenType::IDENTIFIER, "Expected function name"));
             ret->name = idt;
 
-            consume(Token(TokenType::LEFT_PAREN, "(", "", line), std::unique_ptr<ParserException>(new ParserException("Expected '(' after function name")));
+            expect(TokenType::LEFT_PAREN, "Expected '(' after function name");
             ret->params = params();
-            consume(Token(TokenType::RIGHT_PAREN, ")", "", line), std::unique_ptr<ParserException>(new ParserException("Expected ')' after function params")));
+            expect(TokenType::RIGHT_PAREN, "Expected ')' after function params");
             
-            if(match({Token(TokenType::LEFT_BRACE, "{", "", line)})) {
-                ret->blk = std::move(block());
+            if(match(TokenType::LEFT_BRACE)) {
+                if (lazy && depth == 0) {
+                    ret->begin = skip();
+                    deferred.push_back(ret);
+                } else {
+                    ret->blk = block();
+                }
             } else {
                 // TODO: allow stmt to emulate lambdas
-                rift::error::report(line, "function", "Lambdas not implemented yet", peek(), ParserException("Lambdas not implemented yet"));
+                rift::error::report(line, "function", "Lambdas not implemented yet", token(peek()), ParserException("Lambdas not implemented yet"));
             }
 
             return ret;
         }
 
+        uint32_t Parser::skip()
+        {
+            auto begin = curr;
+            closers.assign(1, TokenType::RIGHT_BRACE);
+            while (!closers.empty()) {
+                if (atEnd())
+                    rift::error::report(line, "statement_block", "Expected '}' after block", token(peek()), ParserException("Expected '}' after block"));
+                auto type = advance().type;
+                switch (type) {
+                    case TokenType::LEFT_BRACE: closers.push_back(TokenType::RIGHT_BRACE); break;
+                    case TokenType::LEFT_PAREN: closers.push_back(TokenType::RIGHT_PAREN); break;
+                    case TokenType::LEFT_BRACKET: closers.push_back(TokenType::RIGHT_BRACKET); break;
+                    case TokenType::RIGHT_BRACE:
+                    case TokenType::RIGHT_PAREN:
+                    case TokenType::RIGHT_BRACKET:
+                        // what the eager parse would stop at too, whatever else is wrong
+                        if (type != closers.back())
+                            rift::error::report(line, "function", "Unbalanced brackets in function body", token(peekPrev()), ParserException("Unbalanced brackets in function body"));
+                        closers.pop_back();
+                        break;
+                    default: break;
+                }
+            }
+            return begin;
+        }
+
         // should be a comma operator instead... sigh aman
         Tokens Parser::params()
         {
             Tokens toks = {};
-            while(peek() == Token(TokenType::IDENTIFIER) || peek() == Token(TokenType::C_IDENTIFIER)) {
-                toks.push_back(consume_va({Token(TokenType::IDENTIFIER), Token(TokenType::C_IDENTIFIER)}, std::unique_ptr<ParserException>(new ParserException("Expected parameter name"))));
-                if (!consume(Token(TokenType::COMMA, ",", "", line))) break;
+            while(peek(TokenType::IDENTIFIER) || peek(TokenType::C_IDENTIFIER)) {
+                toks.push_back(token(match(TokenType::C_IDENTIFIER) ? peekPrev() : expect(TokenType::IDENTIFIER, "Expected parameter name")));
+                if (!consume(TokenType::COMMA)) break;
             }
             return toks;
         }
 
-        Exprs Parser::args()
+        Exprs Parser::args(TokenType close)
         {
             Exprs exprs = {};
-            while(peek().type != TokenType::RIGHT_PAREN) {
+            if (peek().type == close) return exprs;
+            do {
                 auto exp = expression();
-                exprs.emplace_back(std::move(exp));
-            }
+                if (exp == nullptr)
+                    rift::error::report(line, "args", "Expected argument expression", token(peek()), ParserException("Expected argument expression"));
+                exprs.emplace_back(exp);
+            } while (consume(TokenType::COMMA));
             return exprs;
         }
 
@@ -468,22 +562,30 @@ namespace rift
 
         std::unique_ptr<Program> Parser::program()
         {
-            vec_prog decls = std::make_unique<std::vector<std::unique_ptr<Decl>>>();
+            vec_prog decls;
 
             while (!atEnd()) {
                 auto inner = ret_decl();
-                decls->insert(decls->end(), std::make_move_iterator(inner->begin()), std::make_move_iterator(inner->end()));
+                decls.insert(decls.end(), inner.begin(), inner.end());
             }
 
-            env::getInstance(true).clear(true);
-            return std::unique_ptr<Program>(new Program(std::move(decls)));
+            auto prgm = std::make_unique<Program>(std::move(decls), std::move(arena));
+            prgm->imported = std::move(imports);
+            imports.clear();
+            if (!deferred.empty()) {
+                prgm->tokens = tokens;
+                prgm->isolate = &isolate;
+                for (auto func : deferred) func->owner = prgm.get();
+                deferred.clear();
+            }
+            return prgm;
         }
 
         # pragma mark - Utilities
 
         void Parser::synchronize()
         {
-            advance();
+            if (!atEnd()) advance();
 
             while (!atEnd()) {
                 if (peekPrev().type == TokenType::SEMICOLON) return;
@@ -493,6 +595,8 @@ namespace rift
                     case TokenType::FUN:
                     case TokenType::VAR:
                     case TokenType::FOR:
+                    case TokenType::PARALLEL:
+                    case TokenType::IMPORT:
                     case TokenType::IF:
                     case TokenType::WHILE:
                     case TokenType::PRINT:
@@ -0,0 +1,43 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ast/prgm.hh>
+#include <ast/parser.hh>
+#include <ast/resolver.hh>
+#include <ast/optimizer.hh>
+
+namespace rift
+{
+    namespace ast
+    {
+        #pragma mark - Deferred Bodies
+
+        const Block* DeclFunc::Func::parse() const
+        {
+            return owner->body(*this);
+        }
+
+        Block* Program::body(const DeclFunc::Func& func) const
+        {
+            if (!func.deferred()) return func.blk;
+
+            // the body goes through the same passes as the rest of the program did
+            Parser parser(tokens, *isolate);
+            func.blk = parser.body(func.begin, *arena);
+            Resolver(*isolate).resolve(*this, func);
+            Optimizer().optimize(*this, func);
+            return func.blk;
+        }
+    }
+}
\ No newline at end of file
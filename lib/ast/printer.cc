@@ -13,6 +13,7 @@
 /////////////////////////////////////////////////////////////
 
 #include <ast/printer.hh>
+#include <utils/literals.hh>
 
 #include <vector>
 #include <initializer_list>
@@ -57,22 +58,22 @@ namespace rift
         string Visitor::print_binary(const Binary& expr) const
         {
             vec v;
-            v.push_back(expr.left.get());
-            v.push_back(expr.right.get());
+            v.push_back(expr.left);
+            v.push_back(expr.right);
             return printer->parenthesize(expr.op.lexeme, v);
         }
 
         string Visitor::print_unary(const Unary& expr) const
         {
             vec v;
-            v.push_back(expr.expr.get());
+            v.push_back(expr.expr);
             return printer->parenthesize(expr.op.lexeme, v);
         }
 
         string Visitor::print_grouping(const Grouping& expr) const
         {
             vec v;
-            v.push_back(expr.expr.get());
+            v.push_back(expr.expr);
             return printer->group(v);
         }
 
@@ -83,7 +84,7 @@ namespace rift
             if (literal.type() == typeid(std::string))
                 return std::any_cast<std::string>(literal);
             else if (literal.type() == typeid(double))
-                return std::to_string(std::any_cast<double>(literal));
+                return formatNumber(std::any_cast<double>(literal));
             else if (literal.type() == typeid(int))
                 return std::to_string(std::any_cast<int>(literal));
             else if (literal.type() == typeid(char**))
@@ -0,0 +1,211 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ast/profiler.hh>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sys/time.h>
+
+namespace rift
+{
+    namespace ast
+    {
+        Profiler* Profiler::active = nullptr;
+
+        /// @brief words of sample storage, a ten frame deep stack every millisecond lasts ~3 minutes
+        static constexpr size_t BUFFER_WORDS = size_t(4) << 20;
+
+        Profiler::Profiler(std::chrono::microseconds interval) : interval(interval) {}
+
+        Profiler::~Profiler() { stop(); }
+
+        #pragma mark - Timer
+
+        void Profiler::start()
+        {
+            if (active == this) return;
+            if (active != nullptr) active->stop();
+            if (!buffer) {
+                buffer = std::make_unique<uint32_t[]>(BUFFER_WORDS);
+                capacity = BUFFER_WORDS;
+            }
+
+            active = this;
+            struct sigaction action = {};
+            action.sa_handler = &Profiler::sample;
+            action.sa_flags = SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGPROF, &action, &previous);
+
+            struct itimerval timer = {};
+            timer.it_interval.tv_sec = interval.count() / 1000000;
+            timer.it_interval.tv_usec = interval.count() % 1000000;
+            timer.it_value = timer.it_interval;
+            if (setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+                std::cerr << "profile: could not start the timer (" << std::strerror(errno) << ")" << std::endl;
+        }
+
+        void Profiler::stop()
+        {
+            if (active != this) return;
+            struct itimerval timer = {};
+            setitimer(ITIMER_PROF, &timer, nullptr);
+            sigaction(SIGPROF, &previous, nullptr);
+            active = nullptr;
+        }
+
+        void Profiler::sample(int)
+        {
+            Profiler* prof = active;
+            if (prof == nullptr) return;
+
+            uint32_t depth = prof->depth;
+            if (depth > MAX_DEPTH) depth = MAX_DEPTH;
+            size_t need = 1 + 2 * size_t(depth);
+            size_t used = prof->used;
+            if (used + need > prof->capacity) {
+                prof->dropped = prof->dropped + 1;
+                return;
+            }
+
+            uint32_t* out = prof->buffer.get() + used;
+            *out++ = depth;
+            for (uint32_t i = 0; i < depth; i++) {
+                *out++ = prof->fns[i];
+                *out++ = prof->lines[i];
+            }
+            prof->used = used + need;
+            prof->count = prof->count + 1;
+        }
+
+        #pragma mark - Shadow Stack
+
+        void Profiler::enter(const std::string& name)
+        {
+            auto [it, inserted] = ids.try_emplace(name, uint32_t(names.size()));
+            if (inserted) names.push_back(name);
+
+            // the frame is filled in before it becomes visible to the handler
+            if (depth < MAX_DEPTH) {
+                fns[depth] = it->second;
+                lines[depth] = 0;
+            }
+            depth = depth + 1;
+        }
+
+        #pragma mark - Reports
+
+        template <typename F>
+        void Profiler::each(F&& fn) const
+        {
+            const uint32_t* it = buffer.get();
+            const uint32_t* end = it + used;
+            while (it < end) {
+                uint32_t depth = *it++;
+                fn(it, depth);
+                it += 2 * size_t(depth);
+            }
+        }
+
+        static std::string percent(size_t part, size_t total)
+        {
+            char buf[16];
+            std::snprintf(buf, sizeof(buf), "%6.2f%%", total ? 100.0 * double(part) / double(total) : 0.0);
+            return buf;
+        }
+
+        /// @brief the text of a (1 based) line, empty when out of range
+        static std::string_view quote(std::span<const char> source, uint32_t line)
+        {
+            std::string_view src(source.data(), source.size());
+            size_t pos = 0;
+            for (uint32_t i = 1; i < line && pos != std::string_view::npos; i++) {
+                pos = src.find('\n', pos);
+                if (pos != std::string_view::npos) pos++;
+            }
+            if (line == 0 || pos == std::string_view::npos || pos >= src.size()) return {};
+
+            auto text = src.substr(pos, src.find('\n', pos) - pos);
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+            return text;
+        }
+
+        void Profiler::report(std::ostream& out, std::span<const char> source) const
+        {
+            struct Function { size_t self = 0, total = 0; };
+            std::vector<Function> fns(names.size());
+            std::map<uint32_t, size_t> lines;
+            std::vector<uint32_t> seen(names.size(), 0);
+
+            uint32_t nth = 0;
+            each([&](const uint32_t* frames, uint32_t depth) {
+                nth++;
+                for (uint32_t i = 0; i < depth; i++) {
+                    auto fn = frames[2 * i];
+                    // recursion is only counted once towards the total
+                    if (seen[fn] != nth) { seen[fn] = nth; fns[fn].total++; }
+                }
+                fns[frames[2 * (depth - 1)]].self++;
+                lines[frames[2 * (depth - 1) + 1]]++;
+            });
+
+            size_t total = count;
+            out << "profile: " << total << " samples every " << interval.count() << "us";
+            if (dropped) out << " (" << dropped << " dropped)";
+            out << std::endl << std::endl;
+
+            std::vector<uint32_t> order(names.size());
+            for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+            std::sort(order.begin(), order.end(), [&](uint32_t l, uint32_t r) { return fns[l].self > fns[r].self; });
+            out << "    self    total  function" << std::endl;
+            for (auto fn : order) {
+                if (fns[fn].total == 0) continue;
+                out << percent(fns[fn].self, total) << " " << percent(fns[fn].total, total) << "  " << names[fn] << std::endl;
+            }
+            out << std::endl;
+
+            std::vector<std::pair<uint32_t, size_t>> hot(lines.begin(), lines.end());
+            std::stable_sort(hot.begin(), hot.end(), [](const auto& l, const auto& r) { return l.second > r.second; });
+            out << "    self  samples  line" << std::endl;
+            for (const auto& [line, samples] : hot) {
+                char buf[32];
+                std::snprintf(buf, sizeof(buf), " %8zu %5u  ", samples, line);
+                out << percent(samples, total) << buf << quote(source, line) << std::endl;
+            }
+        }
+
+        void Profiler::collapsed(std::ostream& out) const
+        {
+            std::map<std::string, size_t> stacks;
+            std::string key;
+            each([&](const uint32_t* frames, uint32_t depth) {
+                key.clear();
+                for (uint32_t i = 0; i < depth; i++) {
+                    if (i) key += ';';
+                    key += names[frames[2 * i]];
+                    key += ':';
+                    key += std::to_string(frames[2 * i + 1]);
+                }
+                stacks[key]++;
+            });
+            for (const auto& [stack, samples] : stacks)
+                out << stack << " " << samples << std::endl;
+        }
+    }
+}
\ No newline at end of file
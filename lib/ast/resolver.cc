@@ -0,0 +1,344 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ast/resolver.hh>
+#include <ast/env.hh>
+#include <error/error.hh>
+
+
+namespace rift
+{
+    namespace ast
+    {
+        #pragma mark - Public API
+
+        void Resolver::resolve(const Program& prgm)
+        {
+            Isolate::Scope enter(*isolate);
+            open.clear();
+            globals = &prgm.declared;
+            globals->clear();
+            programs++;
+            visible = UINT32_MAX;
+            function = 0;
+            parallel = NONE;
+            prgm.accept(*this);
+        }
+
+        void Resolver::resolve(const Program& prgm, const DeclFunc::Func& func)
+        {
+            // a deferred body is always a top level function's, so no scope is open around it
+            Isolate::Scope enter(*isolate);
+            open.clear();
+            globals = &prgm.declared;
+            visible = func.globals;
+            function = 0;
+            parallel = NONE;
+            body(func);
+            visible = UINT32_MAX;
+        }
+
+        #pragma mark - Scopes
+
+        Address Resolver::declare(const Token& name, bool is_const) const
+        {
+            // a declaration can't shadow anything visible from it
+            auto order = globals->find(name.symbol);
+            bool shadows = order && *order < visible;
+            for (size_t i = function; i < open.size() && !shadows; i++)
+                shadows = open[i].locals.contains(name.symbol);
+            if (shadows)
+                rift::error::report(name.line, "declaration_variable", "🛑 Variable '" + name.lexeme + "' already declared", name, ResolverException("Variable '" + name.lexeme + "' already declared"));
+
+            if (open.empty()) {
+                // another module (or the importer) would overwrite it once they both ran
+                if (*linked.emplace(name.symbol, programs).first != programs)
+                    rift::error::report(name.line, "declaration_variable", "Variable '" + name.lexeme + "' already declared by another module", name, ResolverException("Variable '" + name.lexeme + "' already declared by another module"));
+                globals->emplace(name.symbol, static_cast<uint32_t>(globals->size()));
+                return {Address::GLOBAL, isolate->globals.slot(name.symbol)};
+            }
+
+            auto& scope = open.back();
+            auto slot = scope.slots++;
+            scope.locals.emplace(name.symbol, Local{slot, is_const});
+            return {0, slot};
+        }
+
+        Address Resolver::declareFunc(const Token& name) const
+        {
+            // redefining a global function is reported when it runs
+            if (open.empty())
+                return {Address::GLOBAL, isolate->globals.slot(name.symbol)};
+
+            auto& scope = open.back();
+            if (scope.locals.contains(name.symbol))
+                rift::error::report(name.line, "declaration_func", "Function '" + name.lexeme + "' already defined", name, ResolverException("Function '" + name.lexeme + "' already defined"));
+
+            auto slot = scope.slots++;
+            scope.locals.emplace(name.symbol, Local{slot, false});
+            return {0, slot};
+        }
+
+        Address Resolver::lookup(const Token& name, bool assign) const
+        {
+            for (size_t i = open.size(); i-- > 0;) {
+                auto local = open[i].locals.find(name.symbol);
+                if (!local) continue;
+
+                if (i < function)
+                    rift::error::report(name.line, "lookup", "Cannot use local variable '" + name.lexeme + "' of an enclosing function", name, ResolverException("Closures are not supported"));
+                if (assign && local->is_const)
+                    rift::error::report(name.line, "lookup", "Cannot reassign a constant variable", name, ResolverException("Cannot reassign a constant variable"));
+                if (assign && i < parallel && parallel != NONE)
+                    sequential(name.line, "assign '" + name.lexeme + "', it is declared outside of it");
+                return {static_cast<uint32_t>(open.size() - 1 - i), local->slot};
+            }
+            // the iterations would all write the same global at once
+            if (assign && parallel != NONE)
+                sequential(name.line, "assign the global '" + name.lexeme + "'");
+            return {Address::GLOBAL, isolate->globals.slot(name.symbol)};
+        }
+
+        void Resolver::sequential(uint32_t line, const std::string& what) const
+        {
+            rift::error::report(line, "parallel", "Cannot " + what + " inside a parallel for", Token(), ResolverException("Cannot " + what + " inside a parallel for"));
+        }
+
+        void Resolver::declarations(const Block& block) const
+        {
+            for (const auto& decl : block.decls)
+                decl->accept(*this);
+            block.slots = open.back().slots;
+        }
+
+        #pragma mark - Expressions
+
+        Value Resolver::visit_literal(const Literal& expr) const
+        {
+            if (expr.value.type == TokenType::IDENTIFIER || expr.value.type == TokenType::C_IDENTIFIER)
+                expr.addr = lookup(expr.value, false);
+            return Value();
+        }
+
+        Value Resolver::visit_binary(const Binary& expr) const
+        {
+            expr.left->accept(*this);
+            expr.right->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_assign(const Assign& expr) const
+        {
+            expr.value->accept(*this);
+            expr.addr = lookup(expr.name, true);
+            return Value();
+        }
+
+        Value Resolver::visit_grouping(const Grouping& expr) const
+        {
+            expr.expr->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_unary(const Unary& expr) const
+        {
+            expr.expr->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_ternary(const Ternary& expr) const
+        {
+            expr.condition->accept(*this);
+            expr.left->accept(*this);
+            expr.right->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_call(const Call& expr) const
+        {
+            expr.name->accept(*this);
+            // whether the global is defined is only known when the call runs
+            auto name = dynamic_cast<const Literal*>(expr.name);
+            if (name != nullptr && name->addr.global() && CompactToken::named(name->value.type))
+                expr.builtin = builtins::lookup(name->value.lexeme);
+            for (const auto& arg : expr.args)
+                arg->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_spawn(const Spawn& expr) const
+        {
+            if (parallel != NONE) sequential(expr.keyword.line, "spawn a task");
+            expr.call->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_await(const Await& expr) const
+        {
+            if (parallel != NONE) sequential(expr.keyword.line, "await a task");
+            expr.task->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_array(const Array& expr) const
+        {
+            for (const auto& element : expr.elements)
+                element->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_index(const Index& expr) const
+        {
+            expr.target->accept(*this);
+            expr.index->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_set_index(const SetIndex& expr) const
+        {
+            expr.target->accept(*this);
+            expr.index->accept(*this);
+            expr.value->accept(*this);
+            return Value();
+        }
+
+        #pragma mark - Statements
+
+        Value Resolver::visit_expr_stmt(const StmtExpr& stmt) const
+        {
+            stmt.expr->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_print_stmt(const StmtPrint& stmt) const
+        {
+            stmt.expr->accept(*this);
+            return Value();
+        }
+
+        Value Resolver::visit_if_stmt(const StmtIf& stmt) const
+        {
+            auto branch = [this](const StmtIf::Stmt* branch) {
+                if (branch == nullptr) return;
+                if (branch->expr != nullptr) branch->expr->accept(*this);
+                if (branch->blk != nullptr) branch->blk->accept(*this);
+                else if (branch->stmt != nullptr) branch->stmt->accept(*this);
+            };
+
+            branch(stmt.if_stmt);
+            for (const auto& elif_stmt : stmt.elif_stmts)
+                branch(elif_stmt);
+            branch(stmt.else_stmt);
+            return Value();
+        }
+
+        Value Resolver::visit_return_stmt(const StmtReturn& stmt) const
+        {
+            // a function declared in the body may return, the body itself can't
+            if (parallel != NONE && function < parallel) sequential(stmt.line, "return");
+            if (stmt.expr != nullptr) stmt.expr->accept(*this);
+            return Value();
+        }
+
+        #pragma mark - Declarations
+
+        Values Resolver::visit_decl_stmt(const DeclStmt& decl) const
+        {
+            decl.stmt->accept(*this);
+            return {};
+        }
+
+        Values Resolver::visit_decl_var(const DeclVar& decl) const
+        {
+            // the initializer can't see the variable it initializes
+            if (decl.expr != nullptr) decl.expr->accept(*this);
+            decl.addr = declare(decl.identifier, decl.identifier.type == TokenType::C_IDENTIFIER);
+            return {};
+        }
+
+        Values Resolver::visit_decl_func(const DeclFunc& decl) const
+        {
+            // declared first so the body can call itself
+            decl.addr = declareFunc(decl.func->name);
+            decl.func->globals = static_cast<uint32_t>(globals->size());
+            if (decl.func->blk != nullptr) body(*decl.func);
+            return {};
+        }
+
+        Values Resolver::visit_import(const Import& decl) const
+        {
+            // modules are loaded by the driver, anything else compiling a program can't import
+            if (!decl.linked)
+                rift::error::report(decl.line, "import", "Module '" + decl.path.lexeme + "' wasn't loaded, only files run by the driver can import", decl.path, ResolverException("Module wasn't loaded"));
+            return {};
+        }
+
+        void Resolver::body(const DeclFunc::Func& func) const
+        {
+            auto enclosing = function;
+            function = open.size();
+            open.emplace_back();
+            // parameters may shadow globals, but not each other
+            auto& scope = open.back();
+            for (const auto& param : func.params) {
+                if (scope.locals.contains(param.symbol))
+                    rift::error::report(param.line, "declaration_func", "Duplicate parameter '" + param.lexeme + "'", param, ResolverException("Duplicate parameter '" + param.lexeme + "'"));
+                scope.locals.emplace(param.symbol, Local{scope.slots++, false});
+            }
+            declarations(*func.blk);
+            open.pop_back();
+            function = enclosing;
+        }
+
+        Values Resolver::visit_for(const For& decl) const
+        {
+            For::Counted loop;
+            if (decl.parallel && !decl.counted(loop))
+                rift::error::report(decl.line, "parallel", "A parallel for must count: for (mut i = start; i < end; i = i + step)", Token(), ResolverException("A parallel for must count"));
+
+            open.emplace_back();
+            if (decl.decl != nullptr) decl.decl->accept(*this);
+            else if (decl.stmt_l != nullptr) decl.stmt_l->accept(*this);
+            decl.slots = open.back().slots;
+
+            if (decl.expr != nullptr) decl.expr->accept(*this);
+            if (decl.stmt_r != nullptr) decl.stmt_r->accept(*this);
+
+            // the loop variable belongs to the loop, not to the body
+            auto enclosing = parallel;
+            if (decl.parallel) parallel = open.size();
+            if (decl.stmt_o != nullptr) decl.stmt_o->accept(*this);
+            else if (decl.blk != nullptr) decl.blk->accept(*this);
+            parallel = enclosing;
+
+            open.pop_back();
+            return {};
+        }
+
+        Values Resolver::visit_block_stmt(const Block& block) const
+        {
+            open.emplace_back();
+            declarations(block);
+            open.pop_back();
+            return {};
+        }
+
+        Values Resolver::visit_program(const Program& prgm) const
+        {
+            for (const auto& decl : prgm.decls)
+                decl->accept(*this);
+            return {};
+        }
+    }
+}
\ No newline at end of file
@@ -13,18 +13,32 @@
 /////////////////////////////////////////////////////////////
 
 
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
-#include <fstream> // file stream
-#include <sstream> // string stream
+#include <span>
 #include <vector>
 #include <driver/driver.hh>
 #include <error/error.hh>
+#include <utils/mapped_file.hh>
+#include <utils/scheduler.hh>
 
 
 #include <ast/expr.hh>
 #include <ast/parser.hh>
 #include <scanner/scanner.hh>
 #include <ast/eval.hh>
+#include <ast/profiler.hh>
+#include <ast/resolver.hh>
+#include <ast/optimizer.hh>
+#include <vm/vm.hh>
+#include <vm/cache.hh>
+#include <vm/compiler.hh>
+#include <vm/image.hh>
+#include <ir/builder.hh>
+#include <ir/passes.hh>
 #include <string>
 
 using namespace rift::error;
@@ -37,53 +51,270 @@ namespace rift
     {
         # pragma mark - Driver Tools
 
-        void run(std::string lines, bool interactive)
+        Driver::Driver() = default;
+        Driver::Driver(Emit emit) : emit(emit) {}
+        Driver::~Driver() = default;
+
+        void Driver::run(std::span<const char> source, bool interactive, const std::string& file)
         {
-            std::istringstream scanner(lines);
-            std::shared_ptr<std::vector<char>> source = std::make_shared<std::vector<char>>(std::istreambuf_iterator<char>(scanner), std::istreambuf_iterator<char>()); 
-            
-            Scanner riftScanner(source);
-            riftScanner.scan_source();
-
-            std::shared_ptr<std::vector<Token>> tokensPtr = std::make_shared<std::vector<Token>>(riftScanner.tokens);
-            Parser riftParser(tokensPtr);
-            std::unique_ptr<Program> statements = riftParser.parse(); 
-
-            Eval riftEvaluator;
-            riftEvaluator.evaluate(*statements, interactive);
-            rift::ast::Environment::getInstance(true).printState();
-            rift::ast::Environment::getInstance(false).printState();
+            Isolate::Scope enter(isolate);
+            auto stats = this->stats.get();
+            auto profiler = this->profiler.get();
+
+            // phases run untimed unless --stats was given
+            auto phase = [stats](const std::string& name, auto&& fn) -> decltype(auto) {
+                if (stats) return stats->time(name, fn);
+                return fn();
+            };
+
+            // nothing reads the results, so none are kept however long the program runs
+            DiscardResults results;
+
+            // a script compiled from this exact source skips every phase up to eval
+            uint64_t key = 0;
+            std::string cache;
+            if (engine == Engine::VM && caching && !dumping && emit == Emit::NONE && !file.empty() && file != "-") {
+                key = rift::vm::ScriptCache::key(source);
+                cache = rift::vm::ScriptCache::path(file, key);
+                auto script = phase("load", [&] { return rift::vm::ScriptCache::load(cache, key, isolate.symbols); });
+                if (script) {
+                    if (!vm) vm = std::make_unique<rift::vm::VM>(isolate);
+                    phase("eval", [&] { vm->run(std::move(script), results); });
+                    if (stats) stats->depth = std::max(stats->depth, vm->peakDepth());
+                    return;
+                }
+            }
+
+            Scanner riftScanner(source, isolate);
+            phase("scan", [&] { riftScanner.scan_source(); });
+
+            Parser riftParser(riftScanner.tokens, isolate);
+            if (stats) riftParser.kinds = &stats->kinds;
+            // sources outlive their programs, so bodies can be parsed when first called
+            riftParser.lazy = true;
+            std::unique_ptr<Program> statements = phase("parse", [&] { return riftParser.parse(); });
+
+            // imports are compiled at once and in parallel, then resolved in the order they run
+            std::vector<Module*> imported;
+            if (!statements->imports().empty()) {
+                auto self = file.empty() || file == "-" ? std::filesystem::path() : std::filesystem::path(file);
+                auto from = self.empty() ? std::filesystem::current_path() : std::filesystem::absolute(self).parent_path();
+                modules.counting = stats != nullptr;
+                imported = phase("import", [&] { return modules.load(*statements, from, self); });
+                if (stats) {
+                    for (auto module : imported) {
+                        stats->tokens += module->tokens;
+                        for (const auto& [kind, count] : module->kinds) stats->kinds[kind] += count;
+                    }
+                }
+            }
+            std::vector<const Program*> programs;
+            for (auto module : imported) programs.push_back(module->program.get());
+            programs.push_back(statements.get());
+
+            Resolver riftResolver(isolate);
+            phase("resolve", [&] { for (auto program : programs) riftResolver.resolve(*program); });
+
+            phase("optimize", [&] { modules.optimize(imported, *statements); });
+
+            if (stats) stats->tokens += riftScanner.tokens->size();
+
+            if (dumping) {
+                for (auto program : programs) {
+                    auto module = phase("ir", [&] { return rift::ir::Builder().build(*program); });
+                    auto passes = rift::ir::PassManager::standard();
+                    phase("passes", [&] { passes.run(*module); });
+                    dump(*module, passes);
+                }
+            }
+
+            // compiled ahead of time, what runs later is the vm's bytecode whatever the engine
+            if (emit != Emit::NONE) {
+                std::vector<std::unique_ptr<rift::vm::Script>> scripts;
+                phase("compile", [&] { for (auto program : programs) scripts.push_back(rift::vm::Compiler().compile(*program)); });
+                if (!isolate.errors.compile) phase("emit", [&] { write(rift::vm::Image::encode(scripts, isolate.symbols), file); });
+                return;
+            }
+
+            if (engine == Engine::VM) {
+                if (profiler && !warned) std::cerr << "profile: only the tree engine is sampled" << std::endl;
+                warned = warned || profiler;
+
+                if (!vm) vm = std::make_unique<rift::vm::VM>(isolate);
+                for (auto program : programs) {
+                    auto script = phase("compile", [&] { return rift::vm::Compiler().compile(*program); });
+                    // a script doesn't hold the modules it imports, so those aren't cached
+                    if (!cache.empty() && program == statements.get() && imported.empty()) rift::vm::ScriptCache::store(cache, key, *script, isolate.symbols);
+                    phase("eval", [&] { vm->run(std::move(script), results); });
+                }
+                if (stats) stats->depth = std::max(stats->depth, vm->peakDepth());
+                return;
+            }
+
+            if (!eval) {
+                eval = std::make_unique<Eval>(isolate);
+                eval->tiered(engine == Engine::TIERED);
+            }
+            if (profiler) {
+                eval->profile(profiler);
+                profiler->start();
+            }
+            // kept before it runs, what a line declared stays callable when it fails halfway
+            if (interactive) session.push_back(std::move(statements));
+            phase("eval", [&] { for (auto program : programs) eval->evaluate(*program, results); });
+            if (profiler) profiler->stop();
+            if (stats) stats->depth = std::max(stats->depth, eval->peakDepth());
+        }
+
+        void Driver::dump(const rift::ir::Module& module, const rift::ir::PassManager& passes)
+        {
+            std::string out = module.print() + ";";
+            for (size_t i = 0; i < passes.changes.size(); i++) out += (i ? ", " : " ") + passes.changes[i].first + ": " + std::to_string(passes.changes[i].second);
+            out += "\n";
+
+            if (ir_path.empty()) {
+                std::cerr << out;
+                return;
+            }
+            std::ofstream file(ir_path, std::ios::app);
+            if (file) file << out;
+            else std::cerr << "Could not write the IR to '" << ir_path << "'" << std::endl;
+        }
+
+        void Driver::write(std::string_view image, const std::string& file)
+        {
+            bool exe = emit == Emit::EXE;
+            auto path = output;
+            if (path.empty()) {
+                auto from = std::filesystem::path(file == "-" ? "a.rf" : file);
+                path = exe ? from.replace_extension().string() : from.replace_extension(".rfo").string();
+                // a file without an extension isn't written over
+                if (path == file) path += ".out";
+            }
+
+            if (!rift::vm::Image::write(path, image, exe)) {
+                std::cerr << "Could not write '" << path << "'" << std::endl;
+                exit(1);
+            }
+        }
+
+        bool Driver::runEmbedded()
+        {
+            auto self = rift::vm::Image::self();
+            auto exe = self.empty() ? nullptr : MappedFile::open(self);
+            if (!exe) return false;
+            auto image = rift::vm::Image::embedded(exe->span());
+            if (image.empty()) return false;
+
+            runImage(image, self);
+            if (isolate.errors.runtime) exit(69);
+            return true;
+        }
+
+        void Driver::runImage(std::span<const char> image, const std::string& from)
+        {
+            Isolate::Scope enter(isolate);
+            auto scripts = rift::vm::Image::decode(image, isolate.symbols);
+            if (scripts.empty()) {
+                std::cerr << "'" << from << "' was compiled by another build of rift" << std::endl;
+                exit(1);
+            }
+
+            DiscardResults results;
+            if (!vm) vm = std::make_unique<rift::vm::VM>(isolate);
+            auto eval = [&] { for (auto& script : scripts) vm->run(std::move(script), results); };
+            if (stats) {
+                stats->time("eval", eval);
+                stats->depth = std::max(stats->depth, vm->peakDepth());
+            } else {
+                eval();
+            }
         }
 
         void Driver::runFile(std::string path)
         {
-            std::ifstream file(std::string(path), std::ios::binary | std::ios::ate);
-            if (file) {
-                std::streamsize size = file.tellg();
-                file.seekg(0, std::ios::beg);
-                std::vector<char> buffer(size);
-                if (file.read(buffer.data(), size)) {
-                    run(buffer.data(), false);
-                    if (errorOccured) exit(42);
-                    if (runtimeErrorOccured) exit(69);
-                }
-            }   
+            // mapped (or read, for pipes and "-") once, the scanner works on it in place
+            auto file = MappedFile::open(path);
+            if (file && rift::vm::Image::is(file->span()) && emit != Emit::NONE) {
+                // compiled already (--emit=obj), it only has to be copied out
+                write(std::string_view(file->span().data(), file->span().size()), path);
+            } else if (file && rift::vm::Image::is(file->span())) {
+                // there is no source to quote
+                runImage(file->span(), path);
+                report({});
+                if (isolate.errors.runtime) exit(69);
+            } else if (file) {
+                run(file->span(), false, path);
+                report(file->span());
+                if (isolate.errors.compile) exit(42);
+                if (isolate.errors.runtime) exit(69);
+            }
         }
 
         void Driver::runPrompt()
         {
             rl_bind_key('\t', rl_complete);
+            // a line's error is printed and the session goes on, with whatever ran before it
+            isolate.errors.raise = true;
             while(true) {
                 char* input = readline("🦊 ＞ ");
                 if (input == nullptr) break;
                 add_history(input);
 
-                run(input, true);
-                
-                // reset
-                errorOccured = false;
+                // kept for the session, only this line is scanned, parsed and resolved
+                lines.emplace_back(input);
                 free(input);
+                try {
+                    run(lines.back(), true);
+                } catch (const rift::error::Error& err) {
+                    if (profiler) profiler->stop();
+                    isolate.output.flush();
+                    std::cout << (err.runtime ? "⛔️ Runtime Error: " : "🛑 ") << err.what() << std::endl;
+                }
+
+                // reset
+                isolate.errors.compile = false;
+                isolate.errors.runtime = false;
+            }
+            isolate.errors.raise = false;
+            report({});
+        }
+
+        void Driver::runPrelude(std::string path)
+        {
+            auto file = MappedFile::open(path);
+            if (!file) {
+                std::cout << "Could not open '" << path << "'" << std::endl;
+                return;
+            }
+            run(file->span(), true, path);
+            files.push_back(std::move(file));
+        }
+
+        void Driver::report(std::span<const char> source)
+        {
+            if (profiler) {
+                profiler->report(std::cerr, source);
+                if (!profile_path.empty()) {
+                    std::ofstream out(profile_path);
+                    if (out) profiler->collapsed(out);
+                    else std::cerr << "Could not write the profile to '" << profile_path << "'" << std::endl;
+                }
+            }
+
+            if (!stats) return;
+            stats->gc = isolate.heap.stats();
+            if (stats_path.empty()) {
+                stats->print(std::cerr);
+                return;
+            }
+
+            std::ofstream out(stats_path);
+            if (!out) {
+                std::cerr << "Could not write stats to '" << stats_path << "'" << std::endl;
+                return;
             }
+            stats->json(out);
         }
 
         void Driver::version()
@@ -98,10 +329,18 @@ namespace rift
             std::cout << "Rift Lang" << std::endl;
             std::cout << "Usage: rift [options] [file]" << std::endl;
             std::cout << "Options:" << std::endl;
-            std::cout << "  [file]            Run the compiler" << std::endl;
+            std::cout << "  [file]            Run the compiler (- reads stdin)" << std::endl;
             std::cout << "  -h, --help        Display this information" << std::endl;
             std::cout << "  -v, --version     Display the version of the program" << std::endl;
-            std::cout << "  -i, --interactive Run the interpreter" << std::endl;
+            std::cout << "  -i, --interactive Run the interpreter ([file] is loaded into it first)" << std::endl;
+            std::cout << "  --engine=<name>   Execution engine: tree (default), vm or tiered (tree + native hot functions)" << std::endl;
+            std::cout << "  --stats[=<file>]  Report phase times, counts and allocations (to <file> as JSON)" << std::endl;
+            std::cout << "  --profile[=<file>] Sample hot lines and functions (collapsed stacks to <file>)" << std::endl;
+            std::cout << "  --no-cache        Always recompile, with --engine=vm files are cached as .rfc otherwise" << std::endl;
+            std::cout << "  --dump-ir[=<file>] Print the optimized SSA IR of each program (appended to <file>)" << std::endl;
+            std::cout << "  --workers=<n>     Threads running parallel for and spawned tasks besides the main one" << std::endl;
+            std::cout << "  --emit=<obj|exe>  Compile [file] instead of running it, to an image riftlang runs (.rfo) or an executable" << std::endl;
+            std::cout << "  --output=<file>   Where --emit writes, foo.rf emits foo.rfo or foo otherwise" << std::endl;
             exit(1);
         }
 
@@ -109,10 +348,12 @@ namespace rift
 
         int Driver::parse(int argc, char **argv) 
         {
-            bool passed = false;
+            // an emitted executable only runs its program, whatever it is given
+            if (runEmbedded()) return 0;
+
+            bool interactive = false;
             int opt = 0, idx = 0;
             while ((opt = getopt_long(argc, argv, "", opts, &idx)) != -1) {
-                passed = true;
                 switch (opt) {
                     case 'h':
                         help();
@@ -120,7 +361,57 @@ namespace rift
                     case 'v':
                         version();
                     case 'i':
-                        runPrompt();
+                        interactive = true;
+                        break;
+                    case 'e':
+                        if (std::string(optarg) == "vm") engine = Engine::VM;
+                        else if (std::string(optarg) == "tree") engine = Engine::TREE;
+                        else if (std::string(optarg) == "tiered") engine = Engine::TIERED;
+                        else {
+                            std::cout << "Invalid engine '" << optarg << "'" << std::endl;
+                            exit(1);
+                        }
+                        break;
+                    case 's':
+                        stats = std::make_unique<Stats>();
+                        if (optarg) stats_path = optarg;
+                        break;
+                    case 'p':
+#ifdef RIFT_PROFILER
+                        profiler = std::make_unique<Profiler>();
+                        if (optarg) profile_path = optarg;
+#else
+                        std::cout << "Rift was built without RIFT_PROFILER, --profile is ignored" << std::endl;
+#endif
+                        break;
+                    case 'n':
+                        caching = false;
+                        break;
+                    case 'd':
+                        dumping = true;
+                        if (optarg) ir_path = optarg;
+                        break;
+                    case 'w': {
+                        char* end = nullptr;
+                        auto workers = std::strtoul(optarg, &end, 10);
+                        if (end == optarg || *end != '\0') {
+                            std::cout << "Invalid number of workers '" << optarg << "'" << std::endl;
+                            exit(1);
+                        }
+                        rift::Scheduler::configure(workers);
+                        break;
+                    }
+                    case 'x':
+                        if (std::string(optarg) == "obj") emit = Emit::OBJ;
+                        else if (std::string(optarg) == "exe") emit = Emit::EXE;
+                        else {
+                            std::cout << "Invalid output '" << optarg << "', expected obj or exe" << std::endl;
+                            exit(1);
+                        }
+                        break;
+                    case 'o':
+                        output = optarg;
+                        break;
                     default:
                         std::cout << "Invalid option" << std::endl;
                         break;
@@ -128,12 +419,13 @@ namespace rift
                 }
             }
 
-            if (!passed) {
-                if (optind < argc) {
-                    runFile(argv[optind]);
-                } else {
-                    help();
-                }
+            if (interactive) {
+                if (optind < argc) runPrelude(argv[optind]);
+                runPrompt();
+            } else if (optind < argc) {
+                runFile(argv[optind]);
+            } else {
+                help();
             }
 
             return 0;
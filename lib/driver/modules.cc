@@ -0,0 +1,197 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+
+#include <driver/modules.hh>
+#include <error/error.hh>
+#include <utils/mapped_file.hh>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/optimizer.hh>
+#include <algorithm>
+#include <set>
+
+namespace rift
+{
+    namespace driver
+    {
+        #pragma mark - Module
+
+        Module::Module(Modules& modules, std::filesystem::path path, std::filesystem::file_time_type mtime)
+            : path(std::move(path)), mtime(mtime), modules(modules) {}
+
+        Module::~Module() = default;
+
+        void Module::run()
+        {
+            // nothing here may touch what the calling thread is using: errors are raised, and
+            // literals go to the module's own heap, only the symbols are shared (and locked)
+            rift::error::Raise raise;
+            Isolate::Scope enter(modules.isolate);
+            Heap::Scope allocate(heap);
+
+            file = MappedFile::open(path.string());
+            if (!file) {
+                error = "can't be opened";
+                return;
+            }
+            try {
+                scanner::Scanner scanner(file->span(), modules.isolate);
+                scanner.scan_source();
+                tokens = scanner.tokens->size();
+
+                ast::Parser parser(scanner.tokens, modules.isolate);
+                // the file stays mapped as long as the module, so bodies can wait until called
+                parser.lazy = true;
+                if (modules.counting) parser.kinds = &kinds;
+                program = parser.parse();
+            } catch (const rift::error::Error& err) {
+                error = std::string("doesn't compile: ") + err.what();
+                return;
+            }
+            if (!program) {
+                error = "doesn't compile";
+                return;
+            }
+            modules.expand(*program, path.parent_path(), imports);
+        }
+
+        #pragma mark - Loading
+
+        Modules::~Modules() = default;
+
+        std::filesystem::path Modules::resolve(const std::filesystem::path& from, const std::string& name)
+        {
+            std::error_code ec;
+            auto path = std::filesystem::weakly_canonical(from / name, ec);
+            return ec ? (from / name).lexically_normal() : path;
+        }
+
+        Module* Modules::request(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            auto mtime = std::filesystem::last_write_time(path, ec);
+
+            std::unique_lock guard(lock);
+            auto& slot = cache[path];
+            if (slot && slot->seen == generation) return slot.get();
+            if (slot && !ec && slot->mtime == mtime && slot->error.empty()) {
+                // unchanged, but what it imports may not be
+                auto module = slot.get();
+                module->seen = generation;
+                guard.unlock();
+                expand(*module->program, path.parent_path(), module->imports);
+                return module;
+            }
+
+            if (slot) retired.push_back(std::move(slot));
+            slot = std::make_unique<Module>(*this, path, mtime);
+            auto module = slot.get();
+            module->seen = generation;
+            guard.unlock();
+            Scheduler::shared().spawn(*group, *module);
+            return module;
+        }
+
+        void Modules::expand(const ast::Program& program, const std::filesystem::path& from, std::vector<Module*>& into)
+        {
+            into.clear();
+            for (auto import : program.imports()) {
+                import->linked = true;
+                into.push_back(request(resolve(from, import->path.lexeme)));
+            }
+        }
+
+        std::vector<Module*> Modules::load(const ast::Program& program, const std::filesystem::path& from, const std::filesystem::path& self)
+        {
+            if (program.imports().empty()) return {};
+
+            std::vector<Module*> direct;
+            {
+                Symbols::Sharing sharing(isolate.symbols);
+                Scheduler::Group compiling;
+                group = &compiling;
+                generation++;
+                expand(program, from, direct);
+                Scheduler::shared().wait(compiling);
+                group = nullptr;
+            }
+
+            // everything is compiled, the tree is walked in the order it runs in
+            auto root = self.empty() ? self : resolve(std::filesystem::current_path(), self.string());
+            std::vector<Module*> order, open;
+            std::set<Module*> done;
+            auto visit = [&](auto& visit, const ast::Program& importer, const std::vector<Module*>& imports) -> void {
+                for (size_t i = 0; i < imports.size(); i++) {
+                    auto import = importer.imports()[i];
+                    auto module = imports[i];
+                    auto name = "'" + module->path.string() + "'";
+                    if (!module->error.empty())
+                        rift::error::report(import->line, "import", name + " " + module->error, import->path, std::exception());
+                    if (module->path == root || std::find(open.begin(), open.end(), module) != open.end())
+                        rift::error::report(import->line, "import", "Circular import of " + name, import->path, std::exception());
+                    if (done.contains(module)) continue;
+
+                    open.push_back(module);
+                    visit(visit, *module->program, module->imports);
+                    open.pop_back();
+                    done.insert(module);
+                    if (!module->ran) order.push_back(module);
+                }
+            };
+            visit(visit, program, direct);
+            for (auto module : order) module->ran = true;
+            return order;
+        }
+
+        #pragma mark - Optimizing
+
+        void Modules::optimize(const std::vector<Module*>& modules, const ast::Program& program)
+        {
+            if (modules.empty()) {
+                ast::Optimizer().optimize(program);
+                return;
+            }
+
+            struct Pass : public Scheduler::Task {
+                Isolate& isolate;
+                const ast::Program& program;
+                Heap& heap;
+
+                Pass(Isolate& isolate, const ast::Program& program, Heap& heap) : isolate(isolate), program(program), heap(heap) {}
+
+                void run() override
+                {
+                    Isolate::Scope enter(isolate);
+                    Heap::Scope allocate(heap);
+                    ast::Optimizer().optimize(program);
+                }
+            };
+
+            Symbols::Sharing sharing(isolate.symbols);
+            std::vector<std::unique_ptr<Pass>> passes;
+            passes.reserve(modules.size() + 1);
+            Scheduler::Group group;
+            auto& pool = Scheduler::shared();
+            for (auto module : modules) {
+                passes.push_back(std::make_unique<Pass>(isolate, *module->program, module->heap));
+                pool.spawn(group, *passes.back());
+            }
+            // only one pass allocates on the isolate's heap
+            passes.push_back(std::make_unique<Pass>(isolate, program, isolate.heap));
+            pool.spawn(group, *passes.back());
+            pool.wait(group);
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <driver/stats.hh>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <memory>
+
+namespace rift
+{
+    namespace driver
+    {
+        #pragma mark - Timer
+
+        Stats::Timer::Timer(Stats& stats, const std::string& name) : stats(stats), phase{name}, tracked(alloc::tracking())
+        {
+            alloc::track(true);
+            heap = alloc::counts();
+            start = std::chrono::steady_clock::now();
+        }
+
+        Stats::Timer::~Timer()
+        {
+            phase.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            phase.heap = alloc::counts() - heap;
+            alloc::track(tracked);
+            stats.phases.push_back(std::move(phase));
+        }
+
+        #pragma mark - Stats
+
+        size_t Stats::nodes() const
+        {
+            size_t total = 0;
+            for (const auto& [_, count] : kinds) total += count;
+            return total;
+        }
+
+        std::string Stats::kind(const std::type_index& type)
+        {
+            int status = 0;
+            std::unique_ptr<char, void(*)(void*)> name(abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), std::free);
+            std::string res = status == 0 ? name.get() : type.name();
+            // nested nodes keep their parent (StmtIf::Stmt)
+            return res.starts_with("rift::ast::") ? res.substr(11) : res;
+        }
+
+        /// @brief node counts ordered by name
+        static std::map<std::string, size_t> named(const std::map<std::type_index, size_t>& kinds)
+        {
+            std::map<std::string, size_t> res;
+            for (const auto& [type, count] : kinds) res[Stats::kind(type)] += count;
+            return res;
+        }
+
+        static std::string fixed(double value, const char* fmt)
+        {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), fmt, value);
+            return buf;
+        }
+
+        void Stats::print(std::ostream& out) const
+        {
+            out << "phase       time (ms)   allocs      bytes" << std::endl;
+            for (const auto& phase : phases) {
+                out << phase.name << std::string(phase.name.size() < 12 ? 12 - phase.name.size() : 1, ' ')
+                    << fixed(phase.seconds * 1e3, "%9.3f") << fixed(double(phase.heap.allocations), "%9.0f")
+                    << fixed(double(phase.heap.bytes), "%11.0f") << std::endl;
+            }
+            out << "tokens      " << tokens << std::endl;
+            out << "nodes       " << nodes() << std::endl;
+            for (const auto& [name, count] : named(kinds))
+                out << "  " << name << " " << count << std::endl;
+            out << "peak depth  " << depth << std::endl;
+            out << "gc          " << gc.collections << " collections, " << gc.freed << " freed, "
+                << gc.objects << " live (" << gc.bytes << " of " << gc.reserved << " bytes)" << std::endl;
+        }
+
+        void Stats::json(std::ostream& out) const
+        {
+            out << "{\n  \"phases\": [";
+            for (size_t i = 0; i < phases.size(); i++) {
+                const auto& phase = phases[i];
+                out << (i ? "," : "") << "\n    {\"name\": \"" << phase.name << "\", \"seconds\": " << fixed(phase.seconds, "%.9f")
+                    << ", \"allocations\": " << phase.heap.allocations << ", \"bytes\": " << phase.heap.bytes << "}";
+            }
+            out << "\n  ],\n  \"tokens\": " << tokens << ",\n  \"nodes\": {";
+            bool first = true;
+            for (const auto& [name, count] : named(kinds)) {
+                out << (first ? "" : ",") << "\n    \"" << name << "\": " << count;
+                first = false;
+            }
+            out << "\n  },\n  \"depth\": " << depth << ",\n  \"gc\": {\"collections\": " << gc.collections
+                << ", \"freed\": " << gc.freed << ", \"objects\": " << gc.objects << ", \"bytes\": " << gc.bytes
+                << ", \"reserved\": " << gc.reserved << ", \"classes\": [";
+            for (size_t i = 0; i < gc.classes.size(); i++) out << (i ? ", " : "") << gc.classes[i];
+            out << "]}\n}" << std::endl;
+        }
+    }
+}
\ No newline at end of file
@@ -14,18 +14,30 @@
 
 #include <iostream>
 #include <error/error.hh>
+#include <utils/isolate.hh>
 namespace rift
 {
     namespace error
     {
+        /// @brief set by a Raise on this thread
+        static thread_local bool raising = false;
+
+        Raise::Raise() : previous(raising) { raising = true; }
+        Raise::~Raise() { raising = previous; }
 
         void report(int line, std::string_view where, std::string msg, const rift::scanner::Token& token, std::exception e) {
+            if (raising) throw Error("[line " + std::to_string(line) + "] Error " + std::string(where) + ": " + msg, false);
+            Isolate::current().errors.compile = true;
+            if (Isolate::current().errors.raise)
+                throw Error("[line " + std::to_string(line) + "] Error " + std::string(where) + ": " + msg, false);
+
+            // what was printed before the error shows up before it
+            Isolate::current().output.flush();
             std::cout << "🛑 [line " << line << "] Error " << where << ": " << msg;
             if (token.type != rift::scanner::TokenType::EOFF) {
                 std::cout << " (token: " << token.to_string();
             }
             std::cout << ")" << std::endl;
-            errorOccured = true;
 
             if (e.what() != nullptr) {
                 exit(1);
@@ -34,8 +46,12 @@ namespace rift
 
         void runTimeError(std::string_view msg)
         {
+            if (raising) throw Error(std::string(msg), true);
+            Isolate::current().errors.runtime = true;
+            if (Isolate::current().errors.raise) throw Error(std::string(msg), true);
+
+            Isolate::current().output.flush();
             std::cout << "⛔️ Runtime Error: " << msg << std::endl;
-            runtimeErrorOccured = true;
             exit(1);
         }
     }
@@ -0,0 +1,496 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ir/builder.hh>
+#include <ast/env.hh>
+
+namespace rift
+{
+    namespace ir
+    {
+        #pragma mark - Builder
+
+        std::unique_ptr<Module> Builder::build(const Program& prgm)
+        {
+            auto ret = std::make_unique<Module>();
+            module = ret.get();
+            defs.clear();
+            incomplete.clear();
+            sealed.clear();
+            forwarded.clear();
+            prgm.accept(*this);
+            module = nullptr;
+            return ret;
+        }
+
+        Values Builder::visit_program(const Program& prgm) const
+        {
+            module->functions.push_back(std::make_unique<Function>("<main>", 0));
+            fn = module->functions.back().get();
+            current = fn->block();
+            seal(current);
+            for (const auto& decl : prgm.decls) decl->accept(*this);
+            if (!terminated()) emit(Op::RETURN, Type::NONE, {constant(Value::nil())});
+            fn->prune();
+            return {};
+        }
+
+        void Builder::function(const DeclFunc::Func& func) const
+        {
+            auto outer = std::make_tuple(fn, current, std::move(scopes), locals);
+            // the function's blocks are pruned, their addresses may come back as the outer function's
+            auto ssa = std::make_tuple(std::move(defs), std::move(incomplete), std::move(sealed), std::move(forwarded));
+            defs.clear();
+            incomplete.clear();
+            sealed.clear();
+            forwarded.clear();
+            module->functions.push_back(std::make_unique<Function>(func.name.lexeme, static_cast<uint32_t>(func.params.size())));
+            fn = module->functions.back().get();
+            current = fn->block();
+            seal(current);
+            scopes.clear();
+            locals = 0;
+
+            // parameters and the body's locals share one scope (see Resolver::visit_decl_func)
+            const ast::Block* body = func.body();
+            beginScope(body->slots);
+            for (uint32_t i = 0; i < func.params.size(); i++) {
+                auto param = emit(Op::PARAM, Type::ANY);
+                param->index = i;
+                param->label = func.params[i].lexeme;
+                write(i, current, param);
+            }
+            for (const auto& decl : body->decls) decl->accept(*this);
+            endScope();
+            if (!terminated()) emit(Op::RETURN, Type::NONE, {constant(Value::nil())});
+            fn->prune();
+
+            std::tie(fn, current, scopes, locals) = std::move(outer);
+            std::tie(defs, incomplete, sealed, forwarded) = std::move(ssa);
+        }
+
+        #pragma mark - SSA construction
+
+        void Builder::write(uint32_t var, ir::Block* block, Inst* val) const
+        {
+            defs[block][var] = val;
+        }
+
+        Inst* Builder::read(uint32_t var, ir::Block* block) const
+        {
+            auto& local = defs[block];
+            auto it = local.find(var);
+            if (it == local.end()) return readRecursive(var, block);
+            auto val = it->second;
+            while (forwarded.count(val)) val = forwarded[val];
+            return it->second = val;
+        }
+
+        Inst* Builder::readRecursive(uint32_t var, ir::Block* block) const
+        {
+            Inst* val;
+            if (!sealed.count(block)) {
+                // the rest of the predecessors fill it in once they are known
+                val = fn->phi(block);
+                incomplete[block].push_back({var, val});
+            } else if (block->preds.size() == 1) {
+                val = read(var, block->preds[0]);
+            } else if (block->preds.empty()) {
+                // read before any assignment, only in code that can't be reached
+                val = fn->append(block, Op::CONST, Type::ANY);
+            } else {
+                // written first, breaks the cycle through loops
+                val = fn->phi(block);
+                write(var, block, val);
+                val = addPhiOperands(var, val);
+            }
+            write(var, block, val);
+            return val;
+        }
+
+        Inst* Builder::addPhiOperands(uint32_t var, Inst* phi) const
+        {
+            for (auto pred : phi->block->preds) fn->addOperand(phi, read(var, pred));
+            return tryRemoveTrivialPhi(phi);
+        }
+
+        Inst* Builder::tryRemoveTrivialPhi(Inst* phi) const
+        {
+            // still waiting for its operands
+            if (!sealed.count(phi->block)) return phi;
+            Inst* same = nullptr;
+            for (auto op : phi->operands) {
+                if (op == same || op == phi) continue;
+                if (same != nullptr) return phi; // merges at least two values
+                same = op;
+            }
+            if (same == nullptr) same = fn->append(fn->blocks[0].get(), Op::CONST, Type::ANY);
+
+            std::vector<Inst*> users;
+            for (auto user : phi->users)
+                if (user != phi) users.push_back(user);
+            fn->replace(phi, same);
+            fn->remove(phi);
+            forwarded[phi] = same;
+
+            // removing this one may have made the phis using it trivial
+            for (auto user : users)
+                if (user->op == Op::PHI && user->block != nullptr) tryRemoveTrivialPhi(user);
+            return same;
+        }
+
+        void Builder::seal(ir::Block* block) const
+        {
+            auto pending = std::move(incomplete[block]);
+            incomplete.erase(block);
+            sealed.insert(block);
+            for (auto [var, phi] : pending) addPhiOperands(var, phi);
+        }
+
+        #pragma mark - Emitters
+
+        Inst* Builder::value(const Expr& expr) const
+        {
+            expr.accept(*this);
+            return result;
+        }
+
+        Inst* Builder::constant(Value val) const
+        {
+            Type type = val.isNumber() ? Type::NUMBER : val.isBool() ? Type::BOOL : val.isString() ? Type::STRING
+                      : val.isNil() ? Type::NIL : val.isUndefined() ? Type::ANY : Type::FUNCTION;
+            auto inst = emit(Op::CONST, type);
+            inst->constant = val;
+            return inst;
+        }
+
+        void Builder::unreachable() const
+        {
+            current = fn->block();
+            seal(current);
+        }
+
+        Inst* Builder::join(std::vector<Inst*> vals, Type type) const
+        {
+            auto phi = fn->phi(current);
+            phi->type = type;
+            for (auto val : vals) fn->addOperand(phi, val);
+            return phi;
+        }
+
+        void Builder::branch(const StmtIf::Stmt& branch) const
+        {
+            if (branch.blk != nullptr) branch.blk->accept(*this);
+            else if (branch.stmt != nullptr) branch.stmt->accept(*this);
+        }
+
+        void Builder::beginScope(uint32_t n) const
+        {
+            scopes.push_back(locals);
+            locals += n;
+        }
+
+        #pragma mark - Expr Visitors
+
+        Value Builder::visit_assign(const Assign& expr) const
+        {
+            auto val = value(*expr.value);
+            if (expr.addr.global()) {
+                auto store = emit(Op::STORE_GLOBAL, Type::NONE, {val});
+                store->index = expr.addr.slot;
+                store->label = expr.name.lexeme;
+            } else {
+                write(variable(expr.addr), current, val);
+            }
+            result = val;
+            return Value();
+        }
+
+        Value Builder::visit_binary(const Binary& expr) const
+        {
+            switch (expr.op.type) {
+                case TokenType::LOG_AND:
+                case TokenType::LOG_OR:
+                case TokenType::NULLISH_COAL: {
+                    // the right side runs in its own block, the result is a phi where both meet
+                    auto left = value(*expr.left);
+                    auto from = current;
+                    auto rhs = fn->block(), done = fn->block();
+                    if (expr.op.type == TokenType::LOG_AND) fn->branch(from, left, rhs, done);
+                    else if (expr.op.type == TokenType::LOG_OR) fn->branch(from, left, done, rhs);
+                    else fn->branch(from, emit(Op::EQ, Type::BOOL, {left, constant(Value::nil())}), rhs, done);
+                    seal(rhs);
+
+                    current = rhs;
+                    auto right = value(*expr.right);
+                    if (expr.op.type != TokenType::NULLISH_COAL) right = emit(Op::BOOL, Type::BOOL, {right});
+                    fn->jump(current, done);
+                    seal(done);
+
+                    current = done;
+                    Inst* first = expr.op.type == TokenType::NULLISH_COAL ? left : nullptr;
+                    if (first == nullptr) {
+                        // the constant has to be defined where the short circuit was taken
+                        auto rest = current;
+                        current = from;
+                        first = constant(Value::boolean(expr.op.type == TokenType::LOG_OR));
+                        current = rest;
+                    }
+                    result = join({first, right}, expr.op.type == TokenType::NULLISH_COAL ? Type::ANY : Type::BOOL);
+                    return Value();
+                }
+                default:
+                    break;
+            }
+
+            auto left = value(*expr.left);
+            auto right = value(*expr.right);
+            switch (expr.arith) {
+                case arith::Op::ADD: result = emit(Op::ADD, Type::ANY, {left, right}); break;
+                case arith::Op::SUB: result = emit(Op::SUB, Type::NUMBER, {left, right}); break;
+                case arith::Op::MUL: result = emit(Op::MUL, Type::NUMBER, {left, right}); break;
+                case arith::Op::DIV: result = emit(Op::DIV, Type::NUMBER, {left, right}); break;
+                case arith::Op::LESS: result = emit(Op::LT, Type::BOOL, {left, right}); break;
+                case arith::Op::LESS_EQUAL: result = emit(Op::LE, Type::BOOL, {left, right}); break;
+                case arith::Op::GREATER: result = emit(Op::GT, Type::BOOL, {left, right}); break;
+                case arith::Op::GREATER_EQUAL: result = emit(Op::GE, Type::BOOL, {left, right}); break;
+                case arith::Op::EQUAL: result = emit(Op::EQ, Type::BOOL, {left, right}); break;
+                case arith::Op::NOT_EQUAL: result = emit(Op::NE, Type::BOOL, {left, right}); break;
+                default: throw std::runtime_error("Unknown operator for a binary expression");
+            }
+            return Value();
+        }
+
+        Value Builder::visit_grouping(const Grouping& expr) const
+        {
+            result = value(*expr.expr);
+            return Value();
+        }
+
+        Value Builder::visit_literal(const Literal& expr) const
+        {
+            if (expr.value.type != TokenType::IDENTIFIER && expr.value.type != TokenType::C_IDENTIFIER) {
+                result = constant(expr.constant);
+            } else if (expr.addr.global()) {
+                result = emit(Op::LOAD_GLOBAL, Type::ANY);
+                result->index = expr.addr.slot;
+                result->label = expr.value.lexeme;
+            } else {
+                result = read(variable(expr.addr), current);
+            }
+            return Value();
+        }
+
+        Value Builder::visit_unary(const Unary& expr) const
+        {
+            auto val = value(*expr.expr);
+            if (expr.op.type == TokenType::MINUS) result = emit(Op::NEG, Type::NUMBER, {val});
+            else result = emit(Op::NOT, Type::BOOL, {val});
+            return Value();
+        }
+
+        Value Builder::visit_ternary(const Ternary& expr) const
+        {
+            auto cond = value(*expr.condition);
+            auto then = fn->block(), other = fn->block(), done = fn->block();
+            fn->branch(current, cond, then, other);
+            seal(then);
+            seal(other);
+
+            current = then;
+            auto left = value(*expr.left);
+            fn->jump(current, done);
+            current = other;
+            auto right = value(*expr.right);
+            fn->jump(current, done);
+            seal(done);
+
+            current = done;
+            result = join({left, right}, Type::ANY);
+            return Value();
+        }
+
+        Value Builder::visit_call(const Call& expr) const
+        {
+            std::vector<Inst*> operands = {value(*expr.name)};
+            for (const auto& arg : expr.args) operands.push_back(value(*arg));
+            result = emit(Op::CALL, Type::ANY, std::move(operands));
+            return Value();
+        }
+
+        Value Builder::visit_spawn(const Spawn& expr) const
+        {
+            std::vector<Inst*> operands = {value(*expr.call->name)};
+            for (const auto& arg : expr.call->args) operands.push_back(value(*arg));
+            result = emit(Op::SPAWN, Type::ANY, std::move(operands));
+            return Value();
+        }
+
+        Value Builder::visit_await(const Await& expr) const
+        {
+            result = emit(Op::AWAIT, Type::ANY, {value(*expr.task)});
+            return Value();
+        }
+
+        Value Builder::visit_array(const Array& expr) const
+        {
+            std::vector<Inst*> operands;
+            for (const auto& element : expr.elements) operands.push_back(value(*element));
+            result = emit(Op::ARRAY, Type::ANY, std::move(operands));
+            return Value();
+        }
+
+        Value Builder::visit_index(const Index& expr) const
+        {
+            auto target = value(*expr.target);
+            auto index = value(*expr.index);
+            result = emit(Op::INDEX, Type::NUMBER, {target, index});
+            return Value();
+        }
+
+        Value Builder::visit_set_index(const SetIndex& expr) const
+        {
+            auto target = value(*expr.target);
+            auto index = value(*expr.index);
+            auto val = value(*expr.value);
+            emit(Op::SET_INDEX, Type::NONE, {target, index, val});
+            result = val;
+            return Value();
+        }
+
+        #pragma mark - Stmt Visitors
+
+        Value Builder::visit_expr_stmt(const StmtExpr& stmt) const
+        {
+            value(*stmt.expr);
+            return Value();
+        }
+
+        Value Builder::visit_print_stmt(const StmtPrint& stmt) const
+        {
+            emit(Op::PRINT, Type::NONE, {value(*stmt.expr)});
+            return Value();
+        }
+
+        Value Builder::visit_if_stmt(const StmtIf& stmt) const
+        {
+            auto done = fn->block();
+            std::vector<const StmtIf::Stmt*> conds = {stmt.if_stmt};
+            conds.insert(conds.end(), stmt.elif_stmts.begin(), stmt.elif_stmts.end());
+            for (auto cond : conds) {
+                auto then = fn->block(), next = fn->block();
+                fn->branch(current, value(*cond->expr), then, next);
+                seal(then);
+                seal(next);
+                current = then;
+                branch(*cond);
+                if (!terminated()) fn->jump(current, done);
+                current = next;
+            }
+            if (stmt.else_stmt != nullptr) branch(*stmt.else_stmt);
+            if (!terminated()) fn->jump(current, done);
+            seal(done);
+            current = done;
+            return Value();
+        }
+
+        Value Builder::visit_return_stmt(const StmtReturn& stmt) const
+        {
+            emit(Op::RETURN, Type::NONE, {stmt.expr != nullptr ? value(*stmt.expr) : constant(Value::nil())});
+            unreachable();
+            return Value();
+        }
+
+        #pragma mark - Decl Visitors
+
+        Values Builder::visit_decl_stmt(const DeclStmt& decl) const
+        {
+            decl.stmt->accept(*this);
+            return {};
+        }
+
+        Values Builder::visit_decl_var(const DeclVar& decl) const
+        {
+            auto val = decl.expr != nullptr ? value(*decl.expr) : constant(Value::nil());
+            if (decl.addr.global()) {
+                auto store = emit(Op::STORE_GLOBAL, Type::NONE, {val});
+                store->index = decl.addr.slot;
+                store->label = decl.identifier.lexeme;
+                store->constant = Value::boolean(decl.identifier.type == TokenType::C_IDENTIFIER);
+            } else {
+                write(variable(decl.addr), current, val);
+            }
+            return {};
+        }
+
+        Values Builder::visit_decl_func(const DeclFunc& decl) const
+        {
+            Inst* val;
+            if (decl.func->body() != nullptr) {
+                val = emit(Op::FUNC, Type::FUNCTION);
+                val->func = decl.func;
+                val->label = decl.func->name.lexeme;
+                function(*decl.func);
+            } else {
+                val = constant(Value::nil());
+            }
+
+            if (decl.addr.global()) {
+                auto store = emit(Op::STORE_GLOBAL, Type::NONE, {val});
+                store->index = decl.addr.slot;
+                store->label = decl.func->name.lexeme;
+                store->constant = Value::boolean(false);
+            } else {
+                write(variable(decl.addr), current, val);
+            }
+            return {};
+        }
+
+        Values Builder::visit_for(const For& decl) const
+        {
+            beginScope(decl.slots);
+            if (decl.decl != nullptr) decl.decl->accept(*this);
+            else if (decl.stmt_l != nullptr) decl.stmt_l->accept(*this);
+
+            // the block the loop is entered from only jumps to the header, passes hoist into it
+            auto header = fn->block();
+            fn->jump(current, header);
+            current = header;
+
+            auto body = fn->block(), done = fn->block();
+            fn->branch(current, value(*decl.expr), body, done);
+            seal(body);
+            seal(done);
+
+            current = body;
+            if (decl.stmt_o != nullptr) decl.stmt_o->accept(*this);
+            else if (decl.blk != nullptr) decl.blk->accept(*this);
+            if (!terminated() && decl.stmt_r != nullptr) decl.stmt_r->accept(*this);
+            if (!terminated()) fn->jump(current, header);
+            seal(header);
+
+            current = done;
+            endScope();
+            return {};
+        }
+
+        Values Builder::visit_block_stmt(const ast::Block& block) const
+        {
+            beginScope(block.slots);
+            for (const auto& decl : block.decls) decl->accept(*this);
+            endScope();
+            return {};
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,315 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ir/ir.hh>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace rift
+{
+    namespace ir
+    {
+        #pragma mark - Names
+
+        const char* name(Op op)
+        {
+            static const auto names = [] {
+                std::vector<std::string> ret = {
+                    #define __RIFT_IR_NAME(name) #name,
+                    RIFT_IR_OPS(__RIFT_IR_NAME)
+                    #undef __RIFT_IR_NAME
+                };
+                for (auto& str : ret)
+                    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+                return ret;
+            }();
+            return names[static_cast<size_t>(op)].c_str();
+        }
+
+        const char* name(Type type)
+        {
+            switch (type) {
+                case Type::NONE: return "none";
+                case Type::NUMBER: return "number";
+                case Type::BOOL: return "bool";
+                case Type::STRING: return "string";
+                case Type::NIL: return "nil";
+                case Type::FUNCTION: return "function";
+                default: return "any";
+            }
+        }
+
+        #pragma mark - Function
+
+        Block* Function::block()
+        {
+            blocks.push_back(std::make_unique<Block>(next_block++));
+            return blocks.back().get();
+        }
+
+        Inst* Function::append(Block* block, Op op, Type type, std::vector<Inst*> operands)
+        {
+            auto inst = &insts.emplace_back(op, type, static_cast<uint32_t>(insts.size()));
+            inst->block = block;
+            for (auto operand : operands) addOperand(inst, operand);
+            if (!inst->terminator() && block->terminator() != nullptr)
+                block->insts.insert(block->insts.end() - 1, inst);
+            else
+                block->insts.push_back(inst);
+            return inst;
+        }
+
+        Inst* Function::phi(Block* block)
+        {
+            auto inst = &insts.emplace_back(Op::PHI, Type::ANY, static_cast<uint32_t>(insts.size()));
+            inst->block = block;
+            auto pos = std::find_if(block->insts.begin(), block->insts.end(), [](const Inst* i) { return i->op != Op::PHI; });
+            block->insts.insert(pos, inst);
+            return inst;
+        }
+
+        void Function::addOperand(Inst* inst, Inst* operand)
+        {
+            inst->operands.push_back(operand);
+            operand->users.push_back(inst);
+        }
+
+        Inst* Function::jump(Block* from, Block* to)
+        {
+            from->succs.push_back(to);
+            to->preds.push_back(from);
+            return append(from, Op::JUMP, Type::NONE);
+        }
+
+        Inst* Function::branch(Block* from, Inst* cond, Block* then, Block* other)
+        {
+            for (auto to : {then, other}) {
+                from->succs.push_back(to);
+                to->preds.push_back(from);
+            }
+            return append(from, Op::BRANCH, Type::NONE, {cond});
+        }
+
+        void Function::replace(Inst* from, Inst* to)
+        {
+            for (auto user : from->users) {
+                std::replace(user->operands.begin(), user->operands.end(), from, to);
+                to->users.push_back(user);
+            }
+            from->users.clear();
+        }
+
+        void Function::remove(Inst* inst)
+        {
+            auto& list = inst->block->insts;
+            list.erase(std::find(list.begin(), list.end(), inst));
+            for (auto operand : inst->operands) {
+                auto& users = operand->users;
+                users.erase(std::find(users.begin(), users.end(), inst));
+            }
+            inst->operands.clear();
+            inst->block = nullptr;
+        }
+
+        void Function::move(Inst* inst, Block* block)
+        {
+            auto& list = inst->block->insts;
+            list.erase(std::find(list.begin(), list.end(), inst));
+            inst->block = block;
+            block->insts.insert(block->terminator() != nullptr ? block->insts.end() - 1 : block->insts.end(), inst);
+        }
+
+        void Function::prune()
+        {
+            auto order = rpo();
+            std::unordered_set<const Block*> live(order.begin(), order.end());
+
+            // the edges from dead blocks go first, along with what flowed in through them
+            for (auto block : order) {
+                for (size_t i = block->preds.size(); i-- > 0;) {
+                    if (live.count(block->preds[i])) continue;
+                    block->preds.erase(block->preds.begin() + i);
+                    for (auto inst : block->insts) {
+                        if (inst->op != Op::PHI) break;
+                        auto& users = inst->operands[i]->users;
+                        users.erase(std::find(users.begin(), users.end(), inst));
+                        inst->operands.erase(inst->operands.begin() + i);
+                    }
+                }
+            }
+            for (const auto& block : blocks) {
+                if (live.count(block.get())) continue;
+                for (auto inst : block->insts) {
+                    for (auto operand : inst->operands) {
+                        auto& users = operand->users;
+                        users.erase(std::find(users.begin(), users.end(), inst));
+                    }
+                    inst->block = nullptr;
+                }
+            }
+            std::erase_if(blocks, [&](const std::unique_ptr<Block>& block) { return !live.count(block.get()); });
+        }
+
+        std::vector<Block*> Function::rpo() const
+        {
+            std::vector<Block*> order;
+            if (blocks.empty()) return order;
+
+            std::unordered_set<const Block*> seen = {blocks[0].get()};
+            // (block, next successor to visit)
+            std::vector<std::pair<Block*, size_t>> stack = {{blocks[0].get(), 0}};
+            while (!stack.empty()) {
+                auto& [block, next] = stack.back();
+                if (next < block->succs.size()) {
+                    auto succ = block->succs[next++];
+                    if (seen.insert(succ).second) stack.push_back({succ, 0});
+                    continue;
+                }
+                order.push_back(block);
+                stack.pop_back();
+            }
+            std::reverse(order.begin(), order.end());
+            return order;
+        }
+
+        void Function::dominators()
+        {
+            // Cooper, Harvey & Kennedy, "A Simple, Fast Dominance Algorithm"
+            auto order = rpo();
+            std::unordered_map<const Block*, size_t> index;
+            for (size_t i = 0; i < order.size(); i++) index[order[i]] = i;
+            for (auto block : order) block->idom = nullptr;
+            if (order.empty()) return;
+
+            auto entry = order[0];
+            entry->idom = entry;
+            auto intersect = [&](Block* a, Block* b) {
+                while (a != b) {
+                    while (index[a] > index[b]) a = a->idom;
+                    while (index[b] > index[a]) b = b->idom;
+                }
+                return a;
+            };
+
+            for (bool changed = true; changed;) {
+                changed = false;
+                for (size_t i = 1; i < order.size(); i++) {
+                    Block* idom = nullptr;
+                    for (auto pred : order[i]->preds) {
+                        if (pred->idom == nullptr) continue;
+                        idom = idom == nullptr ? pred : intersect(pred, idom);
+                    }
+                    if (order[i]->idom != idom) {
+                        order[i]->idom = idom;
+                        changed = true;
+                    }
+                }
+            }
+            entry->idom = nullptr;
+        }
+
+        bool Function::dominates(const Block* a, const Block* b) const
+        {
+            for (; b != nullptr; b = b->idom)
+                if (a == b) return true;
+            return false;
+        }
+
+        #pragma mark - Printing
+
+        /// @brief the operand form of a value
+        static std::string ref(const Inst* inst) { return "%" + std::to_string(inst->id); }
+
+        /// @brief false for instructions that only have effects
+        static bool defines(const Inst* inst)
+        {
+            return !inst->terminator() && inst->op != Op::STORE_GLOBAL && inst->op != Op::SET_INDEX && inst->op != Op::PRINT;
+        }
+
+        static std::string print(const Inst* inst)
+        {
+            std::ostringstream out;
+            if (defines(inst)) out << ref(inst) << " = ";
+            out << name(inst->op);
+
+            switch (inst->op) {
+                case Op::CONST:
+                    if (inst->constant.isString()) out << " \"" << printValue(inst->constant) << "\"";
+                    else if (inst->constant.isUndefined()) out << " undefined";
+                    else out << " " << printValue(inst->constant);
+                    break;
+                case Op::PARAM:
+                    out << " " << inst->index << " (" << inst->label << ")";
+                    break;
+                case Op::FUNC:
+                    out << " " << inst->label;
+                    break;
+                case Op::LOAD_GLOBAL:
+                    out << " @" << inst->label;
+                    break;
+                case Op::STORE_GLOBAL:
+                    out << " @" << inst->label << ", " << ref(inst->operands[0]) << (inst->constant.isBool() ? (inst->constant.as.boolean ? " const" : " decl") : "");
+                    break;
+                case Op::PHI:
+                    for (size_t i = 0; i < inst->operands.size(); i++)
+                        out << (i ? ", " : " ") << "[" << ref(inst->operands[i]) << ", b" << inst->block->preds[i]->id << "]";
+                    break;
+                case Op::CALL:
+                case Op::SPAWN:
+                    out << " " << ref(inst->operands[0]) << "(";
+                    for (size_t i = 1; i < inst->operands.size(); i++) out << (i > 1 ? ", " : "") << ref(inst->operands[i]);
+                    out << ")";
+                    break;
+                case Op::JUMP:
+                    out << " b" << inst->block->succs[0]->id;
+                    break;
+                case Op::BRANCH:
+                    out << " " << ref(inst->operands[0]) << ", b" << inst->block->succs[0]->id << ", b" << inst->block->succs[1]->id;
+                    break;
+                default:
+                    for (size_t i = 0; i < inst->operands.size(); i++) out << (i ? ", " : " ") << ref(inst->operands[i]);
+                    break;
+            }
+            if (defines(inst)) out << " : " << name(inst->type);
+            return out.str();
+        }
+
+        std::string Function::print() const
+        {
+            std::ostringstream out;
+            out << "fun " << name << "(" << arity << ") {\n";
+            for (auto block : rpo()) {
+                out << "  b" << block->id << ":";
+                if (!block->preds.empty()) {
+                    out << " ; preds";
+                    for (auto pred : block->preds) out << " b" << pred->id;
+                }
+                out << "\n";
+                for (auto inst : block->insts) out << "    " << ir::print(inst) << "\n";
+            }
+            out << "}\n";
+            return out.str();
+        }
+
+        std::string Module::print() const
+        {
+            std::string out;
+            for (const auto& fn : functions) out += (out.empty() ? "" : "\n") + fn->print();
+            return out;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,326 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <ir/passes.hh>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace rift
+{
+    namespace ir
+    {
+        #pragma mark - PassManager
+
+        PassManager PassManager::standard()
+        {
+            PassManager ret;
+            ret.add(std::make_unique<TypeSpecialization>())
+               .add(std::make_unique<GlobalValueNumbering>())
+               .add(std::make_unique<LoopInvariantCodeMotion>())
+               .add(std::make_unique<DeadStoreElimination>());
+            return ret;
+        }
+
+        void PassManager::run(Module& module)
+        {
+            changes.clear();
+            for (const auto& pass : passes) {
+                size_t n = 0;
+                for (const auto& fn : module.functions) n += pass->run(*fn);
+                changes.emplace_back(pass->name(), n);
+            }
+        }
+
+        bool safe(const Inst* inst)
+        {
+            switch (inst->op) {
+                case Op::CONST:
+                case Op::PARAM:
+                case Op::PHI:
+                case Op::FUNC:
+                case Op::EQ:
+                case Op::NE:
+                case Op::BOOL:
+                case Op::NADD:
+                case Op::NSUB:
+                case Op::NMUL:
+                case Op::NDIV:
+                case Op::NLT:
+                case Op::NLE:
+                case Op::NGT:
+                case Op::NGE:
+                case Op::NEQ:
+                case Op::NNE:
+                    return true;
+                case Op::NEG:
+                    return inst->operands[0]->type == Type::NUMBER;
+                case Op::NOT: {
+                    auto type = inst->operands[0]->type;
+                    return type == Type::BOOL || type == Type::NUMBER || type == Type::STRING;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        #pragma mark - TypeSpecialization
+
+        /// @brief the type of inst given the current types of its operands
+        static Type infer(const Inst* inst)
+        {
+            switch (inst->op) {
+                case Op::PHI: {
+                    Type ret = Type::NONE;
+                    for (auto operand : inst->operands) ret = join(ret, operand->type);
+                    return ret;
+                }
+                case Op::ADD: {
+                    auto left = inst->operands[0]->type, right = inst->operands[1]->type;
+                    if (left == Type::NONE || right == Type::NONE) return Type::NONE;
+                    if (left == Type::NUMBER && right == Type::NUMBER) return Type::NUMBER;
+                    // a string on either side concatenates, anything else but a number fails
+                    if ((left == Type::STRING || left == Type::NUMBER) && (right == Type::STRING || right == Type::NUMBER)) return Type::STRING;
+                    return Type::ANY;
+                }
+                default:
+                    return inst->type;
+            }
+        }
+
+        /// @brief the number only form of a generic op, or the op itself
+        static Op numeric(Op op)
+        {
+            switch (op) {
+                case Op::ADD: return Op::NADD;
+                case Op::SUB: return Op::NSUB;
+                case Op::MUL: return Op::NMUL;
+                case Op::DIV: return Op::NDIV;
+                case Op::LT: return Op::NLT;
+                case Op::LE: return Op::NLE;
+                case Op::GT: return Op::NGT;
+                case Op::GE: return Op::NGE;
+                case Op::EQ: return Op::NEQ;
+                case Op::NE: return Op::NNE;
+                default: return op;
+            }
+        }
+
+        size_t TypeSpecialization::run(Function& fn)
+        {
+            auto order = fn.rpo();
+            for (auto block : order)
+                for (auto inst : block->insts)
+                    if (inst->op == Op::PHI || inst->op == Op::ADD) inst->type = Type::NONE;
+
+            for (bool changed = true; changed;) {
+                changed = false;
+                for (auto block : order) {
+                    for (auto inst : block->insts) {
+                        auto type = infer(inst);
+                        if (type == inst->type) continue;
+                        inst->type = type;
+                        changed = true;
+                    }
+                }
+            }
+
+            size_t n = 0;
+            for (auto block : order) {
+                for (auto inst : block->insts) {
+                    // only reachable through a value that never gets defined
+                    if (inst->type == Type::NONE && (inst->op == Op::PHI || inst->op == Op::ADD)) inst->type = Type::ANY;
+                    auto op = numeric(inst->op);
+                    if (op == inst->op || inst->operands[0]->type != Type::NUMBER || inst->operands[1]->type != Type::NUMBER) continue;
+                    inst->op = op;
+                    n++;
+                }
+            }
+            return n;
+        }
+
+        #pragma mark - GlobalValueNumbering
+
+        /// @brief true when swapping the operands keeps the result
+        static bool commutative(Op op)
+        {
+            return op == Op::MUL || op == Op::NADD || op == Op::NMUL || op == Op::EQ || op == Op::NE || op == Op::NEQ || op == Op::NNE;
+        }
+
+        /// @brief equal for instructions that compute the same value
+        static std::string key(const Inst* inst)
+        {
+            std::string ret = name(inst->op);
+            std::vector<uint32_t> ids;
+            for (auto operand : inst->operands) ids.push_back(operand->id);
+            if (commutative(inst->op)) std::sort(ids.begin(), ids.end());
+            for (auto id : ids) ret += " " + std::to_string(id);
+
+            if (inst->op == Op::CONST) {
+                const auto& val = inst->constant;
+                ret += std::string(" ") + name(inst->type) + " ";
+                if (val.isNumber()) {
+                    // by bits, 0 and -0 are different constants
+                    uint64_t bits;
+                    std::memcpy(&bits, &val.as.number, sizeof(bits));
+                    ret += std::to_string(bits);
+                } else if (!val.isUndefined()) {
+                    ret += printValue(val);
+                }
+            }
+            return ret;
+        }
+
+        /// @brief the instructions that only depend on their operands
+        static bool pure(const Inst* inst)
+        {
+            switch (inst->op) {
+                case Op::PARAM:
+                case Op::PHI:
+                case Op::FUNC:
+                case Op::LOAD_GLOBAL:
+                case Op::STORE_GLOBAL:
+                case Op::CALL:
+                case Op::SPAWN:
+                case Op::AWAIT:
+                case Op::ARRAY:
+                case Op::INDEX:
+                case Op::SET_INDEX:
+                case Op::PRINT:
+                    return false;
+                default:
+                    // an undefined constant stands for a value that doesn't exist
+                    return !inst->terminator() && !(inst->op == Op::CONST && inst->constant.isUndefined());
+            }
+        }
+
+        size_t GlobalValueNumbering::run(Function& fn)
+        {
+            fn.dominators();
+            // the reverse post order visits a dominator before what it dominates
+            std::unordered_map<std::string, std::vector<Inst*>> values;
+            size_t n = 0;
+            for (auto block : fn.rpo()) {
+                for (auto inst : std::vector<Inst*>(block->insts)) {
+                    if (!pure(inst)) continue;
+                    auto& same = values[key(inst)];
+                    auto it = std::find_if(same.begin(), same.end(), [&](const Inst* other) { return fn.dominates(other->block, block); });
+                    if (it == same.end()) {
+                        same.push_back(inst);
+                        continue;
+                    }
+                    fn.replace(inst, *it);
+                    fn.remove(inst);
+                    n++;
+                }
+            }
+            return n;
+        }
+
+        #pragma mark - LoopInvariantCodeMotion
+
+        size_t LoopInvariantCodeMotion::run(Function& fn)
+        {
+            fn.dominators();
+            // the natural loop of every back edge, by header
+            std::unordered_map<Block*, std::unordered_set<const Block*>> loops;
+            for (auto block : fn.rpo()) {
+                for (auto header : block->succs) {
+                    if (!fn.dominates(header, block)) continue;
+                    auto& body = loops[header];
+                    body.insert(header);
+                    std::vector<Block*> work = {block};
+                    while (!work.empty()) {
+                        auto next = work.back();
+                        work.pop_back();
+                        if (!body.insert(next).second) continue;
+                        for (auto pred : next->preds) work.push_back(pred);
+                    }
+                }
+            }
+
+            // inner loops first, what they hoist may be invariant in the outer one too
+            std::vector<Block*> headers;
+            for (const auto& [header, body] : loops) headers.push_back(header);
+            std::sort(headers.begin(), headers.end(), [&](Block* a, Block* b) { return loops[a].size() < loops[b].size() || (loops[a].size() == loops[b].size() && a->id < b->id); });
+
+            size_t n = 0;
+            auto order = fn.rpo();
+            for (auto header : headers) {
+                const auto& body = loops[header];
+                Block* preheader = nullptr;
+                for (auto pred : header->preds) {
+                    if (body.count(pred)) continue;
+                    preheader = preheader == nullptr ? pred : nullptr;
+                    if (preheader == nullptr) break;
+                }
+                if (preheader == nullptr || preheader->succs.size() != 1) continue;
+
+                for (bool changed = true; changed;) {
+                    changed = false;
+                    for (auto block : order) {
+                        if (!body.count(block)) continue;
+                        for (auto inst : std::vector<Inst*>(block->insts)) {
+                            if (inst->op == Op::PHI || !safe(inst)) continue;
+                            if (std::any_of(inst->operands.begin(), inst->operands.end(), [&](const Inst* op) { return body.count(op->block); })) continue;
+                            fn.move(inst, preheader);
+                            changed = true;
+                            n++;
+                        }
+                    }
+                }
+            }
+            return n;
+        }
+
+        #pragma mark - DeadStoreElimination
+
+        size_t DeadStoreElimination::run(Function& fn)
+        {
+            size_t n = 0;
+            for (const auto& block : fn.blocks) {
+                for (size_t i = 0; i < block->insts.size(); i++) {
+                    auto store = block->insts[i];
+                    // declarations stay, they are what makes the global exist
+                    if (store->op != Op::STORE_GLOBAL || !store->constant.isUndefined()) continue;
+                    for (size_t j = i + 1; j < block->insts.size(); j++) {
+                        auto next = block->insts[j];
+                        // a call (or the tasks an await runs) may read any global
+                        if (next->op == Op::CALL || next->op == Op::AWAIT || (next->op == Op::LOAD_GLOBAL && next->index == store->index)) break;
+                        if (next->op != Op::STORE_GLOBAL || next->index != store->index) continue;
+                        fn.remove(store);
+                        i--;
+                        n++;
+                        break;
+                    }
+                }
+            }
+
+            // what's left of a local that is never read, and whatever only it used
+            for (bool changed = true; changed;) {
+                changed = false;
+                for (const auto& block : fn.blocks) {
+                    for (auto inst : std::vector<Inst*>(block->insts)) {
+                        if (!inst->users.empty() || inst->op == Op::PARAM || !safe(inst)) continue;
+                        fn.remove(inst);
+                        changed = true;
+                        n++;
+                    }
+                }
+            }
+            return n;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,620 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <jit/jit.hh>
+#include <ast/eval.hh>
+#include <algorithm>
+#include <cstring>
+
+#if defined(RIFT_JIT) && defined(ARCH_X64) && !defined(OS_WINDOWS)
+    #define RIFT_JIT_X64 1
+    #include <sys/mman.h>
+#else
+    #define RIFT_JIT_X64 0
+#endif
+
+namespace rift
+{
+    namespace jit
+    {
+        #pragma mark - Code
+
+        bool Code::supported() { return RIFT_JIT_X64; }
+
+        std::unique_ptr<Code> Code::compile(const ObjCallable& fn, uint32_t self)
+        {
+#if RIFT_JIT_X64
+            std::vector<uint8_t> bytes;
+            try {
+                bytes = Compiler(self).compile(fn);
+            } catch (const JitException&) {
+                return nullptr;
+            }
+
+            // written while writable, executable once it's never written again
+            void* mem = mmap(nullptr, bytes.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mem == MAP_FAILED) return nullptr;
+            std::memcpy(mem, bytes.data(), bytes.size());
+            if (mprotect(mem, bytes.size(), PROT_READ | PROT_EXEC) != 0) {
+                munmap(mem, bytes.size());
+                return nullptr;
+            }
+            return std::unique_ptr<Code>(new Code(mem, bytes.size()));
+#else
+            (void)fn;
+            (void)self;
+            return nullptr;
+#endif
+        }
+
+        Code::~Code()
+        {
+#if RIFT_JIT_X64
+            munmap(mem, len);
+#endif
+        }
+
+        #pragma mark - Compiler
+
+        static bool returns(const Stmt* stmt);
+
+        /// @brief true when the end of decl can't be reached, compiled code has to return a number
+        static bool returns(const Decl* decl)
+        {
+            if (auto blk = dynamic_cast<const Block*>(decl))
+                return std::any_of(blk->decls.begin(), blk->decls.end(), [](const Decl* d) { return returns(d); });
+            if (auto stmt = dynamic_cast<const DeclStmt*>(decl))
+                return returns(stmt->stmt);
+            return false;
+        }
+
+        static bool returns(const StmtIf::Stmt* branch)
+        {
+            return branch != nullptr && (branch->blk != nullptr ? returns(branch->blk) : returns(branch->stmt));
+        }
+
+        static bool returns(const Stmt* stmt)
+        {
+            if (dynamic_cast<const StmtReturn*>(stmt)) return true;
+            if (auto cond = dynamic_cast<const StmtIf*>(stmt)) {
+                return returns(cond->if_stmt) && returns(cond->else_stmt)
+                    && std::all_of(cond->elif_stmts.begin(), cond->elif_stmts.end(), [](const StmtIf::Stmt* s) { return returns(s); });
+            }
+            return false;
+        }
+
+        std::vector<uint8_t> Compiler::compile(const ObjCallable& fn)
+        {
+            if (fn.arity > MAX_ARGS) throw JitException("too many parameters");
+            const Block* body = fn.func->body();
+            if (body == nullptr || !returns(body)) throw JitException("the body may finish without returning");
+            arity = fn.arity;
+
+            // push rbp; mov rbp, rsp; push rbx; push r12; sub rsp, <frame>
+            emit({0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54, 0x48, 0x81, 0xEC});
+            size_t frame = code.size();
+            emit32(0);
+            // rbx holds the arguments, r12 the call budget
+            emit({0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4, 0x4D, 0x85, 0xE4});
+            Label overflow;
+            jump(overflow, 0x84);
+
+            // parameters and the body's locals share one scope (see Resolver::visit_decl_func)
+            beginScope(body->slots);
+            for (uint32_t i = 0; i < arity; i++) {
+                sse(0xF2, 0x10, 0, Mem{Mem::ARGS, static_cast<int32_t>(8 * i)});
+                sse(0xF2, 0x11, 0, local({0, i}));
+            }
+            for (const auto& decl : body->decls) decl->accept(*this);
+            endScope();
+            emit({0x0F, 0x0B}); // ud2, every path returned before
+
+            // xor eax, eax; mov rbx, [rbp - 8]; mov r12, [rbp - 16]; mov rsp, rbp; pop rbp; ret
+            bind(exit);
+            emit({0x31, 0xC0});
+            bind(unwind);
+            emit({0x48, 0x8B, 0x5D, 0xF8, 0x4C, 0x8B, 0x65, 0xF0, 0x48, 0x89, 0xEC, 0x5D, 0xC3});
+
+            // mov eax, 1; jmp unwind (the caller raises the error, see Result)
+            bind(overflow);
+            emit({0xB8, 0x01, 0x00, 0x00, 0x00});
+            jump(unwind);
+
+            // the frame keeps rsp 16 byte aligned, as do the spills
+            uint32_t size = (8 * reserved + 15) & ~15u;
+            std::memcpy(code.data() + frame, &size, sizeof(size));
+
+            while (code.size() % 8 != 0) code.push_back(0xCC);
+            size_t base = code.size();
+            for (double val : constants) {
+                uint8_t bytes[8];
+                std::memcpy(bytes, &val, sizeof(val));
+                code.insert(code.end(), bytes, bytes + 8);
+            }
+            for (auto [end, idx] : pool) {
+                int32_t disp = static_cast<int32_t>(base + 8 * idx - end);
+                std::memcpy(code.data() + end - 4, &disp, sizeof(disp));
+            }
+            return std::move(code);
+        }
+
+        #pragma mark - Emitters
+
+        void Compiler::emit32(uint32_t val) const
+        {
+            for (int i = 0; i < 4; i++) code.push_back(static_cast<uint8_t>(val >> (8 * i)));
+        }
+
+        void Compiler::sse(uint8_t prefix, uint8_t op, int reg, int rm) const
+        {
+            emit({prefix, 0x0F, op, static_cast<uint8_t>(0xC0 | reg << 3 | rm)});
+        }
+
+        void Compiler::sse(uint8_t prefix, uint8_t op, int reg, Mem mem) const
+        {
+            emit({prefix, 0x0F, op});
+            switch (mem.kind) {
+                case Mem::FRAME: emit({static_cast<uint8_t>(0x85 | reg << 3)}); break;                  // [rbp + disp32]
+                case Mem::ARGS: emit({static_cast<uint8_t>(0x83 | reg << 3)}); break;                   // [rbx + disp32]
+                case Mem::STACK: emit({static_cast<uint8_t>(0x84 | reg << 3), 0x24}); break;            // [rsp + disp32]
+                case Mem::CONST: emit({static_cast<uint8_t>(0x05 | reg << 3)}); break;                  // [rip + disp32]
+            }
+            emit32(static_cast<uint32_t>(mem.disp));
+            if (mem.kind == Mem::CONST) pool.push_back({code.size(), static_cast<size_t>(mem.disp)});
+        }
+
+        void Compiler::jump(Label& label, uint8_t cc) const
+        {
+            if (cc == 0) emit({0xE9});
+            else emit({0x0F, cc});
+            if (label.pos != SIZE_MAX) {
+                emit32(static_cast<uint32_t>(static_cast<int32_t>(label.pos - (code.size() + 4))));
+            } else {
+                label.fixups.push_back(code.size());
+                emit32(0);
+            }
+        }
+
+        void Compiler::bind(Label& label) const
+        {
+            label.pos = code.size();
+            for (auto fix : label.fixups) {
+                int32_t rel = static_cast<int32_t>(label.pos - (fix + 4));
+                std::memcpy(code.data() + fix, &rel, sizeof(rel));
+            }
+            label.fixups.clear();
+        }
+
+        Compiler::Mem Compiler::constant(double val) const
+        {
+            size_t idx = 0;
+            // bitwise, -0.0 and 0.0 are different constants
+            while (idx < constants.size() && std::memcmp(&constants[idx], &val, sizeof(val)) != 0) idx++;
+            if (idx == constants.size()) constants.push_back(val);
+            return {Mem::CONST, static_cast<int32_t>(idx)};
+        }
+
+        bool Compiler::operand(const Expr& expr, Mem& mem) const
+        {
+            if (auto group = dynamic_cast<const Grouping*>(&expr))
+                return operand(*group->expr, mem);
+            auto lit = dynamic_cast<const Literal*>(&expr);
+            if (lit == nullptr) return false;
+            if (lit->value.type == TokenType::IDENTIFIER || lit->value.type == TokenType::C_IDENTIFIER) {
+                if (lit->addr.global()) return false;
+                mem = local(lit->addr);
+                return true;
+            }
+            if (!lit->constant.isNumber()) return false;
+            mem = constant(lit->constant.as.number);
+            return true;
+        }
+
+        void Compiler::spill() const
+        {
+            emit({0x48, 0x83, 0xEC, 0x10}); // sub rsp, 16
+            sse(0xF2, 0x11, 0, Mem{Mem::STACK, 0});
+        }
+
+        void Compiler::unspill(int reg) const
+        {
+            sse(0xF2, 0x10, reg, Mem{Mem::STACK, 0});
+            emit({0x48, 0x83, 0xC4, 0x10}); // add rsp, 16
+        }
+
+        void Compiler::number(const Expr& expr) const
+        {
+            if (!expr.accept(*this).isNumber()) throw JitException("expected a number");
+        }
+
+        void Compiler::operands(const Binary& expr) const
+        {
+            number(*expr.left);
+            Mem mem;
+            if (operand(*expr.right, mem)) {
+                sse(0xF2, 0x10, 1, mem);
+                return;
+            }
+            spill();
+            number(*expr.right);
+            sse(0x66, 0x28, 1, 0); // movapd xmm1, xmm0
+            unspill(0);
+        }
+
+        bool Compiler::compare(const Binary& expr) const
+        {
+            switch (expr.arith) {
+                case arith::Op::LESS:
+                case arith::Op::LESS_EQUAL:
+                    // a < b is b > a, so unordered operands come out false like every other comparison
+                    operands(expr);
+                    sse(0x66, 0x2E, 1, 0);
+                    return true;
+                case arith::Op::GREATER:
+                case arith::Op::GREATER_EQUAL:
+                case arith::Op::EQUAL:
+                case arith::Op::NOT_EQUAL:
+                    operands(expr);
+                    sse(0x66, 0x2E, 0, 1);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        void Compiler::branch(const Expr& cond, Label& label) const
+        {
+            if (auto group = dynamic_cast<const Grouping*>(&cond))
+                return branch(*group->expr, label);
+
+            if (auto bin = dynamic_cast<const Binary*>(&cond)) {
+                if (bin->op.type == TokenType::LOG_AND) {
+                    branch(*bin->left, label);
+                    return branch(*bin->right, label);
+                }
+                // jumps on the negated condition, with unordered operands as false
+                if (compare(*bin)) {
+                    switch (bin->arith) {
+                        case arith::Op::LESS:
+                        case arith::Op::GREATER:
+                            return jump(label, 0x86); // jbe
+                        case arith::Op::LESS_EQUAL:
+                        case arith::Op::GREATER_EQUAL:
+                            return jump(label, 0x82); // jb
+                        case arith::Op::EQUAL:
+                            jump(label, 0x85); // jne
+                            return jump(label, 0x8A); // jp
+                        default: {
+                            Label taken;
+                            jump(taken, 0x8A); // jp
+                            jump(label, 0x84); // je
+                            return bind(taken);
+                        }
+                    }
+                }
+            }
+
+            // numbers are always truthy
+            if (cond.accept(*this).isBool()) {
+                emit({0x85, 0xC0}); // test eax, eax
+                jump(label, 0x84);
+            }
+        }
+
+        void Compiler::branch(const StmtIf::Stmt& branch) const
+        {
+            if (branch.blk != nullptr) branch.blk->accept(*this);
+            else if (branch.stmt != nullptr) branch.stmt->accept(*this);
+            else throw JitException("If statement should have a statement or block");
+        }
+
+        void Compiler::beginScope(uint32_t n) const
+        {
+            scopes.push_back(locals);
+            locals += n;
+            reserved = std::max(reserved, locals);
+        }
+
+        #pragma mark - Expr Visitors
+
+        Value Compiler::visit_assign(const Assign& expr) const
+        {
+            if (expr.addr.global()) throw JitException("assigns a global");
+            number(*expr.value);
+            sse(0xF2, 0x11, 0, local(expr.addr));
+            return Value::number(0);
+        }
+
+        Value Compiler::visit_binary(const Binary& expr) const
+        {
+            switch (expr.op.type) {
+                case TokenType::NULLISH_COAL:
+                    // a number is never nil
+                    return expr.left->accept(*this);
+                case TokenType::LOG_AND:
+                case TokenType::LOG_OR: {
+                    Label done;
+                    for (auto side : {expr.left, expr.right}) {
+                        if (!side->accept(*this).isBool()) emit({0xB8, 0x01, 0x00, 0x00, 0x00}); // mov eax, 1
+                        if (side == expr.right) break;
+                        emit({0x85, 0xC0});
+                        jump(done, expr.op.type == TokenType::LOG_AND ? 0x84 : 0x85);
+                    }
+                    bind(done);
+                    return Value::boolean(false);
+                }
+                default:
+                    break;
+            }
+
+            uint8_t op = 0;
+            switch (expr.arith) {
+                case arith::Op::ADD: op = 0x58; break;
+                case arith::Op::MUL: op = 0x59; break;
+                case arith::Op::SUB: op = 0x5C; break;
+                case arith::Op::DIV: op = 0x5E; break;
+                default: break;
+            }
+            if (op != 0) {
+                number(*expr.left);
+                Mem mem;
+                if (operand(*expr.right, mem)) {
+                    sse(0xF2, op, 0, mem);
+                } else {
+                    spill();
+                    number(*expr.right);
+                    sse(0x66, 0x28, 1, 0);
+                    unspill(0);
+                    sse(0xF2, op, 0, 1);
+                }
+                return Value::number(0);
+            }
+
+            if (!compare(expr)) throw JitException("unsupported operator");
+            switch (expr.arith) {
+                case arith::Op::LESS:
+                case arith::Op::GREATER:
+                    emit({0x0F, 0x97, 0xC0}); // seta al
+                    break;
+                case arith::Op::LESS_EQUAL:
+                case arith::Op::GREATER_EQUAL:
+                    emit({0x0F, 0x93, 0xC0}); // setae al
+                    break;
+                case arith::Op::EQUAL:
+                    emit({0x0F, 0x94, 0xC0, 0x0F, 0x9B, 0xC1, 0x20, 0xC8}); // sete al; setnp cl; and al, cl
+                    break;
+                default:
+                    emit({0x0F, 0x95, 0xC0, 0x0F, 0x9A, 0xC1, 0x08, 0xC8}); // setne al; setp cl; or al, cl
+                    break;
+            }
+            emit({0x0F, 0xB6, 0xC0}); // movzx eax, al
+            return Value::boolean(false);
+        }
+
+        Value Compiler::visit_grouping(const Grouping& expr) const
+        {
+            return expr.expr->accept(*this);
+        }
+
+        Value Compiler::visit_literal(const Literal& expr) const
+        {
+            if (expr.value.type == TokenType::IDENTIFIER || expr.value.type == TokenType::C_IDENTIFIER) {
+                if (expr.addr.global()) throw JitException("reads a global");
+                sse(0xF2, 0x10, 0, local(expr.addr));
+                return Value::number(0);
+            }
+            if (expr.constant.isNumber()) {
+                sse(0xF2, 0x10, 0, constant(expr.constant.as.number));
+                return Value::number(0);
+            }
+            if (expr.constant.isBool()) {
+                emit({0xB8, static_cast<uint8_t>(expr.constant.as.boolean), 0x00, 0x00, 0x00}); // mov eax, imm32
+                return Value::boolean(false);
+            }
+            throw JitException("unsupported literal");
+        }
+
+        Value Compiler::visit_unary(const Unary& expr) const
+        {
+            switch (expr.op.type) {
+                case TokenType::MINUS:
+                    number(*expr.expr);
+                    // movq rax, xmm0; btc rax, 63; movq xmm0, rax
+                    emit({0x66, 0x48, 0x0F, 0x7E, 0xC0, 0x48, 0x0F, 0xBA, 0xF8, 0x3F, 0x66, 0x48, 0x0F, 0x6E, 0xC0});
+                    return Value::number(0);
+                case TokenType::BANG:
+                    if (expr.expr->accept(*this).isBool()) {
+                        emit({0x83, 0xF0, 0x01}); // xor eax, 1
+                    } else {
+                        // !n is n == 0
+                        sse(0x66, 0x57, 1, 1);
+                        sse(0x66, 0x2E, 0, 1);
+                        emit({0x0F, 0x94, 0xC0, 0x0F, 0x9B, 0xC1, 0x20, 0xC8, 0x0F, 0xB6, 0xC0});
+                    }
+                    return Value::boolean(false);
+                default:
+                    throw JitException("unsupported operator");
+            }
+        }
+
+        Value Compiler::visit_ternary(const Ternary& expr) const
+        {
+            Label other, done;
+            branch(*expr.condition, other);
+            auto left = expr.left->accept(*this);
+            jump(done);
+            bind(other);
+            auto right = expr.right->accept(*this);
+            bind(done);
+            if (left.type != right.type) throw JitException("branches of different types");
+            return left;
+        }
+
+        Value Compiler::visit_spawn(const Spawn& expr) const
+        {
+            (void)expr;
+            throw JitException("spawns a task");
+        }
+
+        Value Compiler::visit_await(const Await& expr) const
+        {
+            (void)expr;
+            throw JitException("awaits a task");
+        }
+
+        Value Compiler::visit_array(const Array& expr) const
+        {
+            (void)expr;
+            throw JitException("makes an array");
+        }
+
+        Value Compiler::visit_index(const Index& expr) const
+        {
+            (void)expr;
+            throw JitException("indexes an array");
+        }
+
+        Value Compiler::visit_set_index(const SetIndex& expr) const
+        {
+            (void)expr;
+            throw JitException("assigns an array element");
+        }
+
+        Value Compiler::visit_call(const Call& expr) const
+        {
+            auto name = dynamic_cast<const Literal*>(expr.name);
+            if (self == Address::GLOBAL || name == nullptr || !name->addr.global() || name->addr.slot != self)
+                throw JitException("calls another function");
+            if (expr.args.size() != arity) throw JitException("wrong number of arguments");
+
+            // the arguments are evaluated straight into the callee's args, spills go below them
+            uint32_t area = (8 * arity + 15) & ~15u;
+            if (area != 0) {
+                emit({0x48, 0x81, 0xEC});
+                emit32(area);
+            }
+            for (uint32_t i = 0; i < arity; i++) {
+                number(*expr.args[i]);
+                sse(0xF2, 0x11, 0, Mem{Mem::STACK, static_cast<int32_t>(8 * i)});
+            }
+            // mov rdi, rsp; lea rsi, [r12 - 1]; call <entry>
+            emit({0x48, 0x89, 0xE7, 0x49, 0x8D, 0x74, 0x24, 0xFF, 0xE8});
+            emit32(static_cast<uint32_t>(-static_cast<int32_t>(code.size() + 4)));
+            // test eax, eax; jnz unwind, an overflow below returns all the way out
+            emit({0x85, 0xC0});
+            jump(unwind, 0x85);
+            if (area != 0) {
+                emit({0x48, 0x81, 0xC4});
+                emit32(area);
+            }
+            return Value::number(0);
+        }
+
+        #pragma mark - Stmt Visitors
+
+        Value Compiler::visit_expr_stmt(const StmtExpr& stmt) const
+        {
+            stmt.expr->accept(*this);
+            return Value();
+        }
+
+        Value Compiler::visit_print_stmt(const StmtPrint&) const
+        {
+            throw JitException("prints");
+        }
+
+        Value Compiler::visit_if_stmt(const StmtIf& stmt) const
+        {
+            if (stmt.if_stmt == nullptr || stmt.if_stmt->expr == nullptr)
+                throw JitException("If statement expression should not be null");
+
+            Label done;
+            std::vector<const StmtIf::Stmt*> conds = {stmt.if_stmt};
+            conds.insert(conds.end(), stmt.elif_stmts.begin(), stmt.elif_stmts.end());
+            for (auto cond : conds) {
+                if (cond->expr == nullptr) throw JitException("Elif statement expression should not be null");
+                Label next;
+                branch(*cond->expr, next);
+                branch(*cond);
+                jump(done);
+                bind(next);
+            }
+            if (stmt.else_stmt != nullptr) branch(*stmt.else_stmt);
+            bind(done);
+            return Value();
+        }
+
+        Value Compiler::visit_return_stmt(const StmtReturn& stmt) const
+        {
+            if (stmt.expr == nullptr) throw JitException("returns nil");
+            number(*stmt.expr);
+            jump(exit);
+            return Value();
+        }
+
+        #pragma mark - Decl Visitors
+
+        Values Compiler::visit_decl_stmt(const DeclStmt& decl) const
+        {
+            decl.stmt->accept(*this);
+            return {};
+        }
+
+        Values Compiler::visit_decl_var(const DeclVar& decl) const
+        {
+            if (decl.addr.global()) throw JitException("declares a global");
+            if (decl.expr == nullptr) throw JitException("declares a nil local");
+            number(*decl.expr);
+            sse(0xF2, 0x11, 0, local(decl.addr));
+            return {};
+        }
+
+        Values Compiler::visit_decl_func(const DeclFunc&) const
+        {
+            throw JitException("declares a function");
+        }
+
+        Values Compiler::visit_for(const For& decl) const
+        {
+            beginScope(decl.slots);
+            if (decl.decl != nullptr) decl.decl->accept(*this);
+            else if (decl.stmt_l != nullptr) decl.stmt_l->accept(*this);
+
+            Label top, done;
+            bind(top);
+            branch(*decl.expr, done);
+            if (decl.stmt_o != nullptr) decl.stmt_o->accept(*this);
+            else if (decl.blk != nullptr) decl.blk->accept(*this);
+            else throw JitException("For statement should have a statement or block");
+            if (decl.stmt_r != nullptr) decl.stmt_r->accept(*this);
+            jump(top);
+            bind(done);
+            endScope();
+            return {};
+        }
+
+        Values Compiler::visit_block_stmt(const Block& block) const
+        {
+            beginScope(block.slots);
+            for (const auto& decl : block.decls) decl->accept(*this);
+            endScope();
+            return {};
+        }
+
+        Values Compiler::visit_program(const Program&) const
+        {
+            throw JitException("only function bodies are compiled");
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <rift/rift.h>
+#include <rift/rift.hh>
+#include <string>
+#include <vector>
+
+namespace embed = rift::embed;
+
+struct rift_runtime
+{
+    explicit rift_runtime(bool tiered) : runtime(tiered) {}
+    embed::Runtime runtime;
+    std::string error;
+    /// @brief what the last call returned, its string is what the caller was handed
+    embed::Value last;
+};
+
+struct rift_script
+{
+    embed::Script script;
+};
+
+#pragma mark - Values
+
+static embed::Value fromC(const rift_value& val)
+{
+    switch (val.type) {
+        case RIFT_BOOL: return embed::Value(val.as.boolean != 0);
+        case RIFT_NUMBER: return embed::Value(val.as.number);
+        case RIFT_STRING: return embed::Value(std::string_view(val.as.string.data, val.as.string.size));
+        case RIFT_FUNCTION: return embed::Value::function(std::string(val.as.string.data, val.as.string.size));
+        default: return embed::Value();
+    }
+}
+
+/// @note a string points into val, which must outlive the result
+static rift_value toC(const embed::Value& val)
+{
+    switch (val.type()) {
+        case embed::Value::Type::BOOL: return rift_bool(val.asBool());
+        case embed::Value::Type::NUMBER: return rift_number(val.asNumber());
+        case embed::Value::Type::STRING:
+        case embed::Value::Type::FUNCTION: {
+            auto view = val.asString().view();
+            auto ret = rift_string(view.data(), view.size());
+            ret.type = val.isString() ? RIFT_STRING : RIFT_FUNCTION;
+            return ret;
+        }
+        default: return rift_nil();
+    }
+}
+
+#pragma mark - Runtime
+
+rift_runtime* rift_runtime_new(int tiered)
+{
+    return new rift_runtime(tiered != 0);
+}
+
+void rift_runtime_free(rift_runtime* runtime)
+{
+    delete runtime;
+}
+
+rift_script* rift_compile(rift_runtime* runtime, const char* source, size_t size)
+{
+    runtime->error.clear();
+    try {
+        return new rift_script{runtime->runtime.compile(std::string(source, size))};
+    } catch (const std::exception& e) {
+        runtime->error = e.what();
+        return nullptr;
+    }
+}
+
+void rift_script_free(rift_script* script)
+{
+    delete script;
+}
+
+int rift_call(rift_runtime* runtime, rift_script* script, const char* name, const rift_value* args, size_t argc, rift_value* result)
+{
+    runtime->error.clear();
+    try {
+        embed::Value inlined[embed::Runtime::INLINE_ARGS];
+        std::vector<embed::Value> spilled;
+        embed::Value* argv = inlined;
+        if (argc > embed::Runtime::INLINE_ARGS) {
+            spilled.resize(argc);
+            argv = spilled.data();
+        }
+        for (size_t i = 0; i < argc; i++) argv[i] = fromC(args[i]);
+
+        runtime->last = runtime->runtime.call(script->script, name, std::span<const embed::Value>(argv, argc));
+        if (result != nullptr) *result = toC(runtime->last);
+        return 0;
+    } catch (const std::exception& e) {
+        runtime->error = e.what();
+        return -1;
+    }
+}
+
+void rift_define(rift_runtime* runtime, const char* name, uint32_t arity, rift_host_fn fn, void* data)
+{
+    std::string label(name);
+    runtime->runtime.define(label, arity, [fn, data, label](std::span<const embed::Value> args) {
+        rift_value inlined[embed::Runtime::INLINE_ARGS];
+        std::vector<rift_value> spilled;
+        rift_value* argv = inlined;
+        if (args.size() > embed::Runtime::INLINE_ARGS) {
+            spilled.resize(args.size());
+            argv = spilled.data();
+        }
+        for (size_t i = 0; i < args.size(); i++) argv[i] = toC(args[i]);
+        rift_value ret = rift_nil();
+        if (fn(data, argv, args.size(), &ret) != 0)
+            throw embed::Error("Host function '" + label + "' failed", true);
+        return fromC(ret);
+    });
+}
+
+const char* rift_error(const rift_runtime* runtime)
+{
+    return runtime->error.c_str();
+}
\ No newline at end of file
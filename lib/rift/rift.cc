@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <rift/rift.hh>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/resolver.hh>
+#include <ast/optimizer.hh>
+#include <array>
+#include <vector>
+
+namespace rift
+{
+    namespace embed
+    {
+        #pragma mark - Value
+
+        bool Value::operator==(const Value& other) const
+        {
+            if (kind != other.kind) return false;
+            switch (kind) {
+                case Type::NIL: return true;
+                case Type::BOOL: return as.boolean == other.as.boolean;
+                case Type::NUMBER: return as.number == other.as.number;
+                default: return str == other.str;
+            }
+        }
+
+        #pragma mark - Script
+
+        struct Script::State
+        {
+            /// @brief tokens point into it, and deferred bodies are parsed from them
+            std::string source;
+            std::unique_ptr<ast::Program> program;
+        };
+
+        Function Script::function(std::string_view name) const
+        {
+            return Function(runtime, runtime->context.globals.slot(std::string(name)), std::string(name));
+        }
+
+        #pragma mark - Runtime
+
+        Runtime::Runtime(bool tiered) : eval(context)
+        {
+            context.errors.raise = true;
+            eval.tiered(tiered);
+        }
+
+        Runtime::~Runtime() = default;
+
+        Script Runtime::compile(std::string source)
+        {
+            Isolate::Scope enter(context);
+            auto state = std::make_shared<Script::State>();
+            state->source = std::move(source);
+
+            scanner::Scanner scanner(state->source, context);
+            scanner.scan_source();
+            ast::Parser parser(scanner.tokens, context);
+            parser.lazy = true;
+            state->program = parser.parse();
+            if (state->program == nullptr) throw Error("Could not parse the script", false);
+            ast::Resolver(context).resolve(*state->program);
+            ast::Optimizer().optimize(*state->program);
+
+            DiscardResults results;
+            eval.evaluate(*state->program, results);
+            return Script(this, std::move(state));
+        }
+
+        Value Runtime::call(const Function& fn, std::span<const Value> args)
+        {
+            if (fn.runtime != this) throw Error("'" + fn.name() + "' was looked up in another runtime", true);
+            Isolate::Scope enter(context);
+            const auto& callee = context.globals.get(fn.slot);
+            if (!callee.isCallable() && !callee.isNative())
+                throw Error("Undefined function '" + fn.name() + "'", true);
+
+            // nothing collects before the arguments are in the callee's frame
+            std::array<rift::Value, INLINE_ARGS> inlined;
+            std::vector<rift::Value> spilled;
+            std::span<rift::Value> argv(inlined.data(), args.size());
+            if (args.size() > INLINE_ARGS) {
+                spilled.resize(args.size());
+                argv = spilled;
+            }
+            for (size_t i = 0; i < args.size(); i++) argv[i] = fromHost(args[i]);
+
+            auto res = toHost(eval.call(callee, argv));
+            // the result is the host's now, whatever the call left behind can go
+            context.heap.safepoint();
+            return res;
+        }
+
+        void Runtime::define(std::string_view name, uint32_t arity, Host fn)
+        {
+            Isolate::Scope enter(context);
+            std::string label(name);
+            auto native = context.heap.allocate<ObjNative>(label, arity, [this, fn = std::move(fn)](std::span<const rift::Value> args) {
+                std::array<Value, INLINE_ARGS> inlined;
+                std::vector<Value> spilled;
+                std::span<Value> argv(inlined.data(), args.size());
+                if (args.size() > INLINE_ARGS) {
+                    spilled.resize(args.size());
+                    argv = spilled;
+                }
+                for (size_t i = 0; i < args.size(); i++) argv[i] = toHost(args[i]);
+                return fromHost(fn(argv));
+            });
+            context.globals.set(context.globals.slot(label), rift::Value::object(native), false);
+        }
+
+        Value Runtime::get(std::string_view name)
+        {
+            const auto& val = context.globals.get(context.globals.slot(std::string(name)));
+            return val.isUndefined() ? Value() : toHost(val);
+        }
+
+        rift::Value Runtime::fromHost(const Value& val)
+        {
+            switch (val.type()) {
+                case Value::Type::NIL: return rift::Value::nil();
+                case Value::Type::BOOL: return rift::Value::boolean(val.asBool());
+                case Value::Type::NUMBER: return rift::Value::number(val.asNumber());
+                case Value::Type::STRING: return context.heap.string(val.asString());
+                default: {
+                    // by name, a function only exists inside the runtime
+                    const auto& fn = context.globals.get(context.globals.slot(val.asString().str()));
+                    if (!fn.isCallable() && !fn.isNative()) throw Error("Undefined function '" + val.asString().str() + "'", true);
+                    return fn;
+                }
+            }
+        }
+
+        Value Runtime::toHost(const rift::Value& val)
+        {
+            switch (val.type) {
+                case ValueType::BOOL: return Value(val.as.boolean);
+                case ValueType::NUMBER: return Value(val.as.number);
+                case ValueType::OBJ:
+                    if (val.isString()) return Value(val.asString());
+                    if (val.isCallable()) return Value::function(val.asCallable()->name);
+                    if (val.isNative()) return Value::function(val.asNative()->name);
+                    [[fallthrough]];
+                default: return Value();
+            }
+        }
+    }
+}
\ No newline at end of file
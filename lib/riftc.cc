@@ -0,0 +1,23 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <driver/driver.hh>
+
+/// @brief The entry of riftc, the driver compiling files to executables (--emit=exe) by default
+/// @return 0 if the program exits successfully
+int main(int argc, char **argv)
+{
+    rift::driver::Driver driver(rift::driver::Emit::EXE);
+    return driver.parse(argc, argv);
+}
@@ -14,8 +14,12 @@
 
 
 #include <scanner/scanner.hh>
+#include <utils/scheduler.hh>
+#include <cstring>
 #include <iostream>
 #include <format>
+#include <algorithm>
+#include <cstdint>
 
 typedef rift::scanner::Token Token;
 typedef rift::scanner::TokenType Type;
@@ -28,29 +32,8 @@ namespace rift
         
         #pragma mark - Initializers
         
-        Scanner::Scanner(std::shared_ptr<std::vector<char>> source) : Reader<char>(source) {
-            this->source = source;
-            this->tokens = std::vector<Token>();
-
-            keywords = {};
-            keywords["and"] = Type::LOG_AND;
-            keywords["class"] = Type::CLASS;
-            keywords["false"] = Type::FALSE;
-            keywords["for"] = Type::FOR;
-            keywords["fun"] = Type::FUN;
-            keywords["if"] = Type::IF;
-            keywords["else"] = Type::ELSE;
-            keywords["elif"] = Type::ELIF;
-            keywords["nil"] = Type::NIL;
-            keywords["or"] = Type::LOG_OR;
-            keywords["print"] = Type::PRINT;
-            keywords["return"] = Type::RETURN;
-            keywords["super"] = Type::SUPER;
-            keywords["this"] = Type::THIS;
-            keywords["true"] = Type::TRUE;
-            keywords["mut!"] = Type::CONST;
-            keywords["mut"] = Type::VAR;
-            keywords["while"] = Type::WHILE;
+        Scanner::Scanner(std::span<const char> source, Isolate& isolate) : Reader<char>(source), isolate(isolate), symbols(isolate.symbols) {
+            this->tokens = std::make_shared<TokenBuffer>(strv_t(source.data(), source.size()), symbols);
         }
 
         #pragma mark - Token Scanners
@@ -58,70 +41,63 @@ namespace rift
         /// if three quotes then its a multiline string
         void Scanner::string() {
             prevance();
-            if (peek3('"')) {
-                advance();
-                while (!peek3('"') && !atEnd()) {
-                    line++; advance();
-                }
-            } else if (peek('"')) {
-                advance();
-                while (!peek('"') && !atEnd()) {
-                    if (peek('\n')) line++;
-                    advance();
-                }
+            bool multiline = peek3('"');
+            curr += multiline ? 3 : 1;
+
+            size_t lines = 0;
+            while (true) {
+                curr += simd.findQuote(here(), left(), lines);
+                if (atEnd() || !multiline || peek3('"')) break;
+                curr++;
             }
+            line += lines;
 
             if (atEnd()) {
                 rift::error::report(line, "string", "Unterminated String", Token(), std::exception());
                 return;
             }
 
-            if (peek3('"')) {
-                addToken(Type::STRINGLITERAL, std::string(source->begin()+start, source->begin()+curr+3));
-                advance(); advance(); advance();
-            }
-            else {
-                addToken(Type::STRINGLITERAL, std::string(source->begin()+start, source->begin()+curr+1));
-                advance();
-            }
+            curr += multiline ? 3 : 1;
+            // the lexeme is the contents, the quotes are stripped here once rather than on every use
+            size_t quotes = multiline ? 3 : 1;
+            tokens->emplace_back(Type::STRINGLITERAL, start + quotes, curr - start - 2 * quotes, line);
         }
 
         void Scanner::num() {
-            while (isDigit(peek())) advance();
+            curr += simd.digitsEnd(here(), left());
             if (peek('.') && isDigit(peekNext())) {
                 advance();
-                while (isDigit(advance()));
+                curr += simd.digitsEnd(here(), left());
             }
 
-            addToken(Type::NUMERICLITERAL, std::string(source->begin()+start, source->begin()+curr));
+            addToken(Type::NUMERICLITERAL);
         }
         
         void Scanner::identifier() {
-            while (isIdentifier(peek())) advance();
-            std::string text = std::string(source->begin()+start, source->begin()+curr);
-            text.erase(std::remove_if(text.begin(), text.end(), ::isspace), text.end());
-            if (keywords.find(text)!= keywords.end()) {
-                rift::error::report(line, "identifier", "Invalid Identifier(its a keyword)", Token(), std::exception());
+            curr += simd.identifierEnd(here(), left());
+            auto type = keywords::lookup(strv_t(source.data()+start, curr-start));
+
+            if (type == Type::VAR && peek('!')) {
+                advance();
+                addToken(Type::CONST);
+            } else if (type != Type::IDENTIFIER) {
+                addToken(type);
             } else {
-                if (tokens.size() > 0 && tokens.back().type == Type::CONST) {
-                    addToken(Type::C_IDENTIFIER, text);
-                } else {
-                    addToken(Type::IDENTIFIER, text);
-                }
+                auto named = tokens->size() > 0 && tokens->back().type == Type::CONST ? Type::C_IDENTIFIER : Type::IDENTIFIER;
+                CompactToken tok(named, start, 0, line);
+                tok.symbol = symbols.intern(strv_t(source.data()+start, curr-start));
+                tokens->push_back(tok);
             }
         }
 
-        bool Scanner::keyword() {
-            prevance();
-            for (const auto &[k,v] : keywords) {
-                std::vector vec = std::vector(k.begin(), k.end());
-                if (peek_word(vec, k.size())) {
-                    addToken(v);
-                    for (size_t i=0; i<k.size(); i++) advance();
-                    return true;
-                }
-            }
-            return false;
+        void Scanner::spaces() {
+            size_t lines = 0;
+            curr += simd.skipWhitespace(here(), left(), lines);
+            line += lines;
+        }
+
+        void Scanner::comment() {
+            curr += simd.lineEnd(here(), left());
         }
 
         #pragma mark - Public API
@@ -130,38 +106,40 @@ namespace rift
         {
             char c = advance();
             switch(c) {
-                case '(': addToken(Type::LEFT_PAREN, "(");break;
-                case ')': addToken(Type::RIGHT_PAREN, ")");break;
-                case '{': addToken(Type::LEFT_BRACE, "{");break;
-                case '}': addToken(Type::RIGHT_BRACE, "}");break;
-                case ',': addToken(Type::COMMA, ",");break;
+                case '(': addToken(Type::LEFT_PAREN);break;
+                case ')': addToken(Type::RIGHT_PAREN);break;
+                case '{': addToken(Type::LEFT_BRACE);break;
+                case '}': addToken(Type::RIGHT_BRACE);break;
+                case '[': addToken(Type::LEFT_BRACKET);break;
+                case ']': addToken(Type::RIGHT_BRACKET);break;
+                case ',': addToken(Type::COMMA);break;
                 case '.':
                     if(isDigit(peekNext())) num();
-                    else addToken(Type::DOT);break;
-                case '-': addToken(Type::MINUS, "-");break;
-                case '+': addToken(Type::PLUS, "+");break;
-                case ';': addToken(Type::SEMICOLON, ";");break;
-                case '*': addToken(Type::STAR, "*");break;
+                    else addToken(Type::DOT);
+                    break;
+                case '-': addToken(Type::MINUS);break;
+                case '+': addToken(Type::PLUS);break;
+                case ';': addToken(Type::SEMICOLON);break;
+                case '*': addToken(Type::STAR);break;
                 case '!': addToken(match_one('=') ? Type::BANG_EQUAL : Type::BANG);break;
                 case '=': addToken(match_one('=') ? Type::EQUAL_EQUAL : Type::EQUAL);break;
                 case '<': addToken(match_one('=') ? Type::LESS_EQUAL : Type::LESS);break;
                 case '>': addToken(match_one('=') ? Type::GREATER_EQUAL : Type::GREATER);break;
-                case '/': match_one('/') ? scanComment() : addToken(Type::SLASH, "/");break;
+                case '/': match_one('/') ? comment() : addToken(Type::SLASH);break;
                 case '"': string(); break;
-                case ' ': break;
-                case '\r': break;
-                case '\t': break;
-                case '\n': line++; break;
+                case ' ':
+                case '\r':
+                case '\t':
+                case '\n': prevance(); spaces(); break;
 
                 case '?': twoChar(Type::QUESTION, Type::NULLISH_COAL, c); break;
-                case ':': addToken(TokenType::COLON, ":");break;
+                case ':': addToken(TokenType::COLON);break;
 
                 case '&': twoChar(Type::BIT_AND, Type::LOG_AND, c); break;
                 case '|': twoChar(Type::BIT_OR, Type::LOG_OR, c); break;
 
                 default:
                     if (isDigit(c)) num();
-                    else if (keyword()) return;
                     else if (isAlpha(c)) identifier();
                     else rift::error::report(line, "scanToken", std::format("Unorthodox Character {}", c), Token(), std::exception());
             };
@@ -177,10 +155,166 @@ namespace rift
 
         void Scanner::scan_source()
         {
+            // token spans are 32 bit
+            if (source.size() > UINT32_MAX)
+                rift::error::report(line, "scan_source", "Source file too large", Token(), std::exception());
+            // chunk scanners end on whitespace, which a checked reader takes for a missing sentinel
+            if (!checked && curr == 0 && source.size() >= parallel) {
+                auto workers = Scheduler::shared().workers();
+                auto chunks = std::min(4 * (workers + 1), source.size() / CHUNK);
+                if (workers > 0 && chunks > 1 && scan_chunks(chunks)) return;
+            }
+            // roughly one token every few characters, saves regrowing the buffer
+            tokens->reserve(tokens->size() + (source.size() - curr) / 4);
             while (!atEnd()) {
                 start = curr;
                 scan_token();
             }
         }
+
+        #pragma mark - Parallel Scanning
+
+        static inline bool isSpace(char c) { return c == ' ' || c == '\r' || c == '\t' || c == '\n'; }
+
+        /// @brief where the chunks of source start, the first at 0, every other on whitespace
+        ///        outside of strings and comments (which are skipped the way the scanner does)
+        /// @details only quotes and slashes can start either, the pass jumps from one to the next
+        /// @note the last entry is the end of the source
+        static std::vector<size_t> boundaries(std::span<const char> source, size_t chunks)
+        {
+            const char* s = source.data();
+            size_t n = source.size(), i = 0;
+            auto next = [&](char c, size_t from) {
+                auto at = static_cast<const char*>(std::memchr(s + from, c, n - from));
+                return at ? static_cast<size_t>(at - s) : n;
+            };
+            auto triple = [&](size_t at) { return at + 2 < n && s[at] == '"' && s[at + 1] == '"' && s[at + 2] == '"'; };
+            // the next quote and slash, only searched for again once passed
+            size_t quote = next('"', 0), slash = next('/', 0);
+
+            std::vector<size_t> starts = {0};
+            for (size_t k = 1; k < chunks && i < n; k++) {
+                auto target = std::max(n / chunks * k, starts.back() + 1);
+                while (i < n) {
+                    if (quote < i) quote = next('"', i);
+                    if (slash < i) slash = next('/', i);
+                    auto special = std::min(quote, slash);
+                    if (i < target) {
+                        if (special >= target) {
+                            i = target;
+                            continue;
+                        }
+                        i = special;
+                    } else {
+                        // past the target, the first whitespace that isn't in a string or comment
+                        while (i < special && !isSpace(s[i])) i++;
+                        if (i < special || i >= n) break;
+                    }
+
+                    if (triple(i)) {
+                        // up to the next """, a lone quote doesn't close it
+                        for (i = next('"', i + 3); i < n && !triple(i); i = next('"', i + 1)) {}
+                        i = std::min(i + 3, n);
+                    } else if (s[i] == '"') {
+                        i = std::min(next('"', i + 1) + 1, n);
+                    } else if (i + 1 < n && s[i + 1] == '/') {
+                        i = next('\n', i);
+                    } else {
+                        i++;
+                    }
+                }
+                if (i < n) starts.push_back(i);
+            }
+            starts.push_back(n);
+            return starts;
+        }
+
+        bool Scanner::scan_chunks(size_t chunks)
+        {
+            auto starts = boundaries(source, chunks);
+            if (starts.size() < 3) return false;
+
+            struct Chunk : public Scheduler::Task {
+                std::unique_ptr<Scanner> scanner;
+                bool failed = false;
+
+                Chunk(std::span<const char> source, size_t from, Isolate& isolate) : scanner(std::make_unique<Scanner>(source, isolate)) {
+                    scanner->curr = scanner->start = static_cast<unsigned>(from);
+                    scanner->parallel = SIZE_MAX;
+                }
+
+                void run() override
+                {
+                    // thrown rather than reported, the serial scan reports it with the right line
+                    rift::error::Raise raise;
+                    try {
+                        scanner->scan_source();
+                    } catch (const rift::error::Error&) {
+                        failed = true;
+                    }
+                }
+            };
+
+            /// @brief copies the tokens of a chunk to where they go, a line offset added
+            struct Stitch : public Scheduler::Task {
+                const TokenBuffer& from;
+                CompactToken* into;
+                unsigned lines;
+
+                Stitch(const TokenBuffer& from, CompactToken* into, unsigned lines) : from(from), into(into), lines(lines) {}
+
+                void run() override
+                {
+                    for (size_t i = 0; i < from.size(); i++) {
+                        into[i] = from[i];
+                        into[i].line += lines;
+                    }
+                }
+            };
+
+            auto& pool = Scheduler::shared();
+            std::vector<std::unique_ptr<Chunk>> scans;
+            scans.reserve(starts.size() - 1);
+            {
+                Symbols::Sharing sharing(symbols);
+                Scheduler::Group group;
+                for (size_t k = 0; k + 1 < starts.size(); k++) {
+                    scans.push_back(std::make_unique<Chunk>(source.first(starts[k + 1]), starts[k], isolate));
+                    pool.spawn(group, *scans.back());
+                }
+                pool.wait(group);
+            }
+            for (const auto& scan : scans)
+                if (scan->failed) return false;
+
+            // prefix sums of the tokens and newlines of the chunks before, each counted its lines from 1
+            std::vector<std::unique_ptr<Stitch>> stitches;
+            stitches.reserve(scans.size());
+            size_t base = tokens->size(), total = base;
+            unsigned lines = 0;
+            for (const auto& scan : scans) total += scan->scanner->tokens->size();
+            tokens->resize(total);
+            {
+                Scheduler::Group group;
+                size_t at = base;
+                for (const auto& scan : scans) {
+                    stitches.push_back(std::make_unique<Stitch>(*scan->scanner->tokens, tokens->data() + at, lines));
+                    pool.spawn(group, *stitches.back());
+                    at += scan->scanner->tokens->size();
+                    lines += scan->scanner->line - 1;
+                }
+                pool.wait(group);
+            }
+
+            // mut! and its name can end up in two chunks
+            for (size_t k = 0, first = base; k < scans.size(); first += scans[k++]->scanner->tokens->size()) {
+                if (k == 0 || first == 0 || first == total) continue;
+                auto& tok = (*tokens)[first];
+                if (tok.type == Type::IDENTIFIER && (*tokens)[first - 1].type == Type::CONST) tok.type = Type::C_IDENTIFIER;
+            }
+            line += lines;
+            start = curr = static_cast<unsigned>(source.size());
+            return true;
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,276 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <scanner/simd.hh>
+
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define RIFT_SIMD_X86 1
+    #include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    #define RIFT_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+/// @brief Vector loops shared by every instruction set
+/// @details each ISA namespace provides WIDTH (bytes per step), BITS (mask bits per byte),
+///          FULL (mask of a whole step) and the mask helpers whitespace/identifier/digits/newline/quote,
+///          the tail that doesn't fill a vector goes through the scalar kernels
+#define RIFT_SIMD_LOOPS(TARGET)                                                                 \
+    TARGET size_t skipWhitespace(const char* p, size_t n, size_t& lines) {                      \
+        size_t i = 0;                                                                           \
+        for (; i + WIDTH <= n; i += WIDTH) {                                                    \
+            uint64_t nl, stop = ~whitespace(p + i, nl) & FULL;                                  \
+            if (stop) {                                                                         \
+                lines += std::popcount(nl & ((stop & -stop) - 1)) / BITS;                        \
+                return i + std::countr_zero(stop) / BITS;                                       \
+            }                                                                                   \
+            lines += std::popcount(nl) / BITS;                                                  \
+        }                                                                                       \
+        return i + scalar::skipWhitespace(p + i, n - i, lines);                                 \
+    }                                                                                           \
+    TARGET size_t identifierEnd(const char* p, size_t n) {                                      \
+        size_t i = 0;                                                                           \
+        for (; i + WIDTH <= n; i += WIDTH)                                                      \
+            if (uint64_t stop = ~identifier(p + i) & FULL) return i + std::countr_zero(stop) / BITS; \
+        return i + scalar::identifierEnd(p + i, n - i);                                         \
+    }                                                                                           \
+    TARGET size_t digitsEnd(const char* p, size_t n) {                                          \
+        size_t i = 0;                                                                           \
+        for (; i + WIDTH <= n; i += WIDTH)                                                      \
+            if (uint64_t stop = ~digits(p + i) & FULL) return i + std::countr_zero(stop) / BITS; \
+        return i + scalar::digitsEnd(p + i, n - i);                                             \
+    }                                                                                           \
+    TARGET size_t lineEnd(const char* p, size_t n) {                                            \
+        size_t i = 0;                                                                           \
+        for (; i + WIDTH <= n; i += WIDTH)                                                      \
+            if (uint64_t hit = newline(p + i)) return i + std::countr_zero(hit) / BITS;         \
+        return i + scalar::lineEnd(p + i, n - i);                                               \
+    }                                                                                           \
+    TARGET size_t findQuote(const char* p, size_t n, size_t& lines) {                           \
+        size_t i = 0;                                                                           \
+        for (; i + WIDTH <= n; i += WIDTH) {                                                    \
+            uint64_t nl, hit = quote(p + i, nl);                                                \
+            if (hit) {                                                                          \
+                lines += std::popcount(nl & ((hit & -hit) - 1)) / BITS;                          \
+                return i + std::countr_zero(hit) / BITS;                                        \
+            }                                                                                   \
+            lines += std::popcount(nl) / BITS;                                                  \
+        }                                                                                       \
+        return i + scalar::findQuote(p + i, n - i, lines);                                      \
+    }
+
+namespace rift
+{
+    namespace scanner
+    {
+        namespace simd
+        {
+            #pragma mark - Scalar
+
+            namespace scalar
+            {
+                static inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+                static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+                static inline bool isIdentifier(char c) { return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+
+                static size_t skipWhitespace(const char* p, size_t n, size_t& lines) {
+                    size_t i = 0;
+                    for (; i < n && isSpace(p[i]); i++) lines += p[i] == '\n';
+                    return i;
+                }
+
+                static size_t identifierEnd(const char* p, size_t n) {
+                    size_t i = 0;
+                    while (i < n && isIdentifier(p[i])) i++;
+                    return i;
+                }
+
+                static size_t digitsEnd(const char* p, size_t n) {
+                    size_t i = 0;
+                    while (i < n && isDigit(p[i])) i++;
+                    return i;
+                }
+
+                static size_t lineEnd(const char* p, size_t n) {
+                    size_t i = 0;
+                    while (i < n && p[i] != '\n') i++;
+                    return i;
+                }
+
+                static size_t findQuote(const char* p, size_t n, size_t& lines) {
+                    size_t i = 0;
+                    for (; i < n && p[i] != '"'; i++) lines += p[i] == '\n';
+                    return i;
+                }
+
+                static const Kernels kernels = {Level::SCALAR, "scalar", skipWhitespace, identifierEnd, digitsEnd, lineEnd, findQuote};
+            }
+
+            #if RIFT_SIMD_X86
+            #pragma mark - SSE2
+
+            namespace sse2
+            {
+                static constexpr size_t WIDTH = 16, BITS = 1;
+                static constexpr uint64_t FULL = 0xFFFF;
+
+                static inline __m128i load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                static inline __m128i eq(__m128i v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+                /// @note signed compares, bytes >= 0x80 are never in an ascii range
+                static inline __m128i in(__m128i v, char lo, char hi) { return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1))); }
+                static inline uint64_t bits(__m128i m) { return static_cast<uint32_t>(_mm_movemask_epi8(m)); }
+
+                static inline uint64_t whitespace(const char* p, uint64_t& nl) {
+                    auto v = load(p);
+                    auto n = eq(v, '\n');
+                    nl = bits(n);
+                    return bits(_mm_or_si128(_mm_or_si128(eq(v, ' '), eq(v, '\t')), _mm_or_si128(eq(v, '\r'), n)));
+                }
+                static inline uint64_t identifier(const char* p) {
+                    auto v = load(p);
+                    return bits(_mm_or_si128(_mm_or_si128(in(v, 'a', 'z'), in(v, 'A', 'Z')), _mm_or_si128(in(v, '0', '9'), eq(v, '_'))));
+                }
+                static inline uint64_t digits(const char* p) { return bits(in(load(p), '0', '9')); }
+                static inline uint64_t newline(const char* p) { return bits(eq(load(p), '\n')); }
+                static inline uint64_t quote(const char* p, uint64_t& nl) {
+                    auto v = load(p);
+                    nl = bits(eq(v, '\n'));
+                    return bits(eq(v, '"'));
+                }
+
+                RIFT_SIMD_LOOPS()
+
+                static const Kernels kernels = {Level::SSE2, "sse2", skipWhitespace, identifierEnd, digitsEnd, lineEnd, findQuote};
+            }
+
+            #pragma mark - AVX2
+
+            namespace avx2
+            {
+                #define RIFT_AVX2 __attribute__((target("avx2")))
+                static constexpr size_t WIDTH = 32, BITS = 1;
+                static constexpr uint64_t FULL = 0xFFFFFFFF;
+
+                RIFT_AVX2 static inline __m256i load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                RIFT_AVX2 static inline __m256i eq(__m256i v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+                RIFT_AVX2 static inline __m256i in(__m256i v, char lo, char hi) { return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v)); }
+                RIFT_AVX2 static inline uint64_t bits(__m256i m) { return static_cast<uint32_t>(_mm256_movemask_epi8(m)); }
+
+                RIFT_AVX2 static inline uint64_t whitespace(const char* p, uint64_t& nl) {
+                    auto v = load(p);
+                    auto n = eq(v, '\n');
+                    nl = bits(n);
+                    return bits(_mm256_or_si256(_mm256_or_si256(eq(v, ' '), eq(v, '\t')), _mm256_or_si256(eq(v, '\r'), n)));
+                }
+                RIFT_AVX2 static inline uint64_t identifier(const char* p) {
+                    auto v = load(p);
+                    return bits(_mm256_or_si256(_mm256_or_si256(in(v, 'a', 'z'), in(v, 'A', 'Z')), _mm256_or_si256(in(v, '0', '9'), eq(v, '_'))));
+                }
+                RIFT_AVX2 static inline uint64_t digits(const char* p) { return bits(in(load(p), '0', '9')); }
+                RIFT_AVX2 static inline uint64_t newline(const char* p) { return bits(eq(load(p), '\n')); }
+                RIFT_AVX2 static inline uint64_t quote(const char* p, uint64_t& nl) {
+                    auto v = load(p);
+                    nl = bits(eq(v, '\n'));
+                    return bits(eq(v, '"'));
+                }
+
+                RIFT_SIMD_LOOPS(RIFT_AVX2)
+                #undef RIFT_AVX2
+
+                static const Kernels kernels = {Level::AVX2, "avx2", skipWhitespace, identifierEnd, digitsEnd, lineEnd, findQuote};
+            }
+            #endif
+
+            #if RIFT_SIMD_NEON
+            #pragma mark - NEON
+
+            namespace neon
+            {
+                /// @note no movemask on neon, narrowing gives 4 bits per byte instead
+                static constexpr size_t WIDTH = 16, BITS = 4;
+                static constexpr uint64_t FULL = ~0ull;
+
+                static inline uint8x16_t load(const char* p) { return vld1q_u8(reinterpret_cast<const uint8_t*>(p)); }
+                static inline uint8x16_t eq(uint8x16_t v, char c) { return vceqq_u8(v, vdupq_n_u8(c)); }
+                static inline uint8x16_t in(uint8x16_t v, char lo, char hi) { return vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi))); }
+                static inline uint64_t bits(uint8x16_t m) { return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0); }
+
+                static inline uint64_t whitespace(const char* p, uint64_t& nl) {
+                    auto v = load(p);
+                    auto n = eq(v, '\n');
+                    nl = bits(n);
+                    return bits(vorrq_u8(vorrq_u8(eq(v, ' '), eq(v, '\t')), vorrq_u8(eq(v, '\r'), n)));
+                }
+                static inline uint64_t identifier(const char* p) {
+                    auto v = load(p);
+                    return bits(vorrq_u8(vorrq_u8(in(v, 'a', 'z'), in(v, 'A', 'Z')), vorrq_u8(in(v, '0', '9'), eq(v, '_'))));
+                }
+                static inline uint64_t digits(const char* p) { return bits(in(load(p), '0', '9')); }
+                static inline uint64_t newline(const char* p) { return bits(eq(load(p), '\n')); }
+                static inline uint64_t quote(const char* p, uint64_t& nl) {
+                    auto v = load(p);
+                    nl = bits(eq(v, '\n'));
+                    return bits(eq(v, '"'));
+                }
+
+                RIFT_SIMD_LOOPS()
+
+                static const Kernels kernels = {Level::NEON, "neon", skipWhitespace, identifierEnd, digitsEnd, lineEnd, findQuote};
+            }
+            #endif
+
+            #pragma mark - Dispatch
+
+            const Kernels* kernels(Level level)
+            {
+                switch (level) {
+                    case Level::SCALAR: return &scalar::kernels;
+                    #if RIFT_SIMD_X86
+                    case Level::SSE2: return __builtin_cpu_supports("sse2") ? &sse2::kernels : nullptr;
+                    case Level::AVX2: return __builtin_cpu_supports("avx2") ? &avx2::kernels : nullptr;
+                    #endif
+                    #if RIFT_SIMD_NEON
+                    case Level::NEON: return &neon::kernels;
+                    #endif
+                    default: return nullptr;
+                }
+            }
+
+            static const Kernels& select()
+            {
+                if (const char* forced = std::getenv("RIFT_SIMD")) {
+                    for (auto level : {Level::SCALAR, Level::SSE2, Level::AVX2, Level::NEON}) {
+                        auto k = kernels(level);
+                        if (k != nullptr && std::string_view(k->name) == forced) return *k;
+                    }
+                }
+                for (auto level : {Level::AVX2, Level::NEON, Level::SSE2}) {
+                    if (auto k = kernels(level)) return *k;
+                }
+                return scalar::kernels;
+            }
+
+            const Kernels& kernels()
+            {
+                static const Kernels& best = select();
+                return best;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -25,6 +25,8 @@ std::string Token::convertTypeString(TokenType type) {
         case RIGHT_PAREN: return "RIGHT_PAREN";
         case LEFT_BRACE: return "LEFT_BRACE";
         case RIGHT_BRACE: return "RIGHT_BRACE";
+        case LEFT_BRACKET: return "LEFT_BRACKET";
+        case RIGHT_BRACKET: return "RIGHT_BRACKET";
         case COMMA: return "COMMA";
         case DOT: return "DOT";
         case MINUS: return "MINUS";
@@ -69,6 +71,10 @@ std::string Token::convertTypeString(TokenType type) {
         case VAR: return "VAR";
         case CONST: return "CONST";
         case WHILE: return "WHILE";
+        case PARALLEL: return "PARALLEL";
+        case SPAWN: return "SPAWN";
+        case AWAIT: return "AWAIT";
+        case IMPORT: return "IMPORT";
         case C_IDENTIFIER: return "C_IDENTIFIER";
         case IGNORE: return "IGNORE";
         case EOFF: return "EOFF";
@@ -211,6 +217,14 @@ std::any Token::getLiteral() const
     return std::any(); // should never hit
 }
 
+#pragma mark - Token Buffer
+
+Token TokenBuffer::token(const CompactToken& tok) const
+{
+    auto text = std::string(lexeme(tok));
+    return Token(tok.type, text, text, tok.line, CompactToken::named(tok.type) ? tok.symbol : Symbols::NONE);
+}
+
 #pragma mark - Operators
 
 bool Token::operator==(const Token &token) const
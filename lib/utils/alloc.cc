@@ -0,0 +1,38 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/alloc.hh>
+
+#include <atomic>
+
+namespace rift
+{
+    namespace alloc
+    {
+        static std::atomic<bool> enabled = false;
+        static std::atomic<size_t> allocations = 0;
+        static std::atomic<size_t> bytes = 0;
+
+        void track(bool on) { enabled.store(on, std::memory_order_relaxed); }
+        bool tracking() { return enabled.load(std::memory_order_relaxed); }
+        Counts counts() { return {allocations.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed)}; }
+
+        void count(size_t size)
+        {
+            if (!enabled.load(std::memory_order_relaxed)) return;
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+}
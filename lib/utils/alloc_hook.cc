@@ -0,0 +1,37 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/alloc.hh>
+
+#include <cstdlib>
+#include <new>
+
+/// @file alloc_hook.cc
+/// @brief The global operator new behind alloc::track, linked into riftlang and the tests
+/// @note array and nothrow forms forward to these, aligned forms are left to the runtime
+
+void* operator new(size_t size)
+{
+    rift::alloc::count(size);
+    // like the runtime's own, the new_handler gets to free memory until it gives up
+    for (;;) {
+        if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+        auto handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
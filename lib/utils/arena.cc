@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/arena.hh>
+#include <algorithm>
+#include <cstdint>
+
+namespace rift
+{
+    void* Arena::allocate(size_t size, size_t align)
+    {
+        auto aligned = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t)(align - 1));
+        if (cursor == nullptr || aligned + size > end) {
+            // oversized requests get a block of their own
+            size_t block = std::max(BLOCK_SIZE, size + align);
+            blocks.push_back(std::make_unique<std::byte[]>(block));
+            cursor = blocks.back().get();
+            end = cursor + block;
+            capacity += block;
+            aligned = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t)(align - 1));
+        }
+        cursor = aligned + size;
+        bytes += size;
+        return aligned;
+    }
+
+    void Arena::release()
+    {
+        for (auto it = finalizers.rbegin(); it != finalizers.rend(); it++)
+            it->destroy(it->obj);
+        finalizers.clear();
+        blocks.clear();
+        cursor = end = nullptr;
+        bytes = capacity = count = 0;
+    }
+}
\ No newline at end of file
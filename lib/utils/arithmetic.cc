@@ -13,38 +13,22 @@
 /////////////////////////////////////////////////////////////
 
 #include <utils/arithmetic.hh>
+#include <error/error.hh>
+#include <stdexcept>
 
 namespace rift
 {
-    // for now don't allow different types (although we should be able to add diff types for example: int and double)
-    any any_arithmetic(any left, any right, const Token& op)
+    Value any_arithmetic(const Value& left, const Value& right, const Token& op)
     {
-        if (left.type() != right.type())
-            rift::error::report(op.line, "any_arithmetic", "not able to do arithmetic ops on different types (future work)", Token(), std::runtime_error("unable to do arithmetic ops on different types (future work)"));
+        auto row = arith::op(op.type);
+        if (auto fn = arith::lookup(row, left.type, right.type)) return fn(left, right);
 
-        if (op.type == TokenType::PLUS) {
-            _ANY_ARITHMETIC(left,right,+, op);
-        } else if (op.type == TokenType::MINUS) {    
-            _ANY_ARITHMETIC(left,right,-, op);
-        } else if (op.type == TokenType::STAR) {
-            _ANY_ARITHMETIC(left,right,*, op);
-        } else if (op.type == TokenType::SLASH) {
-            _ANY_ARITHMETIC(left,right,/, op); 
-        } else if (op.type == TokenType::LESS) {
-            _ANY_ARITHMETIC(left,right,<, op);
-        } else if (op.type == TokenType::LESS_EQUAL) {
-            _ANY_ARITHMETIC(left,right,<=, op);
-        } else if (op.type == TokenType::GREATER) {
-            _ANY_ARITHMETIC(left,right,>, op);
-        } else if (op.type == TokenType::GREATER_EQUAL) {
-            _ANY_ARITHMETIC(left,right,>=, op);
-        } else if (op.type == TokenType::BANG_EQUAL) {
-            _ANY_ARITHMETIC(left,right,!=, op);
-        } else if (op.type == TokenType::EQUAL_EQUAL) {
-            _ANY_ARITHMETIC(left,right,==, op);
-        } else {
+        if (row == arith::Op::NONE)
             rift::error::report(op.line, "any_arithmetic", "unsupported operand (future work)", Token(), std::runtime_error("unsupported operand (future work)"));
-        }
-        return any();
+        else if (row <= arith::Op::DIV)
+            rift::error::report(op.line, "Arithmetic Error", "Invalid operands for arithmetic operation", Token(), std::exception());
+        else
+            rift::error::report(op.line, "Arithmetic Error", "Invalid operands for comparison operation", Token(), std::exception());
+        return Value();
     }
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/builtins.hh>
+#include <utils/numeric.hh>
+#include <utils/literals.hh>
+#include <error/error.hh>
+#include <array>
+#include <cmath>
+#include <string>
+
+namespace rift
+{
+    namespace builtins
+    {
+        struct Entry {
+            const char* name;
+            uint32_t arity;
+        };
+
+        /// @note in the order of Builtin
+        static constexpr std::array<Entry, 8> entries = {{
+            {"", 0},
+            {"array", 1},
+            {"len", 1},
+            {"sum", 1},
+            {"min", 1},
+            {"max", 1},
+            {"dot", 2},
+            {"map", 2},
+        }};
+
+        Builtin lookup(std::string_view name)
+        {
+            for (size_t i = 1; i < entries.size(); i++)
+                if (name == entries[i].name) return static_cast<Builtin>(i);
+            return Builtin::NONE;
+        }
+
+        const char* name(Builtin fn) { return entries[static_cast<size_t>(fn)].name; }
+        uint32_t arity(Builtin fn) { return entries[static_cast<size_t>(fn)].arity; }
+
+        double& element(const Value& target, const Value& index)
+        {
+            if (!target.isArray())
+                rift::error::runTimeError("Can only index arrays");
+            auto& items = target.asArray()->items;
+            if (!index.isNumber() || index.as.number != std::floor(index.as.number))
+                rift::error::runTimeError("Expected a whole number index");
+            if (!(index.as.number >= 0 && index.as.number < static_cast<double>(items.size())))
+                rift::error::runTimeError("Index " + formatNumber(index.as.number) + " out of range for an array of " + std::to_string(items.size()));
+            return items[static_cast<size_t>(index.as.number)];
+        }
+
+        /// @brief the array argument of fn, reported if it is anything else
+        static const ObjArray& array(Builtin fn, const Value& arg)
+        {
+            if (!arg.isArray())
+                rift::error::runTimeError(std::string("Expected an array for '") + name(fn) + "'");
+            return *arg.asArray();
+        }
+
+        Value call(Builtin fn, std::span<const Value> args, Heap& heap, const Apply& apply)
+        {
+            if (args.size() != arity(fn))
+                rift::error::runTimeError("Expected " + std::to_string(arity(fn)) + " arguments but got " + std::to_string(args.size()));
+
+            const auto& k = numeric::kernels();
+            switch (fn) {
+                case Builtin::ARRAY: {
+                    const auto& n = args[0];
+                    if (!n.isNumber() || !(n.as.number >= 0 && n.as.number <= UINT32_MAX) || n.as.number != std::floor(n.as.number))
+                        rift::error::runTimeError("Expected a whole number length for 'array'");
+                    return heap.array(std::vector<double>(static_cast<uint32_t>(n.as.number), 0.0));
+                }
+                case Builtin::LEN:
+                    if (args[0].isString()) return Value::number(static_cast<double>(args[0].asString().size()));
+                    return Value::number(static_cast<double>(array(fn, args[0]).items.size()));
+                case Builtin::SUM: {
+                    const auto& items = array(fn, args[0]).items;
+                    return Value::number(k.sum(items.data(), items.size()));
+                }
+                case Builtin::MIN:
+                case Builtin::MAX: {
+                    const auto& items = array(fn, args[0]).items;
+                    if (items.empty())
+                        rift::error::runTimeError(std::string("Expected a non empty array for '") + name(fn) + "'");
+                    return Value::number((fn == Builtin::MIN ? k.min : k.max)(items.data(), items.size()));
+                }
+                case Builtin::DOT: {
+                    const auto& a = array(fn, args[0]).items;
+                    const auto& b = array(fn, args[1]).items;
+                    if (a.size() != b.size())
+                        rift::error::runTimeError("Expected arrays of the same length for 'dot'");
+                    return Value::number(k.dot(a.data(), b.data(), a.size()));
+                }
+                case Builtin::MAP: {
+                    // apply may run code that grows whatever args points into, keep what's needed
+                    const ObjArray* arr = &array(fn, args[0]);
+                    const Value f = args[1];
+                    std::vector<double> items;
+                    items.reserve(arr->items.size());
+                    for (size_t i = 0; i < arr->items.size(); i++) {
+                        auto val = apply(f, Value::number(arr->items[i]));
+                        if (!val.isNumber())
+                            rift::error::runTimeError("Expected the function given to 'map' to return a number");
+                        items.push_back(val.as.number);
+                    }
+                    return heap.array(std::move(items));
+                }
+                default:
+                    rift::error::runTimeError("Unknown builtin");
+                    return Value();
+            }
+        }
+    }
+}
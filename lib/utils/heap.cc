@@ -0,0 +1,167 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/value.hh>
+#include <algorithm>
+#include <atomic>
+
+namespace rift
+{
+    #pragma mark - Roots
+
+    Heap::Roots::Roots(Heap& heap) : heap(&heap)
+    {
+        heap.roots.push_back(this);
+    }
+
+    Heap::Roots::~Roots()
+    {
+        if (heap == nullptr) return;
+        // roots mostly go away in the reverse order they came in
+        auto it = std::find(heap->roots.rbegin(), heap->roots.rend(), this);
+        heap->roots.erase(std::next(it).base());
+    }
+
+    void Heap::Pins::trace(Heap& heap) const
+    {
+        for (auto obj : objects) heap.mark(obj);
+    }
+
+    #pragma mark - Scopes
+
+    /// @brief set by a Scope on this thread
+    static thread_local Heap* entered = nullptr;
+
+    Heap::Scope::Scope(Heap& heap) : previous(entered) { entered = &heap; }
+    Heap::Scope::~Scope() { entered = previous; }
+
+    Heap& Heap::current(Heap& fallback)
+    {
+        return entered != nullptr ? *entered : fallback;
+    }
+
+    #pragma mark - Allocation
+
+    /// @brief large objects are preceded by their size
+    static constexpr size_t LARGE_HEADER = alignof(std::max_align_t);
+
+    /// @brief 0 is left for objects no heap made
+    static std::atomic<uint32_t> heaps{1};
+
+    Heap::Heap() : id(heaps.fetch_add(1, std::memory_order_relaxed)) {}
+
+    Heap::~Heap()
+    {
+        // whatever still points into the heap outlived it, its roots just stop being traced
+        for (auto root : roots) root->heap = nullptr;
+        for (auto obj : objects) release(obj);
+    }
+
+    void* Heap::slot(uint8_t cls, size_t size)
+    {
+        if (cls == LARGE) {
+            auto ptr = static_cast<std::byte*>(::operator new(LARGE_HEADER + size));
+            *reinterpret_cast<size_t*>(ptr) = size;
+            counts.reserved += LARGE_HEADER + size;
+            pressure += size;
+            return ptr + LARGE_HEADER;
+        }
+
+        auto& pool = pools[cls];
+        pressure += CLASSES[cls];
+        if (pool.free != nullptr) {
+            void* ret = pool.free;
+            pool.free = *static_cast<void**>(ret);
+            return ret;
+        }
+        if (pool.next == pool.end) {
+            // a slab is only ever given back with the heap
+            pool.slabs.push_back(std::make_unique<std::byte[]>(SLAB_SIZE));
+            pool.next = pool.slabs.back().get();
+            pool.end = pool.next + SLAB_SIZE / CLASSES[cls] * CLASSES[cls];
+            counts.reserved += SLAB_SIZE;
+        }
+        void* ret = pool.next;
+        pool.next += CLASSES[cls];
+        return ret;
+    }
+
+    void Heap::track(Obj* obj, uint8_t cls)
+    {
+        obj->cls = cls;
+        obj->owner = id;
+        objects.push_back(obj);
+        if (pinning != nullptr) pinning->objects.push_back(obj);
+        counts.objects++;
+        counts.classes[cls]++;
+        counts.bytes += cls == LARGE ? *reinterpret_cast<size_t*>(reinterpret_cast<std::byte*>(obj) - LARGE_HEADER) : CLASSES[cls];
+    }
+
+    void Heap::release(Obj* obj)
+    {
+        auto cls = obj->cls;
+        counts.objects--;
+        counts.classes[cls]--;
+        obj->~Obj();
+
+        if (cls == LARGE) {
+            auto ptr = reinterpret_cast<std::byte*>(obj) - LARGE_HEADER;
+            auto size = *reinterpret_cast<size_t*>(ptr);
+            counts.bytes -= size;
+            counts.reserved -= LARGE_HEADER + size;
+            ::operator delete(ptr);
+            return;
+        }
+        counts.bytes -= CLASSES[cls];
+        auto& pool = pools[cls];
+        *reinterpret_cast<void**>(obj) = pool.free;
+        pool.free = obj;
+    }
+
+    #pragma mark - Collection
+
+    void Heap::mark(Obj* obj)
+    {
+        if (obj->owner != id || obj->marked) return;
+        obj->marked = true;
+        gray.push_back(obj);
+    }
+
+    void Heap::collect()
+    {
+        for (auto root : roots) root->trace(*this);
+        while (!gray.empty()) {
+            auto obj = gray.back();
+            gray.pop_back();
+            obj->trace(*this);
+        }
+
+        size_t live = 0;
+        for (auto obj : objects) {
+            if (obj->marked) {
+                obj->marked = false;
+                objects[live++] = obj;
+                continue;
+            }
+            release(obj);
+            counts.freed++;
+        }
+        objects.resize(live);
+
+        counts.collections++;
+        pressure = 0;
+        // the more survives, the longer until it's worth looking again
+        threshold = std::max(PRESSURE_MIN, 2 * counts.bytes);
+    }
+}
\ No newline at end of file
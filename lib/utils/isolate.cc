@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/isolate.hh>
+
+namespace rift
+{
+    #pragma mark - Isolate
+
+    /// @brief the isolate entered on this thread, if any
+    static thread_local Isolate* entered = nullptr;
+
+    Isolate& Isolate::current()
+    {
+        if (entered) return *entered;
+        static Isolate process;
+        return process;
+    }
+
+    Isolate::Scope::Scope(Isolate& isolate) : previous(entered)
+    {
+        entered = &isolate;
+    }
+
+    Isolate::Scope::~Scope()
+    {
+        entered = previous;
+    }
+
+    void Isolate::Globals::trace(Heap& heap) const
+    {
+        isolate.globals.trace(heap);
+        isolate.parser_globals.trace(heap);
+    }
+
+    #pragma mark - Current Isolate
+
+    Symbols& Symbols::getInstance()
+    {
+        return Isolate::current().symbols;
+    }
+
+    Heap& Heap::getInstance()
+    {
+        return current(Isolate::current().heap);
+    }
+
+    namespace ast
+    {
+        Environment& Environment::getInstance(bool parser)
+        {
+            return Isolate::current().environment(parser);
+        }
+    }
+}
\ No newline at end of file
@@ -16,76 +16,33 @@
 #pragma mark
 
 #include <utils/literals.hh>
+#include <charconv>
 
 namespace rift
 {
-    bool truthy(const Token& tok) {
-        any val = tok.getLiteral();
-        if (val.type() == typeid(bool)) {
-            return std::any_cast<bool>(val);
-        }
-        return true;
-    }
-
-    bool equal(const Token& tl, const Token& tr) {
-        any left = tl.getLiteral();
-        any right = tr.getLiteral();
-        if (left.type() != right.type()) return false;
-        else if (left.type() == typeid(bool)) return std::any_cast<bool>(left) == std::any_cast<bool>(right);
-        else if (left.type() == typeid(std::string)) return std::any_cast<std::string>(left) == std::any_cast<std::string>(right);
-        else if (left.type() == typeid(double)) return std::any_cast<double>(left) == std::any_cast<double>(right);
-        return false;
-    }
-
-    bool isNumber(const Token& tok) {
-        any val = tok.getLiteral();
-        return val.type() == typeid(double) || val.type() == typeid(float) || 
-                val.type() == typeid(int) || val.type() == typeid(long) ||
-                val.type() == typeid(unsigned) || val.type() == typeid(short) || 
-                val.type() == typeid(unsigned long) || val.type() == typeid(unsigned short) ||
-                val.type() == typeid(unsigned long long) || val.type() == typeid(long long);
+    std::string formatNumber(double num) {
+        // shortest representation that round-trips, so 2.0 prints as "2"
+        char buf[32];
+        auto res = std::to_chars(buf, buf + sizeof(buf), num);
+        return std::string(buf, res.ptr);
     }
 
-    bool isString(const Token& tok) {
-        any val = tok.getLiteral();
-        if(val.type() == typeid(Token)) return isString(std::any_cast<Token>(val));
-        return val.type() == typeid(std::string) || val.type() == typeid(char*) || val.type() == typeid(const char*) ||
-                val.type() == typeid(char) || val.type() == typeid(unsigned char) || val.type() == typeid(signed char);
-    }
-
-    any castNumber(const Token& tok) {
-        any val = tok.getLiteral();
-        if (val.type() == typeid(double)) {
-            return std::any_cast<double>(val);
-        } else if (val.type() == typeid(float)) {
-            return std::any_cast<float>(val);
-        } else if (val.type() == typeid(int)) {
-            return std::any_cast<int>(val);
-        } else if (val.type() == typeid(long)) {
-            return std::any_cast<long>(val);
-        } else if (val.type() == typeid(unsigned)) {
-            return std::any_cast<unsigned>(val);
-        } else if (val.type() == typeid(short)) {
-            return std::any_cast<short>(val);
-        } else if (val.type() == typeid(unsigned long)) {
-            return std::any_cast<unsigned long>(val);
-        } else if (val.type() == typeid(unsigned short)) {
-            return std::any_cast<unsigned short>(val);
-        } else if (val.type() == typeid(unsigned long long)) {
-            return std::any_cast<unsigned long long>(val);
-        } else if (val.type() == typeid(long long)) {
-            return std::any_cast<long long>(val);
+    Value literalValue(const Token& tok) {
+        switch (tok.type) {
+            case TokenType::NUMERICLITERAL: return Value::number(std::stod(tok.lexeme));
+            case TokenType::STRINGLITERAL: return Heap::getInstance().string(tok.lexeme);
+            case TokenType::TRUE: return Value::boolean(true);
+            case TokenType::FALSE: return Value::boolean(false);
+            case TokenType::NIL: return Value::nil();
+            default: return Value::undefined();
         }
-
-        rift::error::runTimeError("Expected a number");
-        return "";
     }
 
     std::string castNumberString(const any& val, bool err) {
         if (val.type() == typeid(double)) {
-            return std::to_string(std::any_cast<double>(val));
+            return formatNumber(std::any_cast<double>(val));
         } else if (val.type() == typeid(float)) {
-            return std::to_string(std::any_cast<float>(val));
+            return formatNumber(std::any_cast<float>(val));
         } else if (val.type() == typeid(int)) {
             return std::to_string(std::any_cast<int>(val));
         } else if (val.type() == typeid(long)) {
@@ -131,20 +88,4 @@ namespace rift
             rift::error::runTimeError("Expected a string");
         return "";
     }
-
-    std::string castAnyString(const Token& tok)
-    {
-        if (tok.type == TokenType::TRUE) return "true";
-        if (tok.type == TokenType::FALSE) return "false";
-        if (tok.type == TokenType::NIL) return "nil";
-        std::string str = castNumberString(tok.getLiteral(), false);
-        if (str.empty()) {
-            str = castString(tok, false);
-            if (str.empty()) {
-                rift::error::runTimeError("Expected a string or number");
-            }
-        }
-        return str;
-    }
-}
-
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/mapped_file.hh>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rift
+{
+    std::unique_ptr<MappedFile> MappedFile::open(const std::string& path)
+    {
+        auto file = std::unique_ptr<MappedFile>(new MappedFile());
+        if (path == "-")
+            return file->slurp(STDIN_FILENO) ? std::move(file) : nullptr;
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && S_ISREG(st.st_mode) && st.st_size > 0) {
+            // the file is mapped over zeroed pages one byte longer than it, that byte is the
+            // sentinel (the rest of the file's last page is zero filled by the kernel already)
+            size_t page = sysconf(_SC_PAGESIZE);
+            size_t length = (st.st_size + 1 + page - 1) / page * page;
+            void* zeros = mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            void* addr = zeros == MAP_FAILED ? MAP_FAILED : mmap(zeros, st.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+            if (addr != MAP_FAILED) {
+                // the scanner reads front to back exactly once
+                madvise(addr, st.st_size, MADV_SEQUENTIAL);
+                file->data = static_cast<const char*>(addr);
+                file->size = st.st_size;
+                file->length = length;
+                file->is_mapped = true;
+            } else if (zeros != MAP_FAILED) {
+                munmap(zeros, length);
+            }
+        }
+        // empty files, fifos, /dev/stdin, ...
+        if (ok && !file->is_mapped) ok = file->slurp(fd);
+
+        close(fd);
+        return ok ? std::move(file) : nullptr;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (is_mapped) munmap(const_cast<char*>(data), length);
+    }
+
+    bool MappedFile::slurp(int fd)
+    {
+        char chunk[64 * 1024];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) != 0) {
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return false;
+            buffer.insert(buffer.end(), chunk, chunk + n);
+        }
+        size = buffer.size();
+        buffer.push_back('\0');
+        data = buffer.data();
+        return true;
+    }
+}
\ No newline at end of file
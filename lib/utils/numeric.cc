@@ -0,0 +1,255 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/numeric.hh>
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define RIFT_NUMERIC_X86 1
+    #include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    #define RIFT_NUMERIC_NEON 1
+    #include <arm_neon.h>
+#endif
+
+/// @brief Vector loops shared by every instruction set
+/// @details each ISA namespace provides V (a vector of doubles), WIDTH (doubles per vector)
+///          and the helpers zero/load/store/add/mul/least/most/nans. Sums keep LANES partial
+///          sums whatever the WIDTH and fold them like the scalar kernels do, so every level
+///          adds in the same order. A NaN sends min and max back to the scalar kernel
+#define RIFT_NUMERIC_LOOPS(TARGET)                                                              \
+    TARGET static inline double reduce(V v, double (*fn)(const double*, size_t)) {              \
+        double lanes[WIDTH];                                                                    \
+        store(lanes, v);                                                                        \
+        return fn(lanes, WIDTH);                                                                \
+    }                                                                                           \
+    TARGET static inline double fold(const V* acc) {                                            \
+        double lanes[LANES];                                                                    \
+        for (size_t j = 0; j < LANES / WIDTH; j++) store(lanes + j * WIDTH, acc[j]);            \
+        return scalar::fold(lanes);                                                             \
+    }                                                                                           \
+    /* the lanes nans marked are all ones, a NaN too */                                         \
+    TARGET static inline bool any(V mask) {                                                     \
+        double lanes[WIDTH];                                                                    \
+        store(lanes, mask);                                                                     \
+        for (size_t j = 0; j < WIDTH; j++) if (lanes[j] != 0) return true;                      \
+        return false;                                                                           \
+    }                                                                                           \
+    TARGET double sum(const double* p, size_t n) {                                              \
+        size_t i = 0;                                                                           \
+        V acc[LANES / WIDTH];                                                                   \
+        for (auto& v : acc) v = zero();                                                         \
+        for (; i + LANES <= n; i += LANES)                                                      \
+            for (size_t j = 0; j < LANES / WIDTH; j++)                                          \
+                acc[j] = add(acc[j], load(p + i + j * WIDTH));                                  \
+        double ret = fold(acc);                                                                 \
+        for (; i < n; i++) ret += p[i];                                                         \
+        return ret;                                                                             \
+    }                                                                                           \
+    TARGET double min(const double* p, size_t n) {                                              \
+        if (n < WIDTH) return scalar::min(p, n);                                                \
+        size_t i = WIDTH;                                                                       \
+        V acc = load(p), seen = nans(zero(), acc);                                              \
+        for (; i + WIDTH <= n; i += WIDTH) {                                                    \
+            V v = load(p + i);                                                                  \
+            seen = nans(seen, v);                                                               \
+            acc = least(acc, v);                                                                \
+        }                                                                                       \
+        double ret = reduce(acc, scalar::min), tail = i < n ? scalar::min(p + i, n - i) : ret;  \
+        if (any(seen) || tail != tail) return scalar::min(p, n);                                \
+        return std::min(ret, tail);                                                             \
+    }                                                                                           \
+    TARGET double max(const double* p, size_t n) {                                              \
+        if (n < WIDTH) return scalar::max(p, n);                                                \
+        size_t i = WIDTH;                                                                       \
+        V acc = load(p), seen = nans(zero(), acc);                                              \
+        for (; i + WIDTH <= n; i += WIDTH) {                                                    \
+            V v = load(p + i);                                                                  \
+            seen = nans(seen, v);                                                               \
+            acc = most(acc, v);                                                                 \
+        }                                                                                       \
+        double ret = reduce(acc, scalar::max), tail = i < n ? scalar::max(p + i, n - i) : ret;  \
+        if (any(seen) || tail != tail) return scalar::max(p, n);                                \
+        return std::max(ret, tail);                                                             \
+    }                                                                                           \
+    TARGET double dot(const double* a, const double* b, size_t n) {                             \
+        size_t i = 0;                                                                           \
+        V acc[LANES / WIDTH];                                                                   \
+        for (auto& v : acc) v = zero();                                                         \
+        for (; i + LANES <= n; i += LANES)                                                      \
+            for (size_t j = 0; j < LANES / WIDTH; j++)                                          \
+                acc[j] = add(acc[j], mul(load(a + i + j * WIDTH), load(b + i + j * WIDTH)));    \
+        double ret = fold(acc);                                                                 \
+        for (; i < n; i++) ret += a[i] * b[i];                                                  \
+        return ret;                                                                             \
+    }
+
+namespace rift
+{
+    namespace numeric
+    {
+        #pragma mark - Scalar
+
+        /// @brief partial sums every level keeps, as wide as the widest vector
+        static constexpr size_t LANES = 4;
+
+        namespace scalar
+        {
+            /// @brief adds up the partial sums, in pairs
+            static inline double fold(const double* lanes) {
+                return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
+
+            static double sum(const double* p, size_t n) {
+                size_t i = 0;
+                double lanes[LANES] = {};
+                for (; i + LANES <= n; i += LANES)
+                    for (size_t j = 0; j < LANES; j++) lanes[j] += p[i + j];
+                double ret = fold(lanes);
+                for (; i < n; i++) ret += p[i];
+                return ret;
+            }
+
+            static double min(const double* p, size_t n) {
+                double ret = p[0];
+                for (size_t i = 0; i < n; i++) {
+                    if (p[i] != p[i]) return p[i];
+                    if (p[i] < ret) ret = p[i];
+                }
+                return ret;
+            }
+
+            static double max(const double* p, size_t n) {
+                double ret = p[0];
+                for (size_t i = 0; i < n; i++) {
+                    if (p[i] != p[i]) return p[i];
+                    if (p[i] > ret) ret = p[i];
+                }
+                return ret;
+            }
+
+            static double dot(const double* a, const double* b, size_t n) {
+                size_t i = 0;
+                double lanes[LANES] = {};
+                for (; i + LANES <= n; i += LANES)
+                    for (size_t j = 0; j < LANES; j++) lanes[j] += a[i + j] * b[i + j];
+                double ret = fold(lanes);
+                for (; i < n; i++) ret += a[i] * b[i];
+                return ret;
+            }
+
+            static const Kernels kernels = {Level::SCALAR, "scalar", sum, min, max, dot};
+        }
+
+        #if RIFT_NUMERIC_X86
+        #pragma mark - SSE2
+
+        namespace sse2
+        {
+            using V = __m128d;
+            static constexpr size_t WIDTH = 2;
+
+            static inline V zero() { return _mm_setzero_pd(); }
+            static inline V load(const double* p) { return _mm_loadu_pd(p); }
+            static inline void store(double* p, V v) { _mm_storeu_pd(p, v); }
+            static inline V add(V a, V b) { return _mm_add_pd(a, b); }
+            static inline V mul(V a, V b) { return _mm_mul_pd(a, b); }
+            static inline V least(V a, V b) { return _mm_min_pd(a, b); }
+            static inline V most(V a, V b) { return _mm_max_pd(a, b); }
+            static inline V nans(V seen, V v) { return _mm_or_pd(seen, _mm_cmpunord_pd(v, v)); }
+
+            RIFT_NUMERIC_LOOPS()
+
+            static const Kernels kernels = {Level::SSE2, "sse2", sum, min, max, dot};
+        }
+
+        #pragma mark - AVX2
+
+        namespace avx2
+        {
+            #define RIFT_AVX2 __attribute__((target("avx2")))
+            using V = __m256d;
+            static constexpr size_t WIDTH = 4;
+
+            RIFT_AVX2 static inline V zero() { return _mm256_setzero_pd(); }
+            RIFT_AVX2 static inline V load(const double* p) { return _mm256_loadu_pd(p); }
+            RIFT_AVX2 static inline void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+            RIFT_AVX2 static inline V add(V a, V b) { return _mm256_add_pd(a, b); }
+            RIFT_AVX2 static inline V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+            RIFT_AVX2 static inline V least(V a, V b) { return _mm256_min_pd(a, b); }
+            RIFT_AVX2 static inline V most(V a, V b) { return _mm256_max_pd(a, b); }
+            RIFT_AVX2 static inline V nans(V seen, V v) { return _mm256_or_pd(seen, _mm256_cmp_pd(v, v, _CMP_UNORD_Q)); }
+
+            RIFT_NUMERIC_LOOPS(RIFT_AVX2)
+            #undef RIFT_AVX2
+
+            static const Kernels kernels = {Level::AVX2, "avx2", sum, min, max, dot};
+        }
+        #endif
+
+        #if RIFT_NUMERIC_NEON
+        #pragma mark - NEON
+
+        namespace neon
+        {
+            using V = float64x2_t;
+            static constexpr size_t WIDTH = 2;
+
+            static inline V zero() { return vdupq_n_f64(0); }
+            static inline V load(const double* p) { return vld1q_f64(p); }
+            static inline void store(double* p, V v) { vst1q_f64(p, v); }
+            static inline V add(V a, V b) { return vaddq_f64(a, b); }
+            static inline V mul(V a, V b) { return vmulq_f64(a, b); }
+            static inline V least(V a, V b) { return vminq_f64(a, b); }
+            static inline V most(V a, V b) { return vmaxq_f64(a, b); }
+            static inline V nans(V seen, V v) {
+                auto ordered = vceqq_f64(v, v);
+                return vreinterpretq_f64_u64(vorrq_u64(vreinterpretq_u64_f64(seen), veorq_u64(ordered, vdupq_n_u64(~0ull))));
+            }
+
+            RIFT_NUMERIC_LOOPS()
+
+            static const Kernels kernels = {Level::NEON, "neon", sum, min, max, dot};
+        }
+        #endif
+
+        #pragma mark - Dispatch
+
+        const Kernels* kernels(Level level)
+        {
+            switch (level) {
+                case Level::SCALAR: return &scalar::kernels;
+                #if RIFT_NUMERIC_X86
+                case Level::SSE2: return __builtin_cpu_supports("sse2") ? &sse2::kernels : nullptr;
+                case Level::AVX2: return __builtin_cpu_supports("avx2") ? &avx2::kernels : nullptr;
+                #endif
+                #if RIFT_NUMERIC_NEON
+                case Level::NEON: return &neon::kernels;
+                #endif
+                default: return nullptr;
+            }
+        }
+
+        const Kernels& kernels()
+        {
+            // the scanner already picked the best level this cpu runs (or the forced one)
+            static const Kernels& best = [] () -> const Kernels& {
+                auto k = numeric::kernels(scanner::simd::kernels().level);
+                return k != nullptr ? *k : scalar::kernels;
+            }();
+            return best;
+        }
+    }
+}
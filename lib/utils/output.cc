@@ -0,0 +1,178 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/output.hh>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <mutex>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace rift
+{
+    #pragma mark - Sinks
+
+    namespace
+    {
+        class FdSink : public Output::Sink
+        {
+            public:
+                FdSink(int fd) : fd(fd), tty(::isatty(fd) == 1) {}
+
+                void write(std::span<const std::string_view> parts) override
+                {
+                    std::vector<iovec> iov;
+                    iov.reserve(parts.size());
+                    for (auto part : parts)
+                        if (!part.empty()) iov.push_back({const_cast<char*>(part.data()), part.size()});
+
+                    for (size_t i = 0; i < iov.size();) {
+                        auto wrote = ::writev(fd, &iov[i], static_cast<int>(std::min<size_t>(iov.size() - i, IOV_MAX)));
+                        if (wrote < 0) {
+                            if (errno == EINTR) continue;
+                            return; // nowhere left to report it
+                        }
+                        // a short write resumes in the middle of a part
+                        auto left = static_cast<size_t>(wrote);
+                        for (; i < iov.size() && left >= iov[i].iov_len; i++) left -= iov[i].iov_len;
+                        if (left > 0) {
+                            iov[i].iov_base = static_cast<char*>(iov[i].iov_base) + left;
+                            iov[i].iov_len -= left;
+                        }
+                    }
+                }
+
+                bool interactive() const override { return tty; }
+
+            private:
+                int fd;
+                bool tty;
+        };
+
+        class MemorySink : public Output::Sink
+        {
+            public:
+                MemorySink(std::string& out) : out(out) {}
+                void write(std::span<const std::string_view> parts) override { for (auto part : parts) out.append(part); }
+
+            private:
+                std::string& out;
+        };
+
+        class CallbackSink : public Output::Sink
+        {
+            public:
+                CallbackSink(std::function<void(std::string_view)> fn) : fn(std::move(fn)) {}
+                void write(std::span<const std::string_view> parts) override { for (auto part : parts) fn(part); }
+
+            private:
+                std::function<void(std::string_view)> fn;
+        };
+
+        /// @brief every live Output, flushed when the process exits without unwinding
+        struct Registry {
+            std::mutex lock;
+            std::vector<Output*> outputs;
+        };
+
+        Registry& registry()
+        {
+            static Registry ret;
+            return ret;
+        }
+    }
+
+    std::unique_ptr<Output::Sink> Output::fd(int fd) { return std::make_unique<FdSink>(fd); }
+    std::unique_ptr<Output::Sink> Output::memory(std::string& out) { return std::make_unique<MemorySink>(out); }
+    std::unique_ptr<Output::Sink> Output::callback(std::function<void(std::string_view)> fn) { return std::make_unique<CallbackSink>(std::move(fn)); }
+
+    #pragma mark - Output
+
+    Output::Output() : sink(fd(STDOUT_FILENO)), flushing(sink->interactive() ? Policy::LINE : Policy::FULL)
+    {
+        buffer.reserve(CAPACITY);
+        auto& reg = registry();
+        std::lock_guard guard(reg.lock);
+        // registered after the registry exists, so it runs before the registry is destroyed
+        static bool registered = std::atexit(flushAll) == 0;
+        (void)registered;
+        reg.outputs.push_back(this);
+    }
+
+    Output::~Output()
+    {
+        flush();
+        auto& reg = registry();
+        std::lock_guard guard(reg.lock);
+        std::erase(reg.outputs, this);
+    }
+
+    void Output::redirect(std::unique_ptr<Sink> sink)
+    {
+        flush();
+        this->sink = std::move(sink);
+        flushing = this->sink->interactive() ? Policy::LINE : Policy::FULL;
+    }
+
+    void Output::write(std::string_view text)
+    {
+        if (!segments.empty() && segments.back().pinned.empty() && segments.back().offset + segments.back().size == buffer.size())
+            segments.back().size += text.size();
+        else
+            segments.push_back({buffer.size(), text.size(), String()});
+        buffer.append(text);
+        size += text.size();
+    }
+
+    void Output::print(const Value& val)
+    {
+        if (val.isString() && val.asString().size() >= PIN_MIN) {
+            // flattened now, the pinned copy keeps the text where the batch points
+            const auto& str = val.asString();
+            str.view();
+            segments.push_back({0, str.size(), str});
+            size += str.size();
+        } else if (val.isString()) {
+            write(val.asString().view());
+        } else {
+            write(printValue(val));
+        }
+        write("\n");
+        if (flushing == Policy::LINE || size >= CAPACITY) flush();
+    }
+
+    void Output::flush()
+    {
+        if (segments.empty()) return;
+        std::vector<std::string_view> parts;
+        parts.reserve(segments.size());
+        for (const auto& segment : segments)
+            parts.push_back(segment.pinned.empty() ? std::string_view(buffer).substr(segment.offset, segment.size) : segment.pinned.view());
+
+        sink->write(parts);
+        segments.clear();
+        buffer.clear();
+        size = 0;
+        batches++;
+    }
+
+    void Output::flushAll()
+    {
+        auto& reg = registry();
+        std::lock_guard guard(reg.lock);
+        for (auto output : reg.outputs) output->flush();
+    }
+}
\ No newline at end of file
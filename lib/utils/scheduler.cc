@@ -0,0 +1,196 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/scheduler.hh>
+#include <chrono>
+#include <functional>
+
+namespace rift
+{
+    namespace
+    {
+        /// @brief no worker, the calling thread isn't one of the pool's
+        constexpr size_t OUTSIDE = SIZE_MAX;
+        /// @brief times an idle worker yields before it goes to sleep
+        constexpr int SPINS = 64;
+        /// @brief how long a waiter sleeps before it looks for work to help with again
+        constexpr auto NAP = std::chrono::microseconds(500);
+
+        /// @brief the pool the current thread works for, and its index in it
+        thread_local Scheduler* owner = nullptr;
+        thread_local size_t self = OUTSIDE;
+
+        /// @brief xorshift, picks the first victim of a steal
+        size_t victim(size_t n)
+        {
+            thread_local uint32_t state = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state % n;
+        }
+
+        std::atomic<size_t> configured{OUTSIDE};
+    }
+
+    #pragma mark - Scheduler
+
+    Scheduler::Scheduler(size_t workers)
+    {
+        queues.reserve(workers);
+        for (size_t i = 0; i < workers; i++) queues.push_back(std::make_unique<Queue>());
+        // every deque exists before any worker may steal from it
+        for (size_t i = 0; i < workers; i++) queues[i]->thread = std::thread([this, i] { work(i); });
+    }
+
+    Scheduler::~Scheduler()
+    {
+        {
+            std::lock_guard guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& queue : queues) queue->thread.join();
+    }
+
+    Scheduler& Scheduler::shared()
+    {
+        static Scheduler pool([] {
+            auto n = configured.load();
+            if (n != OUTSIDE) return n;
+            auto threads = std::thread::hardware_concurrency();
+            return static_cast<size_t>(threads > 1 ? threads - 1 : 0);
+        }());
+        return pool;
+    }
+
+    void Scheduler::configure(size_t workers)
+    {
+        configured.store(workers);
+    }
+
+    Scheduler::Stats Scheduler::stats() const
+    {
+        return {executed.load(std::memory_order_relaxed), stolen.load(std::memory_order_relaxed)};
+    }
+
+    #pragma mark - Tasks
+
+    void Scheduler::spawn(Group& group, Task& task)
+    {
+        task.group = &group;
+        group.pending.fetch_add(1);
+        // counted first, a worker that finds nothing yet just looks again
+        queued.fetch_add(1);
+        if (owner == this) {
+            queues[self]->tasks.push(&task);
+        } else {
+            std::lock_guard guard(lock);
+            injected.push_back(&task);
+            incoming.fetch_add(1);
+        }
+        if (sleeping.load() > 0) {
+            std::lock_guard guard(lock);
+            wake.notify_one();
+        }
+    }
+
+    void Scheduler::wait(Group& group)
+    {
+        auto index = owner == this ? self : OUTSIDE;
+        while (!group.done()) {
+            if (auto task = find(index)) {
+                execute(task);
+                continue;
+            }
+            // the rest of the group is running elsewhere
+            std::unique_lock guard(lock);
+            waiting.fetch_add(1);
+            finished.wait_for(guard, NAP, [&] { return group.done(); });
+            waiting.fetch_sub(1);
+        }
+    }
+
+    Scheduler::Task* Scheduler::find(size_t index)
+    {
+        if (index != OUTSIDE) {
+            if (auto task = queues[index]->tasks.pop()) {
+                queued.fetch_sub(1);
+                return task;
+            }
+        }
+        if (incoming.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard guard(lock);
+            if (!injected.empty()) {
+                auto task = injected.front();
+                injected.pop_front();
+                incoming.fetch_sub(1);
+                queued.fetch_sub(1);
+                return task;
+            }
+        }
+        if (queues.empty()) return nullptr;
+
+        auto first = victim(queues.size());
+        for (size_t i = 0; i < queues.size(); i++) {
+            auto other = (first + i) % queues.size();
+            if (other == index) continue;
+            if (auto task = queues[other]->tasks.steal()) {
+                queued.fetch_sub(1);
+                stolen.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void Scheduler::execute(Task* task)
+    {
+        auto group = task->group;
+        task->run();
+        executed.fetch_add(1, std::memory_order_relaxed);
+        // the waiter may free the group (and the task) as soon as it is done
+        if (group->pending.fetch_sub(1) == 1 && waiting.load() > 0) {
+            std::lock_guard guard(lock);
+            finished.notify_all();
+        }
+    }
+
+    #pragma mark - Workers
+
+    void Scheduler::work(size_t index)
+    {
+        owner = this;
+        self = index;
+        while (true) {
+            if (auto task = find(index)) {
+                execute(task);
+                continue;
+            }
+            // work often comes in bursts, look again for a while before sleeping
+            bool more = false;
+            for (int i = 0; i < SPINS && !more; i++) {
+                std::this_thread::yield();
+                more = queued.load() > 0;
+            }
+            if (more) continue;
+
+            std::unique_lock guard(lock);
+            sleeping.fetch_add(1);
+            wake.wait(guard, [&] { return stopping || queued.load() > 0; });
+            sleeping.fetch_sub(1);
+            if (stopping) return;
+        }
+    }
+}
\ No newline at end of file
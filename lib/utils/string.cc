@@ -0,0 +1,161 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/string.hh>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+namespace rift
+{
+    /// @note the characters follow the header
+    struct String::Buffer : String::Rep
+    {
+        inline char* chars() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    struct String::Rope : String::Rep
+    {
+        String left, right;
+        /// @brief the flattened text, the sides are released once it is set
+        String flat;
+    };
+
+    #pragma mark - Construction
+
+    char* String::reserve(size_t size)
+    {
+        if (size <= INLINE) {
+            small(size);
+            return bytes;
+        }
+        auto buffer = new (::operator new(sizeof(Buffer) + size + 1)) Buffer();
+        buffer->refs = 1;
+        buffer->depth = 0;
+        buffer->size = size;
+        buffer->chars()[size] = '\0';
+        point(buffer);
+        return buffer->chars();
+    }
+
+    String::String(std::string_view str)
+    {
+        std::memcpy(reserve(str.size()), str.data(), str.size());
+    }
+
+    String operator+(const String& left, const String& right)
+    {
+        if (left.empty()) return right;
+        if (right.empty()) return left;
+
+        size_t size = left.size() + right.size();
+        if (size < String::ROPE_MIN) {
+            // both sides are shorter than a rope, so already flat
+            String ret;
+            char* data = ret.reserve(size);
+            auto l = left.view(), r = right.view();
+            std::memcpy(data, l.data(), l.size());
+            std::memcpy(data + l.size(), r.data(), r.size());
+            return ret;
+        }
+
+        auto rope = new String::Rope();
+        rope->refs = 1;
+        rope->depth = std::max(left.depth(), right.depth()) + 1;
+        rope->size = size;
+        rope->left = left;
+        rope->right = right;
+        String ret;
+        ret.point(rope);
+        return ret;
+    }
+
+    void String::release(Rep* rep)
+    {
+        if (rep->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        if (rep->depth == 0) {
+            ::operator delete(rep);
+            return;
+        }
+
+        // a rope built by appending in a loop is as deep as it is long
+        std::vector<Rope*> work = {static_cast<Rope*>(rep)};
+        while (!work.empty()) {
+            auto rope = work.back();
+            work.pop_back();
+            for (auto side : {&rope->left, &rope->right, &rope->flat}) {
+                if (!side->heap()) continue;
+                auto child = side->rep();
+                side->small(0);
+                if (child->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+                if (child->depth == 0) ::operator delete(child);
+                else work.push_back(static_cast<Rope*>(child));
+            }
+            delete rope;
+        }
+    }
+
+    #pragma mark - Access
+
+    bool String::rope() const
+    {
+        return heap() && rep()->depth != 0 && static_cast<Rope*>(rep())->flat.empty();
+    }
+
+    std::string_view String::view() const
+    {
+        if (!heap()) return std::string_view(bytes, size());
+        auto rep = this->rep();
+        if (rep->depth == 0) return std::string_view(static_cast<Buffer*>(rep)->chars(), rep->size);
+
+        auto rope = static_cast<Rope*>(rep);
+        if (!rope->flat.empty()) return rope->flat.view();
+
+        String flat;
+        char* data = flat.reserve(rope->size);
+        // leaves left to right, a side that was flattened already is copied whole
+        std::vector<const String*> work = {&rope->right, &rope->left};
+        while (!work.empty()) {
+            auto next = work.back();
+            work.pop_back();
+            if (next->heap() && next->rep()->depth != 0 && static_cast<Rope*>(next->rep())->flat.empty()) {
+                auto side = static_cast<Rope*>(next->rep());
+                work.push_back(&side->right);
+                work.push_back(&side->left);
+                continue;
+            }
+            auto part = next->view();
+            std::memcpy(data, part.data(), part.size());
+            data += part.size();
+        }
+
+        rope->flat = std::move(flat);
+        rope->left = String();
+        rope->right = String();
+        return rope->flat.view();
+    }
+
+    int String::compare(const String& other) const
+    {
+        if (heap() && other.heap() && rep() == other.rep()) return 0;
+        return view().compare(other.view());
+    }
+
+    bool operator==(const String& left, const String& right)
+    {
+        if (left.size() != right.size()) return false;
+        if (left.heap() && right.heap() && left.rep() == right.rep()) return true;
+        return left.view() == right.view();
+    }
+}
\ No newline at end of file
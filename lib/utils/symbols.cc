@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/symbols.hh>
+#include <stdexcept>
+
+namespace rift
+{
+    static constexpr SymbolId EMPTY_BUCKET = UINT32_MAX;
+
+    Symbols::Symbols() : chunks(new std::unique_ptr<std::string[]>[CHUNKS])
+    {
+        buckets.assign(1024, EMPTY_BUCKET);
+        intern("");
+    }
+
+    uint64_t Symbols::hash(std::string_view name)
+    {
+        // FNV-1a, identifiers are short
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (unsigned char c : name) {
+            h ^= c;
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    SymbolId Symbols::insert(std::string_view name)
+    {
+        auto h = hash(name);
+        auto mask = buckets.size() - 1;
+        size_t i = h & mask;
+        for (; buckets[i] != EMPTY_BUCKET; i = (i + 1) & mask) {
+            auto id = buckets[i];
+            if (hashes[id] == h && this->name(id) == name) return id;
+        }
+
+        auto n = count.load(std::memory_order_relaxed);
+        if (n == CHUNK * CHUNKS) throw std::length_error("too many symbols");
+        auto& chunk = chunks[n / CHUNK];
+        if (!chunk) chunk.reset(new std::string[CHUNK]);
+        chunk[n % CHUNK] = name;
+        // published once the name is in place, to whoever is handed the id after this
+        count.store(n + 1, std::memory_order_release);
+
+        auto id = static_cast<SymbolId>(n);
+        hashes.push_back(h);
+        buckets[i] = id;
+        if ((n + 1) * 2 > buckets.size()) grow();
+        return id;
+    }
+
+    void Symbols::grow()
+    {
+        buckets.assign(buckets.size() * 2, EMPTY_BUCKET);
+        auto mask = buckets.size() - 1;
+        for (SymbolId id = 0; id < hashes.size(); id++) {
+            size_t i = hashes[id] & mask;
+            while (buckets[i] != EMPTY_BUCKET) i = (i + 1) & mask;
+            buckets[i] = id;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <utils/value.hh>
+#include <utils/literals.hh>
+#include <error/error.hh>
+
+namespace rift
+{
+    bool equal(const Value& left, const Value& right)
+    {
+        if (left.type != right.type) return false;
+        switch (left.type) {
+            case ValueType::NIL: return true;
+            case ValueType::BOOL: return left.as.boolean == right.as.boolean;
+            case ValueType::NUMBER: return left.as.number == right.as.number;
+            case ValueType::OBJ:
+                if (left.isString() && right.isString()) return left.asString() == right.asString();
+                if (left.isArray() && right.isArray()) return left.asArray()->items == right.asArray()->items;
+                return false;
+            default: return false;
+        }
+    }
+
+    /// @brief the elements of an array, as in `[1, 2, 3]`
+    static std::string printArray(const ObjArray& arr)
+    {
+        std::string ret = "[";
+        for (size_t i = 0; i < arr.items.size(); i++) {
+            if (i > 0) ret += ", ";
+            ret += formatNumber(arr.items[i]);
+        }
+        return ret + "]";
+    }
+
+    std::string printValue(const Value& val)
+    {
+        switch (val.type) {
+            case ValueType::NIL: return "nil";
+            case ValueType::BOOL: return val.as.boolean ? "true" : "false";
+            case ValueType::NUMBER: return formatNumber(val.as.number);
+            case ValueType::OBJ:
+                if (val.isString()) return val.asString().str();
+                if (val.isArray()) return printArray(*val.asArray());
+                [[fallthrough]];
+            default:
+                rift::error::runTimeError("Expected a string or number");
+                return "";
+        }
+    }
+
+    std::string resultValue(const Value& val)
+    {
+        switch (val.type) {
+            case ValueType::NIL: return "null";
+            case ValueType::BOOL: return val.as.boolean ? "true" : "false";
+            case ValueType::NUMBER: return formatNumber(val.as.number);
+            case ValueType::OBJ:
+                if (val.isString()) return val.asString().str();
+                if (val.isArray()) return printArray(*val.asArray());
+                [[fallthrough]];
+            default: return "undefined";
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,363 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <vm/cache.hh>
+#include <vm/opcodes.hh>
+#include <utils/builtins.hh>
+#include <utils/mapped_file.hh>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+namespace rift
+{
+    namespace vm
+    {
+        #pragma mark - Layout
+
+        /// @details header, the global names, then the main function. A function is its name,
+        ///          arity, code, line table and constants, function constants are written in
+        ///          place (depth first), so functions load back in the order they were compiled.
+        ///          The header ends with a checksum of everything after it
+        static constexpr uint32_t MAGIC = 0x43464952; // "RIFC"
+
+        /// @brief every opcode name in order, a cache from another opcode set never loads
+        static constexpr const char OPCODES[] =
+            #define __RIFT_OPCODE_NAME(name) #name ","
+            RIFT_OPCODES(__RIFT_OPCODE_NAME)
+            #undef __RIFT_OPCODE_NAME
+            "";
+
+        struct Header {
+            uint32_t magic;
+            uint32_t format;
+            uint64_t key;
+            uint64_t sum;
+        };
+
+        enum class Tag : uint8_t { NIL, BOOL, NUMBER, STRING, FUNCTION };
+
+        /// @brief FNV-1a, continuing from h
+        static uint64_t fnv(std::string_view bytes, uint64_t h = 0xcbf29ce484222325ull)
+        {
+            for (unsigned char c : bytes) {
+                h ^= c;
+                h *= 0x100000001b3ull;
+            }
+            return h;
+        }
+
+        #pragma mark - Writing
+
+        struct Output {
+            std::string bytes;
+
+            template <typename T>
+            inline void put(T val) { bytes.append(reinterpret_cast<const char*>(&val), sizeof(T)); }
+            inline void str(std::string_view str) { put(static_cast<uint32_t>(str.size())); bytes.append(str); }
+        };
+
+        static void writeFunction(Output& out, const ObjFunction& fn)
+        {
+            out.str(fn.name);
+            out.put(static_cast<uint32_t>(fn.arity));
+
+            const auto& chunk = fn.chunk;
+            out.put(static_cast<uint32_t>(chunk.code.size()));
+            out.bytes.append(reinterpret_cast<const char*>(chunk.code.data()), chunk.code.size());
+            for (auto line : chunk.lines) out.put(static_cast<int32_t>(line));
+
+            out.put(static_cast<uint32_t>(chunk.constants.size()));
+            for (const auto& val : chunk.constants) {
+                if (val.isString()) {
+                    out.put(Tag::STRING);
+                    out.str(val.asString().view());
+                } else if (val.isFunction()) {
+                    out.put(Tag::FUNCTION);
+                    writeFunction(out, *val.asFunction());
+                } else if (val.isNumber()) {
+                    out.put(Tag::NUMBER);
+                    out.put(val.as.number);
+                } else if (val.isBool()) {
+                    out.put(Tag::BOOL);
+                    out.put(val.as.boolean);
+                } else {
+                    out.put(Tag::NIL);
+                }
+            }
+        }
+
+        #pragma mark - Reading
+
+        /// @note every read is bounds checked, a short file just fails (a corrupt one fails
+        ///       its checksum, and code that passes it is still verified before it runs)
+        struct Input {
+            const char* at;
+            const char* end;
+            bool ok = true;
+
+            template <typename T>
+            inline T get() {
+                T val{};
+                if (static_cast<size_t>(end - at) < sizeof(T)) { ok = false; return val; }
+                std::memcpy(&val, at, sizeof(T));
+                at += sizeof(T);
+                return val;
+            }
+            inline std::string_view bytes(size_t len) {
+                if (static_cast<size_t>(end - at) < len) { ok = false; return {}; }
+                std::string_view view(at, len);
+                at += len;
+                return view;
+            }
+            inline std::string_view str() { return bytes(get<uint32_t>()); }
+        };
+
+        /// @brief true when the code of fn can't take the VM outside the script, its own code
+        ///        or its frame: every reachable instruction is whole and known, its constants,
+        ///        globals and builtins exist, its jumps land inside the code and no path runs
+        ///        off the end. Each instruction is also reached with one stack depth, so pops
+        ///        stay above the frame's function and locals below the top
+        static bool verify(const ObjFunction& fn, const Script& script)
+        {
+            const auto& code = fn.chunk.code;
+            if (code.empty()) return false;
+            // -1 until reached, the depth counts the function and its arguments
+            std::vector<int64_t> depth(code.size(), -1);
+            std::vector<size_t> work;
+            auto reach = [&](size_t at, int64_t d) {
+                if (at >= code.size()) return false;
+                if (depth[at] == -1) {
+                    depth[at] = d;
+                    work.push_back(at);
+                }
+                return depth[at] == d;
+            };
+            reach(0, 1 + static_cast<int64_t>(fn.arity));
+
+            while (!work.empty()) {
+                size_t at = work.back();
+                work.pop_back();
+                int64_t d = depth[at];
+                auto op = static_cast<OpCode>(code[at]);
+
+                size_t len = 1;
+                switch (op) {
+                    case OP_CALL: len = 2; break;
+                    case OP_CONSTANT: case OP_GET_GLOBAL: case OP_SET_GLOBAL: case OP_DEFINE_GLOBAL:
+                    case OP_DEFINE_CONST: case OP_DEFINE_FUNC: case OP_GET_LOCAL: case OP_SET_LOCAL:
+                    case OP_RESERVE: case OP_POPN: case OP_JUMP: case OP_JUMP_IF_FALSE:
+                    case OP_JUMP_IF_NOT_NIL: case OP_LOOP: case OP_ARRAY: case OP_GET_BUILTIN:
+                    case OP_CALL_BUILTIN: len = 3; break;
+                    default: if (op >= OP_COUNT) return false; break;
+                }
+                if (at + len > code.size()) return false;
+                uint16_t arg = len == 3 ? static_cast<uint16_t>(code[at + 1] << 8 | code[at + 2]) : len == 2 ? code[at + 1] : 0;
+                size_t next = at + len;
+
+                // what the instruction takes off the stack and leaves on it, peeks are both
+                int64_t pops = 0, pushes = 0;
+                bool falls = true;
+                size_t target = SIZE_MAX;
+                switch (op) {
+                    case OP_CONSTANT:
+                        if (arg >= fn.chunk.constants.size()) return false;
+                        pushes = 1;
+                        break;
+                    case OP_NIL: case OP_TRUE: case OP_FALSE: pushes = 1; break;
+                    case OP_POP: pops = 1; break;
+                    case OP_GET_GLOBAL: case OP_GET_BUILTIN:
+                        if (arg >= script.globals.size()) return false;
+                        pushes = 1;
+                        break;
+                    case OP_SET_GLOBAL: case OP_DEFINE_GLOBAL: case OP_DEFINE_CONST:
+                        if (arg >= script.globals.size()) return false;
+                        pops = pushes = 1;
+                        break;
+                    case OP_DEFINE_FUNC:
+                        if (arg >= script.globals.size()) return false;
+                        pops = 1;
+                        break;
+                    case OP_GET_LOCAL:
+                        if (arg >= d) return false;
+                        pushes = 1;
+                        break;
+                    case OP_SET_LOCAL:
+                        if (arg >= d) return false;
+                        pops = pushes = 1;
+                        break;
+                    case OP_RESERVE: pushes = arg; break;
+                    case OP_POPN: pops = arg; break;
+                    case OP_ADD: case OP_SUBTRACT: case OP_MULTIPLY: case OP_DIVIDE:
+                    case OP_EQUAL: case OP_NOT_EQUAL: case OP_GREATER: case OP_GREATER_EQUAL:
+                    case OP_LESS: case OP_LESS_EQUAL: case OP_GET_INDEX:
+                        pops = 2;
+                        pushes = 1;
+                        break;
+                    case OP_NEGATE: case OP_NOT: case OP_TO_BOOL: case OP_PRINT: pops = pushes = 1; break;
+                    case OP_JUMP: falls = false; target = next + arg; break;
+                    case OP_JUMP_IF_FALSE: pops = 1; target = next + arg; break;
+                    case OP_JUMP_IF_NOT_NIL: pops = pushes = 1; target = next + arg; break;
+                    case OP_LOOP:
+                        if (arg > next) return false;
+                        falls = false;
+                        target = next - arg;
+                        break;
+                    case OP_CALL:
+                        pops = arg + 1;
+                        pushes = 1;
+                        break;
+                    case OP_RETURN: pops = 1; falls = false; break;
+                    case OP_ARRAY:
+                        pops = arg;
+                        pushes = 1;
+                        break;
+                    case OP_SET_INDEX:
+                        pops = 3;
+                        pushes = 1;
+                        break;
+                    case OP_CALL_BUILTIN: {
+                        auto builtin = static_cast<builtins::Builtin>(code[at + 1]);
+                        if (builtin == builtins::Builtin::NONE || builtin > builtins::Builtin::MAP) return false;
+                        pops = code[at + 2] + 1;
+                        pushes = 1;
+                        break;
+                    }
+                    case OP_RESULT: pops = 1; break;
+                    case OP_HALT: falls = false; break;
+                    default: return false;
+                }
+
+                // slot 0, the running function, is never popped
+                if (d - pops < 1) return false;
+                int64_t after = d - pops + pushes;
+                if (falls && !reach(next, after)) return false;
+                if (target != SIZE_MAX && !reach(target, after)) return false;
+            }
+            return true;
+        }
+
+        static ObjFunction* readFunction(Input& in, Script& script)
+        {
+            auto fn = script.newFunction(std::string(in.str()));
+            fn->arity = in.get<uint32_t>();
+
+            auto& chunk = fn->chunk;
+            auto code = in.bytes(in.get<uint32_t>());
+            chunk.code.assign(code.begin(), code.end());
+            chunk.lines.resize(code.size());
+            for (auto& line : chunk.lines) line = in.get<int32_t>();
+
+            auto constants = in.get<uint32_t>();
+            if (!in.ok || constants > static_cast<size_t>(in.end - in.at)) { in.ok = false; return fn; }
+            chunk.constants.reserve(constants);
+            for (uint32_t i = 0; i < constants && in.ok; i++) {
+                switch (in.get<Tag>()) {
+                    case Tag::NIL: chunk.constants.push_back(Value::nil()); break;
+                    case Tag::BOOL: chunk.constants.push_back(Value::boolean(in.get<bool>())); break;
+                    case Tag::NUMBER: chunk.constants.push_back(Value::number(in.get<double>())); break;
+                    case Tag::STRING: chunk.constants.push_back(Value::object(script.newString(std::string(in.str())))); break;
+                    case Tag::FUNCTION: chunk.constants.push_back(Value::object(readFunction(in, script))); break;
+                    default: in.ok = false; break;
+                }
+            }
+            if (in.ok && !verify(*fn, script)) in.ok = false;
+            return fn;
+        }
+
+        #pragma mark - Script Cache
+
+        uint64_t ScriptCache::key(std::span<const char> source)
+        {
+            auto build = fnv(OPCODES, fnv(std::string_view(reinterpret_cast<const char*>(&FORMAT), sizeof(FORMAT))));
+            return fnv(std::string_view(source.data(), source.size()), build);
+        }
+
+        std::string ScriptCache::path(const std::string& file, uint64_t key)
+        {
+            const char* xdg = std::getenv("XDG_CACHE_HOME");
+            if (xdg == nullptr || *xdg == '\0') return file + "c";
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.rfc", static_cast<unsigned long long>(key));
+            return (std::filesystem::path(xdg) / "rift" / name).string();
+        }
+
+        std::string ScriptCache::encode(uint64_t key, const Script& script, const Symbols& symbols)
+        {
+            Output out;
+            out.put(Header{MAGIC, FORMAT, key, 0});
+            out.put(static_cast<uint32_t>(script.globals.size()));
+            for (auto name : script.globals) out.str(symbols.name(name));
+            writeFunction(out, *script.main);
+
+            uint64_t sum = fnv(std::string_view(out.bytes).substr(sizeof(Header)));
+            std::memcpy(out.bytes.data() + offsetof(Header, sum), &sum, sizeof(sum));
+            return std::move(out.bytes);
+        }
+
+        std::unique_ptr<Script> ScriptCache::decode(std::span<const char> bytes, uint64_t key, Symbols& symbols)
+        {
+            Input in{bytes.data(), bytes.data() + bytes.size()};
+            auto header = in.get<Header>();
+            if (!in.ok || header.magic != MAGIC || header.format != FORMAT || header.key != key) return nullptr;
+            if (header.sum != fnv(std::string_view(in.at, static_cast<size_t>(in.end - in.at)))) return nullptr;
+
+            auto script = std::make_unique<Script>();
+            auto globals = in.get<uint32_t>();
+            for (uint32_t i = 0; i < globals && in.ok; i++)
+                script->global(symbols.intern(in.str()));
+            script->main = readFunction(in, *script);
+
+            if (!in.ok || in.at != in.end) return nullptr;
+            return script;
+        }
+
+        std::unique_ptr<Script> ScriptCache::load(const std::string& path, uint64_t key, Symbols& symbols)
+        {
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(path, ec)) return nullptr;
+            auto file = MappedFile::open(path);
+            if (!file) return nullptr;
+            return decode(file->span(), key, symbols);
+        }
+
+        bool ScriptCache::store(const std::string& path, uint64_t key, const Script& script, const Symbols& symbols)
+        {
+            auto bytes = encode(key, script, symbols);
+
+            // written aside and renamed over, a reader never sees half a file
+            std::error_code ec;
+            auto target = std::filesystem::path(path);
+            if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path(), ec);
+            auto temp = path + ".tmp" + std::to_string(getpid());
+            {
+                std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+                if (!file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+                    std::filesystem::remove(temp, ec);
+                    return false;
+                }
+            }
+            std::filesystem::rename(temp, target, ec);
+            if (!ec) return true;
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <vm/chunk.hh>
+#include <vm/opcodes.hh>
+#include <utils/builtins.hh>
+#include <error/error.hh>
+#include <sstream>
+#include <iomanip>
+
+namespace rift
+{
+    namespace vm
+    {
+        #pragma mark - OpCode
+
+        const char* opcodeName(OpCode op)
+        {
+            static const char* names[] = {
+                #define __RIFT_OPCODE_NAME(name) #name,
+                RIFT_OPCODES(__RIFT_OPCODE_NAME)
+                #undef __RIFT_OPCODE_NAME
+            };
+            return op < OP_COUNT ? names[op] : "UNKNOWN";
+        }
+
+        #pragma mark - Chunk
+
+        uint16_t Chunk::addConstant(Value val)
+        {
+            if (constants.size() > UINT16_MAX)
+                rift::error::report(lines.empty() ? 0 : lines.back(), "addConstant", "Too many constants in one chunk", rift::scanner::Token(), std::exception());
+            constants.push_back(val);
+            return static_cast<uint16_t>(constants.size() - 1);
+        }
+
+        std::string Chunk::disassemble(const std::string& name) const
+        {
+            std::ostringstream out;
+            out << "== " << name << " ==" << std::endl;
+            for (size_t i = 0; i < code.size();) {
+                auto op = static_cast<OpCode>(code[i]);
+                out << std::setw(4) << std::setfill('0') << i << " " << std::setw(4) << std::setfill(' ') << lines[i] << " " << opcodeName(op);
+                size_t operand = i + 1 < code.size() ? code[i+1] : 0;
+                size_t wide = i + 2 < code.size() ? (operand << 8) | code[i+2] : 0;
+                switch (op) {
+                    case OP_CONSTANT:
+                        out << " " << wide << " '" << resultValue(constants[wide]) << "'";
+                        i += 3; break;
+                    case OP_GET_GLOBAL: case OP_SET_GLOBAL: case OP_DEFINE_GLOBAL:
+                    case OP_DEFINE_CONST: case OP_DEFINE_FUNC:
+                    case OP_GET_LOCAL: case OP_SET_LOCAL: case OP_RESERVE: case OP_POPN:
+                    case OP_ARRAY: case OP_GET_BUILTIN:
+                        out << " " << wide;
+                        i += 3; break;
+                    case OP_JUMP: case OP_JUMP_IF_FALSE: case OP_JUMP_IF_NOT_NIL:
+                        out << " -> " << i + 3 + wide;
+                        i += 3; break;
+                    case OP_LOOP:
+                        out << " -> " << i + 3 - wide;
+                        i += 3; break;
+                    case OP_CALL:
+                        out << " " << operand;
+                        i += 2; break;
+                    case OP_CALL_BUILTIN:
+                        out << " " << builtins::name(static_cast<builtins::Builtin>(operand)) << " " << (i + 2 < code.size() ? code[i+2] : 0);
+                        i += 3; break;
+                    default:
+                        i += 1; break;
+                }
+                out << std::endl;
+            }
+            return out.str();
+        }
+
+        #pragma mark - Script
+
+        ObjString* Script::newString(String str)
+        {
+            auto obj = std::make_unique<ObjString>(std::move(str));
+            auto ret = obj.get();
+            objects.push_back(std::move(obj));
+            return ret;
+        }
+
+        ObjFunction* Script::newFunction(std::string name)
+        {
+            auto obj = std::make_unique<ObjFunction>(std::move(name));
+            obj->script = this;
+            auto ret = obj.get();
+            objects.push_back(std::move(obj));
+            return ret;
+        }
+
+        uint16_t Script::global(SymbolId name)
+        {
+            if (auto idx = global_index.find(name)) return *idx;
+            if (globals.size() > UINT16_MAX)
+                rift::error::report(0, "global", "Too many globals in one script", rift::scanner::Token(), std::exception());
+            globals.push_back(name);
+            return *global_index.emplace(name, static_cast<uint16_t>(globals.size() - 1)).first;
+        }
+
+        std::string Script::disassemble() const
+        {
+            std::string res = main->chunk.disassemble("<script>");
+            for (const auto& obj : objects)
+                if (obj->type == ObjType::FUNCTION && obj.get() != main)
+                    res += static_cast<ObjFunction*>(obj.get())->chunk.disassemble(static_cast<ObjFunction*>(obj.get())->name);
+            return res;
+        }
+    }
+}
\ No newline at end of file
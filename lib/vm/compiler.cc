@@ -0,0 +1,461 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <vm/compiler.hh>
+#include <error/error.hh>
+
+namespace rift
+{
+    namespace vm
+    {
+        #pragma mark - Public API
+
+        std::unique_ptr<Script> Compiler::compile(const Program& prgm)
+        {
+            auto ret = std::make_unique<Script>();
+            script = ret.get();
+            function = script->main = script->newFunction("<script>");
+            strings.clear();
+            scopes.clear();
+            locals = 0;
+
+            prgm.accept(*this);
+            emit(OP_HALT);
+
+            script = nullptr;
+            function = nullptr;
+            return ret;
+        }
+
+        #pragma mark - Emitters
+
+        void Compiler::emitConstant(Value val) const
+        {
+            emit(OP_CONSTANT, chunk().addConstant(val));
+        }
+
+        size_t Compiler::emitJump(OpCode op) const
+        {
+            emit(op, 0xffff);
+            return chunk().code.size() - 2;
+        }
+
+        void Compiler::patchJump(size_t offset) const
+        {
+            size_t jump = chunk().code.size() - offset - 2;
+            if (jump > UINT16_MAX)
+                rift::error::report(line, "patchJump", "Too much code to jump over", Token(), CompilerException("Too much code to jump over"));
+            chunk().code[offset] = (jump >> 8) & 0xff;
+            chunk().code[offset+1] = jump & 0xff;
+        }
+
+        void Compiler::emitLoop(size_t loop_start) const
+        {
+            size_t jump = chunk().code.size() - loop_start + 3;
+            if (jump > UINT16_MAX)
+                rift::error::report(line, "emitLoop", "Loop body too large", Token(), CompilerException("Loop body too large"));
+            emit(OP_LOOP, static_cast<uint16_t>(jump));
+        }
+
+        #pragma mark - Locals
+
+        void Compiler::beginScope(uint32_t slots) const
+        {
+            if (locals + slots + 1 > UINT16_MAX)
+                rift::error::report(line, "beginScope", "Too many local variables in one function", Token(), CompilerException("Too many local variables in one function"));
+            scopes.push_back(locals);
+            locals += slots;
+            if (slots > 0) emit(OP_RESERVE, static_cast<uint16_t>(slots));
+        }
+
+        void Compiler::endScope() const
+        {
+            auto slots = locals - scopes.back();
+            locals = scopes.back();
+            scopes.pop_back();
+            if (slots > 0) emit(OP_POPN, static_cast<uint16_t>(slots));
+        }
+
+        #pragma mark - Expressions
+
+        Value Compiler::visit_literal(const Literal& expr) const
+        {
+            const Token& val = expr.value;
+            line = val.line;
+            switch (val.type) {
+                case TokenType::NIL: emit(OP_NIL); break;
+                case TokenType::TRUE: emit(OP_TRUE); break;
+                case TokenType::FALSE: emit(OP_FALSE); break;
+                // converted once by the parser (or the optimizer), the lexeme is only for display
+                case TokenType::NUMERICLITERAL:
+                    emitConstant(expr.constant);
+                    break;
+                case TokenType::STRINGLITERAL: {
+                    auto str = expr.constant.asString().str();
+                    auto it = strings.find(str);
+                    ObjString* obj = it != strings.end() ? it->second : (strings[str] = script->newString(str));
+                    emitConstant(Value::object(obj));
+                    break;
+                }
+                case TokenType::IDENTIFIER:
+                case TokenType::C_IDENTIFIER:
+                    if (expr.addr.global()) emit(OP_GET_GLOBAL, script->global(val.symbol));
+                    else emit(OP_GET_LOCAL, local(expr.addr));
+                    break;
+                default:
+                    rift::error::report(line, "visit_literal", "Unknown literal type", val, CompilerException("Unknown literal type"));
+            }
+            return Value();
+        }
+
+        Value Compiler::visit_binary(const Binary& expr) const
+        {
+            size_t jump, end;
+            switch (expr.op.type) {
+                // short circuiting operators
+                case TokenType::NULLISH_COAL:
+                    expr.left->accept(*this);
+                    jump = emitJump(OP_JUMP_IF_NOT_NIL);
+                    emit(OP_POP);
+                    expr.right->accept(*this);
+                    patchJump(jump);
+                    return Value();
+                case TokenType::LOG_AND:
+                    expr.left->accept(*this);
+                    jump = emitJump(OP_JUMP_IF_FALSE);
+                    expr.right->accept(*this);
+                    emit(OP_TO_BOOL);
+                    end = emitJump(OP_JUMP);
+                    patchJump(jump);
+                    emit(OP_FALSE);
+                    patchJump(end);
+                    return Value();
+                case TokenType::LOG_OR:
+                    expr.left->accept(*this);
+                    jump = emitJump(OP_JUMP_IF_FALSE);
+                    emit(OP_TRUE);
+                    end = emitJump(OP_JUMP);
+                    patchJump(jump);
+                    expr.right->accept(*this);
+                    emit(OP_TO_BOOL);
+                    patchJump(end);
+                    return Value();
+                default:
+                    break;
+            }
+
+            expr.left->accept(*this);
+            expr.right->accept(*this);
+            line = expr.op.line;
+
+            switch (expr.op.type) {
+                case TokenType::PLUS: emit(OP_ADD); break;
+                case TokenType::MINUS: emit(OP_SUBTRACT); break;
+                case TokenType::STAR: emit(OP_MULTIPLY); break;
+                case TokenType::SLASH: emit(OP_DIVIDE); break;
+                case TokenType::GREATER: emit(OP_GREATER); break;
+                case TokenType::GREATER_EQUAL: emit(OP_GREATER_EQUAL); break;
+                case TokenType::LESS: emit(OP_LESS); break;
+                case TokenType::LESS_EQUAL: emit(OP_LESS_EQUAL); break;
+                case TokenType::EQUAL_EQUAL: emit(OP_EQUAL); break;
+                case TokenType::BANG_EQUAL: emit(OP_NOT_EQUAL); break;
+                default:
+                    rift::error::report(line, "visit_binary", "Unknown operator for a binary expression", expr.op, CompilerException("Unknown operator for a binary expression"));
+            }
+            return Value();
+        }
+
+        Value Compiler::visit_assign(const Assign& expr) const
+        {
+            expr.value->accept(*this);
+            line = expr.name.line;
+            if (expr.addr.global()) emit(OP_SET_GLOBAL, script->global(expr.name.symbol));
+            else emit(OP_SET_LOCAL, local(expr.addr));
+            return Value();
+        }
+
+        Value Compiler::visit_grouping(const Grouping& expr) const
+        {
+            return expr.expr->accept(*this);
+        }
+
+        Value Compiler::visit_unary(const Unary& expr) const
+        {
+            expr.expr->accept(*this);
+            line = expr.op.line;
+            switch (expr.op.type) {
+                case TokenType::MINUS: emit(OP_NEGATE); break;
+                case TokenType::BANG: emit(OP_NOT); break;
+                default:
+                    rift::error::report(line, "visit_unary", "Unknown operator for a unary expression", expr.op, CompilerException("Unknown operator for a unary expression"));
+            }
+            return Value();
+        }
+
+        Value Compiler::visit_ternary(const Ternary& expr) const
+        {
+            expr.condition->accept(*this);
+            auto jump = emitJump(OP_JUMP_IF_FALSE);
+            expr.left->accept(*this);
+            auto end = emitJump(OP_JUMP);
+            patchJump(jump);
+            expr.right->accept(*this);
+            patchJump(end);
+            return Value();
+        }
+
+        Value Compiler::visit_call(const Call& expr) const
+        {
+            // a builtin's name is read even when undefined, CALL_BUILTIN tells the two apart
+            bool builtin = expr.builtin != builtins::Builtin::NONE;
+            if (builtin) emit(OP_GET_BUILTIN, script->global(static_cast<const Literal*>(expr.name)->value.symbol));
+            else expr.name->accept(*this);
+            if (expr.args.size() > UINT8_MAX)
+                rift::error::report(line, "visit_call", "Too many arguments", Token(), CompilerException("Too many arguments"));
+            for (const auto& arg : expr.args)
+                arg->accept(*this);
+            if (builtin) {
+                emit(OP_CALL_BUILTIN);
+                emit(static_cast<uint8_t>(expr.builtin));
+            } else emit(OP_CALL);
+            emit(static_cast<uint8_t>(expr.args.size()));
+            return Value();
+        }
+
+        Value Compiler::visit_spawn(const Spawn& expr) const
+        {
+            rift::error::report(expr.keyword.line, "visit_spawn", "Tasks are only run by the tree engines (--engine=tree or tiered)", expr.keyword, CompilerException("Tasks are only run by the tree engines"));
+            return Value();
+        }
+
+        Value Compiler::visit_await(const Await& expr) const
+        {
+            rift::error::report(expr.keyword.line, "visit_await", "Tasks are only run by the tree engines (--engine=tree or tiered)", expr.keyword, CompilerException("Tasks are only run by the tree engines"));
+            return Value();
+        }
+
+        Value Compiler::visit_array(const Array& expr) const
+        {
+            if (expr.elements.size() > UINT16_MAX)
+                rift::error::report(expr.bracket.line, "visit_array", "Too many array elements", expr.bracket, CompilerException("Too many array elements"));
+            for (const auto& element : expr.elements)
+                element->accept(*this);
+            line = expr.bracket.line;
+            emit(OP_ARRAY, static_cast<uint16_t>(expr.elements.size()));
+            return Value();
+        }
+
+        Value Compiler::visit_index(const Index& expr) const
+        {
+            expr.target->accept(*this);
+            expr.index->accept(*this);
+            line = expr.bracket.line;
+            emit(OP_GET_INDEX);
+            return Value();
+        }
+
+        Value Compiler::visit_set_index(const SetIndex& expr) const
+        {
+            expr.target->accept(*this);
+            expr.index->accept(*this);
+            expr.value->accept(*this);
+            line = expr.bracket.line;
+            emit(OP_SET_INDEX);
+            return Value();
+        }
+
+        #pragma mark - Statements
+
+        Value Compiler::visit_expr_stmt(const StmtExpr& stmt) const
+        {
+            return stmt.expr->accept(*this);
+        }
+
+        Value Compiler::visit_print_stmt(const StmtPrint& stmt) const
+        {
+            stmt.expr->accept(*this);
+            emit(OP_PRINT);
+            return Value();
+        }
+
+        void Compiler::branch(const StmtIf::Stmt& branch) const
+        {
+            if (branch.blk != nullptr) branch.blk->accept(*this);
+            else if (branch.stmt != nullptr) {
+                branch.stmt->accept(*this);
+                emit(OP_POP);
+            }
+            else rift::error::report(line, "visit_if_stmt", "If statement should have a statement or block", Token(), CompilerException("If statement should have a statement or block"));
+        }
+
+        Value Compiler::visit_if_stmt(const StmtIf& stmt) const
+        {
+            std::vector<size_t> ends;
+            std::vector<const StmtIf::Stmt*> arms = {stmt.if_stmt};
+            arms.insert(arms.end(), stmt.elif_stmts.begin(), stmt.elif_stmts.end());
+
+            for (const auto arm : arms) {
+                if (arm->expr == nullptr)
+                    rift::error::report(line, "visit_if_stmt", "If statement expression should not be null", Token(), CompilerException("If statement expression should not be null"));
+                arm->expr->accept(*this);
+                auto next = emitJump(OP_JUMP_IF_FALSE);
+                branch(*arm);
+                ends.push_back(emitJump(OP_JUMP));
+                patchJump(next);
+            }
+
+            if (stmt.else_stmt != nullptr) branch(*stmt.else_stmt);
+            for (auto end : ends) patchJump(end);
+
+            // an if statement evaluates to nil
+            emit(OP_NIL);
+            return Value();
+        }
+
+        Value Compiler::visit_return_stmt(const StmtReturn& stmt) const
+        {
+            if (stmt.expr != nullptr) stmt.expr->accept(*this);
+            else emit(OP_NIL);
+            emit(OP_RETURN);
+            return Value();
+        }
+
+        #pragma mark - Declarations
+
+        void Compiler::discard(const Decl& decl) const
+        {
+            if (!decl.accept(*this).empty()) emit(OP_POP);
+        }
+
+        Values Compiler::visit_decl_stmt(const DeclStmt& decl) const
+        {
+            decl.stmt->accept(*this);
+            return {Value()};
+        }
+
+        Values Compiler::visit_decl_var(const DeclVar& decl) const
+        {
+            if (decl.expr != nullptr) decl.expr->accept(*this);
+            else emit(OP_NIL);
+            line = decl.identifier.line;
+            if (!decl.addr.global()) {
+                // constness of locals is checked by the Resolver
+                emit(OP_SET_LOCAL, local(decl.addr));
+                return {Value()};
+            }
+            auto op = decl.identifier.type == TokenType::C_IDENTIFIER ? OP_DEFINE_CONST : OP_DEFINE_GLOBAL;
+            emit(op, script->global(decl.identifier.symbol));
+            return {Value()};
+        }
+
+        Values Compiler::visit_decl_func(const DeclFunc& decl) const
+        {
+            const auto& name = decl.func->name;
+            line = name.line;
+
+            auto enclosing = function;
+            auto enclosing_scopes = std::move(scopes);
+            auto enclosing_locals = locals;
+            auto compiled = script->newFunction(name.lexeme);
+            compiled->arity = static_cast<unsigned>(decl.func->params.size());
+
+            function = compiled;
+            scopes.clear();
+            locals = 0;
+            if (const Block* body = decl.func->body()) {
+                // parameters and the body's locals share one scope, the call already pushed the arguments
+                if (body->slots + 1 > UINT16_MAX)
+                    rift::error::report(line, "beginScope", "Too many local variables in one function", Token(), CompilerException("Too many local variables in one function"));
+                scopes.push_back(0);
+                locals = body->slots;
+                if (body->slots > compiled->arity) emit(OP_RESERVE, static_cast<uint16_t>(body->slots - compiled->arity));
+                for (const auto& decl : body->decls)
+                    discard(*decl);
+                // the frame is dropped on return, so the scope isn't popped
+            }
+            emit(OP_NIL);
+            emit(OP_RETURN);
+            function = enclosing;
+            scopes = std::move(enclosing_scopes);
+            locals = enclosing_locals;
+
+            emitConstant(Value::object(compiled));
+            if (decl.addr.global()) {
+                emit(OP_DEFINE_FUNC, script->global(name.symbol));
+            } else {
+                emit(OP_SET_LOCAL, local(decl.addr));
+                emit(OP_POP);
+            }
+
+            // a function declaration evaluates to its name
+            auto str = strings.find(name.lexeme);
+            ObjString* obj = str != strings.end() ? str->second : (strings[name.lexeme] = script->newString(name.lexeme));
+            emitConstant(Value::object(obj));
+            return {Value()};
+        }
+
+        Values Compiler::visit_for(const For& decl) const
+        {
+            // running the iterations one after another would hide the writes the tree engine rejects
+            if (decl.parallel)
+                rift::error::report(decl.line, "visit_for", "A parallel for is only run by the tree engines (--engine=tree or tiered)", Token(), CompilerException("A parallel for is only run by the tree engines"));
+            beginScope(decl.slots);
+            if (decl.decl != nullptr) discard(*decl.decl);
+            else if (decl.stmt_l != nullptr) {
+                decl.stmt_l->accept(*this);
+                emit(OP_POP);
+            }
+
+            auto loop_start = chunk().code.size();
+            decl.expr->accept(*this);
+            auto exit = emitJump(OP_JUMP_IF_FALSE);
+
+            if (decl.stmt_o != nullptr) {
+                decl.stmt_o->accept(*this);
+                emit(OP_POP);
+            } else if (decl.blk != nullptr) {
+                decl.blk->accept(*this);
+            } else {
+                rift::error::report(line, "visit_for", "For statement should have a statement or block", Token(), CompilerException("For statement should have a statement or block"));
+            }
+
+            if (decl.stmt_r != nullptr) {
+                decl.stmt_r->accept(*this);
+                emit(OP_POP);
+            }
+            emitLoop(loop_start);
+            patchJump(exit);
+            endScope();
+            return {};
+        }
+
+        Values Compiler::visit_block_stmt(const Block& block) const
+        {
+            beginScope(block.slots);
+            for (const auto& decl : block.decls)
+                discard(*decl);
+            endScope();
+            return {};
+        }
+
+        Values Compiler::visit_program(const Program& prgm) const
+        {
+            for (const auto& decl : prgm.decls) {
+                // top level values are reported back as results
+                if (!decl->accept(*this).empty()) emit(OP_RESULT);
+            }
+            return {};
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <vm/image.hh>
+#include <vm/cache.hh>
+#include <utils/mapped_file.hh>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+#if defined(OS_APPLE) || defined(__APPLE__)
+    #include <mach-o/dyld.h>
+#endif
+
+namespace rift
+{
+    namespace vm
+    {
+        #pragma mark - Layout
+
+        /// @details the header, then every script as its length and its cache file bytes.
+        ///          An executable ends with the image and the trailer saying how long it is
+        static constexpr uint32_t MAGIC = 0x49464952; // "RIFI"
+
+        struct Header {
+            uint32_t magic;
+            uint32_t format;
+            uint32_t scripts;
+        };
+
+        struct Trailer {
+            uint64_t size;
+            uint32_t magic;
+            uint32_t format;
+        };
+
+        /// @brief the key every script of an image is stored with, any image of this build matches it
+        static uint64_t build() { return ScriptCache::key({}); }
+
+        #pragma mark - Image
+
+        bool Image::is(std::span<const char> bytes)
+        {
+            uint32_t magic = 0;
+            if (bytes.size() < sizeof(magic)) return false;
+            std::memcpy(&magic, bytes.data(), sizeof(magic));
+            return magic == MAGIC;
+        }
+
+        std::string Image::encode(std::span<const std::unique_ptr<Script>> scripts, const Symbols& symbols)
+        {
+            std::string out;
+            Header header{MAGIC, FORMAT, static_cast<uint32_t>(scripts.size())};
+            out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const auto& script : scripts) {
+                auto bytes = ScriptCache::encode(build(), *script, symbols);
+                uint64_t size = bytes.size();
+                out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+                out.append(bytes);
+            }
+            return out;
+        }
+
+        std::vector<std::unique_ptr<Script>> Image::decode(std::span<const char> bytes, Symbols& symbols)
+        {
+            std::vector<std::unique_ptr<Script>> scripts;
+            Header header{};
+            if (bytes.size() < sizeof(header)) return {};
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            if (header.magic != MAGIC || header.format != FORMAT) return {};
+
+            // bounds checked like a cache file, a short image just fails
+            auto rest = bytes.subspan(sizeof(header));
+            for (uint32_t i = 0; i < header.scripts; i++) {
+                uint64_t size = 0;
+                if (rest.size() < sizeof(size)) return {};
+                std::memcpy(&size, rest.data(), sizeof(size));
+                rest = rest.subspan(sizeof(size));
+                if (rest.size() < size) return {};
+
+                auto script = ScriptCache::decode(rest.first(size), build(), symbols);
+                if (!script) return {};
+                scripts.push_back(std::move(script));
+                rest = rest.subspan(size);
+            }
+            if (!rest.empty()) return {};
+            return scripts;
+        }
+
+        std::span<const char> Image::embedded(std::span<const char> executable)
+        {
+            Trailer trailer{};
+            if (executable.size() < sizeof(trailer)) return {};
+            std::memcpy(&trailer, executable.data() + executable.size() - sizeof(trailer), sizeof(trailer));
+            if (trailer.magic != MAGIC || trailer.format != FORMAT || trailer.size > executable.size() - sizeof(trailer)) return {};
+            return executable.subspan(executable.size() - sizeof(trailer) - trailer.size, trailer.size);
+        }
+
+        std::string Image::self()
+        {
+            #if defined(OS_APPLE) || defined(__APPLE__)
+            uint32_t size = 0;
+            _NSGetExecutablePath(nullptr, &size);
+            std::string path(size, '\0');
+            if (_NSGetExecutablePath(path.data(), &size) != 0) return {};
+            path.resize(std::strlen(path.c_str()));
+            return path;
+            #else
+            std::error_code ec;
+            auto path = std::filesystem::read_symlink("/proc/self/exe", ec);
+            return ec ? std::string() : path.string();
+            #endif
+        }
+
+        bool Image::write(const std::string& path, std::string_view image, bool executable)
+        {
+            // an executable is this one, less the image it may run itself
+            std::unique_ptr<MappedFile> exe;
+            std::span<const char> base;
+            if (executable) {
+                auto from = self();
+                if (from.empty() || !(exe = MappedFile::open(from))) return false;
+                base = exe->span();
+                auto own = embedded(base);
+                if (!own.empty()) base = base.first(base.size() - own.size() - sizeof(Trailer));
+            }
+
+            // written aside and renamed over, like a cache file
+            std::error_code ec;
+            auto temp = path + ".tmp" + std::to_string(getpid());
+            {
+                std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+                file.write(base.data(), static_cast<std::streamsize>(base.size()));
+                file.write(image.data(), static_cast<std::streamsize>(image.size()));
+                if (executable) {
+                    Trailer trailer{image.size(), MAGIC, FORMAT};
+                    file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+                }
+                if (!file) {
+                    std::filesystem::remove(temp, ec);
+                    return false;
+                }
+            }
+            if (executable) {
+                using std::filesystem::perms;
+                std::filesystem::permissions(temp, perms::owner_exec | perms::group_exec | perms::others_exec, std::filesystem::perm_options::add, ec);
+            }
+            std::filesystem::rename(temp, path, ec);
+            if (!ec) return true;
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+    }
+}
@@ -0,0 +1,450 @@
+/////////////////////////////////////////////////////////////
+///                                                       ///
+///     ██████╗ ██╗███████╗████████╗                      ///
+///     ██╔══██╗██║██╔════╝╚══██╔══╝                      ///
+///     ██████╔╝██║█████╗     ██║                         ///
+///     ██╔══██╗██║██╔══╝     ██║                         ///
+///     ██║  ██║██║██║        ██║                         ///
+///     ╚═╝  ╚═╝╚═╝╚═╝        ╚═╝                         ///
+///     * RIFT CORE - The official compiler for Rift.     ///
+///     * Copyright (c) 2024, Rift-Org                    ///
+///     * License terms may be found in the LICENSE file. ///
+///                                                       ///
+/////////////////////////////////////////////////////////////
+
+#include <vm/vm.hh>
+#include <vm/compiler.hh>
+#include <utils/literals.hh>
+#include <utils/builtins.hh>
+#include <error/error.hh>
+#include <iostream>
+
+namespace rift
+{
+    namespace vm
+    {
+        #pragma mark - Public API
+
+        VM::VM(Isolate& isolate) : isolate(isolate), stack(new Value[STACK_MAX]), top(stack.get()), roots(*this) {}
+
+        void VM::evaluate(const rift::ast::Program& prgm, ResultSink& sink)
+        {
+            Isolate::Scope enter(isolate);
+            Compiler compiler;
+            scripts.push_back(compiler.compile(prgm));
+            run(*scripts.back(), sink);
+        }
+
+        void VM::run(std::unique_ptr<Script> script, ResultSink& sink)
+        {
+            scripts.push_back(std::move(script));
+            run(*scripts.back(), sink);
+        }
+
+        std::vector<std::string> VM::evaluate(const rift::ast::Program& prgm, bool interactive)
+        {
+            (void)interactive;
+            CollectResults collect;
+            evaluate(prgm, collect);
+            return std::move(collect.results);
+        }
+
+        void VM::run(const Script& script, ResultSink& sink)
+        {
+            Isolate::Scope enter(isolate);
+            // relink, a script passed by reference may live where a freed one did
+            links.erase(&script);
+            execute(script, sink);
+            top = stack.get();
+            isolate.output.flush();
+        }
+
+        VM::Global* const* VM::link(const Script* script)
+        {
+            auto [it, added] = links.try_emplace(script);
+            if (added) {
+                // link the script's global indices against the persistent globals
+                it->second.reserve(script->globals.size());
+                for (auto name : script->globals) {
+                    auto [idx, fresh] = global_index.emplace(name, static_cast<uint32_t>(globals.size()));
+                    if (fresh) globals.emplace_back();
+                    it->second.push_back(&globals[*idx]);
+                }
+            }
+            return it->second.data();
+        }
+
+        ObjString* VM::newString(String str)
+        {
+            return static_cast<ObjString*>(isolate.heap.string(std::move(str)).as.obj);
+        }
+
+        void VM::Roots::trace(Heap& heap) const
+        {
+            for (const Value* val = vm.stack.get(); val < vm.top; val++) heap.mark(*val);
+            for (const auto& global : vm.globals) heap.mark(global.value);
+        }
+
+        #pragma mark - Dispatch Loop
+
+        void VM::execute(const Script& script, ResultSink& sink)
+        {
+            CallFrame* frame = &frames[0];
+            frame->function = script.main;
+            frame->ip = script.main->chunk.code.data();
+            frame->slots = stack.get();
+            frame->linked = link(&script);
+
+            // slot 0 of every frame holds the running function
+            Value* sp = stack.get();
+            *sp++ = Value::object(script.main);
+            dispatch(0, sp, sink);
+        }
+
+        Value VM::apply(const Value& fn, const Value& arg, size_t depth, Value* sp, ResultSink& sink)
+        {
+            if (!fn.isFunction())
+                rift::error::runTimeError("Can only call functions");
+            if (depth == FRAMES_MAX || sp + 256 >= stack.get() + STACK_MAX)
+                rift::error::runTimeError("Stack overflow");
+            if (fn.asFunction()->arity != 1)
+                rift::error::runTimeError("Expected " + std::to_string(fn.asFunction()->arity) + " arguments but got 1");
+
+            // above everything the caller still has on the stack, like a CALL would lay it out
+            CallFrame* frame = &frames[depth];
+            frame->function = fn.asFunction();
+            frame->ip = frame->function->chunk.code.data();
+            frame->slots = sp;
+            frame->linked = link(frame->function->script);
+            *sp++ = fn;
+            *sp++ = arg;
+            return dispatch(depth, sp, sink);
+        }
+
+        Value VM::dispatch(size_t base, Value* sp, ResultSink& sink)
+        {
+            CallFrame* frame = &frames[base];
+            size_t frame_count = base + 1;
+            if (peak < frame_count) peak = frame_count;
+            const uint8_t* ip = frame->ip;
+            const Value* constants = frame->function->chunk.constants.data();
+            Global* const* linked = frame->linked;
+            // set before jumping to call, CALL_BUILTIN falls back to a plain call through it
+            uint8_t argc;
+
+            #define READ_BYTE() (*ip++)
+            #define READ_SHORT() (ip += 2, static_cast<uint16_t>((ip[-2] << 8) | ip[-1]))
+            #define PUSH(val) (*sp++ = (val))
+            #define POP() (*--sp)
+            #define PEEK(n) (sp[-1 - (n)])
+            // only where an instruction allocated, with every live value on the stack
+            #define SAFEPOINT() \
+                do { \
+                    if (isolate.heap.pending()) { top = sp; isolate.heap.collect(); } \
+                } while (false)
+            #define GLOBAL_NAME(idx) std::string(isolate.symbols.name(frame->function->script->globals[idx]))
+
+            #define NUMERIC_OP(op, name) \
+                do { \
+                    if (!PEEK(0).isNumber() || !PEEK(1).isNumber()) \
+                        rift::error::runTimeError("Expected a number for '" name "' operator"); \
+                    double r = POP().as.number; \
+                    sp[-1].as.number = sp[-1].as.number op r; \
+                } while (false)
+
+            #define COMPARE_OP(op, name) \
+                do { \
+                    Value r = POP(), l = POP(); \
+                    if (l.isNumber() && r.isNumber()) PUSH(Value::boolean(l.as.number op r.as.number)); \
+                    else if (l.isString() && r.isString()) PUSH(Value::boolean(l.asString().compare(r.asString()) op 0)); \
+                    else rift::error::runTimeError("Expected a number or string for '" name "' operator"); \
+                } while (false)
+
+            #if RIFT_COMPUTED_GOTO
+                static void* dispatch_table[] = {
+                    #define __RIFT_OPCODE_LABEL(name) &&op_##name,
+                    RIFT_OPCODES(__RIFT_OPCODE_LABEL)
+                    #undef __RIFT_OPCODE_LABEL
+                };
+                #define DISPATCH() goto *dispatch_table[READ_BYTE()]
+                #define CASE(name) op_##name:
+                DISPATCH();
+            #else
+                #define DISPATCH() break
+                #define CASE(name) case OP_##name:
+                for (;;) switch (READ_BYTE()) {
+            #endif
+
+            CASE(CONSTANT) {
+                PUSH(constants[READ_SHORT()]);
+                DISPATCH();
+            }
+            CASE(NIL) { PUSH(Value::nil()); DISPATCH(); }
+            CASE(TRUE) { PUSH(Value::boolean(true)); DISPATCH(); }
+            CASE(FALSE) { PUSH(Value::boolean(false)); DISPATCH(); }
+            CASE(POP) { sp--; DISPATCH(); }
+
+            CASE(GET_GLOBAL) {
+                auto idx = READ_SHORT();
+                const Value& val = linked[idx]->value;
+                if (val.isUndefined())
+                    rift::error::runTimeError("Undefined variable '" + GLOBAL_NAME(idx) + "'");
+                PUSH(val);
+                DISPATCH();
+            }
+            CASE(SET_GLOBAL) {
+                auto global = linked[READ_SHORT()];
+                if (global->is_const && !global->value.isUndefined())
+                    rift::error::runTimeError("Cannot reassign a constant variable");
+                global->value = PEEK(0);
+                DISPATCH();
+            }
+            CASE(DEFINE_GLOBAL) {
+                auto global = linked[READ_SHORT()];
+                if (global->is_const && !global->value.isUndefined())
+                    rift::error::runTimeError("Cannot reassign a constant variable");
+                global->value = PEEK(0);
+                DISPATCH();
+            }
+            CASE(DEFINE_CONST) {
+                auto global = linked[READ_SHORT()];
+                if (global->is_const && !global->value.isUndefined())
+                    rift::error::runTimeError("Cannot reassign a constant variable");
+                global->value = PEEK(0);
+                global->is_const = true;
+                DISPATCH();
+            }
+            CASE(DEFINE_FUNC) {
+                auto idx = READ_SHORT();
+                auto global = linked[idx];
+                if (!global->value.isUndefined() && !global->value.isNil())
+                    rift::error::runTimeError("Function '" + GLOBAL_NAME(idx) + "' already defined");
+                global->value = POP();
+                DISPATCH();
+            }
+
+            CASE(GET_LOCAL) {
+                const Value& val = frame->slots[READ_SHORT()];
+                if (val.isUndefined())
+                    rift::error::runTimeError("Undefined local variable");
+                PUSH(val);
+                DISPATCH();
+            }
+            CASE(SET_LOCAL) {
+                frame->slots[READ_SHORT()] = PEEK(0);
+                DISPATCH();
+            }
+            CASE(RESERVE) {
+                auto count = READ_SHORT();
+                if (sp + count >= stack.get() + STACK_MAX)
+                    rift::error::runTimeError("Stack overflow");
+                for (auto end = sp + count; sp < end;) *sp++ = Value::undefined();
+                DISPATCH();
+            }
+            CASE(POPN) {
+                sp -= READ_SHORT();
+                DISPATCH();
+            }
+
+            CASE(ADD) {
+                Value r = PEEK(0), l = PEEK(1);
+                if (l.isNumber() && r.isNumber()) {
+                    sp--;
+                    sp[-1].as.number += r.as.number;
+                } else if (l.isString() && r.isString()) {
+                    sp--;
+                    sp[-1] = Value::object(newString(l.asString() + r.asString()));
+                    SAFEPOINT();
+                } else if (l.isString() && r.isNumber()) {
+                    sp--;
+                    sp[-1] = Value::object(newString(l.asString() + formatNumber(r.as.number)));
+                    SAFEPOINT();
+                } else if (l.isNumber() && r.isString()) {
+                    sp--;
+                    sp[-1] = Value::object(newString(formatNumber(l.as.number) + r.asString()));
+                    SAFEPOINT();
+                } else {
+                    rift::error::runTimeError("Expected a number or string for '+' operator");
+                }
+                DISPATCH();
+            }
+            CASE(SUBTRACT) { NUMERIC_OP(-, "-"); DISPATCH(); }
+            CASE(MULTIPLY) { NUMERIC_OP(*, "*"); DISPATCH(); }
+            CASE(DIVIDE) { NUMERIC_OP(/, "/"); DISPATCH(); }
+            CASE(NEGATE) {
+                if (!PEEK(0).isNumber())
+                    rift::error::runTimeError("Expected a number after '-' operator");
+                sp[-1].as.number = -sp[-1].as.number;
+                DISPATCH();
+            }
+            CASE(NOT) {
+                Value val = POP();
+                if (val.isBool()) PUSH(Value::boolean(!val.as.boolean));
+                else if (val.isNumber()) PUSH(Value::boolean(val.as.number == 0));
+                else if (val.isString()) PUSH(Value::boolean(val.asString().empty()));
+                else rift::error::runTimeError("Expected a number or string after '!' operator");
+                DISPATCH();
+            }
+            CASE(TO_BOOL) {
+                sp[-1] = Value::boolean(truthy(sp[-1]));
+                DISPATCH();
+            }
+
+            CASE(EQUAL) {
+                Value r = POP(), l = POP();
+                if (l.isNumber() && r.isNumber()) PUSH(Value::boolean(l.as.number == r.as.number));
+                else PUSH(Value::boolean(equal(l, r)));
+                DISPATCH();
+            }
+            CASE(NOT_EQUAL) {
+                Value r = POP(), l = POP();
+                if (l.isNumber() && r.isNumber()) PUSH(Value::boolean(l.as.number != r.as.number));
+                else PUSH(Value::boolean(!equal(l, r)));
+                DISPATCH();
+            }
+            CASE(GREATER) { COMPARE_OP(>, ">"); DISPATCH(); }
+            CASE(GREATER_EQUAL) { COMPARE_OP(>=, ">="); DISPATCH(); }
+            CASE(LESS) { COMPARE_OP(<, "<"); DISPATCH(); }
+            CASE(LESS_EQUAL) { COMPARE_OP(<=, "<="); DISPATCH(); }
+
+            CASE(JUMP) {
+                auto offset = READ_SHORT();
+                ip += offset;
+                DISPATCH();
+            }
+            CASE(JUMP_IF_FALSE) {
+                auto offset = READ_SHORT();
+                if (!truthy(POP())) ip += offset;
+                DISPATCH();
+            }
+            CASE(JUMP_IF_NOT_NIL) {
+                auto offset = READ_SHORT();
+                if (!PEEK(0).isNil()) ip += offset;
+                DISPATCH();
+            }
+            CASE(LOOP) {
+                auto offset = READ_SHORT();
+                ip -= offset;
+                DISPATCH();
+            }
+
+            CASE(CALL) {
+                argc = READ_BYTE();
+            call:
+                Value callee = PEEK(argc);
+                if (!callee.isFunction())
+                    rift::error::runTimeError("Can only call functions");
+                if (frame_count == FRAMES_MAX || sp + 256 >= stack.get() + STACK_MAX)
+                    rift::error::runTimeError("Stack overflow");
+
+                if (argc != callee.asFunction()->arity)
+                    rift::error::runTimeError("Expected " + std::to_string(callee.asFunction()->arity) + " arguments but got " + std::to_string(argc));
+
+                // the arguments stay where they were pushed, as the first locals of the frame
+                frame->ip = ip;
+                frame = &frames[frame_count++];
+                if (frame_count > peak) peak = frame_count;
+                frame->function = callee.asFunction();
+                frame->slots = sp - argc - 1;
+                // functions keep indexing the globals of the script that compiled them
+                frame->linked = frame->function->script == frame[-1].function->script
+                    ? linked : link(frame->function->script);
+                linked = frame->linked;
+                ip = frame->function->chunk.code.data();
+                constants = frame->function->chunk.constants.data();
+                DISPATCH();
+            }
+            CASE(RETURN) {
+                Value res = POP();
+                if (frame_count == 1)
+                    rift::error::runTimeError("Cannot return from top level code");
+                sp = frame->slots;
+                // back to the builtin that called it
+                if (--frame_count == base) return res;
+                frame = &frames[frame_count - 1];
+                ip = frame->ip;
+                constants = frame->function->chunk.constants.data();
+                linked = frame->linked;
+                PUSH(res);
+                DISPATCH();
+            }
+
+            CASE(ARRAY) {
+                auto count = READ_SHORT();
+                std::vector<double> items(count);
+                const Value* elements = sp - count;
+                for (size_t i = 0; i < count; i++) {
+                    const Value& val = elements[i];
+                    if (!val.isNumber()) rift::error::runTimeError("Expected a number for an array element");
+                    items[i] = val.as.number;
+                }
+                sp -= count;
+                PUSH(isolate.heap.array(std::move(items)));
+                SAFEPOINT();
+                DISPATCH();
+            }
+            CASE(GET_INDEX) {
+                Value index = POP();
+                sp[-1] = Value::number(builtins::element(sp[-1], index));
+                DISPATCH();
+            }
+            CASE(SET_INDEX) {
+                Value val = POP(), index = POP();
+                auto& slot = builtins::element(sp[-1], index);
+                if (!val.isNumber()) rift::error::runTimeError("Expected a number for an array element");
+                slot = val.as.number;
+                sp[-1] = val;
+                DISPATCH();
+            }
+            CASE(GET_BUILTIN) {
+                // undefined unless the program declared a global of the builtin's name
+                PUSH(linked[READ_SHORT()]->value);
+                DISPATCH();
+            }
+            CASE(CALL_BUILTIN) {
+                auto fn = static_cast<builtins::Builtin>(READ_BYTE());
+                argc = READ_BYTE();
+                if (!PEEK(argc).isUndefined()) goto call;
+                // the arguments stay below the frames map calls, reachable while they run
+                Value res = builtins::call(fn, std::span<const Value>(sp - argc, argc), isolate.heap, [&](const Value& f, const Value& arg) {
+                    return apply(f, arg, frame_count, sp, sink);
+                });
+                sp -= argc + 1;
+                PUSH(res);
+                SAFEPOINT();
+                DISPATCH();
+            }
+
+            CASE(PRINT) {
+                isolate.output.print(PEEK(0));
+                DISPATCH();
+            }
+            CASE(RESULT) {
+                sink.result(POP());
+                DISPATCH();
+            }
+            CASE(HALT) {
+                return Value();
+            }
+
+            #if !RIFT_COMPUTED_GOTO
+                default:
+                    rift::error::runTimeError("Unknown opcode");
+                    return Value();
+                }
+            #endif
+
+            #undef READ_BYTE
+            #undef READ_SHORT
+            #undef PUSH
+            #undef POP
+            #undef PEEK
+            #undef GLOBAL_NAME
+            #undef SAFEPOINT
+            #undef NUMERIC_OP
+            #undef COMPARE_OP
+            #undef DISPATCH
+            #undef CASE
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <utils/arena.hh>
+
+#pragma mark - Rift Arena (Tests)
+
+TEST(RiftArena, layoutFollowsAllocationOrder) {
+    rift::Arena arena;
+    auto a = arena.make<uint64_t>(1);
+    auto b = arena.make<uint64_t>(2);
+    auto c = arena.make<uint64_t>(3);
+
+    EXPECT_EQ(b, a + 1);
+    EXPECT_EQ(c, b + 1);
+    EXPECT_EQ(*a + *b + *c, 6u);
+    EXPECT_EQ(arena.used(), 3 * sizeof(uint64_t));
+}
+
+TEST(RiftArena, alignmentAndOversizedBlocks) {
+    rift::Arena arena;
+    arena.make<char>('x');
+    auto d = arena.make<double>(1.5);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0u);
+
+    auto big = arena.allocate(4 * rift::Arena::BLOCK_SIZE);
+    EXPECT_NE(big, nullptr);
+    EXPECT_GE(arena.reserved(), 5 * rift::Arena::BLOCK_SIZE);
+}
+
+TEST(RiftArena, releaseRunsDestructorsOnce) {
+    struct Counted {
+        int* count;
+        ~Counted() { (*count)++; }
+    };
+
+    int count = 0;
+    {
+        rift::Arena arena;
+        for (int i = 0; i < 100; i++) arena.make<Counted>(Counted{&count});
+        auto str = arena.make<std::string>(1000, 'r');
+        EXPECT_EQ(str->size(), 1000u);
+        count = 0;
+        arena.release();
+        EXPECT_EQ(count, 100);
+        EXPECT_EQ(arena.used(), 0u);
+    }
+    EXPECT_EQ(count, 100);
+}
\ No newline at end of file
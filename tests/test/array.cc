@@ -0,0 +1,127 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <vm/vm.hh>
+#include <error/error.hh>
+#include <utils/isolate.hh>
+#include <utils/numeric.hh>
+#include <utils/scheduler.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::test;
+
+#pragma mark - Rift Arrays (Tests)
+
+/// @note fractions round at every add, so the levels only agree if they all add in the same order
+TEST(RiftArray, kernelsMatchScalar) {
+    using numeric::Level;
+    const auto& ref = *numeric::kernels(Level::SCALAR);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::mt19937 rng(7);
+
+    for (auto level : {Level::SSE2, Level::AVX2, Level::NEON}) {
+        auto k = numeric::kernels(level);
+        if (k == nullptr) continue;
+
+        for (size_t n = 0; n < 40; n++) {
+            std::vector<double> a(n), b(n);
+            for (size_t i = 0; i < n; i++) {
+                a[i] = static_cast<double>(static_cast<int>(rng() % 2001) - 1000) / 7;
+                b[i] = static_cast<double>(static_cast<int>(rng() % 21) - 10) / 3;
+            }
+            EXPECT_EQ(k->sum(a.data(), n), ref.sum(a.data(), n)) << k->name << " " << n;
+            EXPECT_EQ(k->dot(a.data(), b.data(), n), ref.dot(a.data(), b.data(), n)) << k->name << " " << n;
+            if (n == 0) continue;
+            EXPECT_EQ(k->min(a.data(), n), ref.min(a.data(), n)) << k->name << " " << n;
+            EXPECT_EQ(k->max(a.data(), n), ref.max(a.data(), n)) << k->name << " " << n;
+
+            // a NaN anywhere is what min and max give, at every level
+            for (size_t i = 0; i < n; i++) {
+                auto with = a;
+                with[i] = nan;
+                EXPECT_TRUE(std::isnan(k->min(with.data(), n))) << k->name << " " << n << " " << i;
+                EXPECT_TRUE(std::isnan(k->max(with.data(), n))) << k->name << " " << n << " " << i;
+            }
+        }
+    }
+    EXPECT_TRUE(std::isnan(ref.min(std::vector<double>{1, nan, 0}.data(), 3)));
+    EXPECT_TRUE(std::isnan(ref.max(std::vector<double>{nan, 2, 3}.data(), 3)));
+    EXPECT_EQ(numeric::kernels(numeric::kernels().level), &numeric::kernels());
+}
+
+TEST(RiftArray, literalsAndElements) {
+    for (bool vm : {false, true}) {
+        EXPECT_EQ(run("mut a = [1, 2.5, -3]; print(a); print(a[1]); a[2] = a[0] + 10; print(a);", vm), "[1, 2.5, -3]\n2.5\n[1, 2.5, 11]\n") << vm;
+        EXPECT_EQ(run("mut a = array(3); for (mut k = 0; k < 3; k = k + 1) { a[k] = k * k; } print(a); print(a[2] = 7);", vm), "[0, 1, 4]\n7\n") << vm;
+        EXPECT_EQ(run("print([]); print([1, 2] == [1, 2]); print([1] == [2]); print(len([]));", vm), "[]\ntrue\nfalse\n0\n") << vm;
+        // an element is a number like any other
+        EXPECT_EQ(run("fun at(a, i) { return a[i] * 2; } mut a = [3, 4]; print(at(a, 1) + a[0]);", vm), "11\n") << vm;
+    }
+}
+
+TEST(RiftArray, builtins) {
+    std::string source = "mut a = [4, -2, 9, 1, 0, 3, 8, 5, 7]; mut b = array(len(a));"
+                         "for (mut i = 0; i < len(b); i = i + 1) { b[i] = i; }"
+                         "print(sum(a)); print(min(a)); print(max(a)); print(dot(a, b)); print(len(\"four\"));";
+    EXPECT_EQ(run(source), "35\n-2\n9\n173\n4\n");
+    EXPECT_EQ(run(source, true), run(source));
+    // the same digits whatever the cpu runs, the kernels all add in one order
+    EXPECT_EQ(run("print(sum([0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.1, 1.2, 1.3, 1.4, 1.5, 1.6, 1.6]));"), "14.200000000000001\n");
+    EXPECT_EQ(run("mut z = 0; mut m = min([1, z / z, 3]); print(m == m); print(max([z / z, 1]) == 1);"), "false\nfalse\n");
+
+    for (bool vm : {false, true}) {
+        EXPECT_EQ(run("fun sq(x) { return x * x; } print(map([1, 2, 3], sq)); print(sum(map([], sq)));", vm), "[1, 4, 9]\n0\n") << vm;
+        // the callback calls on, maps again, and collects what it allocated along the way
+        EXPECT_EQ(run("fun sq(x) { return x * x; } fun inner(x) { mut s = \"\"; for (mut k = 0; k < 50; k = k + 1) { s = s + k; } return sum(map([x, len(s)], sq)); }"
+                      "mut a = array(200); for (mut i = 0; i < 200; i = i + 1) { a[i] = i; } mut b = map(a, inner); print(b[0]); print(b[199]); print(len(b));", vm),
+                  "8100\n47701\n200\n") << vm;
+    }
+    // a program's own function of the same name is the one called
+    for (bool vm : {false, true})
+        EXPECT_EQ(run("fun sum(a) { return 42; } print(sum([1, 2]));", vm), "42\n") << vm;
+}
+
+TEST(RiftArray, errorsAreReported) {
+    for (bool vm : {false, true}) {
+        EXPECT_NE(failure("mut a = [1, 2]; print(a[2]);", vm).find("out of range"), std::string::npos) << vm;
+        EXPECT_NE(failure("mut a = [1, 2]; print(a[-1]);", vm).find("out of range"), std::string::npos) << vm;
+        EXPECT_NE(failure("mut a = [1, 2]; print(a[0.5]);", vm).find("whole number"), std::string::npos) << vm;
+        EXPECT_NE(failure("mut a = [1, \"two\"];", vm).find("array element"), std::string::npos) << vm;
+        EXPECT_NE(failure("mut a = [1]; a[0] = nil;", vm).find("array element"), std::string::npos) << vm;
+        EXPECT_NE(failure("mut a = 3; print(a[0]);", vm).find("Can only index arrays"), std::string::npos) << vm;
+        EXPECT_NE(failure("print(min([]));", vm).find("non empty"), std::string::npos) << vm;
+        EXPECT_NE(failure("print(dot([1], [1, 2]));", vm).find("same length"), std::string::npos) << vm;
+        EXPECT_NE(failure("print(sum(3));", vm).find("Expected an array for 'sum'"), std::string::npos) << vm;
+        EXPECT_NE(failure("print(array(-1));", vm).find("whole number length"), std::string::npos) << vm;
+        EXPECT_NE(failure("print(len([1], 2));", vm).find("arguments"), std::string::npos) << vm;
+    }
+    for (bool vm : {false, true}) {
+        EXPECT_NE(failure("fun f(x) { return \"s\"; } print(map([1], f));", vm).find("return a number"), std::string::npos) << vm;
+        EXPECT_NE(failure("fun f(x, y) { return x; } print(map([1], f));", vm).find("arguments"), std::string::npos) << vm;
+        EXPECT_NE(failure("print(map([1], 2));", vm).find("Can only call"), std::string::npos) << vm;
+        EXPECT_NE(failure("fun f(x) { return f(x); } print(map([1], f));", vm).find("Stack overflow"), std::string::npos) << vm;
+    }
+}
+
+TEST(RiftArray, parallelWorkersOnlyWriteTheirOwnArrays) {
+    Scheduler::configure(4);
+    EXPECT_EQ(run("mut a = [1, 2, 3]; parallel for (mut i = 0; i < 3; i = i + 1) { mut b = [a[i], 0]; b[1] = sum(a); print(b); }"),
+              "[1, 6]\n[2, 6]\n[3, 6]\n");
+    EXPECT_NE(failure("mut a = [1, 2]; parallel for (mut i = 0; i < 2; i = i + 1) { a[i] = 0; }").find("made outside"), std::string::npos);
+
+    // an array a task made is the awaiter's once it's done, one it was given stays the same
+    EXPECT_EQ(run("fun make(n) { mut a = array(n); a[0] = n; return a; } mut t = spawn make(2); mut r = await t; r[1] = 5; print(r);"), "[2, 5]\n");
+    EXPECT_EQ(run("fun same(a) { return a; } mut a = [1]; mut r = await spawn same(a); r[0] = 9; print(a);"), "[9]\n");
+}
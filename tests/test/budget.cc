@@ -0,0 +1,152 @@
+#include <string>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/profiler.hh>
+#include <ast/resolver.hh>
+#include <rift/rift.hh>
+#include <utils/alloc.hh>
+#include <utils/isolate.hh>
+#include <utils/results.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::test;
+
+#pragma mark - Rift Budgets (Fixtures)
+
+/// @brief Performance contracts, what a phase may allocate (counted by the global operator
+///        new hook, see alloc::track) and how many statements it may run (Profiler::steps)
+/// @note budgets are set with room to spare over what the phases take today, a test failing
+///       means the cost of something grew with its input where it shouldn't have
+class RiftBudget : public ::testing::Test {
+
+    protected:
+        /// @brief heap traffic of fn, only what the process allocates while it runs
+        template <typename F>
+        static alloc::Counts counted(F&& fn)
+        {
+            alloc::track(true);
+            auto before = alloc::counts();
+            fn();
+            auto used = alloc::counts() - before;
+            alloc::track(false);
+            return used;
+        }
+
+        /// @brief what evaluating a program cost, its front end isn't counted
+        struct Cost {
+            alloc::Counts heap;
+            size_t steps = 0;
+            Heap::Stats gc;
+        };
+
+        static Cost evaluate(const std::string& source)
+        {
+            Isolate isolate;
+            std::string out;
+            isolate.output.redirect(Output::memory(out));
+            Isolate::Scope enter(isolate);
+            auto prgm = compile(isolate, source);
+
+            Cost cost;
+            Eval eval(isolate);
+            Profiler profiler;
+            eval.profile(&profiler);
+            DiscardResults results;
+            cost.heap = counted([&] { eval.evaluate(*prgm, results); });
+            cost.steps = profiler.steps;
+            cost.gc = isolate.heap.stats();
+            return cost;
+        }
+
+        /// @brief a counted for loop running body n times
+        static std::string loop(size_t n, const std::string& body, const std::string& before = "")
+        {
+            return before + "mut s = 0; for (mut i = 0; i < " + std::to_string(n) + "; i = i + 1) { " + body + " }";
+        }
+};
+
+#pragma mark - Rift Budgets (Tests)
+
+TEST_F(RiftBudget, scanningAllocatesPerBufferNotPerToken) {
+    std::string distinct, same;
+    for (int i = 0; i < 10000; i++) {
+        distinct += "name" + std::to_string(i) + " ";
+        same += "name; ";
+    }
+    // the token buffer once, then the symbol table's chunks and buckets as it grows
+    EXPECT_LE(counted([&] { Scanner(distinct).scan_source(); }).allocations, 64u);
+    EXPECT_LE(counted([&] { Scanner(same).scan_source(); }).allocations, 8u);
+}
+
+TEST_F(RiftBudget, parsingIsLinear) {
+    auto parse = [&](size_t n) {
+        std::string source;
+        for (size_t i = 0; i < n; i++) source += "mut v" + std::to_string(i) + " = (1 + 2) * v0;\n";
+        Isolate isolate;
+        Isolate::Scope enter(isolate);
+        Scanner scanner(source, isolate);
+        scanner.scan_source();
+        return counted([&] { Parser(scanner.tokens, isolate).parse(); }).allocations;
+    };
+    auto small = parse(1000), large = parse(10000);
+    EXPECT_LE(large, 10000u * 32);
+    EXPECT_LE(large, small * 11);
+}
+
+TEST_F(RiftBudget, loopsAllocateNothingPerIteration) {
+    for (auto body : {"mut x = i * 2; s = s + x;", "s = s + sq(i);", "if (i > 2) { s = s - 1; } else { s = s + 1; }"}) {
+        auto before = "fun sq(x) { return x * x; } ";
+        auto small = evaluate(loop(1000, body, before)), large = evaluate(loop(10000, body, before));
+        EXPECT_LE(large.heap.allocations, small.heap.allocations + 16) << body;
+    }
+}
+
+TEST_F(RiftBudget, callsAllocateNothingPerCall) {
+    // called straight from a top level statement, the body's declarations still aren't top level
+    auto fib = [&](int n) {
+        return evaluate("fun fib(n) { mut m = n - 1; if (n < 2) { return n; } return fib(m) + fib(n - 2); } print(fib(" + std::to_string(n) + "));");
+    };
+    auto small = fib(10), large = fib(18);
+    EXPECT_LE(large.heap.allocations, small.heap.allocations + 16);
+
+    // nor are they when the host calls in, long after the program ran
+    embed::Runtime runtime;
+    auto script = runtime.compile("fun twice(x) { mut y = x * 2; fun id(z) { return z; } return id(y); }");
+    auto twice = script.function("twice");
+    auto calls = [&](int n) {
+        return counted([&] { for (int i = 0; i < n; i++) runtime.call(twice, {i}); }).allocations;
+    };
+    // until the heap's slabs and free lists settle
+    calls(10000);
+    EXPECT_LE(calls(10000), calls(1000) + 16);
+}
+
+TEST_F(RiftBudget, stepsGrowWithIterations) {
+#ifndef RIFT_PROFILER
+    GTEST_SKIP() << "steps are counted by the profiler hooks";
+#endif
+    auto small = evaluate(loop(1000, "mut x = i * 2; s = s + x;")), large = evaluate(loop(10000, "mut x = i * 2; s = s + x;"));
+    // the condition, the two statements of the body and the increment, every iteration
+    EXPECT_LE(large.steps, 10000u * 4 + 16);
+    EXPECT_LE(large.steps, small.steps * 10 + 16);
+
+    auto calls = evaluate(loop(10000, "s = s + sq(i);", "fun sq(x) { return x * x; } "));
+    // the return of the call takes the place of the second statement
+    EXPECT_LE(calls.steps, 10000u * 4 + 16);
+}
+
+TEST_F(RiftBudget, evalMemoryStaysBounded) {
+    // garbage strings every iteration, the collector keeps what is live (and reserved) flat
+    auto small = evaluate(loop(20000, "mut t = \"item \" + i;")), large = evaluate(loop(400000, "mut t = \"item \" + i;"));
+    EXPECT_GE(large.gc.collections, 1u);
+    EXPECT_LE(large.gc.reserved, 4u << 20);
+    EXPECT_LE(large.gc.reserved, 2 * small.gc.reserved + (1u << 20));
+    EXPECT_LE(large.gc.objects, 64u << 10);
+}
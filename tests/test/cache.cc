@@ -0,0 +1,172 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/resolver.hh>
+#include <utils/mapped_file.hh>
+#include <vm/cache.hh>
+#include <vm/compiler.hh>
+#include <vm/image.hh>
+#include <vm/vm.hh>
+#include <vm/opcodes.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::vm;
+
+#pragma mark - Rift Script Cache (Fixtures)
+
+class RiftScriptCache : public ::testing::Test {
+
+    protected:
+        const std::string source =
+            "mut! greeting = \"hi \";"
+            "fun twice(n) { fun inner(m) { return m * 2; } return inner(n); }"
+            "print(greeting + twice(21));"
+            "mut flag = true; print(flag == (1 < 2));";
+        const std::string path = testing::TempDir() + "rift_cache_test.rfc";
+
+        std::unique_ptr<Script> compile()
+        {
+            prgm = test::compile(Isolate::current(), source);
+            return Compiler().compile(*prgm);
+        }
+
+        std::string run(std::unique_ptr<Script> script)
+        {
+            VM vm;
+            DiscardResults results;
+            testing::internal::CaptureStdout();
+            vm.run(std::move(script), results);
+            return testing::internal::GetCapturedStdout();
+        }
+
+        void TearDown() override { std::filesystem::remove(path); }
+
+        std::unique_ptr<Program> prgm;
+};
+
+#pragma mark - Rift Script Cache (Tests)
+
+TEST_F(RiftScriptCache, roundTrips) {
+    auto key = ScriptCache::key(source);
+    auto& symbols = Isolate::current().symbols;
+    auto script = compile();
+    ASSERT_TRUE(ScriptCache::store(path, key, *script, symbols));
+
+    auto loaded = ScriptCache::load(path, key, symbols);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->disassemble(), script->disassemble());
+    EXPECT_EQ(loaded->globals, script->globals);
+    EXPECT_EQ(run(std::move(loaded)), run(std::move(script)));
+}
+
+TEST_F(RiftScriptCache, missesOnChangedOrBrokenFiles) {
+    auto key = ScriptCache::key(source);
+    auto& symbols = Isolate::current().symbols;
+    EXPECT_EQ(ScriptCache::load(path, key, symbols), nullptr);
+
+    ASSERT_TRUE(ScriptCache::store(path, key, *compile(), symbols));
+    EXPECT_NE(ScriptCache::key(source + " "), key);
+    EXPECT_EQ(ScriptCache::load(path, ScriptCache::key(source + " "), symbols), nullptr);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+    EXPECT_EQ(ScriptCache::load(path, key, symbols), nullptr);
+}
+
+TEST_F(RiftScriptCache, missesOnCorruptFiles) {
+    auto key = ScriptCache::key(source);
+    auto& symbols = Isolate::current().symbols;
+    auto bytes = ScriptCache::encode(key, *compile(), symbols);
+    ASSERT_NE(ScriptCache::decode(bytes, key, symbols), nullptr);
+    // any flipped bit fails the checksum (or the header) rather than reaching the vm
+    for (size_t i = 0; i < bytes.size(); i++) {
+        auto broken = bytes;
+        broken[i] ^= static_cast<char>(1 << (i % 8));
+        EXPECT_EQ(ScriptCache::decode(broken, key, symbols), nullptr) << i;
+    }
+}
+
+TEST_F(RiftScriptCache, verifiesCode) {
+    auto& symbols = Isolate::current().symbols;
+    // encoded as is, so only the verifier stands between the code and the vm
+    auto decodes = [&](std::vector<uint8_t> code, unsigned arity = 0) {
+        Script script;
+        script.global(symbols.intern("g"));
+        script.main = script.newFunction("main");
+        script.main->arity = arity;
+        script.main->chunk.addConstant(Value::number(1));
+        for (auto byte : code) script.main->chunk.write(byte, 1);
+        return ScriptCache::decode(ScriptCache::encode(0, script, symbols), 0, symbols) != nullptr;
+    };
+    EXPECT_TRUE(decodes({OP_CONSTANT, 0, 0, OP_DEFINE_GLOBAL, 0, 0, OP_POP, OP_GET_LOCAL, 0, 1, OP_POP, OP_HALT}, 1));
+    EXPECT_TRUE(decodes({OP_TRUE, OP_JUMP_IF_FALSE, 0, 2, OP_NIL, OP_POP, OP_HALT}));
+
+    EXPECT_FALSE(decodes({}));
+    EXPECT_FALSE(decodes({OP_COUNT, OP_HALT}));
+    EXPECT_FALSE(decodes({OP_NIL}));                                    // runs off the end
+    EXPECT_FALSE(decodes({OP_CONSTANT, 0}));                            // cut short
+    EXPECT_FALSE(decodes({OP_CONSTANT, 0, 1, OP_HALT}));                // no such constant
+    EXPECT_FALSE(decodes({OP_GET_GLOBAL, 0, 1, OP_HALT}));              // no such global
+    EXPECT_FALSE(decodes({OP_GET_LOCAL, 0, 1, OP_HALT}));               // above the stack
+    EXPECT_FALSE(decodes({OP_POP, OP_HALT}));                           // pops the function
+    EXPECT_FALSE(decodes({OP_JUMP, 0, 9, OP_HALT}));                    // jumps out
+    EXPECT_FALSE(decodes({OP_LOOP, 0, 9, OP_HALT}));
+    EXPECT_FALSE(decodes({OP_TRUE, OP_JUMP_IF_FALSE, 0, 1, OP_NIL, OP_HALT}));  // one path leaves more behind
+    EXPECT_FALSE(decodes({OP_NIL, OP_LOOP, 0, 4}));                     // grows the stack every time round
+    EXPECT_FALSE(decodes({OP_NIL, OP_CALL_BUILTIN, 0, 0, OP_HALT}));    // no such builtin
+}
+
+TEST_F(RiftScriptCache, imagesRunWithoutTheirSource) {
+    auto& symbols = Isolate::current().symbols;
+    std::vector<std::unique_ptr<Script>> scripts;
+    scripts.push_back(compile());
+    auto expected = scripts[0]->disassemble();
+
+    auto image = Image::encode(scripts, symbols);
+    EXPECT_TRUE(Image::is(image));
+    EXPECT_FALSE(Image::is(source));
+    auto loaded = Image::decode(image, symbols);
+    ASSERT_EQ(loaded.size(), 1u);
+    EXPECT_EQ(loaded[0]->disassemble(), expected);
+    EXPECT_EQ(run(std::move(loaded[0])), run(compile()));
+
+    // any flipped bit, each script is checked like a cached one
+    for (size_t i = 0; i < image.size(); i++) {
+        auto broken = image;
+        broken[i] ^= static_cast<char>(1 << (i % 8));
+        EXPECT_TRUE(Image::decode(broken, symbols).empty()) << i;
+    }
+    // cut short, or from another build
+    EXPECT_TRUE(Image::decode(std::string_view(image).substr(0, image.size() - 1), symbols).empty());
+    image[4] ^= 1;
+    EXPECT_TRUE(Image::decode(image, symbols).empty());
+}
+
+TEST_F(RiftScriptCache, executablesCarryTheirImage) {
+    auto& symbols = Isolate::current().symbols;
+    std::vector<std::unique_ptr<Script>> scripts;
+    scripts.push_back(compile());
+    auto image = Image::encode(scripts, symbols);
+
+    auto self = Image::self();
+    ASSERT_FALSE(self.empty());
+    ASSERT_TRUE(Image::write(path, image, true));
+    auto exe = MappedFile::open(path);
+    ASSERT_NE(exe, nullptr);
+    auto embedded = Image::embedded(exe->span());
+    ASSERT_EQ(embedded.size(), image.size());
+    EXPECT_EQ(std::string_view(embedded.data(), embedded.size()), image);
+    EXPECT_EQ(exe->span().size() - image.size(), std::filesystem::file_size(self) + 16);
+    EXPECT_NE(std::filesystem::status(path).permissions() & std::filesystem::perms::owner_exec, std::filesystem::perms::none);
+
+    // an executable that isn't one
+    EXPECT_TRUE(Image::embedded(MappedFile::open(self)->span()).empty());
+}
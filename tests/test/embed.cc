@@ -0,0 +1,147 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rift/rift.hh>
+#include <rift/rift.h>
+
+namespace embed = rift::embed;
+using embed::Runtime;
+using embed::Error;
+
+#pragma mark - Rift Embed (Tests)
+
+TEST(RiftEmbed, compileOnceCallMany) {
+    Runtime runtime;
+    auto script = runtime.compile("fun add(a, b) { return a + b; } fun greet(name) { return \"hi \" + name; }");
+
+    auto add = script.function("add");
+    double total = 0;
+    for (int i = 0; i < 1000; i++) total += runtime.call(add, {i, 0.5}).asNumber();
+    EXPECT_EQ(total, 999 * 1000 / 2 + 500);
+
+    auto res = runtime.call(script, "greet", {"rift"});
+    ASSERT_TRUE(res.isString());
+    EXPECT_EQ(res.asString(), "hi rift");
+
+    // the heap doesn't keep what the calls left behind
+    for (int i = 0; i < 100000; i++) runtime.call(script, "greet", {std::string(40, 'x')});
+    EXPECT_LT(runtime.isolate().heap.stats().objects, 100000u);
+}
+
+TEST(RiftEmbed, hostFunctions) {
+    Runtime runtime;
+    std::vector<double> seen;
+    runtime.define("scale", 2, [&](std::span<const embed::Value> args) {
+        seen.push_back(args[0].asNumber());
+        return embed::Value(args[0].asNumber() * args[1].asNumber());
+    });
+    auto script = runtime.compile("mut base = scale(2, 3); fun score(n) { return scale(n, base) + 1; }");
+    EXPECT_EQ(runtime.get("base"), embed::Value(6));
+    EXPECT_EQ(runtime.call(script, "score", {10}), embed::Value(61));
+    EXPECT_EQ(seen, (std::vector<double>{2, 10}));
+
+    // defined after the script, found when it runs
+    runtime.define("suffix", 1, [](std::span<const embed::Value> args) { return embed::Value(args[0].asString().str() + "!"); });
+    auto late = runtime.compile("fun shout(s) { return suffix(s); }");
+    EXPECT_EQ(runtime.call(late, "shout", {"hey"}), embed::Value("hey!"));
+    EXPECT_EQ(runtime.call(late, "suffix", {"direct"}), embed::Value("direct!"));
+}
+
+TEST(RiftEmbed, typedResults) {
+    Runtime runtime;
+    auto script = runtime.compile("mut x = 4; fun f() { return x; } fun kind(n) { if (n == 0) { return nil; } elif (n == 1) { return true; } elif (n == 2) { return \"two\"; } return f; }");
+    EXPECT_TRUE(runtime.call(script, "kind", {0}).isNil());
+    EXPECT_EQ(runtime.call(script, "kind", {1}), embed::Value(true));
+    EXPECT_EQ(runtime.call(script, "kind", {2}), embed::Value("two"));
+    auto fn = runtime.call(script, "kind", {3});
+    ASSERT_TRUE(fn.isFunction());
+    EXPECT_EQ(fn.asString(), "f");
+    EXPECT_EQ(runtime.get("x"), embed::Value(4));
+    EXPECT_TRUE(runtime.get("missing").isNil());
+}
+
+TEST(RiftEmbed, errorsAreThrown) {
+    Runtime runtime;
+    try {
+        runtime.compile("mut = 3;");
+        FAIL() << "compiled";
+    } catch (const Error& e) {
+        EXPECT_FALSE(e.runtime);
+    }
+
+    auto script = runtime.compile("fun sub(a, b) { return a - b; }");
+    EXPECT_THROW(runtime.call(script, "sub", {1}), Error);
+    EXPECT_THROW(runtime.call(script, "nope", {}), Error);
+    try {
+        runtime.call(script, "sub", {"a", 1});
+        FAIL() << "called";
+    } catch (const Error& e) {
+        EXPECT_TRUE(e.runtime);
+    }
+
+    // a host function failing unwinds the frames it was called from
+    runtime.define("fail", 0, [](std::span<const embed::Value>) -> embed::Value { throw std::runtime_error("host"); });
+    auto failing = runtime.compile("fun outer(n) { mut x = n; return fail(); }");
+    EXPECT_THROW(runtime.call(failing, "outer", {1}), std::runtime_error);
+    EXPECT_EQ(runtime.call(script, "sub", {5, 2}), embed::Value(3));
+}
+
+TEST(RiftEmbed, overflowsAreThrown) {
+    for (bool tiered : {false, true}) {
+        Runtime runtime(tiered);
+        auto script = runtime.compile("fun down(n) { if (n < 1) { return 0; } return down(n - 1); }");
+        auto down = script.function("down");
+        // warmed up, the tiered runtime overflows in native code
+        for (int i = 0; i < 2000; i++) runtime.call(down, {3});
+        try {
+            runtime.call(down, {1000000});
+            FAIL() << "returned";
+        } catch (const Error& e) {
+            EXPECT_TRUE(e.runtime) << tiered;
+            EXPECT_NE(std::string(e.what()).find("Stack overflow"), std::string::npos) << tiered;
+        }
+        EXPECT_EQ(runtime.call(down, {100}), embed::Value(0)) << tiered;
+    }
+}
+
+/// @note call sites remember the function their global held, assigning it again has to be seen
+TEST(RiftEmbed, reassignedCallees) {
+    Runtime runtime;
+    auto script = runtime.compile("fun one() { return 1; } fun two(x) { return 2; } mut f = one; fun use() { return f(); } fun swap() { f = two; }");
+    for (int i = 0; i < 3; i++) EXPECT_EQ(runtime.call(script, "use", {}), embed::Value(1));
+    runtime.call(script, "swap", {});
+    EXPECT_THROW(runtime.call(script, "use", {}), Error);
+
+    runtime.define("f", 0, [](std::span<const embed::Value>) { return embed::Value(3); });
+    EXPECT_EQ(runtime.call(script, "use", {}), embed::Value(3));
+}
+
+TEST(RiftEmbed, cInterface) {
+    auto runtime = rift_runtime_new(1);
+    int calls = 0;
+    rift_define(runtime, "twice", 1, [](void* data, const rift_value* args, size_t argc, rift_value* result) {
+        ++*static_cast<int*>(data);
+        if (argc != 1 || args[0].type != RIFT_NUMBER) return 1;
+        *result = rift_number(args[0].as.number * 2);
+        return 0;
+    }, &calls);
+
+    std::string source = "fun f(n, s) { return s + twice(n); }";
+    auto script = rift_compile(runtime, source.data(), source.size());
+    ASSERT_NE(script, nullptr) << rift_error(runtime);
+
+    rift_value args[] = {rift_number(21), rift_string("n=", 2)};
+    rift_value result;
+    ASSERT_EQ(rift_call(runtime, script, "f", args, 2, &result), 0) << rift_error(runtime);
+    ASSERT_EQ(result.type, RIFT_STRING);
+    EXPECT_EQ(std::string(result.as.string.data, result.as.string.size), "n=42");
+    EXPECT_EQ(calls, 1);
+
+    EXPECT_NE(rift_call(runtime, script, "f", args, 1, &result), 0);
+    EXPECT_NE(std::string(rift_error(runtime)), "");
+    EXPECT_EQ(rift_compile(runtime, "fun (", 5), nullptr);
+
+    rift_script_free(script);
+    rift_runtime_free(runtime);
+}
\ No newline at end of file
@@ -29,24 +29,22 @@ class RiftEvaluator : public ::testing::Test {
 
 TEST_F(RiftEvaluator, simpleEvalExpr) {
     // evaluate -1 + 2
-    auto expr = std::make_unique<Binary>(rift::ast::Binary(
-        std::make_unique<rift::ast::Unary>(
+    auto arena = std::make_unique<rift::Arena>();
+    auto expr = arena->make<Binary>(
+        arena->make<rift::ast::Unary>(
             rift::scanner::Token(TokenType::MINUS,"-", "", 1),
-            std::make_unique<rift::ast::Literal>(TOK_NUM(1))
+            arena->make<rift::ast::Literal>(TOK_NUM(1))
         ),
         rift::scanner::Token(TokenType::PLUS,"+", "", 1),
-        std::make_unique<rift::ast::Literal>(TOK_NUM(3))
-    ));
-
-    auto stmt_expr = std::make_unique<StmtExpr>(std::move(expr));
-    auto decl_stmt = std::make_unique<DeclStmt>(std::move(stmt_expr));
-    // emplace for no copies
-    std::vector<std::unique_ptr<Decl>> decls;
-    decls.emplace_back(std::move(decl_stmt));
-
-    // Create a unique_ptr to a vector of unique_ptr<Stmt>
-    auto program_statements = std::make_unique<std::vector<std::unique_ptr<Decl>>>(std::move(decls));
-    auto program = std::make_unique<Program>(std::move(program_statements));
+        arena->make<rift::ast::Literal>(TOK_NUM(3))
+    );
+
+    auto stmt_expr = arena->make<StmtExpr>(expr);
+    auto decl_stmt = arena->make<DeclStmt>(stmt_expr);
+    vec_prog decls = {decl_stmt};
+
+    // the program takes over the arena holding its nodes
+    auto program = std::make_unique<Program>(std::move(decls), std::move(arena));
     auto x = eval->evaluate((*program), true);
     EXPECT_EQ(x.at(0), "2");
 }
\ No newline at end of file
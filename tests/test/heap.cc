@@ -0,0 +1,126 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <vm/vm.hh>
+#include <utils/isolate.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::test;
+
+#pragma mark - Rift Heap (Fixtures)
+
+/// @brief a single value kept alive by hand
+class Root : public Heap::Roots {
+    public:
+        Root(Heap& heap) : Heap::Roots(heap) {}
+        void trace(Heap& heap) const override { heap.mark(value); }
+        Value value;
+};
+
+#pragma mark - Rift Heap (Tests)
+
+TEST(RiftHeap, sizeClasses) {
+    EXPECT_EQ(Heap::sizeClass(1), 0);
+    EXPECT_EQ(Heap::sizeClass(Heap::CLASSES[0]), 0);
+    EXPECT_EQ(Heap::sizeClass(Heap::CLASSES[0] + 1), 1);
+    EXPECT_EQ(Heap::sizeClass(Heap::CLASSES.back() + 1), Heap::LARGE);
+    EXPECT_EQ(Heap::sizeClass(sizeof(ObjString)), 0);
+
+    Heap heap;
+    auto str = heap.string(String("a"));
+    EXPECT_EQ(str.as.obj->cls, Heap::sizeClass(sizeof(ObjString)));
+    EXPECT_EQ(heap.stats().objects, 1u);
+    EXPECT_EQ(heap.stats().bytes, Heap::CLASSES[str.as.obj->cls]);
+    EXPECT_EQ(heap.stats().reserved, Heap::SLAB_SIZE);
+}
+
+TEST(RiftHeap, collectsWhatNoRootReaches) {
+    Heap heap;
+    Root root(heap);
+    root.value = heap.string(String("kept"));
+    std::vector<Obj*> garbage;
+    for (int i = 0; i < 100; i++) garbage.push_back(heap.string(String(std::to_string(i))).as.obj);
+
+    heap.collect();
+    EXPECT_EQ(heap.stats().collections, 1u);
+    EXPECT_EQ(heap.stats().freed, 100u);
+    EXPECT_EQ(heap.stats().objects, 1u);
+    EXPECT_EQ(root.value.asString(), "kept");
+
+    // freed slots are handed out again before the pool grows
+    auto reserved = heap.stats().reserved;
+    auto reused = heap.string(String("new")).as.obj;
+    EXPECT_NE(std::find(garbage.begin(), garbage.end(), reused), garbage.end());
+    EXPECT_EQ(heap.stats().reserved, reserved);
+}
+
+TEST(RiftHeap, pinsOutliveCollections) {
+    Heap heap;
+    Value pinned, loose;
+    {
+        Heap::Pins pins(heap);
+        {
+            Heap::Pinning pinning(heap, pins);
+            pinned = heap.string(String(std::string(100, 'p')));
+        }
+        loose = heap.string(String("loose"));
+        heap.collect();
+        EXPECT_EQ(heap.stats().objects, 1u);
+        EXPECT_EQ(pinned.asString(), std::string(100, 'p'));
+    }
+    // once the pins are gone, so is what they held
+    heap.collect();
+    EXPECT_EQ(heap.stats().objects, 0u);
+}
+
+TEST(RiftHeap, collectsWhileRunning) {
+    // each iteration leaves a string behind, enough of them to collect many times over
+    std::string source = "mut keep = \"\"; fun tag(n) { return \"tag-\" + n; }"
+                         "for (mut i = 0; i < 60000; i = i + 1) {"
+                         "  mut junk = \"................................................................\" + i;"
+                         "  if (i == 777) { keep = tag(i); }"
+                         "}"
+                         "print(keep); print(tag(1));";
+    for (bool vm : {false, true}) {
+        Isolate isolate;
+        EXPECT_EQ(run(isolate, source, vm), "tag-777\ntag-1\n") << vm;
+        EXPECT_GT(isolate.heap.stats().collections, 0u) << vm;
+        EXPECT_LT(isolate.heap.stats().objects, 60000u) << vm;
+    }
+}
+
+TEST(RiftHeap, memoryStaysFlat) {
+    for (bool vm : {false, true}) {
+        Isolate isolate;
+        std::string out;
+        isolate.output.redirect(Output::memory(out));
+        // one engine throughout, the globals of every run are the same
+        Eval eval(isolate);
+        rift::vm::VM machine(isolate);
+        auto evaluate = [&](const std::string& source) {
+            auto prgm = compile(isolate, source);
+            if (vm) machine.evaluate(*prgm, false);
+            else eval.evaluate(*prgm, false);
+        };
+
+        evaluate("mut last = nil; mut s = nil;");
+        std::vector<size_t> live;
+        for (int i = 0; i < 200; i++) {
+            evaluate("last = \"run \" + " + std::to_string(i) + " + \" of many\"; s = last + \"!\";");
+            isolate.heap.collect();
+            live.push_back(isolate.heap.stats().objects);
+        }
+        // the programs are gone and only the globals' strings are left
+        EXPECT_EQ(live[10], live.back()) << vm;
+        EXPECT_LE(live.back(), 2u) << vm;
+    }
+}
\ No newline at end of file
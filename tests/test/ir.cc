@@ -0,0 +1,212 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/env.hh>
+#include <ast/resolver.hh>
+#include <ir/builder.hh>
+#include <ir/passes.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using string = std::string;
+
+#pragma mark - Rift IR (Fixtures)
+
+class RiftIR : public ::testing::Test {
+
+    protected:
+        /// @note kept alive, instructions of a FUNC point into them
+        std::vector<std::unique_ptr<Program>> programs;
+
+        std::unique_ptr<ir::Module> lower(const string& source)
+        {
+            Environment::getInstance(false).clear(false);
+            programs.push_back(test::compile(Isolate::current(), source));
+            return ir::Builder().build(*programs.back());
+        }
+
+        /// @brief runs a single pass, returns what it changed
+        template <typename P>
+        static size_t run(ir::Function& fn)
+        {
+            P pass;
+            return pass.run(fn);
+        }
+
+        /// @brief how many instructions of fn are op
+        static size_t count(const ir::Function& fn, ir::Op op)
+        {
+            size_t n = 0;
+            for (auto block : fn.rpo())
+                for (auto inst : block->insts) n += inst->op == op;
+            return n;
+        }
+
+        /// @brief the only instruction of fn that is op
+        static ir::Inst* find(const ir::Function& fn, ir::Op op)
+        {
+            ir::Inst* ret = nullptr;
+            for (auto block : fn.rpo())
+                for (auto inst : block->insts)
+                    if (inst->op == op) { EXPECT_EQ(ret, nullptr) << ir::name(op); ret = inst; }
+            return ret;
+        }
+
+        /// @brief every block ends with its only terminator, phis have one operand per predecessor
+        static void verify(const ir::Function& fn)
+        {
+            for (auto block : fn.rpo()) {
+                ASSERT_NE(block->terminator(), nullptr) << fn.print();
+                for (size_t i = 0; i < block->insts.size(); i++) {
+                    auto inst = block->insts[i];
+                    EXPECT_EQ(inst->block, block);
+                    EXPECT_EQ(inst->terminator(), i + 1 == block->insts.size()) << fn.print();
+                    if (inst->op == ir::Op::PHI) { EXPECT_EQ(inst->operands.size(), block->preds.size()) << fn.print(); }
+                    for (auto operand : inst->operands) EXPECT_NE(operand->block, nullptr) << fn.print();
+                }
+            }
+        }
+};
+
+#pragma mark - Rift IR (Tests)
+
+TEST_F(RiftIR, localsBecomeValues) {
+    auto module = lower("fun f(a, b) { mut x = a; x = x + b; return x; }");
+    ASSERT_EQ(module->functions.size(), 2);
+    auto& f = *module->functions[1];
+    verify(f);
+    EXPECT_EQ(f.name, "f");
+    EXPECT_EQ(f.arity, 2);
+    // no loads or stores left for the locals, the return uses the sum directly
+    EXPECT_EQ(count(f, ir::Op::LOAD_GLOBAL) + count(f, ir::Op::STORE_GLOBAL), 0);
+    auto add = find(f, ir::Op::ADD);
+    ASSERT_NE(add, nullptr);
+    EXPECT_EQ(add->operands[0]->op, ir::Op::PARAM);
+    EXPECT_EQ(add->operands[1]->op, ir::Op::PARAM);
+    EXPECT_EQ(f.blocks[0]->terminator()->operands[0], add);
+}
+
+TEST_F(RiftIR, phisJoinBranchesAndLoops) {
+    auto module = lower("fun f(n) { mut s = 0; for (mut i = 0; i < n; i = i + 1) { s = s + i; } return s; }"
+                        "fun g(c) { mut x = 1; if (c) { x = 2; } else { x = 3; } return x; }");
+    auto& f = *module->functions[1];
+    auto& g = *module->functions[2];
+    verify(f);
+    verify(g);
+    // s and i are carried around the loop, nothing else is
+    EXPECT_EQ(count(f, ir::Op::PHI), 2);
+    auto phi = find(g, ir::Op::PHI);
+    ASSERT_NE(phi, nullptr);
+    ASSERT_EQ(phi->operands.size(), 2);
+    EXPECT_EQ(phi->operands[0]->constant.as.number, 2);
+    EXPECT_EQ(phi->operands[1]->constant.as.number, 3);
+
+    // the top level loop still gets its phi after a function was lowered (and pruned) before it
+    module = lower("fun f(x) { return x; } for (mut k = 0; k < 3; k = k + 1) { print(k); }");
+    auto& main = *module->functions[0];
+    verify(main);
+    phi = find(main, ir::Op::PHI);
+    ASSERT_NE(phi, nullptr) << main.print();
+    EXPECT_EQ(find(main, ir::Op::PRINT)->operands[0], phi);
+}
+
+TEST_F(RiftIR, specializesNumbers) {
+    auto module = lower("fun f(n) { mut s = 0; for (mut i = 0; i < 10; i = i + 1) { s = s + i * 2; } return s + n; }");
+    auto& f = *module->functions[1];
+    EXPECT_EQ(run<ir::TypeSpecialization>(f), 4);
+    verify(f);
+    // the loop only ever sees numbers, the parameter could be anything
+    EXPECT_EQ(count(f, ir::Op::NADD), 2);
+    EXPECT_EQ(count(f, ir::Op::NMUL), 1);
+    EXPECT_EQ(count(f, ir::Op::NLT), 1);
+    EXPECT_EQ(count(f, ir::Op::ADD), 1);
+    for (auto block : f.rpo())
+        for (auto inst : block->insts)
+            if (inst->op == ir::Op::PHI) { EXPECT_EQ(inst->type, ir::Type::NUMBER); }
+
+    auto strings = lower("fun f() { mut s = \"a\"; for (mut i = 0; i < 3; i = i + 1) { s = s + i; } return s; }");
+    run<ir::TypeSpecialization>(*strings->functions[1]);
+    EXPECT_EQ(count(*strings->functions[1], ir::Op::NADD), 1);
+    EXPECT_EQ(count(*strings->functions[1], ir::Op::ADD), 1);
+    EXPECT_EQ(find(*strings->functions[1], ir::Op::ADD)->type, ir::Type::STRING);
+}
+
+TEST_F(RiftIR, numbersEqualValues) {
+    auto module = lower("fun f(a, b) { mut x = a * b; mut y = b * a; if (a) { return a * b + 1; } return x + y + 1; }");
+    auto& f = *module->functions[1];
+    run<ir::TypeSpecialization>(f);
+    EXPECT_EQ(count(f, ir::Op::MUL), 3);
+    // the commuted product is x, the one returned early is dominated by x too
+    EXPECT_EQ(run<ir::GlobalValueNumbering>(f), 2);
+    verify(f);
+    EXPECT_EQ(count(f, ir::Op::MUL), 1);
+    EXPECT_EQ(find(f, ir::Op::MUL)->users.size(), 3);
+    // neither block of the two constants 1 dominates the other
+    EXPECT_EQ(count(f, ir::Op::CONST), 2);
+}
+
+TEST_F(RiftIR, hoistsInvariants) {
+    auto module = lower("fun f(n) { mut s = 0; for (mut i = 0; i < 10; i = i + 1) { s = s + (n == 1) + (3 * 4) + (n + 1); } return s; }");
+    auto& f = *module->functions[1];
+    run<ir::TypeSpecialization>(f);
+    // n == 1, 3 * 4 and their constants can't fail, n + 1 could and stays in the loop
+    EXPECT_EQ(run<ir::LoopInvariantCodeMotion>(f), 8);
+    verify(f);
+    f.dominators();
+    auto header = f.blocks[0]->succs[0];
+    ASSERT_EQ(header->preds.size(), 2);
+    for (auto op : {ir::Op::EQ, ir::Op::NMUL}) {
+        auto inst = find(f, op);
+        ASSERT_NE(inst, nullptr) << ir::name(op);
+        EXPECT_EQ(inst->block, f.blocks[0].get()) << ir::name(op);
+    }
+    for (auto block : f.rpo())
+        for (auto inst : block->insts)
+            if (inst->op == ir::Op::ADD && inst->operands[0]->op == ir::Op::PARAM) { EXPECT_NE(inst->block, f.blocks[0].get()); }
+}
+
+TEST_F(RiftIR, dropsDeadStores) {
+    auto module = lower("mut g = 1; g = 2; g = 3; print(g); g = 4; fun f() { return g; } g = 5; f(); g = 6;"
+                        "fun h(a) { mut unused = a == 2; mut risky = a * 3; mut kept = a; return kept; }");
+    auto& main = *module->functions[0];
+    // g = 2 is overwritten right away, g = 4 before the call could read it, their constants go too
+    EXPECT_EQ(run<ir::DeadStoreElimination>(main), 4);
+    verify(main);
+    std::vector<double> stored;
+    for (auto block : main.rpo())
+        for (auto inst : block->insts)
+            if (inst->op == ir::Op::STORE_GLOBAL && inst->label == "g") stored.push_back(inst->operands[0]->constant.as.number);
+    EXPECT_EQ(stored, (std::vector<double>{1, 3, 5, 6}));
+
+    auto& h = *module->functions[2];
+    run<ir::TypeSpecialization>(h);
+    // a * 3 might fail on something that isn't a number, so it stays
+    EXPECT_EQ(run<ir::DeadStoreElimination>(h), 2);
+    EXPECT_EQ(count(h, ir::Op::EQ), 0);
+    EXPECT_EQ(count(h, ir::Op::MUL), 1);
+    EXPECT_EQ(count(h, ir::Op::CONST), 1);
+}
+
+TEST_F(RiftIR, standardPipeline) {
+    auto module = lower("mut total = 0;"
+                        "fun sum(n) { mut s = 0; for (mut i = 0; i < n; i = i + 1) { mut k = 2 * 3; s = s + k; } return s > 10 || s == 0 ? s : -s; }"
+                        "total = sum(5); print(total ?? 0);");
+    auto passes = ir::PassManager::standard();
+    passes.run(*module);
+    ASSERT_EQ(passes.changes.size(), 4);
+    EXPECT_EQ(passes.changes[0].first, "types");
+    for (const auto& fn : module->functions) verify(*fn);
+
+    auto text = module->print();
+    EXPECT_NE(text.find("fun <main>(0) {"), string::npos) << text;
+    EXPECT_NE(text.find("fun sum(1) {"), string::npos) << text;
+    EXPECT_NE(text.find("store_global @total, %"), string::npos) << text;
+    EXPECT_NE(text.find("= phi ["), string::npos) << text;
+    EXPECT_NE(text.find("= nmul %"), string::npos) << text;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <utils/isolate.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::test;
+
+#pragma mark - Rift Isolate (Tests)
+
+TEST(RiftIsolate, keepsStateApart) {
+    Isolate a, b;
+    // names are looked up in each isolate's own table, whatever ids the default one hands out
+    Isolate::current().symbols.intern("only_in_default");
+    execute(a, "mut shared = 1;");
+    execute(b, "mut shared = \"two\";");
+    EXPECT_EQ(a.globals.getEnv("shared").as.number, 1);
+    EXPECT_EQ(b.globals.getEnv("shared").asString(), "two");
+
+    auto before = b.symbols.size();
+    execute(a, "mut only_in_a = 3;");
+    EXPECT_EQ(b.symbols.size(), before);
+    EXPECT_FALSE(b.globals.contains("only_in_a"));
+    EXPECT_FALSE(Isolate::current().globals.contains("only_in_a"));
+}
+
+TEST(RiftIsolate, entersForItsScope) {
+    Isolate isolate;
+    auto& outer = Isolate::current();
+    {
+        Isolate::Scope enter(isolate);
+        EXPECT_EQ(&Isolate::current(), &isolate);
+        EXPECT_EQ(&Symbols::getInstance(), &isolate.symbols);
+        EXPECT_EQ(&Heap::getInstance(), &isolate.heap);
+        EXPECT_EQ(&Environment::getInstance(false), &isolate.globals);
+    }
+    EXPECT_EQ(&Isolate::current(), &outer);
+}
+
+TEST(RiftIsolate, runsConcurrently) {
+    const std::string source =
+        "mut total = 0;"
+        "fun add(n) { return n + 1; }"
+        "for (mut i = 0; i < 2000; i = i + 1) { total = add(total); }"
+        "mut name = \"t\" + total;"
+        "name;";
+
+    Isolate reference;
+    auto expected = execute(reference, source);
+
+    std::vector<std::vector<std::string>> results(8);
+    std::vector<std::thread> workers;
+    for (auto& result : results)
+        workers.emplace_back([&] {
+            Isolate isolate;
+            result = execute(isolate, source);
+        });
+    for (auto& worker : workers) worker.join();
+
+    for (const auto& result : results)
+        EXPECT_EQ(result, expected);
+}
\ No newline at end of file
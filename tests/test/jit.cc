@@ -0,0 +1,148 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/env.hh>
+#include <ast/resolver.hh>
+#include <jit/jit.hh>
+#include <error/error.hh>
+#include <utils/isolate.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using string = std::string;
+
+#pragma mark - Rift JIT (Fixtures)
+
+/// @note diffs the tiered engine against the plain tree-walking evaluator
+class RiftJIT : public ::testing::Test {
+
+    protected:
+        /// @note kept alive, the callables the tests look at point into them
+        std::vector<std::unique_ptr<Program>> programs;
+
+        const Program& parse(const string& source)
+        {
+            programs.push_back(test::compile(Isolate::current(), source));
+            return *programs.back();
+        }
+
+        string run(const string& source, bool tiered)
+        {
+            Environment::getInstance(false).clear(false);
+            const auto& prgm = parse(source);
+            Eval eval;
+            eval.tiered(tiered);
+            testing::internal::CaptureStdout();
+            eval.evaluate(prgm, false);
+            return testing::internal::GetCapturedStdout();
+        }
+
+        void expectSame(const string& source)
+        {
+            auto ref = run(source, false);
+            EXPECT_EQ(ref, run(source, true)) << source;
+        }
+
+        /// @brief the function bound to a global by the last run
+        ObjCallable& callable(const string& name)
+        {
+            auto& env = Environment::getInstance(false);
+            return *env.get(env.slot(name)).asCallable();
+        }
+
+        /// @brief a loop calling call often enough for its callee to become hot
+        static string hot(const string& call)
+        {
+            return "mut acc = 0; for (mut k = 0; k < " + std::to_string(jit::HOT * 2) + "; k = k + 1) { acc = " + call + "; }\n";
+        }
+};
+
+#pragma mark - Rift JIT (Tests)
+
+TEST_F(RiftJIT, matchesInterpreter) {
+    expectSame("fun fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); } print(fib(20));");
+    expectSame("fun sum(n) { mut s = 0; for (mut i = 0; i < n; i = i + 1) { s = s + i * 2; } return s; } print(sum(5000));");
+    expectSame("fun sign(x) { if (x > 0) { return 1; } elif (x < 0 || x != x) { return -1; } else { return 0; } }" + hot("sign(k - 1000) + sign(0 / 0)") + "print(acc);");
+    expectSame("fun cmp(a, b) { return (a < b ? 1 : 0) + (a <= b ? 10 : 0) + (a >= b ? 100 : 0) + (a == b ? 1000 : 0); }" + hot("cmp(k, 0 / 0) + cmp(k, 3)") + "print(acc);");
+    expectSame("fun neg(x) { return -x / 4 + (!(x >= 1 && x <= 9) ? 1 : 0) + (!x ? 5 : 0); }" + hot("acc + neg(k)") + "print(acc); print(neg(0));");
+}
+
+TEST_F(RiftJIT, compilesHotFunctions) {
+    run("fun sq(x) { return x * x; } fun cold(x) { return x; }" + hot("sq(k)") + "print(cold(acc));", true);
+    auto& sq = callable("sq");
+    EXPECT_EQ(sq.tier.state, jit::Code::supported() ? jit::Tier::State::NATIVE : jit::Tier::State::GENERIC);
+    EXPECT_EQ(callable("cold").tier.state, jit::Tier::State::INTERPRETED);
+}
+
+TEST_F(RiftJIT, loopsCountTowardsHotness) {
+    // called only a handful of times, but its loop runs long enough to tier up
+    run("fun spin(n) { mut s = 0; for (mut i = 0; i < n; i = i + 1) { s = s + 1; } return s; } spin(" + std::to_string(jit::HOT) + "); print(spin(3));", true);
+    EXPECT_NE(callable("spin").tier.state, jit::Tier::State::INTERPRETED);
+}
+
+TEST_F(RiftJIT, deoptimizesOnOtherTypes) {
+    string source = "fun add(a, b) { return a + b; }" + hot("add(acc, 1)") + "print(acc);";
+    for (uint32_t i = 0; i < jit::MAX_DEOPTS; i++) source += "print(add(\"a\", \"b\"));";
+    EXPECT_EQ(run(source, true), "2000\n" + [] { string ab; for (uint32_t i = 0; i < jit::MAX_DEOPTS; i++) ab += "ab\n"; return ab; }());
+    EXPECT_EQ(callable("add").tier.state, jit::Tier::State::GENERIC);
+    EXPECT_EQ(callable("add").tier.code, nullptr);
+}
+
+TEST_F(RiftJIT, feedbackKeepsMixedFunctionsInterpreted) {
+    run("fun id(x) { return x; } id(\"s\");" + hot("id(k)") + "print(acc);", true);
+    EXPECT_EQ(callable("id").tier.state, jit::Tier::State::GENERIC);
+}
+
+TEST_F(RiftJIT, recursionStaysBounded) {
+    // compiled while recursing, the native calls share the interpreter's limit
+    expectSame("fun depth(n) { if (n < 1) return 0; return depth(n - 1) + 1; } print(depth(1000));");
+    EXPECT_EXIT(run("fun down(n) { return down(n + 1); } print(down(0));", true), ::testing::ExitedWithCode(1), "");
+}
+
+TEST_F(RiftJIT, overflowIsRaisedOutsideNativeCode) {
+    // the error is thrown once every native frame returned, so a host raising errors can catch it
+    auto& errors = Isolate::current().errors;
+    errors.raise = true;
+    bool raised = false;
+    try {
+        run("fun down(n) { if (n < 1) return 0; return down(n - 1); }"
+            "for (mut k = 0; k < 2000; k = k + 1) { down(3); }"
+            "print(down(1000000));", true);
+    } catch (const error::Error& err) {
+        raised = std::string(err.what()).find("Stack overflow") != std::string::npos;
+        testing::internal::GetCapturedStdout();
+    }
+    errors.raise = errors.runtime = false;
+    EXPECT_TRUE(raised);
+    EXPECT_EQ(callable("down").tier.state, jit::Tier::State::NATIVE);
+    // and the code still runs afterwards
+    expectSame("fun down(n) { if (n < 1) return 0; return down(n - 1); }"
+               "for (mut k = 0; k < 2000; k = k + 1) { down(3); } print(down(900));");
+}
+
+TEST_F(RiftJIT, rejectsWhatItCantCompile) {
+    run("mut g = 1;"
+        "fun prints(x) { print(x); return x; }"
+        "fun global(x) { return x + g; }"
+        "fun falls(x) { if (x > 1) { return 1; } }"
+        "fun other(x) { return global(x); }"
+        "fun self(x) { if (x < 1) { return 0; } return self(x - 1); }", false);
+    auto& env = Environment::getInstance(false);
+    for (auto name : {"prints", "global", "falls", "other"})
+        EXPECT_THROW(jit::Compiler(env.slot(name)).compile(callable(name)), jit::JitException) << name;
+    EXPECT_NO_THROW(jit::Compiler(env.slot("self")).compile(callable("self")));
+    // calls to itself are only direct through the global it is bound to
+    EXPECT_THROW(jit::Compiler(Address::GLOBAL).compile(callable("self")), jit::JitException);
+}
+
+TEST_F(RiftJIT, guardsItsOwnBinding) {
+    // rebound after it was compiled, the old function has to call the new one through the global
+    expectSame("fun f(n) { if (n < 1) return 0; return f(n - 1) + 1; } fun h(n) { return 100; }" + hot("f(3)") + "mut keep = f; f = h; print(keep(3));");
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <ast/optimizer.hh>
+#include <vm/vm.hh>
+#include <error/error.hh>
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+
+#pragma mark - Rift Lazy Parser (Fixtures)
+
+class RiftLazyParser : public ::testing::Test {
+
+    protected:
+        std::unique_ptr<Program> parse(const std::string& text, bool lazy)
+        {
+            Environment::getInstance(false).clear(false);
+            source = text;
+            scanner = std::make_unique<Scanner>(source);
+            scanner->scan_source();
+            Parser parser(scanner->tokens);
+            parser.lazy = lazy;
+            parser.kinds = &kinds;
+            auto prgm = parser.parse();
+            Resolver().resolve(*prgm);
+            Optimizer().optimize(*prgm);
+            return prgm;
+        }
+
+        std::string run(const Program& prgm)
+        {
+            Eval eval;
+            testing::internal::CaptureStdout();
+            eval.evaluate(prgm, false);
+            return testing::internal::GetCapturedStdout();
+        }
+
+        const std::string library =
+            "mut! scale = 3;"
+            "fun unused(n) { mut a = n * 2; mut b = a + 1; return a * b - n; }"
+            "fun twice(n) { fun inner(m) { return m * scale; } return inner(n) + inner(n); }"
+            "print(twice(7));";
+
+        std::string source;
+        std::unique_ptr<Scanner> scanner;
+        std::map<std::type_index, size_t> kinds;
+};
+
+#pragma mark - Rift Lazy Parser (Tests)
+
+TEST_F(RiftLazyParser, parsesBodiesOnFirstCall) {
+    auto eager = parse(library, false);
+    size_t all = 0;
+    for (auto [kind, count] : kinds) all += count;
+    auto expected = run(*eager);
+
+    kinds.clear();
+    auto lazy = parse(library, true);
+    size_t deferred = 0;
+    for (auto [kind, count] : kinds) deferred += count;
+    EXPECT_LT(deferred, all);
+    EXPECT_EQ(kinds[typeid(Block)], 0u);
+
+    EXPECT_EQ(run(*lazy), expected);
+    EXPECT_EQ(expected, "42\n");
+}
+
+TEST_F(RiftLazyParser, onlyMatchesBracketsUpFront) {
+    error::Raise raise;
+    // brackets that don't nest are found before anything runs
+    EXPECT_THROW(parse("fun broken() { if ( { mut } return; } print(\"ok\");", true), error::Error);
+    EXPECT_THROW(parse("fun broken() { mut a = [1, (2]; } print(\"ok\");", true), error::Error);
+
+    // never called, so the rest of its body is never parsed by the tree engine
+    auto prgm = parse("fun broken() { mut = ; } print(\"ok\");", true);
+    EXPECT_EQ(run(*prgm), "ok\n");
+    // until it is called
+    prgm = parse("fun broken() { mut = ; } print(\"ok\"); broken();", true);
+    testing::internal::CaptureStdout();
+    EXPECT_THROW(Eval().evaluate(*prgm, false), error::Error);
+    Isolate::current().output.flush();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "ok\n");
+    // the vm compiles every body before it runs any of them
+    prgm = parse("fun broken() { mut = ; } print(\"ok\");", true);
+    testing::internal::CaptureStdout();
+    EXPECT_THROW(rift::vm::VM().evaluate(*prgm, false), error::Error);
+    Isolate::current().output.flush();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+}
+
+TEST_F(RiftLazyParser, resolvesBodiesAgainstEarlierGlobals) {
+    // the local may reuse a name only declared after the function, like an eager parse
+    auto prgm = parse("fun f() { mut late = 2; return late; } mut late = 5; print(f() + late);", true);
+    EXPECT_EQ(run(*prgm), "7\n");
+}
\ No newline at end of file
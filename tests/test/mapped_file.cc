@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <utils/mapped_file.hh>
+
+#pragma mark - Rift MappedFile (Tests)
+
+TEST(RiftMappedFile, mapsRegularFiles) {
+    char path[] = "/tmp/rift_mapped_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    std::string src = "print(\"mapped\");";
+    ASSERT_EQ(write(fd, src.data(), src.size()), (ssize_t)src.size());
+    close(fd);
+
+    auto file = rift::MappedFile::open(path);
+    ASSERT_NE(file, nullptr);
+    EXPECT_TRUE(file->mapped());
+    EXPECT_EQ(std::string(file->span().begin(), file->span().end()), src);
+    unlink(path);
+}
+
+TEST(RiftMappedFile, fallsBackForPipesAndEmptyFiles) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string src = "mut x = 1;";
+    ASSERT_EQ(write(fds[1], src.data(), src.size()), (ssize_t)src.size());
+    close(fds[1]);
+
+    auto piped = rift::MappedFile::open("/dev/fd/" + std::to_string(fds[0]));
+    ASSERT_NE(piped, nullptr);
+    EXPECT_FALSE(piped->mapped());
+    EXPECT_EQ(std::string(piped->span().begin(), piped->span().end()), src);
+    close(fds[0]);
+
+    char path[] = "/tmp/rift_empty_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    auto empty = rift::MappedFile::open(path);
+    ASSERT_NE(empty, nullptr);
+    EXPECT_EQ(empty->span().size(), 0u);
+    unlink(path);
+
+    EXPECT_EQ(rift::MappedFile::open("/nonexistent/rift.rf"), nullptr);
+}
+TEST(RiftMappedFile, contentsEndInASentinel) {
+    // a whole page, nothing of the file's own mapping is left for the NUL
+    char path[] = "/tmp/rift_page_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    std::string src(sysconf(_SC_PAGESIZE), ' ');
+    ASSERT_EQ(write(fd, src.data(), src.size()), (ssize_t)src.size());
+    close(fd);
+
+    auto file = rift::MappedFile::open(path);
+    ASSERT_NE(file, nullptr);
+    EXPECT_TRUE(file->mapped());
+    ASSERT_EQ(file->span().size(), src.size());
+    EXPECT_EQ(file->span().data()[src.size()], '\0');
+    unlink(path);
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+    close(fds[1]);
+    auto piped = rift::MappedFile::open("/dev/fd/" + std::to_string(fds[0]));
+    ASSERT_NE(piped, nullptr);
+    EXPECT_EQ(piped->span().size(), 1u);
+    EXPECT_EQ(piped->span().data()[1], '\0');
+    close(fds[0]);
+}
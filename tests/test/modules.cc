@@ -0,0 +1,133 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <driver/modules.hh>
+#include <error/error.hh>
+#include <utils/isolate.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::test;
+namespace fs = std::filesystem;
+
+#pragma mark - Rift Modules (Fixtures)
+
+/// @brief a directory of module files, removed with the fixture
+class RiftModules : public ::testing::Test {
+    protected:
+        fs::path dir;
+
+        void SetUp() override {
+            dir = fs::temp_directory_path() / ("rift-modules-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+            fs::create_directories(dir);
+        }
+        void TearDown() override { fs::remove_all(dir); }
+
+        void write(const std::string& name, const std::string& source) {
+            fs::create_directories((dir / name).parent_path());
+            std::ofstream(dir / name) << source;
+        }
+
+        /// @brief runs source as a file of dir would, with its imports, returns what it printed
+        std::string run(Isolate& isolate, driver::Modules& modules, const std::string& source) {
+            std::string out;
+            isolate.output.redirect(Output::memory(out));
+            Isolate::Scope enter(isolate);
+            auto prgm = parse(isolate, source);
+            auto imported = modules.load(*prgm, dir);
+            // one resolver for all of them, like the driver's
+            Resolver resolver(isolate);
+            for (auto module : imported) resolver.resolve(*module->program);
+            resolver.resolve(*prgm);
+            modules.optimize(imported, *prgm);
+            Eval eval(isolate);
+            for (auto module : imported) eval.evaluate(*module->program, false);
+            eval.evaluate(*prgm, false);
+            isolate.output.flush();
+            programs.push_back(std::move(prgm));
+            return out;
+        }
+
+        std::vector<std::unique_ptr<Program>> programs;
+};
+
+#pragma mark - Rift Modules (Tests)
+
+TEST_F(RiftModules, importsRunOnceBeforeTheirImporter) {
+    write("util.rf", "fun twice(x) { return x * 2; } print(\"util\");");
+    write("lib/greet.rf", "import \"../util.rf\"; fun greet(n) { return \"hi \" + n + \" \" + twice(2); } print(\"greet\");");
+    write("conf.rf", "import \"util.rf\"; mut! scale = twice(21); print(\"conf\");");
+
+    Isolate isolate;
+    isolate.errors.raise = true;
+    driver::Modules modules(isolate);
+    auto out = run(isolate, modules, "import \"lib/greet.rf\"; import \"conf.rf\"; print(greet(\"rift\")); print(scale);");
+    EXPECT_EQ(out, "util\ngreet\nconf\nhi rift 4\n42\n");
+    EXPECT_EQ(modules.size(), 3u);
+
+    // cached and already run, a changed file is compiled and run again
+    EXPECT_EQ(run(isolate, modules, "import \"conf.rf\"; print(scale + 1);"), "43\n");
+    // it runs in the same globals, so it mustn't define twice again
+    write("util.rf", "mut thrice = 3; print(\"util 2\");");
+    fs::last_write_time(dir / "util.rf", fs::last_write_time(dir / "util.rf") + std::chrono::seconds(5));
+    EXPECT_EQ(run(isolate, modules, "import \"conf.rf\"; print(twice(thrice));"), "util 2\n6\n");
+}
+
+TEST_F(RiftModules, compilesEveryFileOfTheTree) {
+    // a wide tree, each module is scanned and parsed on its own
+    std::string root;
+    for (int i = 0; i < 32; i++) {
+        write("m" + std::to_string(i) + ".rf", "import \"base.rf\"; fun f" + std::to_string(i) + "() { return base + " + std::to_string(i) + "; }");
+        root += "import \"m" + std::to_string(i) + ".rf\";";
+    }
+    write("base.rf", "mut base = 100;");
+    root += "mut t = 0; for (mut i = 0; i < 1; i = i + 1) { t = f0() + f31(); } print(t);";
+
+    Isolate isolate;
+    isolate.errors.raise = true;
+    driver::Modules modules(isolate);
+    EXPECT_EQ(run(isolate, modules, root), "231\n");
+    EXPECT_EQ(modules.size(), 33u);
+}
+
+TEST_F(RiftModules, reportsBrokenImports) {
+    Isolate isolate;
+    isolate.errors.raise = true;
+    driver::Modules modules(isolate);
+    auto failure = [&](const std::string& source) { return test::failure([&] { run(isolate, modules, source); }); };
+
+    EXPECT_NE(failure("import \"missing.rf\";").find("can't be opened"), std::string::npos);
+    write("bad.rf", "mut x = ;");
+    EXPECT_NE(failure("import \"bad.rf\";").find("doesn't compile"), std::string::npos);
+    write("a.rf", "import \"b.rf\";");
+    write("b.rf", "import \"a.rf\";");
+    EXPECT_NE(failure("import \"a.rf\";").find("Circular import"), std::string::npos);
+    EXPECT_NE(failure("{ import \"a.rf\"; }").find("top level"), std::string::npos);
+
+    // two modules declaring the same global, like a file declaring it twice
+    write("one.rf", "mut shared = 1;");
+    write("two.rf", "mut! shared = 2;");
+    EXPECT_NE(failure("import \"one.rf\"; import \"two.rf\"; print(shared);").find("'shared' already declared"), std::string::npos);
+    write("three.rf", "mut other = 3;");
+    EXPECT_NE(failure("import \"three.rf\"; mut other = 4;").find("'other' already declared"), std::string::npos);
+    // a local of the same name is nobody else's business
+    write("four.rf", "mut mine = 4; fun f() { mut other = 5; return other; }");
+    EXPECT_EQ(run(isolate, modules, "import \"four.rf\"; mut yours = mine + f(); print(yours);"), "9\n");
+
+    // a program compiled without the driver can't import
+    std::string source = "import \"a.rf\";";
+    Isolate::Scope enter(isolate);
+    auto prgm = parse(isolate, source);
+    EXPECT_THROW(Resolver(isolate).resolve(*prgm), error::Error);
+}
@@ -0,0 +1,94 @@
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <ast/expr.hh>
+#include <ast/optimizer.hh>
+#include <utils/arena.hh>
+
+using namespace rift::ast;
+using rift::scanner::Token;
+using rift::scanner::TokenType;
+
+#pragma mark - Rift Optimizer (Fixtures)
+
+#define TOK_NUM(n) Token(TokenType::NUMERICLITERAL, #n, n, 1)
+#define TOK_STR(s) Token(TokenType::STRINGLITERAL, s, s, 1)
+#define TOK_OP(t, s) Token(TokenType::t, s, "", 1)
+
+class RiftOptimizer : public ::testing::Test {
+    protected:
+        std::unique_ptr<rift::Arena> arena = std::make_unique<rift::Arena>();
+
+        template <typename T, typename... Args>
+        T* make(Args&&... args) { return arena->make<T>(std::forward<Args>(args)...); }
+
+        /// @brief wraps the decls in a program and optimizes it
+        std::unique_ptr<Program> optimize(vec_prog decls) {
+            auto prgm = std::make_unique<Program>(std::move(decls), std::move(arena));
+            Optimizer().optimize(*prgm);
+            return prgm;
+        }
+
+        static const Literal* literal(const Expr* expr) { return dynamic_cast<const Literal*>(expr); }
+};
+
+#pragma mark - Rift Optimizer (Tests)
+
+TEST_F(RiftOptimizer, foldsConstantExpressions) {
+    // print((1 + 2) * -3);
+    auto expr = make<Binary>(
+        make<Grouping>(make<Binary>(make<Literal>(TOK_NUM(1)), TOK_OP(PLUS, "+"), make<Literal>(TOK_NUM(2)))),
+        TOK_OP(STAR, "*"),
+        make<Unary>(TOK_OP(MINUS, "-"), make<Literal>(TOK_NUM(3)))
+    );
+    auto print = make<StmtPrint>(expr);
+    auto prgm = optimize({make<DeclStmt>(print)});
+
+    auto res = literal(print->expr);
+    ASSERT_NE(res, nullptr);
+    EXPECT_EQ(res->value.type, TokenType::NUMERICLITERAL);
+    EXPECT_EQ(res->constant.as.number, -9);
+}
+
+TEST_F(RiftOptimizer, foldsStringConcatenation) {
+    // print("ri" + "ft" + 2);
+    auto expr = make<Binary>(
+        make<Binary>(make<Literal>(TOK_STR("ri")), TOK_OP(PLUS, "+"), make<Literal>(TOK_STR("ft"))),
+        TOK_OP(PLUS, "+"),
+        make<Literal>(TOK_NUM(2))
+    );
+    auto print = make<StmtPrint>(expr);
+    auto prgm = optimize({make<DeclStmt>(print)});
+
+    auto res = literal(print->expr);
+    ASSERT_NE(res, nullptr);
+    ASSERT_TRUE(res->constant.isString());
+    EXPECT_EQ(res->constant.asString(), "rift2");
+}
+
+TEST_F(RiftOptimizer, leavesRuntimeErrorsAlone) {
+    // print("a" - 1); still fails when it runs
+    auto expr = make<Binary>(make<Literal>(TOK_STR("a")), TOK_OP(MINUS, "-"), make<Literal>(TOK_NUM(1)));
+    auto print = make<StmtPrint>(expr);
+    auto prgm = optimize({make<DeclStmt>(print)});
+    EXPECT_EQ(print->expr, expr);
+}
+
+TEST_F(RiftOptimizer, dropsUnreachableArms) {
+    // if (false) print(1); elif (true) print(2); elif (3 > 2) print(3); else print(4);
+    auto arm = [&](Expr* cond, int n) {
+        return make<StmtIf::Stmt>(cond, static_cast<Stmt*>(make<StmtPrint>(make<Literal>(Token(TokenType::NUMERICLITERAL, std::to_string(n), n, 1)))));
+    };
+    auto taken = arm(make<Literal>(TOK_OP(TRUE, "true")), 2);
+    auto stmt = make<StmtIf>(
+        arm(make<Literal>(TOK_OP(FALSE, "false")), 1),
+        make<StmtIf::Stmt>(),
+        std::vector<StmtIf::Stmt*>{taken, arm(make<Binary>(make<Literal>(TOK_NUM(3)), TOK_OP(GREATER, ">"), make<Literal>(TOK_NUM(2))), 3)}
+    );
+    auto prgm = optimize({make<DeclStmt>(stmt)});
+
+    EXPECT_EQ(stmt->if_stmt, taken);
+    EXPECT_TRUE(stmt->elif_stmts.empty());
+    EXPECT_EQ(stmt->else_stmt, nullptr);
+}
\ No newline at end of file
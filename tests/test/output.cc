@@ -0,0 +1,116 @@
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <vm/vm.hh>
+#include <utils/isolate.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::test;
+
+#pragma mark - Rift Output (Fixtures)
+
+/// @brief counts the batches a sink receives, keeping their text
+class Batches : public Output::Sink {
+    public:
+        std::vector<std::string> batches;
+        void write(std::span<const std::string_view> parts) override {
+            batches.emplace_back();
+            for (auto part : parts) batches.back() += part;
+        }
+};
+
+#pragma mark - Rift Output (Tests)
+
+TEST(RiftOutput, batchesAProgram) {
+    for (bool vm : {false, true}) {
+        Isolate isolate;
+        auto sink = std::make_unique<Batches>();
+        auto batches = sink.get();
+        isolate.output.redirect(std::move(sink));
+        execute(isolate, "for (mut i = 0; i < 1000; i = i + 1) { print(i); } print(\"done\");", vm);
+
+        // a single batch once the program finished, not one write per line
+        ASSERT_EQ(batches->batches.size(), 1u) << vm;
+        std::string expect;
+        for (int i = 0; i < 1000; i++) expect += std::to_string(i) + "\n";
+        EXPECT_EQ(batches->batches[0], expect + "done\n");
+        EXPECT_EQ(isolate.output.pending(), 0u);
+    }
+}
+
+TEST(RiftOutput, flushPolicies) {
+    Isolate isolate;
+    std::string out;
+    isolate.output.redirect(Output::memory(out));
+    EXPECT_EQ(isolate.output.policy(), Output::Policy::FULL);
+
+    isolate.output.print(Value::number(1));
+    EXPECT_EQ(out, "");
+    EXPECT_EQ(isolate.output.pending(), 2u);
+
+    // a terminal sees every line as it is printed
+    isolate.output.policy(Output::Policy::LINE);
+    isolate.output.print(Value::boolean(true));
+    EXPECT_EQ(out, "1\ntrue\n");
+
+    // whatever the policy, the buffer doesn't grow past its capacity
+    isolate.output.policy(Output::Policy::FULL);
+    auto before = isolate.output.flushes();
+    std::string line(99, 'x');
+    for (size_t i = 0; i < 2 * Output::CAPACITY / 100; i++) isolate.output.write(line + "\n");
+    isolate.output.print(Value::nil());
+    EXPECT_GE(isolate.output.flushes(), before + 1);
+    EXPECT_LT(isolate.output.pending(), Output::CAPACITY);
+}
+
+TEST(RiftOutput, longStringsAreNotCopied) {
+    Isolate isolate;
+    // parts are only valid during the call, so the sink keeps copies and where they pointed
+    std::vector<std::pair<std::string, const char*>> seen;
+    struct Parts : public Output::Sink {
+        std::vector<std::pair<std::string, const char*>>& seen;
+        Parts(std::vector<std::pair<std::string, const char*>>& seen) : seen(seen) {}
+        void write(std::span<const std::string_view> parts) override { for (auto part : parts) seen.emplace_back(part, part.data()); }
+    };
+    isolate.output.redirect(std::make_unique<Parts>(seen));
+
+    auto text = isolate.heap.string(std::string(Output::PIN_MIN, 'p'));
+    isolate.output.print(Value::number(1));
+    isolate.output.print(text);
+    isolate.output.flush();
+    // the batch points at the string itself, between the buffered lines
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[0].first, "1\n");
+    EXPECT_EQ(seen[1].second, text.asString().view().data());
+    EXPECT_EQ(seen[2].first, "\n");
+}
+
+TEST(RiftOutput, fileDescriptorsAndCallbacks) {
+    Isolate isolate;
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    isolate.output.redirect(Output::fd(fds[1]));
+    execute(isolate, "print(\"" + std::string(Output::PIN_MIN, 'a') + "\"); print(2);");
+    close(fds[1]);
+
+    std::string got;
+    char buf[256];
+    for (ssize_t n; (n = read(fds[0], buf, sizeof(buf))) > 0;) got.append(buf, n);
+    close(fds[0]);
+    EXPECT_EQ(got, std::string(Output::PIN_MIN, 'a') + "\n2\n");
+
+    std::string lines;
+    isolate.output.redirect(Output::callback([&](std::string_view part) { lines += part; }));
+    execute(isolate, "print(3);");
+    EXPECT_EQ(lines, "3\n");
+}
\ No newline at end of file
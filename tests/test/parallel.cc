@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <error/error.hh>
+#include <utils/isolate.hh>
+#include <utils/scheduler.hh>
+
+#include "run.hh"
+
+using namespace rift;
+using namespace rift::ast;
+using namespace rift::scanner;
+using namespace rift::test;
+
+#pragma mark - Rift Parallel (Tests)
+
+TEST(RiftParallel, printsInIterationOrder) {
+    Scheduler::configure(4);
+    std::string body = "{ mut s = \"n\" + i; for (mut k = 0; k < 50; k = k + 1) { s = s + \"\"; } print(s); }";
+    auto seq = run("for (mut i = 0; i < 2000; i = i + 1) " + body);
+    auto par = run("parallel for (mut i = 0; i < 2000; i = i + 1) " + body);
+    EXPECT_EQ(par, seq);
+    EXPECT_EQ(par.substr(0, 6), "n0\nn1\n");
+
+    // the bound and step are read once, counting down and nothing to count work too
+    EXPECT_EQ(run("mut n = 3; parallel for (mut i = n; i >= 0; i = i - 2) { print(i); }"), "3\n1\n");
+    EXPECT_EQ(run("parallel for (mut i = 5; i < 5; i = i + 1) { print(i); } print(\"done\");"), "done\n");
+    EXPECT_EQ(run("fun sq(x) { return x * x; } mut base = 10; parallel for (mut i = 0; i <= 2; i = i + 1) print(base + sq(i));"), "10\n11\n14\n");
+}
+
+TEST(RiftParallel, bodiesOnlyWriteTheirOwnLocals) {
+    EXPECT_NE(failure("mut t = 0; parallel for (mut i = 0; i < 2; i = i + 1) { t = t + i; }").find("parallel for"), std::string::npos);
+    EXPECT_NE(failure("fun f() { mut t = 0; parallel for (mut i = 0; i < 2; i = i + 1) { t = i; } }").find("parallel for"), std::string::npos);
+    EXPECT_NE(failure("parallel for (mut i = 0; i < 2; i = i + 1) { i = i + 1; }").find("parallel for"), std::string::npos);
+    EXPECT_NE(failure("fun f() { parallel for (mut i = 0; i < 2; i = i + 1) { return i; } }").find("parallel for"), std::string::npos);
+    EXPECT_NE(failure("fun g() { return 1; } parallel for (mut i = 0; i < 2; i = i + 1) { mut t = spawn g(); }").find("parallel for"), std::string::npos);
+    EXPECT_NE(failure("parallel for (mut i = 0; i < 2; i = i * 2) { print(i); }").find("must count"), std::string::npos);
+    EXPECT_NE(failure("parallel for (mut i = 0; i < 2; i = i - 1) { print(i); }").find("towards its bound"), std::string::npos);
+
+    // locals of the body are its own, a function it calls can't write a global either
+    EXPECT_EQ(run("parallel for (mut i = 0; i < 3; i = i + 1) { mut t = i; t = t * 2; print(t); }"), "0\n2\n4\n");
+    EXPECT_NE(failure("mut g = 0; fun f() { g = 1; } parallel for (mut i = 0; i < 100; i = i + 1) { f(); }").find("global 'g'"), std::string::npos);
+}
+
+TEST(RiftParallel, errorsFollowTheOutputBeforeThem) {
+    Isolate isolate;
+    isolate.errors.raise = true;
+    std::string out;
+    isolate.output.redirect(Output::memory(out));
+    Isolate::Scope enter(isolate);
+    std::string source = "fun f(i) { if (i == 6) { return 1 + nil; } return i; } parallel for (mut i = 0; i < 10; i = i + 1) { print(f(i)); }";
+    auto prgm = compile(isolate, source);
+    EXPECT_THROW(Eval(isolate).evaluate(*prgm, false), error::Error);
+    isolate.output.flush();
+    // whatever came before the failing iteration in order, at least that much of it
+    EXPECT_EQ(out.substr(0, 12), "0\n1\n2\n3\n4\n5\n");
+    EXPECT_EQ(out.find("7\n"), std::string::npos);
+}
+
+TEST(RiftParallel, spawnAndAwait) {
+    Scheduler::configure(3);
+    auto out = run("fun sum(n) { mut t = 0; for (mut k = 0; k < n; k = k + 1) { t = t + k; } print(\"sum \" + n); return t; }"
+                   "fun name(a, b) { return a + \"-\" + b; }"
+                   "mut a = spawn sum(100); mut b = spawn sum(1000); mut c = spawn name(\"x\", 1);"
+                   "print(\"spawned\"); print(await b); print(await a); print(await c); print(await a);");
+    // tasks start when spawned, their output comes at the await, in the order they were spawned
+    EXPECT_EQ(out, "spawned\nsum 100\nsum 1000\n499500\n4950\nx-1\n4950\n");
+
+    // a task nobody awaits still runs, joined when the program ends
+    EXPECT_EQ(run("fun f() { print(\"ran\"); return 1; } spawn f(); print(\"end\");"), "end\nran\n");
+    EXPECT_EQ(run("fun f() { print(\"ran\"); } fun go() { spawn f(); return 1; } print(go());"), "1\nran\n");
+    // and reads the globals as they were when it was spawned
+    EXPECT_EQ(run("mut g = 1; fun f() { return g; } mut t = spawn f(); g = 2; print(await t); print(g);"), "1\n2\n");
+    EXPECT_EQ(run("mut g = 1; fun f() { return g; } mut a = spawn f(); g = 2; mut b = spawn f(); print(await b + await a);"), "3\n");
+
+    EXPECT_EQ(run("fun f(x) { return x * 2; } mut t = spawn f(21); print(await t);"), "42\n");
+    EXPECT_THROW(run("fun f() { return nil + 1; } mut t = spawn f(); await t;"), error::Error);
+    EXPECT_THROW(run("mut g = 0; fun f() { g = 1; } mut t = spawn f(); await t;"), error::Error);
+    EXPECT_THROW(run("await 3;"), error::Error);
+}
+
+TEST(RiftParallel, onlyTheTreeEnginesRunInParallel) {
+    Scheduler::configure(2);
+    // the vm would run the iterations one after another, it refuses them like it refuses tasks
+    EXPECT_NE(failure("parallel for (mut i = 0; i < 2; i = i + 1) { print(i); }", true).find("tree engines"), std::string::npos);
+    EXPECT_NE(failure("fun f() { return 1; } mut t = spawn f();", true).find("tree engines"), std::string::npos);
+    EXPECT_NE(failure("fun f(t) { return await t; }", true).find("tree engines"), std::string::npos);
+    EXPECT_EQ(run("parallel for (mut i = 0; i < 2; i = i + 1) { print(i); }"), "0\n1\n");
+}
+
+/// @note strings and comments full of spaces, quotes and slashes keep the chunks honest
+TEST(RiftParallel, scanningInChunksMatchesOneThread) {
+    Scheduler::configure(4);
+    std::string src;
+    for (int i = 0; src.size() < 3 * Scanner::CHUNK; i++) {
+        src += "mut! c" + std::to_string(i) + " = \"a // b \";  // \" not a string\n";
+        src += "mut s = \"\"\"two \" lines\n \"\" x\"\"\"   ;\t\r\n";
+        src += "fun f(x) { return x * 2.5 >= .5 ?? x / 3; }\n\n";
+    }
+
+    auto tokens = [&](size_t parallel) {
+        Scanner scanner(src);
+        scanner.parallel = parallel;
+        scanner.scan_source();
+        return scanner.tokens;
+    };
+    auto serial = tokens(SIZE_MAX), chunked = tokens(0);
+    ASSERT_EQ(chunked->size(), serial->size());
+    for (size_t i = 0; i < serial->size(); i++) {
+        const auto &a = (*serial)[i], &b = (*chunked)[i];
+        ASSERT_EQ(b.type, a.type) << i;
+        ASSERT_EQ(b.offset, a.offset) << i;
+        ASSERT_EQ(b.line, a.line) << i;
+        ASSERT_EQ(chunked->lexeme(b), serial->lexeme(a)) << i;
+    }
+    EXPECT_EQ((*chunked)[chunked->size()].type, TokenType::EOFF);
+
+    // two chunks, split right after mut!
+    src = std::string(Scanner::CHUNK - 4, ' ') + "mut!" + std::string(Scanner::CHUNK, ' ') + "x = 1;";
+    auto split = tokens(0);
+    ASSERT_EQ(split->size(), 5u);
+    EXPECT_EQ((*split)[1].type, TokenType::C_IDENTIFIER);
+
+    // an error inside a chunk is reported by the serial scan, at its own line
+    src += "\"never closed";
+    error::Raise raise;
+    auto message = [&](size_t parallel) {
+        try {
+            tokens(parallel);
+        } catch (const error::Error& err) {
+            return std::string(err.what());
+        }
+        return std::string();
+    };
+    EXPECT_NE(message(SIZE_MAX), "");
+    EXPECT_EQ(message(0), message(SIZE_MAX));
+}
@@ -1,10 +1,19 @@
 #include <scanner/scanner.hh>
 #include <ast/expr.hh>
+#include <ast/eval.hh>
+#include <ast/parser.hh>
 #include <ast/printer.hh>
+#include <ast/resolver.hh>
+#include <error/error.hh>
+#include <utils/arena.hh>
+#include <utils/isolate.hh>
 #include <gtest/gtest.h>
 
+#include "run.hh"
+
 using namespace rift::scanner;
 using string = std::string;
+using namespace rift::test;
 
 #pragma mark - Rift Parser (Printer Fixtures)
 
@@ -17,6 +26,7 @@ class RiftPrinter : public ::testing::Test {
         void SetUp() override { }
         void TearDown() override { }
 
+        rift::Arena arena;
 };
 
 #pragma mark - Rift Parser (Printer Tests)
@@ -24,12 +34,12 @@ class RiftPrinter : public ::testing::Test {
 TEST_F(RiftPrinter, simpleParseExpr) {
     // simple expression for the math operation -1 + 2
     rift::ast::Binary expr = rift::ast::Binary(
-        std::make_unique<rift::ast::Unary>(
+        arena.make<rift::ast::Unary>(
             rift::scanner::Token(TokenType::MINUS,"-", "", 1),
-            std::make_unique<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "1", 1, 1))
+            arena.make<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "1", 1, 1))
         ),
         rift::scanner::Token(TokenType::PLUS,"+", "", 1),
-        std::make_unique<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "2", 2, 1))
+        arena.make<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "2", 2, 1))
     );
     EXPECT_EQ(rift::ast::printer->print(&expr), "(+ (- 1) 2)");
 }
@@ -40,10 +50,10 @@ TEST_F(RiftPrinter, simpleParseExprGroup) {
 
     // [1*2]
     rift::ast::Grouping expr = rift::ast::Grouping(
-        std::make_unique<rift::ast::Binary>(
-            std::make_unique<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "1", 1, 1)),
+        arena.make<rift::ast::Binary>(
+            arena.make<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "1", 1, 1)),
             rift::scanner::Token(TokenType::STAR,"*", "", 1),
-            std::make_unique<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "2", 2, 1))
+            arena.make<rift::ast::Literal>(Token(TokenType::NUMERICLITERAL, "2", 2, 1))
         )
     );
 
@@ -55,9 +65,39 @@ TEST_F(RiftPrinter, simpleParseExprGroup) {
 
     // ([1*2] + 3)
     rift::ast::Binary expr3 = rift::ast::Binary(
-        std::make_unique<rift::ast::Grouping>(std::move(expr)),
+        arena.make<rift::ast::Grouping>(std::move(expr)),
         rift::scanner::Token(TokenType::PLUS,"+", "", 1),
-        std::make_unique<rift::ast::Literal>(std::move(expr2))
+        arena.make<rift::ast::Literal>(std::move(expr2))
     );
     EXPECT_EQ(rift::ast::printer->print(&expr3), "(+ [ (* 1 2)] 3)");
-}
\ No newline at end of file
+}
+
+#pragma mark - Rift Parser (Precedence Tests)
+
+TEST(RiftParser, precedenceTable) {
+    using rift::ast::Precedence, rift::ast::precedences;
+    EXPECT_EQ(precedences[TokenType::STAR], Precedence::FACTOR);
+    EXPECT_EQ(precedences[TokenType::NULLISH_COAL], Precedence::OR);
+    EXPECT_EQ(precedences[TokenType::EQUAL], Precedence::NONE);
+    EXPECT_EQ(precedences[TokenType::IDENTIFIER], Precedence::NONE);
+    EXPECT_LT(precedences[TokenType::LOG_AND], precedences[TokenType::EQUAL_EQUAL]);
+}
+
+TEST(RiftParser, operatorsClimbPrecedence) {
+    // left associative at every level
+    EXPECT_EQ(run("print(10 - 4 - 3);"), "3\n");
+    EXPECT_EQ(run("print(64 / 4 / 2);"), "8\n");
+    // tighter levels bind first
+    EXPECT_EQ(run("print(2 + 3 * 4 - 6 / 2);"), "11\n");
+    EXPECT_EQ(run("print(1 + 1 < 3 == 2 > 1);"), "true\n");
+    EXPECT_EQ(run("print(false && true || true);"), "true\n");
+    EXPECT_EQ(run("print((2 + 3) * 4);"), "20\n");
+    EXPECT_EQ(run("mut x = 0; x = 1 < 2 ? 3 + 4 : 5; print(x);"), "7\n");
+}
+
+TEST(RiftParser, missingOperandsAreReported) {
+    EXPECT_NE(failure("print(1 + );").find("Expected number after term operator"), string::npos);
+    EXPECT_NE(failure("print(2 * );").find("Expected number after factor operator"), string::npos);
+    EXPECT_NE(failure("print(1 == );").find("Expected expression after equality operator"), string::npos);
+    EXPECT_NE(failure("print(1 ? 2 3);").find("expected token not found"), string::npos);
+}
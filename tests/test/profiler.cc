@@ -0,0 +1,29 @@
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <ast/profiler.hh>
+
+using namespace rift;
+
+#pragma mark - Rift Profiler (Tests)
+
+TEST(RiftProfiler, samplesTheShadowStack) {
+    ast::Profiler prof(std::chrono::microseconds(200));
+    prof.enter("hot");
+    prof.at(7);
+
+    prof.start();
+    // burn cpu time until the timer fired a few times
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    volatile uint64_t spin = 0;
+    while (prof.samples() < 5 && std::chrono::steady_clock::now() < until) spin = spin + 1;
+    prof.stop();
+    prof.leave();
+
+    ASSERT_GE(prof.samples(), 5u);
+    std::ostringstream out;
+    prof.collapsed(out);
+    EXPECT_EQ(out.str().rfind("<main>:0;hot:7 ", 0), 0u);
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/resolver.hh>
+#include <vm/vm.hh>
+#include <error/error.hh>
+#include <utils/isolate.hh>
+
+/// @brief the scan, parse, resolve and run pipeline the tests share
+/// @note the lazy parser, scanner and symbol tests drive the stages they look at themselves
+namespace rift::test
+{
+    /// @brief scans and parses source in isolate, leaving it unresolved
+    /// @note source must outlive the program, its tokens are spans into it
+    inline std::unique_ptr<ast::Program> parse(Isolate& isolate, const std::string& source)
+    {
+        Isolate::Scope enter(isolate);
+        scanner::Scanner scanner(source, isolate);
+        scanner.scan_source();
+        return ast::Parser(scanner.tokens, isolate).parse();
+    }
+
+    /// @brief scans, parses and resolves source in isolate
+    inline std::unique_ptr<ast::Program> compile(Isolate& isolate, const std::string& source)
+    {
+        Isolate::Scope enter(isolate);
+        auto prgm = parse(isolate, source);
+        ast::Resolver(isolate).resolve(*prgm);
+        return prgm;
+    }
+
+    /// @brief runs source start to finish inside isolate on the tree engine (or the vm),
+    ///        printing wherever isolate's output goes, returns the top level results
+    inline std::vector<std::string> execute(Isolate& isolate, const std::string& source, bool vm = false)
+    {
+        Isolate::Scope enter(isolate);
+        auto prgm = compile(isolate, source);
+        if (!vm) return ast::Eval(isolate).evaluate(*prgm, false);
+        return rift::vm::VM(isolate).evaluate(*prgm, false);
+    }
+
+    /// @brief what source printed run inside isolate, flushed even when it throws
+    inline std::string run(Isolate& isolate, const std::string& source, bool vm = false)
+    {
+        std::string out;
+        isolate.output.redirect(Output::memory(out));
+        try {
+            execute(isolate, source, vm);
+        } catch (...) {
+            isolate.output.flush();
+            throw;
+        }
+        isolate.output.flush();
+        return out;
+    }
+
+    /// @brief what a program printed on its own isolate, its errors are thrown
+    inline std::string run(const std::string& source, bool vm = false)
+    {
+        Isolate isolate;
+        isolate.errors.raise = true;
+        return run(isolate, source, vm);
+    }
+
+    /// @brief the message of the error fn raises, empty when it runs through
+    template <typename F>
+        requires std::invocable<F>
+    inline std::string failure(F&& fn)
+    {
+        try {
+            fn();
+        } catch (const error::Error& err) {
+            return err.what();
+        }
+        return "";
+    }
+
+    /// @brief the message of the error source raises
+    inline std::string failure(const std::string& source, bool vm = false)
+    {
+        return failure([&] { run(source, vm); });
+    }
+}
@@ -15,8 +15,17 @@ class RiftScanner : public ::testing::Test {
     protected:
         RiftScanner() {}
         ~RiftScanner() override {}
-        void SetUp() override { this->scanner = new Scanner(std::make_shared<std::vector<char>>()); }
+        void SetUp() override { this->scanner = nullptr; }
         void TearDown() override { delete this->scanner; }
+
+        /// @brief scans src, which the fixture keeps alive for the tokens
+        void scan(const string& src) {
+            this->source = src;
+            this->scanner = new Scanner(this->source);
+            this->scanner->scan_source();
+        }
+
+        string source;
         Scanner *scanner;
 };
 
@@ -24,14 +33,80 @@ class RiftScanner : public ::testing::Test {
 
 TEST_F(RiftScanner, simpleScanner)
 {
-    scanner->source->clear();
-    scanner->source->push_back('1');
-    scanner->source->push_back('+');
-    scanner->source->push_back('2');
-    scanner->scan_source();
-    auto &tokens = scanner->tokens;
-
-    EXPECT_EQ(tokens[0].lexeme, "1");
-EXPECT_EQ(tokens[1].lexeme, "+");
-    EXPECT_EQ(tokens[2].lexeme, "2");
+    scan("1+2");
+    auto &tokens = *scanner->tokens;
+
+    EXPECT_EQ(tokens.lexeme(tokens[0]), "1");
+    EXPECT_EQ(tokens.lexeme(tokens[1]), "+");
+    EXPECT_EQ(tokens.lexeme(tokens[2]), "2");
+}
+
+TEST_F(RiftScanner, compactTokens)
+{
+    scan("mut x = \"hi\";\nprint(x >= 10);");
+    auto &tokens = *scanner->tokens;
+
+    ASSERT_EQ(tokens.size(), 12u);
+    EXPECT_EQ(tokens[0].type, TokenType::VAR);
+    EXPECT_EQ(tokens.lexeme(tokens[0]), "mut");
+    EXPECT_EQ(tokens.lexeme(tokens[3]), "hi");
+    // the span of a string is its contents, without the quotes
+    EXPECT_EQ(tokens[3].offset, 9u);
+    EXPECT_EQ(tokens[3].length, 2u);
+    EXPECT_EQ(tokens[5].line, 2u);
+    EXPECT_EQ(tokens.lexeme(tokens[8]), ">=");
+
+    // only tokens kept by the AST get a lexeme of their own
+    auto tok = tokens.token(tokens[1]);
+    EXPECT_EQ(tok.type, TokenType::IDENTIFIER);
+    EXPECT_EQ(tok.lexeme, "x");
+    EXPECT_EQ(tok.line, 1);
+}
+
+TEST_F(RiftScanner, keywordsNeedAWordBoundary)
+{
+    scan("format formula mutable iffy for mut! x");
+    auto &tokens = *scanner->tokens;
+
+    ASSERT_EQ(tokens.size(), 7u);
+    for (int i = 0; i < 4; i++) EXPECT_EQ(tokens[i].type, TokenType::IDENTIFIER);
+    EXPECT_EQ(tokens.lexeme(tokens[0]), "format");
+    EXPECT_EQ(tokens[4].type, TokenType::FOR);
+    EXPECT_EQ(tokens[5].type, TokenType::CONST);
+    EXPECT_EQ(tokens.lexeme(tokens[5]), "mut!");
+    EXPECT_EQ(tokens[6].type, TokenType::C_IDENTIFIER);
+}
+
+TEST_F(RiftScanner, commentsAndLines)
+{
+    scan("mut a = 1; // mut b = 2;\n\n\"\"\"two\nlines\"\"\"   \t\r\nx");
+    auto &tokens = *scanner->tokens;
+
+    ASSERT_EQ(tokens.size(), 7u);
+    EXPECT_EQ(tokens[4].type, TokenType::SEMICOLON);
+    EXPECT_EQ(tokens[5].type, TokenType::STRINGLITERAL);
+    EXPECT_EQ(tokens.lexeme(tokens[5]), "two\nlines");
+    EXPECT_EQ(tokens[5].line, 4u);
+    EXPECT_EQ(tokens[6].line, 5u);
+}
+
+TEST_F(RiftScanner, tokensEndInASentinel)
+{
+    scan("a + 1");
+    auto &tokens = *scanner->tokens;
+
+    ASSERT_EQ(tokens.size(), 3u);
+    EXPECT_EQ(tokens[3].type, TokenType::EOFF);
+    EXPECT_EQ(std::span<const CompactToken>(tokens).size(), 3u);
+    EXPECT_EQ(tokens.end() - tokens.begin(), 3);
+}
+
+TEST(RiftKeywords, perfectHashLookup)
+{
+    for (const auto& kw : keywords::LIST)
+        EXPECT_EQ(keywords::lookup(kw.word), kw.type) << kw.word;
+
+    EXPECT_EQ(keywords::lookup("fo"), TokenType::IDENTIFIER);
+    EXPECT_EQ(keywords::lookup("returns"), TokenType::IDENTIFIER);
+    EXPECT_EQ(keywords::lookup("x"), TokenType::IDENTIFIER);
 }
\ No newline at end of file
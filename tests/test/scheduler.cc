@@ -0,0 +1,120 @@
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <utils/scheduler.hh>
+
+using namespace rift;
+
+#pragma mark - Rift Scheduler (Fixtures)
+
+/// @brief counts its runs, and where it ran
+class Count : public Scheduler::Task {
+    public:
+        std::atomic<size_t>& runs;
+        std::thread::id ran;
+        Count(std::atomic<size_t>& runs) : runs(runs) {}
+        void run() override {
+            ran = std::this_thread::get_id();
+            // long enough that the other workers come to steal
+            for (std::atomic<int> i = 0; i.load(std::memory_order_relaxed) < 20000; i.fetch_add(1, std::memory_order_relaxed)) {}
+            runs++;
+        }
+};
+
+#pragma mark - Rift Scheduler (Tests)
+
+TEST(RiftScheduler, dequeEnds) {
+    Deque<int> deque(2);
+    std::vector<int> items(1000);
+    for (auto& item : items) deque.push(&item);
+    EXPECT_EQ(deque.size(), items.size());
+    // the owner takes the newest, a thief the oldest, the ring grew without losing any
+    EXPECT_EQ(deque.pop(), &items.back());
+    EXPECT_EQ(deque.steal(), &items.front());
+    for (size_t i = 1; i + 1 < items.size(); i++) EXPECT_EQ(deque.steal(), &items[i]);
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(RiftScheduler, everyItemOnce) {
+    Deque<int> deque;
+    std::vector<int> items(100000);
+    std::vector<std::atomic<int>> taken(items.size());
+    std::atomic<bool> done = false;
+    auto take = [&](int* item) { if (item != nullptr) taken[item - items.data()]++; };
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; i++)
+        thieves.emplace_back([&] { while (!done) take(deque.steal()); });
+    for (size_t i = 0; i < items.size(); i++) {
+        deque.push(&items[i]);
+        if (i % 3 == 0) take(deque.pop());
+    }
+    while (!deque.empty()) take(deque.pop());
+    done = true;
+    for (auto& thief : thieves) thief.join();
+    for (const auto& count : taken) ASSERT_EQ(count.load(), 1);
+}
+
+TEST(RiftScheduler, waitRunsEveryTask) {
+    for (size_t workers : {0, 1, 4}) {
+        Scheduler pool(workers);
+        std::atomic<size_t> runs = 0;
+        std::vector<std::unique_ptr<Count>> tasks;
+        Scheduler::Group group;
+        for (int i = 0; i < 200; i++) {
+            tasks.push_back(std::make_unique<Count>(runs));
+            pool.spawn(group, *tasks.back());
+        }
+        pool.wait(group);
+        EXPECT_TRUE(group.done());
+        EXPECT_EQ(runs.load(), 200u) << workers;
+        EXPECT_EQ(pool.stats().executed, 200u);
+
+        std::set<std::thread::id> threads;
+        for (const auto& task : tasks) threads.insert(task->ran);
+        if (workers == 0) { EXPECT_EQ(threads, std::set<std::thread::id>{std::this_thread::get_id()}); }
+        else { EXPECT_GT(threads.size(), 1u); }
+    }
+}
+
+TEST(RiftScheduler, nestedTasksAreStolen) {
+    Scheduler pool(4);
+    std::atomic<size_t> runs = 0;
+    std::atomic<bool> started = false;
+
+    // a task on a worker fans out onto its own deque, the others (and the waiter) steal from it
+    struct Fan : public Scheduler::Task {
+        Scheduler& pool;
+        std::atomic<size_t>& runs;
+        std::atomic<bool>& started;
+        std::vector<std::unique_ptr<Count>> children;
+        Fan(Scheduler& pool, std::atomic<size_t>& runs, std::atomic<bool>& started) : pool(pool), runs(runs), started(started) {}
+        void run() override {
+            Scheduler::Group group;
+            for (int i = 0; i < 64; i++) {
+                children.push_back(std::make_unique<Count>(runs));
+                pool.spawn(group, *children.back());
+            }
+            started = true;
+            // even on one core, give the others a moment to come and take some
+            auto until = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            while (pool.stats().stolen == 0 && std::chrono::steady_clock::now() < until) std::this_thread::yield();
+            pool.wait(group);
+        }
+    };
+
+    Fan fan(pool, runs, started);
+    Scheduler::Group group;
+    pool.spawn(group, fan);
+    // a worker has to take the fan, were it this thread its children would go to the shared queue
+    while (!started) std::this_thread::yield();
+    pool.wait(group);
+    EXPECT_EQ(runs.load(), 64u);
+    EXPECT_GT(pool.stats().stolen, 0u);
+}
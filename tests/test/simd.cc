@@ -0,0 +1,50 @@
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <scanner/simd.hh>
+
+using namespace rift::scanner;
+
+#pragma mark - Rift Scanner SIMD (Tests)
+
+/// @note every kernel this cpu supports has to agree with the scalar one, on every offset
+TEST(RiftSimd, kernelsMatchScalar) {
+    const auto& ref = *simd::kernels(simd::Level::SCALAR);
+    const std::string alphabet = "  \t\r\n\nab_Z09\"\"/;+\x80\xff";
+    std::mt19937 rng(42);
+
+    for (auto level : {simd::Level::SSE2, simd::Level::AVX2, simd::Level::NEON}) {
+        auto k = simd::kernels(level);
+        if (k == nullptr) continue;
+
+        for (int round = 0; round < 200; round++) {
+            // long runs of one class so the vector loops cross several steps
+            std::string src;
+            while (src.size() < 160) {
+                char c = alphabet[rng() % alphabet.size()];
+                src.append(rng() % 40, c);
+            }
+
+            for (size_t off = 0; off < src.size(); off += 7) {
+                const char* p = src.data() + off;
+                size_t n = src.size() - off, a = 0, b = 0;
+
+                EXPECT_EQ(k->skipWhitespace(p, n, a), ref.skipWhitespace(p, n, b)) << k->name;
+                EXPECT_EQ(a, b) << k->name;
+                EXPECT_EQ(k->identifierEnd(p, n), ref.identifierEnd(p, n)) << k->name;
+                EXPECT_EQ(k->digitsEnd(p, n), ref.digitsEnd(p, n)) << k->name;
+                EXPECT_EQ(k->lineEnd(p, n), ref.lineEnd(p, n)) << k->name;
+                a = b = 0;
+                EXPECT_EQ(k->findQuote(p, n, a), ref.findQuote(p, n, b)) << k->name;
+                EXPECT_EQ(a, b) << k->name;
+            }
+        }
+    }
+}
+
+TEST(RiftSimd, dispatchPicksASupportedLevel) {
+    const auto& best = simd::kernels();
+    EXPECT_EQ(simd::kernels(best.level), &best);
+    EXPECT_NE(simd::kernels(simd::Level::SCALAR), nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <driver/stats.hh>
+#include <ast/expr.hh>
+#include <utils/alloc.hh>
+
+using namespace rift;
+
+#pragma mark - Rift Stats (Tests)
+
+TEST(RiftStats, countsAllocationsOnlyWhileTracking) {
+    alloc::track(false);
+    auto before = alloc::counts();
+    auto untracked = std::make_unique<int>(1);
+    EXPECT_EQ((alloc::counts() - before).allocations, 0u);
+
+    driver::Stats stats;
+    auto ptr = stats.time("phase", [] { return std::make_unique<long>(2); });
+    EXPECT_FALSE(alloc::tracking());
+    ASSERT_EQ(stats.phases.size(), 1u);
+    EXPECT_EQ(stats.phases[0].name, "phase");
+    EXPECT_EQ(stats.phases[0].heap.allocations, 1u);
+    EXPECT_EQ(stats.phases[0].heap.bytes, sizeof(long));
+    EXPECT_EQ(*ptr, 2);
+}
+
+/// @note no allocator hands out half the address space, the handler runs every time it fails
+TEST(RiftStats, hookCallsTheNewHandler) {
+    static int calls;
+    calls = 0;
+    auto previous = std::set_new_handler([] {
+        if (++calls == 3) std::set_new_handler(nullptr);
+    });
+    void* ptr = nullptr;
+    EXPECT_THROW(ptr = ::operator new(SIZE_MAX / 2), std::bad_alloc);
+    std::set_new_handler(previous);
+    EXPECT_EQ(ptr, nullptr);
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(RiftStats, namesNodeKinds) {
+    driver::Stats stats;
+    stats.kinds[typeid(ast::Binary)] = 2;
+    stats.kinds[typeid(ast::Literal)] = 3;
+    EXPECT_EQ(stats.nodes(), 5u);
+    EXPECT_EQ(driver::Stats::kind(typeid(ast::Binary)), "Binary");
+
+    std::ostringstream out;
+    stats.json(out);
+    EXPECT_NE(out.str().find("\"Literal\": 3"), std::string::npos);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <string>
+
+#include <gtest/gtest.h>
+#include <utils/string.hh>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/env.hh>
+#include <ast/resolver.hh>
+
+#include "run.hh"
+
+using rift::String;
+
+#pragma mark - Rift String (Tests)
+
+TEST(RiftString, shortStringsStayInline) {
+    String empty, a("rift"), full(std::string(String::INLINE, 'x'));
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(a.inlined());
+    EXPECT_TRUE(full.inlined());
+    EXPECT_EQ(a.view(), "rift");
+    EXPECT_EQ(full.size(), String::INLINE);
+
+    String copy = a;
+    EXPECT_EQ(copy, a);
+    EXPECT_EQ(copy.refs(), 0u);
+    EXPECT_FALSE(String(std::string(String::INLINE + 1, 'x')).inlined());
+}
+
+TEST(RiftString, copiesShareTheirBuffer) {
+    String a(std::string(100, 'a'));
+    EXPECT_EQ(a.refs(), 1u);
+    {
+        String b = a, c = b;
+        EXPECT_EQ(a.refs(), 3u);
+        EXPECT_EQ(b.view().data(), a.view().data());
+        String d = std::move(c);
+        EXPECT_EQ(a.refs(), 3u);
+        EXPECT_TRUE(c.empty());
+    }
+    EXPECT_EQ(a.refs(), 1u);
+}
+
+TEST(RiftString, concatenationMakesRopes) {
+    String hello("hello "), world("world");
+    // short results are copied flat
+    String small = hello + world;
+    EXPECT_FALSE(small.rope());
+    EXPECT_EQ(small, "hello world");
+
+    String left(std::string(40, 'l')), right(std::string(40, 'r'));
+    String rope = left + right;
+    EXPECT_TRUE(rope.rope());
+    EXPECT_EQ(rope.size(), 80u);
+    EXPECT_EQ(left.refs(), 2u);
+
+    // flattened once, every copy of the rope sees the flat text
+    String copy = rope;
+    EXPECT_EQ(rope.view(), std::string(40, 'l') + std::string(40, 'r'));
+    EXPECT_FALSE(copy.rope());
+    EXPECT_EQ(copy.view().data(), rope.view().data());
+    EXPECT_EQ(left.refs(), 1u);
+}
+
+TEST(RiftString, deepRopes) {
+    // appending in a loop nests the ropes as deep as the loop runs
+    String text;
+    std::string expect;
+    for (int i = 0; i < 100000; i++) {
+        String part(std::to_string(i % 10));
+        text = text + part;
+        expect += std::to_string(i % 10);
+    }
+    EXPECT_GT(text.depth(), 1000u);
+    String copy = text;
+    EXPECT_EQ(copy.compare(text), 0);
+    EXPECT_EQ(text.view(), expect);
+    EXPECT_LT(String("0").compare(text), 0);
+    EXPECT_GT(String("1").compare(text), 0);
+    EXPECT_NE(text, String(expect.substr(1)));
+}
+
+TEST(RiftString, quotesAreStrippedOnce) {
+    using namespace rift;
+    ast::Environment::getInstance(false).clear(false);
+    std::string source = "mut a = \"ab\"; mut b = \"\"\"c\nd\"\"\"; print(a + b);";
+    auto prgm = test::compile(Isolate::current(), source);
+    testing::internal::CaptureStdout();
+    ast::Eval().evaluate(*prgm, false);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "abc\nd\n");
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <memory>
+#include <span>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <utils/flat_map.hh>
+#include <utils/symbols.hh>
+
+using namespace rift;
+
+#pragma mark - Rift Symbols (Tests)
+
+TEST(RiftSymbols, internsEqualNamesOnce) {
+    auto& symbols = Symbols::getInstance();
+    auto count = symbols.intern("count");
+    EXPECT_NE(count, Symbols::NONE);
+    EXPECT_EQ(symbols.intern(std::string("co") + "unt"), count);
+    EXPECT_NE(symbols.intern("counter"), count);
+    EXPECT_EQ(symbols.name(count), "count");
+    EXPECT_EQ(symbols.intern(""), Symbols::NONE);
+
+    // views stay valid while the table grows
+    auto view = symbols.name(count);
+    for (int i = 0; i < 5000; i++) symbols.intern("sym" + std::to_string(i));
+    EXPECT_EQ(view, "count");
+    EXPECT_EQ(symbols.intern("sym42"), symbols.intern("sym42"));
+}
+
+TEST(RiftSymbols, scannerInternsIdentifiers) {
+    std::string source = "mut total = 1; mut! limit = total; total = limit;";
+    scanner::Scanner scanner(std::span<const char>(source.data(), source.size()));
+    scanner.scan_source();
+    auto& tokens = *scanner.tokens;
+
+    EXPECT_EQ(tokens[1].type, scanner::TokenType::IDENTIFIER);
+    EXPECT_EQ(tokens[6].type, scanner::TokenType::C_IDENTIFIER);
+    EXPECT_EQ(tokens[1].symbol, tokens[8].symbol);
+    EXPECT_EQ(tokens[6].symbol, tokens[12].symbol);
+    EXPECT_EQ(tokens.lexeme(tokens[6]), "limit");
+    EXPECT_EQ(tokens.token(tokens[1]).symbol, Symbols::getInstance().intern("total"));
+}
+
+TEST(RiftSymbols, flatMapProbesAndGrows) {
+    FlatMap<SymbolId, uint32_t> map;
+    EXPECT_EQ(map.find(7), nullptr);
+    for (uint32_t i = 0; i < 1000; i++)
+        EXPECT_TRUE(map.emplace(i * 3, i).second);
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_FALSE(map.emplace(9, 0).second);
+    ASSERT_NE(map.find(9), nullptr);
+    EXPECT_EQ(*map.find(9), 3u);
+    EXPECT_EQ(map.find(10), nullptr);
+    map[10] = 5;
+    EXPECT_EQ(*map.find(10), 5u);
+}
\ No newline at end of file
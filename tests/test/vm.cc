@@ -0,0 +1,112 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <scanner/scanner.hh>
+#include <ast/parser.hh>
+#include <ast/eval.hh>
+#include <ast/env.hh>
+#include <ast/resolver.hh>
+#include <vm/vm.hh>
+
+#include "run.hh"
+
+using namespace rift::ast;
+using namespace rift::scanner;
+using string = std::string;
+
+#pragma mark - Rift VM (Fixtures)
+
+/// @note diffs the vm against the reference tree-walking evaluator
+class RiftVM : public ::testing::Test {
+
+    protected:
+        struct Run {
+            string out;
+            std::vector<string> results;
+        };
+
+        std::unique_ptr<Program> parse(const string& source)
+        {
+            return rift::test::compile(rift::Isolate::current(), source);
+        }
+
+        Run tree(const string& source)
+        {
+            Environment::getInstance(false).clear(false);
+            auto prgm = parse(source);
+            Eval eval;
+            testing::internal::CaptureStdout();
+            auto results = eval.evaluate(*prgm, false);
+            return {testing::internal::GetCapturedStdout(), results};
+        }
+
+        Run vm(const string& source)
+        {
+            auto prgm = parse(source);
+            rift::vm::VM vm;
+            testing::internal::CaptureStdout();
+            auto results = vm.evaluate(*prgm, false);
+            return {testing::internal::GetCapturedStdout(), results};
+        }
+
+        void expectSame(const string& source, bool results = true)
+        {
+            auto ref = tree(source), got = vm(source);
+            EXPECT_EQ(ref.out, got.out) << source;
+            if (results) { EXPECT_EQ(ref.results, got.results) << source; }
+        }
+};
+
+#pragma mark - Rift VM (Tests)
+
+TEST_F(RiftVM, arithmetic) {
+    expectSame("print(1 + 2 * 3); print(7 / 2); print(-4 - 1); print(0.1 + 0.2);");
+    expectSame("1 + 2; 3 * (4 - 1);");
+}
+
+TEST_F(RiftVM, stringsAndComparison) {
+    expectSame("print(\"a\" + \"b\"); print(\"n=\" + 3); print(\"abc\" < \"abd\");");
+    expectSame("print(1 == 1); print(1 != 2); print(nil == nil); print(!true); print(3 >= 4);");
+}
+
+TEST_F(RiftVM, variables) {
+    expectSame("mut x = 3; mut! k = 10; x = x + k; print(x); print(x ?? 4);");
+    expectSame("mut a = 1; mut b = a == 1 && a != 2; print(b || false);");
+    expectSame("mut n; print(n ?? \"unset\"); n = \"set\"; print(n);");
+}
+
+TEST_F(RiftVM, controlFlow) {
+    expectSame("mut x = 2; if (x > 2) print(\"big\"); elif (x > 1) print(\"mid\"); else print(\"small\");");
+    expectSame("mut x = 0; print(x > 0 ? \"pos\" : \"neg\");");
+    expectSame("mut s = 0; for (mut i = 0; i < 10; i = i + 1) { s = s + i; } print(s);");
+}
+
+TEST_F(RiftVM, scopes) {
+    expectSame("mut g = 1; if (g == 1) { mut a = 2; print(a + g); } else { mut a = 3; print(a); }");
+    expectSame("for (mut i = 0; i < 3; i = i + 1) { mut sq = i * i; print(sq); } for (mut i = 5; i > 3; i = i - 1) print(i);");
+    expectSame("mut t = 0; for (mut i = 0; i < 3; i = i + 1) { for (mut j = 0; j < 2; j = j + 1) { mut p = i * j; t = t + p; } } print(t);");
+    expectSame("fun inner() { mut loc = 40; loc = loc + 2; return loc; } print(inner()); print(inner());");
+}
+
+TEST_F(RiftVM, functions) {
+    expectSame("fun one() { return 1; } print(one()); fun hello() { print(\"hello\"); } hello();");
+    expectSame("fun add(a, b) { return 1 + 2; } mut z = add(1, 2); print(z * 2);");
+}
+
+TEST_F(RiftVM, parametersAndReturns) {
+    expectSame("fun add(a, b) { return a + b; } print(add(2, 3)); print(add(\"a\", \"b\"));");
+    expectSame("fun fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); } print(fib(15));");
+    expectSame("fun find(n) { for (mut i = 0; i < 10; i = i + 1) { if (i * i > n) { return i; } } return -1; } print(find(20)); print(find(200));");
+    expectSame("fun twice(x) { mut y = x * 2; return y; } print(twice(twice(3)));");
+}
+
+TEST_F(RiftVM, globalsAcrossScripts) {
+    // every line of a REPL session is its own script, functions keep reading the globals they were compiled against
+    Environment::getInstance(false).clear(false);
+    rift::vm::VM vm;
+    testing::internal::CaptureStdout();
+    for (auto line : {"mut! base = 100; mut other = 1;", "fun lib(n) { return n + base; }", "mut extra = 2; print(lib(5) + extra);"})
+        vm.evaluate(*parse(line), true);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "107\n");
+}
\ No newline at end of file